@@ -65,6 +65,12 @@ cmds_optional = [
     "glEGLImageTargetTexture2DOES",
     # Invalidate subdat
     "glInvalidateFramebuffer",
+    # Program binary
+    "glGetProgramBinary",
+    "glProgramBinary",
+    "glProgramParameteri",
+    # Parallel shader compile
+    "glMaxShaderCompilerThreadsKHR",
 ]
 
 cmds = [
@@ -211,6 +217,7 @@ cmds = [
     "glFenceSync",
     "glWaitSync",
     "glClientWaitSync",
+    "glDeleteSync",
     # Read/Draw Buffer
     "glReadBuffer",
     "glDrawBuffers",
@@ -20,45 +20,72 @@
  */
 
 #include <float.h>
+#include <stdint.h>
 #include "animation.h"
 #include "log.h"
 #include "math_utils.h"
 #include "nopegl.h"
 #include "internal.h"
 
-static size_t get_kf_id(struct ngl_node * const *animkf, size_t nb_animkf, size_t start, double t)
+/*
+ * Return the index of the last key frame with a time lower or equal to t, or
+ * SIZE_MAX if t is before the first key frame. The previously used key frame
+ * is checked first since consecutive evaluations are usually close in time,
+ * with a fallback on a binary search.
+ */
+static size_t get_kf_id(struct ngl_node * const *animkf, size_t nb_animkf, size_t hint, double t)
 {
-    size_t ret = SIZE_MAX;
+    if (hint < nb_animkf) {
+        const struct animkeyframe_opts *kf = animkf[hint]->opts;
+        if (kf->time <= t) {
+            if (hint + 1 == nb_animkf)
+                return hint;
+            const struct animkeyframe_opts *next_kf = animkf[hint + 1]->opts;
+            if (next_kf->time > t)
+                return hint;
+            if (hint + 2 == nb_animkf)
+                return hint + 1;
+            const struct animkeyframe_opts *next2_kf = animkf[hint + 2]->opts;
+            if (next2_kf->time > t)
+                return hint + 1;
+        }
+    }
 
-    for (size_t i = start; i < nb_animkf; i++) {
-        const struct animkeyframe_opts *kf = animkf[i]->opts;
+    size_t lo = 0, hi = nb_animkf;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        const struct animkeyframe_opts *kf = animkf[mid]->opts;
         if (kf->time > t)
-            break;
-        ret = i;
+            hi = mid;
+        else
+            lo = mid + 1;
     }
-    return ret;
+    return lo ? lo - 1 : SIZE_MAX;
+}
+
+static double get_ratio(const struct animkeyframe_opts *kf0,
+                        const struct animkeyframe_opts *kf1,
+                        const struct animkeyframe_priv *kf1_priv, double t)
+{
+    double tnorm = NGLI_LINEAR_NORM(kf0->time, kf1->time, t);
+    if (kf1_priv->scale_boundaries)
+        tnorm = NGLI_MIX_F64(kf1->offsets[0], kf1->offsets[1], tnorm);
+    double ratio = kf1_priv->function(tnorm, kf1->nb_args, kf1->args);
+    if (kf1_priv->scale_boundaries)
+        ratio = NGLI_LINEAR_NORM(kf1_priv->boundaries[0], kf1_priv->boundaries[1], ratio);
+    return ratio;
 }
 
 int ngli_animation_evaluate(struct animation *s, void *dst, double t)
 {
     struct ngl_node * const *animkf = s->kfs;
     const size_t nb_animkf = s->nb_kfs;
-    size_t kf_id = get_kf_id(animkf, nb_animkf, s->current_kf, t);
-    if (kf_id == SIZE_MAX)
-        kf_id = get_kf_id(animkf, nb_animkf, 0, t);
+    const size_t kf_id = get_kf_id(animkf, nb_animkf, s->current_kf, t);
     if (kf_id != SIZE_MAX && kf_id < nb_animkf - 1) {
         const struct animkeyframe_priv *kf1_priv = animkf[kf_id + 1]->priv_data;
         const struct animkeyframe_opts *kf0 = animkf[kf_id    ]->opts;
         const struct animkeyframe_opts *kf1 = animkf[kf_id + 1]->opts;
-        const double t0 = kf0->time;
-        const double t1 = kf1->time;
-
-        double tnorm = NGLI_LINEAR_NORM(t0, t1, t);
-        if (kf1_priv->scale_boundaries)
-            tnorm = NGLI_MIX_F64(kf1->offsets[0], kf1->offsets[1], tnorm);
-        double ratio = kf1_priv->function(tnorm, kf1->nb_args, kf1->args);
-        if (kf1_priv->scale_boundaries)
-            ratio = NGLI_LINEAR_NORM(kf1_priv->boundaries[0], kf1_priv->boundaries[1], ratio);
+        const double ratio = get_ratio(kf0, kf1, kf1_priv, t);
 
         s->current_kf = kf_id;
         s->mix_func(s->user_arg, dst, kf0, kf1, ratio);
@@ -71,13 +98,64 @@ int ngli_animation_evaluate(struct animation *s, void *dst, double t)
     return 0;
 }
 
+int ngli_animation_evaluate_batch(struct animation *s, void *dst, size_t dst_stride,
+                                  const double *ts, size_t nb_ts)
+{
+    struct ngl_node * const *animkf = s->kfs;
+    const size_t nb_animkf = s->nb_kfs;
+    uint8_t *dstp = dst;
+    double ratios[64];
+
+    size_t i = 0;
+    while (i < nb_ts) {
+        const double t = ts[i];
+        const size_t kf_id = get_kf_id(animkf, nb_animkf, s->current_kf, t);
+        if (kf_id == SIZE_MAX || kf_id >= nb_animkf - 1) {
+            const struct animkeyframe_opts *kf0 = animkf[            0]->opts;
+            const struct animkeyframe_opts *kfn = animkf[nb_animkf - 1]->opts;
+            const struct animkeyframe_opts *kf  = t < kf0->time ? kf0 : kfn;
+            s->cpy_func(s->user_arg, dstp, kf);
+            dstp += dst_stride;
+            i++;
+            continue;
+        }
+
+        /*
+         * Gather the following times falling within the same key frame
+         * interval so that they can be mixed in one go
+         */
+        const struct animkeyframe_priv *kf1_priv = animkf[kf_id + 1]->priv_data;
+        const struct animkeyframe_opts *kf0 = animkf[kf_id    ]->opts;
+        const struct animkeyframe_opts *kf1 = animkf[kf_id + 1]->opts;
+        size_t n = 0;
+        ratios[n++] = get_ratio(kf0, kf1, kf1_priv, t);
+        while (i + n < nb_ts && n < NGLI_ARRAY_NB(ratios)) {
+            const double tn = ts[i + n];
+            if (tn < kf0->time || tn >= kf1->time)
+                break;
+            ratios[n++] = get_ratio(kf0, kf1, kf1_priv, tn);
+        }
+
+        s->current_kf = kf_id;
+        if (s->mix_batch_func) {
+            s->mix_batch_func(s->user_arg, dstp, dst_stride, kf0, kf1, ratios, n);
+            dstp += n * dst_stride;
+        } else {
+            for (size_t j = 0; j < n; j++) {
+                s->mix_func(s->user_arg, dstp, kf0, kf1, ratios[j]);
+                dstp += dst_stride;
+            }
+        }
+        i += n;
+    }
+    return 0;
+}
+
 int ngli_animation_derivate(struct animation *s, void *dst, double t)
 {
     struct ngl_node * const *animkf = s->kfs;
     const size_t nb_animkf = s->nb_kfs;
-    size_t kf_id = get_kf_id(animkf, nb_animkf, s->current_kf, t);
-    if (kf_id == SIZE_MAX)
-        kf_id = get_kf_id(animkf, nb_animkf, 0, t);
+    const size_t kf_id = get_kf_id(animkf, nb_animkf, s->current_kf, t);
     if (kf_id != SIZE_MAX && kf_id < nb_animkf - 1) {
         const struct animkeyframe_priv *kf1_priv = animkf[kf_id + 1]->priv_data;
         const struct animkeyframe_opts *kf0 = animkf[kf_id    ]->opts;
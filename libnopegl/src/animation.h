@@ -34,6 +34,11 @@ typedef void (*ngli_animation_mix_func_type)(void *user_arg, void *dst,
 typedef void (*ngli_animation_cpy_func_type)(void *user_arg, void *dst,
                                              const struct animkeyframe_opts *kf);
 
+typedef void (*ngli_animation_mix_batch_func_type)(void *user_arg, void *dst, size_t dst_stride,
+                                                   const struct animkeyframe_opts *kf0,
+                                                   const struct animkeyframe_opts *kf1,
+                                                   const double *ratios, size_t nb_ratios);
+
 struct animation {
     struct ngl_node * const *kfs;
     size_t nb_kfs;
@@ -41,6 +46,7 @@ struct animation {
     void *user_arg;
     ngli_animation_mix_func_type mix_func;
     ngli_animation_cpy_func_type cpy_func;
+    ngli_animation_mix_batch_func_type mix_batch_func; /* optional */
 };
 
 int ngli_animation_init(struct animation *s, void *user_arg,
@@ -49,6 +55,8 @@ int ngli_animation_init(struct animation *s, void *user_arg,
                         ngli_animation_cpy_func_type cpy_func);
 
 int ngli_animation_evaluate(struct animation *s, void *dst, double t);
+int ngli_animation_evaluate_batch(struct animation *s, void *dst, size_t dst_stride,
+                                  const double *ts, size_t nb_ts);
 int ngli_animation_derivate(struct animation *s, void *dst, double t);
 
 #endif
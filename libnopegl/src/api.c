@@ -21,6 +21,7 @@
  * under the License.
  */
 
+#include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
@@ -46,6 +47,8 @@
 #include "internal.h"
 #include "pgcache.h"
 #include "rnode.h"
+#include "rtt.h"
+#include "text.h"
 #include "pthread_compat.h"
 
 #if defined(HAVE_VAAPI)
@@ -247,11 +250,24 @@ int ngli_ctx_set_scene(struct ngl_ctx *s, struct ngl_scene *scene)
     ngli_gpu_ctx_wait_idle(s->gpu_ctx);
     reset_scene(s, NGLI_ACTION_UNREF_SCENE);
 
+    /*
+     * All the Text nodes of the previous scene are detached at this point:
+     * drop their glyphs and atlas so that they do not accumulate across scenes
+     */
+    ngli_text_external_cache_freep(&s->text_external_cache);
+
     ngli_rnode_init(&s->rnode);
     s->rnode_pos = &s->rnode;
     s->rnode_pos->graphics_state = NGLI_GRAPHICS_STATE_DEFAULTS;
     s->rnode_pos->rendertarget_layout = *ngli_gpu_ctx_get_default_rendertarget_layout(s->gpu_ctx);
 
+    /*
+     * The pipelines created while attaching the scene and the HUD are only
+     * initialized at the end of the batch, once all their programs are
+     * compiled, possibly concurrently
+     */
+    ngli_gpu_ctx_begin_pipeline_batch(s->gpu_ctx);
+
     if (scene) {
         if (!scene->params.root) {
             LOG(ERROR, "specified scene doesn't contain a graph");
@@ -259,16 +275,40 @@ int ngli_ctx_set_scene(struct ngl_ctx *s, struct ngl_scene *scene)
             goto fail;
         }
 
-        int ret = ngli_node_attach_ctx(scene->params.root, s);
-        if (ret < 0) {
-            ngli_node_detach_ctx(scene->params.root, s);
-            return ret;
+        /*
+         * The equivalent nodes are identified before any GPU resource is
+         * created, so that only one of them is initialized when the graph is
+         * attached; the graph of the user is left untouched
+         */
+        if (s->config.dedup_nodes) {
+            s->merged_nodes = ngli_hmap_create();
+            if (!s->merged_nodes) {
+                ret = NGL_ERROR_MEMORY;
+                goto fail;
+            }
+            size_t nb_nodes, size;
+            ret = ngli_scene_dedup(scene, s->merged_nodes, &nb_nodes, &size);
+            if (ret < 0)
+                goto fail;
+            LOG(INFO, "merged %zu duplicated nodes (%zu bytes of parameters)", nb_nodes, size);
         }
+
+        /*
+         * The scene is set before attaching its graph so that its timeline
+         * (duration, framerate) is available to the nodes
+         */
         s->scene = scene_copy(scene);
         if (!s->scene) {
             ret = NGL_ERROR_MEMORY;
             goto fail;
         }
+
+        ret = ngli_node_attach_ctx(scene->params.root, s);
+        if (ret < 0)
+            goto fail;
+
+        /* The merged nodes now reference the node they are merged into */
+        ngli_hmap_freep(&s->merged_nodes);
     }
 
     const struct ngl_config *config = &s->config;
@@ -279,18 +319,73 @@ int ngli_ctx_set_scene(struct ngl_ctx *s, struct ngl_scene *scene)
             goto fail;
         }
 
-        int ret = ngli_hud_init(s->hud);
+        ret = ngli_hud_init(s->hud);
         if (ret < 0)
             goto fail;
     }
 
+    ret = ngli_gpu_ctx_end_pipeline_batch(s->gpu_ctx);
+    if (ret < 0)
+        goto fail;
+
     return 0;
 
 fail:
+    /* Ending the batch again is harmless and waits for the pending jobs */
+    ngli_gpu_ctx_end_pipeline_batch(s->gpu_ctx);
     reset_scene(s, NGLI_ACTION_UNREF_SCENE);
+    ngli_hmap_freep(&s->merged_nodes);
     return ret;
 }
 
+int64_t ngli_ctx_get_nb_frames(const struct ngl_ctx *s)
+{
+    if (!s->scene)
+        return 0;
+
+    const struct ngl_scene_params *params = &s->scene->params;
+    const int32_t *rate = params->framerate;
+    if (rate[0] <= 0 || rate[1] <= 0 || !(params->duration >= 0.))
+        return 0;
+
+    const double nb_frames = floor(params->duration * rate[0] / rate[1]) + 1.;
+    if (nb_frames > (double)INT32_MAX)
+        return 0;
+
+    int64_t ret = (int64_t)nb_frames;
+    while (ret > 0 && ngli_ctx_get_frame_time(s, ret - 1) > params->duration)
+        ret--;
+    return ret;
+}
+
+/* Same expression as the one used by the player to derive the frame times */
+double ngli_ctx_get_frame_time(const struct ngl_ctx *s, int64_t frame)
+{
+    const int32_t *rate = s->scene->params.framerate;
+    return (double)(frame * rate[1]) / (double)rate[0];
+}
+
+/*
+ * Return the index of the frame of the scene exactly matching the time t, or
+ * -1 if there is none.
+ */
+int64_t ngli_ctx_get_frame_index(const struct ngl_ctx *s, double t)
+{
+    const int64_t nb_frames = ngli_ctx_get_nb_frames(s);
+    const int32_t *rate = nb_frames ? s->scene->params.framerate : NULL;
+    if (!rate)
+        return -1;
+
+    const double index = t * rate[0] / rate[1];
+    if (!(index > -1. && index < (double)nb_frames))
+        return -1;
+
+    const int64_t frame = llrint(index);
+    if (frame < 0 || frame >= nb_frames || ngli_ctx_get_frame_time(s, frame) != t)
+        return -1;
+    return frame;
+}
+
 void ngli_ctx_reset(struct ngl_ctx *s, int action)
 {
     if (s->gpu_ctx)
@@ -303,7 +398,13 @@ void ngli_ctx_reset(struct ngl_ctx *s, int action)
     ngli_android_ctx_reset(&s->android_ctx);
 #endif
     ngli_hmap_freep(&s->text_builtin_atlasses);
+    ngli_text_external_cache_freep(&s->text_external_cache);
+    ngli_captureconv_reset(&s->captureconv);
     ngli_pgcache_reset(&s->pgcache);
+    ngli_threadpool_freep(&s->update_pool);
+    ngli_darray_clear(&s->parallel_update_nodes);
+    ngli_darray_clear(&s->parallel_update_wave);
+    ngli_darray_clear(&s->transient_attachments);
     ngli_gpu_ctx_freep(&s->gpu_ctx);
     ngli_config_reset(&s->config);
     backend_reset(&s->backend);
@@ -340,6 +441,24 @@ int ngli_ctx_configure(struct ngl_ctx *s, const struct ngl_config *config)
     if (ret < 0)
         goto fail;
 
+    if (config->update_threads > 0) {
+        s->update_pool = ngli_threadpool_create();
+        if (!s->update_pool) {
+            ret = NGL_ERROR_MEMORY;
+            goto fail;
+        }
+
+        ret = ngli_threadpool_init(s->update_pool, (size_t)config->update_threads);
+        if (ret < 0)
+            goto fail;
+    }
+
+    if (config->capture_format != NGL_CAPTURE_FORMAT_RGBA) {
+        ret = ngli_captureconv_init(&s->captureconv, s);
+        if (ret < 0)
+            goto fail;
+    }
+
     s->text_builtin_atlasses = ngli_hmap_create();
     if (!s->text_builtin_atlasses) {
         ret = NGL_ERROR_MEMORY;
@@ -424,6 +543,10 @@ int ngli_ctx_prepare_draw(struct ngl_ctx *s, double t)
     if (ret < 0)
         return ret;
 
+    ret = ngli_node_update_parallel(root, t);
+    if (ret < 0)
+        return ret;
+
     ret = ngli_node_update(root, t);
     if (ret < 0)
         return ret;
@@ -437,7 +560,7 @@ int ngli_ctx_prepare_draw(struct ngl_ctx *s, double t)
     return 0;
 }
 
-int ngli_ctx_draw(struct ngl_ctx *s, double t)
+static int draw_frame(struct ngl_ctx *s, double t)
 {
     int ret = ngli_ctx_prepare_draw(s, t);
     if (ret < 0)
@@ -455,6 +578,7 @@ int ngli_ctx_draw(struct ngl_ctx *s, double t)
     s->available_rendertargets[1] = rt_resume;
     s->current_rendertarget = rt;
     s->render_pass_started = 0;
+    s->draw_id++;
 
     struct ngl_scene *scene = s->scene;
     if (scene) {
@@ -485,9 +609,27 @@ int ngli_ctx_draw(struct ngl_ctx *s, double t)
         s->render_pass_started = 0;
     }
 
+    const struct ngl_config *config = &s->config;
+    if (config->capture_format != NGL_CAPTURE_FORMAT_RGBA && (config->capture_buffer || config->on_frame)) {
+        const struct attachment *color = &rt->params.colors[0];
+        ret = ngli_captureconv_convert(&s->captureconv, color->resolve_target ? color->resolve_target
+                                                                              : color->attachment);
+        if (ret < 0) {
+            ngli_gpu_ctx_end_draw(s->gpu_ctx, t);
+            return ret;
+        }
+    }
+
     return ngli_gpu_ctx_end_draw(s->gpu_ctx, t);
 }
 
+int ngli_ctx_draw(struct ngl_ctx *s, double t)
+{
+    int ret = draw_frame(s, t);
+    int ret_capture = ngli_gpu_ctx_wait_captures(s->gpu_ctx, 0);
+    return ret < 0 ? ret : ret_capture;
+}
+
 int ngli_ctx_dispatch_cmd(struct ngl_ctx *s, cmd_func_type cmd_func, void *arg)
 {
     pthread_mutex_lock(&s->lock);
@@ -501,6 +643,83 @@ int ngli_ctx_dispatch_cmd(struct ngl_ctx *s, cmd_func_type cmd_func, void *arg)
     return s->cmd_ret;
 }
 
+int ngli_ctx_draw_async(struct ngl_ctx *s, double t, void *capture_buffer)
+{
+    pthread_mutex_lock(&s->lock);
+    if (s->nb_async_frames == NGL_MAX_FRAMES_IN_FLIGHT) {
+        pthread_mutex_unlock(&s->lock);
+        LOG(ERROR, "too many frames in flight, ngl_wait_frame() must be called first");
+        return NGL_ERROR_INVALID_USAGE;
+    }
+    const size_t index = (s->async_wait_index + s->nb_async_frames) % NGL_MAX_FRAMES_IN_FLIGHT;
+    s->async_frames[index] = (struct async_frame){.t = t, .capture_buffer = capture_buffer};
+    s->nb_async_frames++;
+    s->nb_async_queued++;
+    pthread_cond_signal(&s->cond_wkr);
+    pthread_mutex_unlock(&s->lock);
+
+    return 0;
+}
+
+static int draw_async_frame(struct ngl_ctx *s, const struct async_frame *frame)
+{
+    struct ngl_config *config = &s->config;
+
+    if (frame->capture_buffer != config->capture_buffer) {
+        int ret = ngli_gpu_ctx_set_capture_buffer(s->gpu_ctx, frame->capture_buffer);
+        if (ret < 0)
+            return ret;
+        config->capture_buffer = frame->capture_buffer;
+    }
+
+    return draw_frame(s, frame->t);
+}
+
+/*
+ * Complete the captures of the oldest drawn frames until at most max_pending
+ * frames remain pending. Must be called with the lock held.
+ */
+static void complete_async_frames(struct ngl_ctx *s, size_t max_pending)
+{
+    if (s->nb_async_pending <= max_pending)
+        return;
+
+    pthread_mutex_unlock(&s->lock);
+    const int ret = ngli_gpu_ctx_wait_captures(s->gpu_ctx, max_pending);
+    pthread_mutex_lock(&s->lock);
+
+    while (s->nb_async_pending > max_pending) {
+        const size_t nb_done = s->nb_async_frames - s->nb_async_queued - s->nb_async_pending;
+        const size_t index = (s->async_wait_index + nb_done) % NGL_MAX_FRAMES_IN_FLIGHT;
+        struct async_frame *frame = &s->async_frames[index];
+        if (frame->ret >= 0)
+            frame->ret = ret;
+        s->nb_async_pending--;
+    }
+    pthread_cond_signal(&s->cond_ctl);
+}
+
+/*
+ * Wait for all the frames queued with ngl_draw_async() to be drawn. This must
+ * be called before any other operation on the context since the queued frames
+ * are drawn concurrently by the worker thread.
+ */
+static void wait_async_frames(struct ngl_ctx *s)
+{
+    pthread_mutex_lock(&s->lock);
+    while (s->nb_async_queued || s->nb_async_pending)
+        pthread_cond_wait(&s->cond_ctl, &s->lock);
+    pthread_mutex_unlock(&s->lock);
+}
+
+/* Drop the frames that have been drawn but not retrieved with ngl_wait_frame() */
+static void drop_async_frames(struct ngl_ctx *s)
+{
+    wait_async_frames(s);
+    s->async_wait_index = 0;
+    s->nb_async_frames = 0;
+}
+
 static void *worker_thread(void *arg)
 {
     struct ngl_ctx *s = arg;
@@ -509,8 +728,30 @@ static void *worker_thread(void *arg)
 
     pthread_mutex_lock(&s->lock);
     for (;;) {
-        while (!s->cmd_func)
+        while (!s->cmd_func && !s->nb_async_queued && !s->nb_async_pending)
             pthread_cond_wait(&s->cond_wkr, &s->lock);
+
+        if (!s->cmd_func) {
+            if (s->nb_async_queued) {
+                const size_t nb_drawn = s->nb_async_frames - s->nb_async_queued;
+                const size_t index = (s->async_wait_index + nb_drawn) % NGL_MAX_FRAMES_IN_FLIGHT;
+                struct async_frame *frame = &s->async_frames[index];
+                pthread_mutex_unlock(&s->lock);
+                frame->ret = draw_async_frame(s, frame);
+                pthread_mutex_lock(&s->lock);
+                s->nb_async_queued--;
+                s->nb_async_pending++;
+            }
+
+            /*
+             * With asynchronous captures, the readback of the last drawn
+             * frame is kept in flight while the next frame is drawn
+             */
+            const int keep_pending = s->config.capture_async && s->nb_async_queued;
+            complete_async_frames(s, keep_pending ? 1 : 0);
+            continue;
+        }
+
         s->cmd_ret = s->cmd_func(s, s->cmd_arg);
         int need_stop = s->cmd_func == cmd_stop;
         s->cmd_func = s->cmd_arg = NULL;
@@ -644,6 +885,9 @@ struct ngl_ctx *ngl_create(void)
     ngli_darray_init(&s->modelview_matrix_stack, 4 * 4 * sizeof(float), 1);
     ngli_darray_init(&s->projection_matrix_stack, 4 * 4 * sizeof(float), 1);
     ngli_darray_init(&s->activitycheck_nodes, sizeof(struct ngl_node *), 0);
+    ngli_darray_init(&s->parallel_update_nodes, sizeof(struct ngl_node *), 0);
+    ngli_darray_init(&s->parallel_update_wave, sizeof(struct ngl_node *), 0);
+    ngli_darray_init(&s->transient_attachments, sizeof(struct transient_attachment), 0);
 
     static const NGLI_ALIGNED_MAT(id_matrix) = NGLI_MAT4_IDENTITY;
     if (!ngli_darray_push(&s->modelview_matrix_stack, id_matrix) ||
@@ -662,6 +906,8 @@ fail:
 
 int ngl_configure(struct ngl_ctx *s, const struct ngl_config *user_config)
 {
+    drop_async_frames(s);
+
     if (s->configured) {
         s->api_impl->reset(s, NGLI_ACTION_KEEP_SCENE);
         s->configured = 0;
@@ -688,6 +934,11 @@ int ngl_configure(struct ngl_ctx *s, const struct ngl_config *user_config)
         return config.platform;
     }
 
+    if (config.update_threads < 0) {
+        LOG(ERROR, "invalid number of update threads: %d", config.update_threads);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
     if (config.backend < 0 ||
         config.backend >= NGLI_ARRAY_NB(api_map)) {
         LOG(ERROR, "unknown backend %d", config.backend);
@@ -734,6 +985,8 @@ void ngl_reset_backend(struct ngl_backend *backend)
 
 int ngl_resize(struct ngl_ctx *s, int32_t width, int32_t height, const int32_t *viewport)
 {
+    wait_async_frames(s);
+
     if (!s->configured) {
         LOG(ERROR, "context must be configured before resizing rendering buffers");
         return NGL_ERROR_INVALID_USAGE;
@@ -744,6 +997,8 @@ int ngl_resize(struct ngl_ctx *s, int32_t width, int32_t height, const int32_t *
 
 int ngl_set_capture_buffer(struct ngl_ctx *s, void *capture_buffer)
 {
+    wait_async_frames(s);
+
     if (!s->configured) {
         LOG(ERROR, "context must be configured before setting a capture buffer");
         return NGL_ERROR_INVALID_USAGE;
@@ -759,6 +1014,8 @@ int ngl_set_capture_buffer(struct ngl_ctx *s, void *capture_buffer)
 
 int ngl_set_scene(struct ngl_ctx *s, struct ngl_scene *scene)
 {
+    wait_async_frames(s);
+
     if (!s->configured) {
         LOG(ERROR, "context must be configured before setting a scene");
         return NGL_ERROR_INVALID_USAGE;
@@ -769,6 +1026,8 @@ int ngl_set_scene(struct ngl_ctx *s, struct ngl_scene *scene)
 
 int ngli_prepare_draw(struct ngl_ctx *s, double t)
 {
+    wait_async_frames(s);
+
     if (!s->configured) {
         LOG(ERROR, "context must be configured before updating");
         return NGL_ERROR_INVALID_USAGE;
@@ -779,6 +1038,8 @@ int ngli_prepare_draw(struct ngl_ctx *s, double t)
 
 int ngl_draw(struct ngl_ctx *s, double t)
 {
+    wait_async_frames(s);
+
     if (!s->configured) {
         LOG(ERROR, "context must be configured before drawing");
         return NGL_ERROR_INVALID_USAGE;
@@ -787,8 +1048,40 @@ int ngl_draw(struct ngl_ctx *s, double t)
     return s->api_impl->draw(s, t);
 }
 
+int ngl_draw_async(struct ngl_ctx *s, double t, void *capture_buffer)
+{
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured before drawing");
+        return NGL_ERROR_INVALID_USAGE;
+    }
+
+    return s->api_impl->draw_async(s, t, capture_buffer);
+}
+
+int ngl_wait_frame(struct ngl_ctx *s, void **capture_bufferp)
+{
+    pthread_mutex_lock(&s->lock);
+    if (!s->nb_async_frames) {
+        pthread_mutex_unlock(&s->lock);
+        LOG(ERROR, "no frame in flight, ngl_draw_async() must be called first");
+        return NGL_ERROR_INVALID_USAGE;
+    }
+    while (s->nb_async_queued + s->nb_async_pending == s->nb_async_frames)
+        pthread_cond_wait(&s->cond_ctl, &s->lock);
+    const struct async_frame frame = s->async_frames[s->async_wait_index];
+    s->async_wait_index = (s->async_wait_index + 1) % NGL_MAX_FRAMES_IN_FLIGHT;
+    s->nb_async_frames--;
+    pthread_mutex_unlock(&s->lock);
+
+    if (capture_bufferp)
+        *capture_bufferp = frame.capture_buffer;
+    return frame.ret;
+}
+
 int ngl_gl_wrap_framebuffer(struct ngl_ctx *s, uint32_t framebuffer)
 {
+    wait_async_frames(s);
+
     if (!s->configured) {
         LOG(ERROR, "context must be configured before wrapping a new external OpenGL framebuffer");
         return NGL_ERROR_INVALID_USAGE;
@@ -824,6 +1117,8 @@ void ngl_freep(struct ngl_ctx **ss)
     if (!s)
         return;
 
+    drop_async_frames(s);
+
     if (s->configured) {
         s->api_impl->reset(s, NGLI_ACTION_UNREF_SCENE);
         s->configured = 0;
@@ -837,6 +1132,9 @@ void ngl_freep(struct ngl_ctx **ss)
     ngli_darray_reset(&s->modelview_matrix_stack);
     ngli_darray_reset(&s->projection_matrix_stack);
     ngli_darray_reset(&s->activitycheck_nodes);
+    ngli_darray_reset(&s->parallel_update_nodes);
+    ngli_darray_reset(&s->parallel_update_wave);
+    ngli_darray_reset(&s->transient_attachments);
     ngli_freep(ss);
 }
 
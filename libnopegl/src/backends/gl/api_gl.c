@@ -184,6 +184,17 @@ static int glw_draw(struct ngl_ctx *s, double t)
     return ret;
 }
 
+static int gl_draw_async(struct ngl_ctx *s, double t, void *capture_buffer)
+{
+    return ngli_ctx_draw_async(s, t, capture_buffer);
+}
+
+static int glw_draw_async(struct ngl_ctx *s, double t, void *capture_buffer)
+{
+    LOG(ERROR, "asynchronous draw is not supported by external OpenGL context");
+    return NGL_ERROR_UNSUPPORTED;
+}
+
 static int cmd_reset(struct ngl_ctx *s, void *arg)
 {
     const int action = *(int *)arg;
@@ -258,6 +269,11 @@ static int glv_draw(struct ngl_ctx *s, double t)
     return is_glw(&s->config) ? glw_draw(s, t) : gl_draw(s, t);
 }
 
+static int glv_draw_async(struct ngl_ctx *s, double t, void *capture_buffer)
+{
+    return is_glw(&s->config) ? glw_draw_async(s, t, capture_buffer) : gl_draw_async(s, t, capture_buffer);
+}
+
 static void glv_reset(struct ngl_ctx *s, int action)
 {
     is_glw(&s->config) ? glw_reset(s, action) : gl_reset(s, action);
@@ -275,6 +291,7 @@ const struct api_impl api_gl = {
     .set_scene           = glv_set_scene,
     .prepare_draw        = glv_prepare_draw,
     .draw                = glv_draw,
+    .draw_async          = glv_draw_async,
     .reset               = glv_reset,
     .gl_wrap_framebuffer = glv_wrap_framebuffer,
 };
@@ -65,6 +65,8 @@ static GLbitfield get_gl_map_flags(int usage)
         flags |= GL_MAP_READ_BIT;
     if (usage & NGLI_BUFFER_USAGE_MAP_WRITE)
         flags |= GL_MAP_WRITE_BIT;
+    if (usage & NGLI_BUFFER_USAGE_MAP_PERSISTENT)
+        flags |= GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
     return flags;
 }
 
@@ -48,6 +48,8 @@
 #define NGLI_FEATURE_GL_TEXTURE_NORM16                             (1ULL << 42)
 #define NGLI_FEATURE_GL_TEXTURE_FLOAT_LINEAR                       (1ULL << 43)
 #define NGLI_FEATURE_GL_FLOAT_BLEND                                (1ULL << 44)
+#define NGLI_FEATURE_GL_GET_PROGRAM_BINARY                         (1ULL << 45)
+#define NGLI_FEATURE_GL_KHR_PARALLEL_SHADER_COMPILE                (1ULL << 46)
 
 #define NGLI_FEATURE_GL_COMPUTE_SHADER_ALL (NGLI_FEATURE_GL_COMPUTE_SHADER           | \
                                             NGLI_FEATURE_GL_PROGRAM_INTERFACE_QUERY  | \
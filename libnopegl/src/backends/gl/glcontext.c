@@ -362,6 +362,8 @@ static int glcontext_probe_limits(struct glcontext *glcontext)
     if (glcontext->features & NGLI_FEATURE_GL_SHADER_STORAGE_BUFFER_OBJECT) {
         GET(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &limits->max_storage_block_size);
         GET(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &limits->min_storage_block_offset_alignment);
+        GET(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS, &limits->max_vertex_storage_blocks);
+        GET(GL_MAX_FRAGMENT_SHADER_STORAGE_BLOCKS, &limits->max_fragment_storage_blocks);
     }
 
     if (glcontext->features & NGLI_FEATURE_GL_SHADER_IMAGE_LOAD_STORE) {
@@ -380,6 +382,9 @@ static int glcontext_probe_limits(struct glcontext *glcontext)
         }
 
         GET(GL_MAX_COMPUTE_SHARED_MEMORY_SIZE, &limits->max_compute_shared_memory_size);
+
+        if (glcontext->features & NGLI_FEATURE_GL_SHADER_STORAGE_BUFFER_OBJECT)
+            GET(GL_MAX_COMPUTE_SHADER_STORAGE_BLOCKS, &limits->max_compute_storage_blocks);
     }
 
     GET(GL_MAX_DRAW_BUFFERS, &limits->max_draw_buffers);
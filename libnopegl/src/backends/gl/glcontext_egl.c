@@ -45,6 +45,7 @@
 #include "glcontext.h"
 #include "log.h"
 #include "nopegl.h"
+#include "pthread_compat.h"
 #include "utils.h"
 
 #define EGL_PLATFORM_DEVICE_EXT 0x313F
@@ -106,6 +107,73 @@ const char *ngli_eglGetDisplayDriverName(struct glcontext *gl)
     return egl->GetDisplayDriverName(egl->display);
 }
 
+/*
+ * EGL displays are shared by the whole process and eglTerminate() invalidates
+ * them for every user, so their initialization is reference counted to allow
+ * several contexts (possibly living in different threads) at the same time.
+ */
+#define MAX_DISPLAYS 16
+
+static pthread_mutex_t display_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct {
+    EGLDisplay display;
+    int refcount;
+} display_refs[MAX_DISPLAYS];
+
+static EGLBoolean egl_initialize_display(EGLDisplay display, EGLint *major, EGLint *minor)
+{
+    pthread_mutex_lock(&display_lock);
+
+    int free_slot = -1;
+    for (int i = 0; i < MAX_DISPLAYS; i++) {
+        if (display_refs[i].display == display) {
+            /* Initializing an already initialized display only returns its version */
+            EGLBoolean ret = eglInitialize(display, major, minor);
+            if (ret)
+                display_refs[i].refcount++;
+            pthread_mutex_unlock(&display_lock);
+            return ret;
+        }
+        if (free_slot < 0 && !display_refs[i].display)
+            free_slot = i;
+    }
+
+    EGLBoolean ret = EGL_FALSE;
+    if (free_slot < 0) {
+        LOG(ERROR, "too many EGL displays in use");
+    } else {
+        ret = eglInitialize(display, major, minor);
+        if (ret) {
+            display_refs[free_slot].display = display;
+            display_refs[free_slot].refcount = 1;
+        }
+    }
+
+    pthread_mutex_unlock(&display_lock);
+    return ret;
+}
+
+static void egl_terminate_display(EGLDisplay display)
+{
+    pthread_mutex_lock(&display_lock);
+
+    for (int i = 0; i < MAX_DISPLAYS; i++) {
+        if (display_refs[i].display == display) {
+            if (!--display_refs[i].refcount) {
+                eglTerminate(display);
+                display_refs[i].display = NULL;
+            }
+            pthread_mutex_unlock(&display_lock);
+            return;
+        }
+    }
+
+    /* Display not initialized by us (external context) */
+    eglTerminate(display);
+
+    pthread_mutex_unlock(&display_lock);
+}
+
 static int egl_probe_extensions(struct glcontext *ctx)
 {
     struct egl_priv *egl = ctx->priv_data;
@@ -207,10 +275,10 @@ static int egl_probe_client_extensions(struct egl_priv *egl)
 static int egl_check_display(struct egl_priv *egl, EGLDisplay display)
 {
     EGLint major, minor;
-    EGLBoolean ret = eglInitialize(display, &major, &minor);
+    EGLBoolean ret = egl_initialize_display(display, &major, &minor);
     if (!ret)
         return NGL_ERROR_EXTERNAL;
-    eglTerminate(display);
+    egl_terminate_display(display);
     return 0;
 }
 
@@ -316,9 +384,10 @@ static int egl_init(struct glcontext *ctx, uintptr_t display, uintptr_t window,
 
     EGLint egl_minor;
     EGLint egl_major;
-    int ret = eglInitialize(egl->display, &egl_major, &egl_minor);
+    int ret = egl_initialize_display(egl->display, &egl_major, &egl_minor);
     if (!ret) {
         LOG(ERROR, "could not initialize EGL: 0x%x", eglGetError());
+        egl->display = EGL_NO_DISPLAY;
         return NGL_ERROR_EXTERNAL;
     }
 
@@ -510,7 +579,7 @@ static void egl_uninit(struct glcontext *ctx)
         eglDestroyContext(egl->display, egl->handle);
 
     if (egl->display)
-        eglTerminate(egl->display);
+        egl_terminate_display(egl->display);
 
 #if defined(TARGET_LINUX)
     if (ctx->platform == NGL_PLATFORM_XLIB) {
@@ -124,6 +124,9 @@ typedef void (NGLI_GL_APIENTRY *GLDEBUGPROC)(GLenum source, GLenum type, GLuint
 # define GL_SHADER_STORAGE_BUFFER_START        0x90D4
 # define GL_SHADER_STORAGE_BUFFER_SIZE         0x90D5
 # define GL_MAX_SHADER_STORAGE_BLOCK_SIZE      0x90DE
+# define GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS   0x90D6
+# define GL_MAX_FRAGMENT_SHADER_STORAGE_BLOCKS 0x90DA
+# define GL_MAX_COMPUTE_SHADER_STORAGE_BLOCKS  0x90DB
 # define GL_UNIFORM_BLOCK                      0x92E2
 # define GL_SHADER_STORAGE_BLOCK               0x92E6
 # define GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT 0x90DF
@@ -147,5 +150,7 @@ typedef void (NGLI_GL_APIENTRY *GLDEBUGPROC)(GLenum source, GLenum type, GLuint
 # define GL_ACTIVE_RESOURCES                   0x92F5
 # define GL_MAX_IMAGE_UNITS                    0x8F38
 # define GL_DYNAMIC_STORAGE_BIT                0x0100
+# define GL_MAP_PERSISTENT_BIT                 0x0040
+# define GL_MAP_COHERENT_BIT                   0x0080
 
 #endif /* GLINCLUDES_H */
@@ -47,7 +47,7 @@
 #include "gpu_capture.h"
 #endif
 
-static void capture_cpu(struct gpu_ctx *s)
+static int capture_cpu(struct gpu_ctx *s, double t)
 {
     struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
     struct glcontext *gl = s_priv->glcontext;
@@ -57,14 +57,95 @@ static void capture_cpu(struct gpu_ctx *s)
 
     ngli_glBindFramebuffer(gl, GL_FRAMEBUFFER, rt_gl->id);
     ngli_glReadPixels(gl, 0, 0, rt->width, rt->height, GL_RGBA, GL_UNSIGNED_BYTE, config->capture_buffer);
+    return 0;
 }
 
-static void capture_corevideo(struct gpu_ctx *s)
+static int gl_wait_captures(struct gpu_ctx *s, size_t max_pending)
+{
+    struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
+    struct glcontext *gl = s_priv->glcontext;
+    const struct ngl_config *config = &s->config;
+    const struct rendertarget *rt = s_priv->capture_rt;
+
+    if (!rt || s_priv->nb_pending_captures <= max_pending)
+        return 0;
+
+    int ret = 0;
+    while (s_priv->nb_pending_captures > max_pending) {
+        struct capture_pbo *pbo = &s_priv->capture_pbos[s_priv->capture_pbo_index];
+        const size_t size = rt->width * rt->height * 4;
+
+        GLenum status;
+        do {
+            status = ngli_glClientWaitSync(gl, pbo->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        } while (status == GL_TIMEOUT_EXPIRED);
+        ngli_glDeleteSync(gl, pbo->fence);
+        pbo->fence = NULL;
+
+        s_priv->capture_pbo_index = (s_priv->capture_pbo_index + 1) % NGLI_ARRAY_NB(s_priv->capture_pbos);
+        s_priv->nb_pending_captures--;
+
+        /* The content of the pixel pack buffer is undefined, drop the capture */
+        if (status == GL_WAIT_FAILED) {
+            LOG(ERROR, "could not wait for capture fence");
+            return NGL_ERROR_GRAPHICS_GENERIC;
+        }
+
+        ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, pbo->id);
+        const void *data = ngli_glMapBufferRange(gl, GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+        if (data) {
+            if (config->on_frame)
+                config->on_frame(config->on_frame_opaque, data, rt->width * 4, pbo->t);
+            else
+                memcpy(pbo->dst, data, size);
+            ngli_glUnmapBuffer(gl, GL_PIXEL_PACK_BUFFER);
+        } else {
+            LOG(ERROR, "could not map capture buffer");
+            ret = NGL_ERROR_GRAPHICS_GENERIC;
+        }
+        ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    return ret;
+}
+
+static int capture_cpu_async(struct gpu_ctx *s, double t)
+{
+    struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
+    struct glcontext *gl = s_priv->glcontext;
+    struct ngl_config *config = &s->config;
+    struct rendertarget *rt = s_priv->capture_rt;
+    struct rendertarget_gl *rt_gl = (struct rendertarget_gl *)rt;
+
+    /* Make room for the new capture if the ring is full */
+    const size_t nb_pbos = NGLI_ARRAY_NB(s_priv->capture_pbos);
+    int ret = gl_wait_captures(s, nb_pbos - 1);
+    if (ret < 0)
+        return ret;
+
+    const size_t index = (s_priv->capture_pbo_index + s_priv->nb_pending_captures) % nb_pbos;
+    struct capture_pbo *pbo = &s_priv->capture_pbos[index];
+
+    ngli_glBindFramebuffer(gl, GL_FRAMEBUFFER, rt_gl->id);
+    ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, pbo->id);
+    ngli_glReadPixels(gl, 0, 0, rt->width, rt->height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, 0);
+
+    pbo->fence = ngli_glFenceSync(gl, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pbo->dst = config->capture_buffer;
+    pbo->t = t;
+    s_priv->nb_pending_captures++;
+
+    return 0;
+}
+
+static int capture_corevideo(struct gpu_ctx *s, double t)
 {
     struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
     struct glcontext *gl = s_priv->glcontext;
 
     ngli_glFinish(gl);
+    return 0;
 }
 
 #if defined(TARGET_IPHONE)
@@ -194,8 +275,8 @@ static int create_rendertarget(struct gpu_ctx *s,
         return NGL_ERROR_MEMORY;
 
     const struct rendertarget_params params = {
-        .width = config->width,
-        .height = config->height,
+        .width = color ? color->params.width : config->width,
+        .height = color ? color->params.height : config->height,
         .nb_colors = 1,
         .colors[0] = {
             .attachment     = color,
@@ -258,9 +339,37 @@ static int offscreen_rendertarget_init(struct gpu_ctx *s)
         return NGL_ERROR_UNSUPPORTED;
 #endif
     } else if (config->capture_buffer_type == NGL_CAPTURE_BUFFER_TYPE_CPU) {
-        int ret = create_texture(s, NGLI_FORMAT_R8G8B8A8_UNORM, 0, COLOR_USAGE, &s_priv->capture_texture);
+        /* The YUV capture formats are converted into a packed RGBA texture */
+        int32_t capture_width, capture_height;
+        ngli_gpu_ctx_get_capture_dimensions(s, &capture_width, &capture_height);
+
+        s_priv->capture_texture = ngli_texture_create(s);
+        if (!s_priv->capture_texture)
+            return NGL_ERROR_MEMORY;
+
+        const struct texture_params params = {
+            .type    = NGLI_TEXTURE_TYPE_2D,
+            .format  = NGLI_FORMAT_R8G8B8A8_UNORM,
+            .width   = capture_width,
+            .height  = capture_height,
+            .usage   = COLOR_USAGE,
+        };
+
+        int ret = ngli_texture_init(s_priv->capture_texture, &params);
         if (ret < 0)
             return ret;
+
+        if (config->capture_async || config->on_frame) {
+            struct glcontext *gl = s_priv->glcontext;
+            const GLsizeiptr size = capture_width * capture_height * 4;
+            for (size_t i = 0; i < NGLI_ARRAY_NB(s_priv->capture_pbos); i++) {
+                struct capture_pbo *pbo = &s_priv->capture_pbos[i];
+                ngli_glGenBuffers(gl, 1, &pbo->id);
+                ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, pbo->id);
+                ngli_glBufferData(gl, GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+            }
+            ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, 0);
+        }
     } else {
         LOG(ERROR, "unsupported capture buffer type: %d", config->capture_buffer_type);
         return NGL_ERROR_UNSUPPORTED;
@@ -271,7 +380,10 @@ static int offscreen_rendertarget_init(struct gpu_ctx *s)
     if (ret < 0)
         return ret;
 
-    ret = create_texture(s, NGLI_FORMAT_R8G8B8A8_UNORM, 0, COLOR_USAGE, &s_priv->color);
+    /* The YUV capture conversion samples the resolved color texture */
+    const int color_usage = config->capture_format != NGL_CAPTURE_FORMAT_RGBA
+                          ? COLOR_USAGE | NGLI_TEXTURE_USAGE_SAMPLED_BIT : COLOR_USAGE;
+    ret = create_texture(s, NGLI_FORMAT_R8G8B8A8_UNORM, 0, color_usage, &s_priv->color);
     if (ret < 0)
         return ret;
 
@@ -300,6 +412,10 @@ static int offscreen_rendertarget_init(struct gpu_ctx *s)
         [NGL_CAPTURE_BUFFER_TYPE_COREVIDEO] = capture_corevideo,
     };
     s_priv->capture_func = capture_func_map[config->capture_buffer_type];
+    /* The frame sink always reads back through the pixel pack buffers so the
+     * frames can be handed out directly from the mapped memory */
+    if (config->capture_async || config->on_frame)
+        s_priv->capture_func = capture_cpu_async;
 
     return 0;
 }
@@ -327,6 +443,18 @@ static void rendertarget_reset(struct gpu_ctx *s)
     ngli_texture_freep(&s_priv->ms_color);
     ngli_texture_freep(&s_priv->depth_stencil);
 
+    struct glcontext *gl = s_priv->glcontext;
+    for (size_t i = 0; i < NGLI_ARRAY_NB(s_priv->capture_pbos); i++) {
+        struct capture_pbo *pbo = &s_priv->capture_pbos[i];
+        if (pbo->fence)
+            ngli_glDeleteSync(gl, pbo->fence);
+        if (pbo->id)
+            ngli_glDeleteBuffers(gl, 1, &pbo->id);
+        memset(pbo, 0, sizeof(*pbo));
+    }
+    s_priv->capture_pbo_index = 0;
+    s_priv->nb_pending_captures = 0;
+
     ngli_rendertarget_freep(&s_priv->capture_rt);
     ngli_texture_freep(&s_priv->capture_texture);
 #if defined(TARGET_IPHONE)
@@ -413,6 +541,7 @@ static const struct {
     {NGLI_FEATURE_SOFTWARE,                     NGLI_FEATURE_GL_SOFTWARE},
     {NGLI_FEATURE_IMAGE_LOAD_STORE,             NGLI_FEATURE_GL_SHADER_IMAGE_LOAD_STORE | NGLI_FEATURE_GL_SHADER_IMAGE_SIZE},
     {NGLI_FEATURE_STORAGE_BUFFER,               NGLI_FEATURE_GL_SHADER_STORAGE_BUFFER_OBJECT},
+    {NGLI_FEATURE_BUFFER_MAP_PERSISTENT,        NGLI_FEATURE_GL_BUFFER_STORAGE},
     {NGLI_FEATURE_DEPTH_STENCIL_RESOLVE,        0},
 };
 
@@ -432,6 +561,40 @@ static void gpu_ctx_info_init(struct gpu_ctx *s)
     s->limits = gl->limits;
 }
 
+static int diskcache_init(struct gpu_ctx *s)
+{
+    const struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
+    const struct glcontext *gl = s_priv->glcontext;
+
+    /* Only the program binaries are cached with this backend */
+    if (!(gl->features & NGLI_FEATURE_GL_GET_PROGRAM_BINARY))
+        return 0;
+
+    GLint nb_formats = 0;
+    ngli_glGetIntegerv(gl, GL_NUM_PROGRAM_BINARY_FORMATS, &nb_formats);
+    if (nb_formats <= 0)
+        return 0;
+
+    /*
+     * Program binaries are only valid for the driver that produced them, so
+     * the cache entries are bound to the driver vendor, renderer and version
+     */
+    const char *vendor   = (const char *)ngli_glGetString(gl, GL_VENDOR);
+    const char *renderer = (const char *)ngli_glGetString(gl, GL_RENDERER);
+    const char *version  = (const char *)ngli_glGetString(gl, GL_VERSION);
+    char *identity = ngli_asprintf("%s|%s|%s|%s",
+                                   gl->backend == NGL_BACKEND_OPENGLES ? "gles" : "gl",
+                                   vendor ? vendor : "",
+                                   renderer ? renderer : "",
+                                   version ? version : "");
+    if (!identity)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngli_gpu_ctx_init_diskcache(s, identity);
+    ngli_free(identity);
+    return ret;
+}
+
 static int gl_init(struct gpu_ctx *s)
 {
     int ret;
@@ -450,17 +613,33 @@ static int gl_init(struct gpu_ctx *s)
             LOG(ERROR, "capture_buffer is not supported by external context");
             return NGL_ERROR_INVALID_ARG;
         }
+        if (config->on_frame) {
+            LOG(ERROR, "on_frame is not supported by external context");
+            return NGL_ERROR_INVALID_ARG;
+        }
     } else if (config->offscreen) {
         if (config->width <= 0 || config->height <= 0) {
             LOG(ERROR, "could not create offscreen context with invalid dimensions (%dx%d)",
                 config->width, config->height);
             return NGL_ERROR_INVALID_ARG;
         }
+        if (config->capture_async && config->capture_buffer_type != NGL_CAPTURE_BUFFER_TYPE_CPU) {
+            LOG(ERROR, "asynchronous capture is only supported with CPU capture buffers");
+            return NGL_ERROR_INVALID_ARG;
+        }
+        if (config->on_frame && config->capture_buffer_type != NGL_CAPTURE_BUFFER_TYPE_CPU) {
+            LOG(ERROR, "on_frame is only supported with CPU capture buffers");
+            return NGL_ERROR_INVALID_ARG;
+        }
     } else {
         if (config->capture_buffer) {
             LOG(ERROR, "capture_buffer is not supported by onscreen context");
             return NGL_ERROR_INVALID_ARG;
         }
+        if (config->on_frame) {
+            LOG(ERROR, "on_frame is not supported by onscreen context");
+            return NGL_ERROR_INVALID_ARG;
+        }
     }
 
 #if DEBUG_GPU_CAPTURE
@@ -507,8 +686,20 @@ static int gl_init(struct gpu_ctx *s)
     }
 #endif
 
+    /*
+     * Let the driver compile the shaders on as many threads as it wants: the
+     * program stages are all submitted before their status is queried (see
+     * ngli_program_gl_init())
+     */
+    if (!external && (gl->features & NGLI_FEATURE_GL_KHR_PARALLEL_SHADER_COMPILE))
+        ngli_glMaxShaderCompilerThreadsKHR(gl, 0xFFFFFFFF);
+
     gpu_ctx_info_init(s);
 
+    ret = diskcache_init(s);
+    if (ret < 0)
+        return ret;
+
 #if DEBUG_GPU_CAPTURE
     if (s->gpu_capture)
         ngli_gpu_capture_begin(s->gpu_capture_ctx);
@@ -768,8 +959,50 @@ int ngli_gpu_ctx_gl_wrap_framebuffer(struct gpu_ctx *s, GLuint fbo)
     return 0;
 }
 
+static void frame_fences_reset(struct gpu_ctx *s)
+{
+    struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
+    struct glcontext *gl = s_priv->glcontext;
+    for (size_t i = 0; i < NGLI_ARRAY_NB(s_priv->frame_fences); i++) {
+        if (s_priv->frame_fences[i])
+            ngli_glDeleteSync(gl, s_priv->frame_fences[i]);
+        s_priv->frame_fences[i] = NULL;
+    }
+}
+
 static int gl_begin_update(struct gpu_ctx *s, double t)
 {
+    struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
+    struct glcontext *gl = s_priv->glcontext;
+
+    if (!(s->features & NGLI_FEATURE_BUFFER_MAP_PERSISTENT))
+        return 0;
+
+    /*
+     * The uniform ring is persistently mapped: the region about to be
+     * written must not be in use anymore by the commands of the frame which
+     * wrote it NGL_MAX_FRAMES_IN_FLIGHT frames ago
+     */
+    GLsync *fences = s_priv->frame_fences;
+    fences[s_priv->frame_fence_index] = ngli_glFenceSync(gl, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    s_priv->frame_fence_index = (s_priv->frame_fence_index + 1) % NGLI_ARRAY_NB(s_priv->frame_fences);
+
+    GLsync fence = fences[s_priv->frame_fence_index];
+    if (!fence)
+        return 0;
+
+    GLenum status;
+    do {
+        status = ngli_glClientWaitSync(gl, fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    } while (status == GL_TIMEOUT_EXPIRED);
+    ngli_glDeleteSync(gl, fence);
+    fences[s_priv->frame_fence_index] = NULL;
+
+    if (status == GL_WAIT_FAILED) {
+        LOG(ERROR, "could not wait for frame fence");
+        return NGL_ERROR_GRAPHICS_GENERIC;
+    }
+
     return 0;
 }
 
@@ -821,9 +1054,13 @@ static int gl_end_draw(struct gpu_ctx *s, double t)
     const struct ngl_config *config = &s->config;
     const struct ngl_config_gl *config_gl = config->backend_config;
 
-    if (s_priv->capture_func && config->capture_buffer) {
-        blit_vflip(s, s_priv->default_rt, s_priv->capture_rt);
-        s_priv->capture_func(s);
+    if (s_priv->capture_func && (config->capture_buffer || config->on_frame)) {
+        /* The YUV capture formats are already converted into the capture rendertarget */
+        if (config->capture_format == NGL_CAPTURE_FORMAT_RGBA)
+            blit_vflip(s, s_priv->default_rt, s_priv->capture_rt);
+        int ret = s_priv->capture_func(s, t);
+        if (ret < 0)
+            return ret;
     }
 
     int ret = ngli_glcontext_check_gl_error(gl, __func__);
@@ -872,6 +1109,7 @@ static void gl_wait_idle(struct gpu_ctx *s)
     struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
     struct glcontext *gl = s_priv->glcontext;
     ngli_glFinish(gl);
+    frame_fences_reset(s);
 }
 
 static void gl_destroy(struct gpu_ctx *s)
@@ -879,6 +1117,7 @@ static void gl_destroy(struct gpu_ctx *s)
     struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
     timer_reset(s);
     rendertarget_reset(s);
+    frame_fences_reset(s);
 #if DEBUG_GPU_CAPTURE
     if (s->gpu_capture)
         ngli_gpu_capture_end(s->gpu_capture_ctx);
@@ -921,6 +1160,15 @@ static struct rendertarget *gl_get_default_rendertarget(struct gpu_ctx *s, int l
     }
 }
 
+static struct rendertarget *gl_get_capture_rendertarget(struct gpu_ctx *s)
+{
+    struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
+    const struct ngl_config *config = &s->config;
+    if (config->capture_format == NGL_CAPTURE_FORMAT_RGBA)
+        return NULL;
+    return s_priv->capture_rt;
+}
+
 static const struct rendertarget_layout *gl_get_default_rendertarget_layout(struct gpu_ctx *s)
 {
     struct gpu_ctx_gl *s_priv = (struct gpu_ctx_gl *)s;
@@ -1005,6 +1253,7 @@ const struct gpu_ctx_class ngli_gpu_ctx_##cls_suffix = {
     .end_update                         = gl_end_update,                         \
     .begin_draw                         = gl_begin_draw,                         \
     .end_draw                           = gl_end_draw,                           \
+    .wait_captures                      = gl_wait_captures,                      \
     .query_draw_time                    = gl_query_draw_time,                    \
     .wait_idle                          = gl_wait_idle,                          \
     .destroy                            = gl_destroy,                            \
@@ -1015,6 +1264,7 @@ const struct gpu_ctx_class ngli_gpu_ctx_##cls_suffix = {
                                                                                  \
     .get_default_rendertarget           = gl_get_default_rendertarget,           \
     .get_default_rendertarget_layout    = gl_get_default_rendertarget_layout,    \
+    .get_capture_rendertarget           = gl_get_capture_rendertarget,           \
                                                                                  \
     .begin_render_pass                  = gl_begin_render_pass,                  \
     .end_render_pass                    = gl_end_render_pass,                    \
@@ -37,7 +37,14 @@
 struct ngl_ctx;
 struct rendertarget;
 
-typedef void (*capture_func_type)(struct gpu_ctx *s);
+typedef int (*capture_func_type)(struct gpu_ctx *s, double t);
+
+struct capture_pbo {
+    GLuint id;
+    GLsync fence;
+    void *dst;
+    double t;
+};
 
 struct gpu_ctx_gl {
     struct gpu_ctx parent;
@@ -61,6 +68,14 @@ struct gpu_ctx_gl {
     CVPixelBufferRef capture_cvbuffer;
     CVOpenGLESTextureRef capture_cvtexture;
 #endif
+    /* Asynchronous capture ring of pixel pack buffers */
+    struct capture_pbo capture_pbos[NGL_MAX_FRAMES_IN_FLIGHT];
+    size_t capture_pbo_index;
+    size_t nb_pending_captures;
+    /* Completion fences of the frames writing to the persistently mapped
+     * uniform ring regions */
+    GLsync frame_fences[NGL_MAX_FRAMES_IN_FLIGHT];
+    size_t frame_fence_index;
     /* Timer */
     GLuint queries[2];
     void (*glGenQueries)(const struct glcontext *gl, GLsizei n, GLuint * ids);
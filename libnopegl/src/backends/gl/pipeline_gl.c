@@ -197,7 +197,8 @@ void ngli_pipeline_gl_draw(struct pipeline *s, int nb_vertices, int nb_instances
     set_graphics_state(s);
     ngli_glstate_use_program(gl, glstate, program_gl->id);
 
-    bind_vertex_attribs(s, gl);
+    if (gpu_ctx->dirty_state & (NGLI_GPU_STATE_PIPELINE | NGLI_GPU_STATE_VERTEX_BUFFERS))
+        bind_vertex_attribs(s, gl);
 
     const GLbitfield barriers = ngli_bindgroup_gl_get_memory_barriers(gpu_ctx->bindgroup);
     if (barriers)
@@ -225,11 +226,18 @@ void ngli_pipeline_gl_draw_indexed(struct pipeline *s, int nb_indices, int nb_in
     set_graphics_state(s);
     ngli_glstate_use_program(gl, glstate, program_gl->id);
 
-    bind_vertex_attribs(s, gl);
+    /*
+     * The vertex attributes and the element array buffer are part of the VAO
+     * state: they only need to be set again if the VAO or its buffers changed
+     */
+    const uint32_t vao_state = NGLI_GPU_STATE_PIPELINE | NGLI_GPU_STATE_VERTEX_BUFFERS;
+    if (gpu_ctx->dirty_state & vao_state)
+        bind_vertex_attribs(s, gl);
 
     const struct buffer_gl *indices_gl = (const struct buffer_gl *)gpu_ctx->index_buffer;
     const GLenum gl_indices_type = get_gl_indices_type(gpu_ctx->index_format);
-    ngli_glBindBuffer(gl, GL_ELEMENT_ARRAY_BUFFER, indices_gl->id);
+    if (gpu_ctx->dirty_state & (vao_state | NGLI_GPU_STATE_INDEX_BUFFER))
+        ngli_glBindBuffer(gl, GL_ELEMENT_ARRAY_BUFFER, indices_gl->id);
 
     const GLbitfield barriers = ngli_bindgroup_gl_get_memory_barriers(gpu_ctx->bindgroup);
     if (barriers)
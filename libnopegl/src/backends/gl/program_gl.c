@@ -24,6 +24,7 @@
 #include <string.h>
 
 #include "bstr.h"
+#include "diskcache.h"
 #include "gpu_ctx_gl.h"
 #include "glincludes.h"
 #include "log.h"
@@ -242,6 +243,94 @@ static struct hmap *program_probe_buffer_blocks(struct glcontext *gl, GLuint pid
     return bmap;
 }
 
+/*
+ * Program binaries cannot be relinked, so they are only used when the vertex
+ * attribute locations are explicit in the shaders and thus never rebound after
+ * the link (see ngli_program_gl_set_locations_and_bindings())
+ */
+static int use_program_binary(const struct gpu_ctx *gpu_ctx, const struct glcontext *gl)
+{
+    if (!gpu_ctx->diskcache)
+        return 0;
+    if (gl->backend == NGL_BACKEND_OPENGLES)
+        return gl->glsl_version >= 310;
+    return gl->glsl_version >= 410;
+}
+
+static struct bstr *get_program_binary_key(const struct program_params *params)
+{
+    const char *srcs[] = {params->vertex, params->fragment, params->compute};
+
+    struct bstr *key = ngli_bstr_create();
+    if (!key)
+        return NULL;
+
+    for (size_t i = 0; i < NGLI_ARRAY_NB(srcs); i++) {
+        const char *src = srcs[i] ? srcs[i] : "";
+        ngli_bstr_printf(key, "%zu:%zu:", i, strlen(src));
+        ngli_bstr_print(key, src);
+    }
+
+    return key;
+}
+
+static int load_program_binary(struct program *s, const struct bstr *key)
+{
+    struct program_gl *s_priv = (struct program_gl *)s;
+    struct gpu_ctx *gpu_ctx = s->gpu_ctx;
+    struct gpu_ctx_gl *gpu_ctx_gl = (struct gpu_ctx_gl *)gpu_ctx;
+    struct glcontext *gl = gpu_ctx_gl->glcontext;
+
+    void *data;
+    size_t size;
+    int ret = ngli_diskcache_load(gpu_ctx->diskcache, "program",
+                                  ngli_bstr_strptr(key), ngli_bstr_len(key), &data, &size);
+    if (ret < 0)
+        return ret;
+
+    if (size <= sizeof(GLenum) || size - sizeof(GLenum) > INT32_MAX) {
+        ngli_free(data);
+        return NGL_ERROR_INVALID_DATA;
+    }
+
+    GLenum format;
+    memcpy(&format, data, sizeof(format));
+    const uint8_t *binary = (const uint8_t *)data + sizeof(format);
+    ngli_glProgramBinary(gl, s_priv->id, format, binary, (GLsizei)(size - sizeof(format)));
+    ngli_free(data);
+
+    /* The driver may reject the binary, in which case the program is rebuilt */
+    GLint status = GL_FALSE;
+    ngli_glGetProgramiv(gl, s_priv->id, GL_LINK_STATUS, &status);
+    return status == GL_TRUE ? 0 : NGL_ERROR_INVALID_DATA;
+}
+
+static void store_program_binary(struct program *s, const struct bstr *key)
+{
+    struct program_gl *s_priv = (struct program_gl *)s;
+    struct gpu_ctx *gpu_ctx = s->gpu_ctx;
+    struct gpu_ctx_gl *gpu_ctx_gl = (struct gpu_ctx_gl *)gpu_ctx;
+    struct glcontext *gl = gpu_ctx_gl->glcontext;
+
+    GLint length = 0;
+    ngli_glGetProgramiv(gl, s_priv->id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    uint8_t *data = ngli_malloc(sizeof(GLenum) + length);
+    if (!data)
+        return;
+
+    GLenum format = 0;
+    GLsizei written = 0;
+    ngli_glGetProgramBinary(gl, s_priv->id, length, &written, &format, data + sizeof(format));
+    memcpy(data, &format, sizeof(format));
+    if (written > 0)
+        ngli_diskcache_store(gpu_ctx->diskcache, "program", ngli_bstr_strptr(key), ngli_bstr_len(key),
+                             data, sizeof(format) + written);
+    ngli_free(data);
+}
+
 struct program *ngli_program_gl_create(struct gpu_ctx *gpu_ctx)
 {
     struct program_gl *s = ngli_calloc(1, sizeof(*s));
@@ -256,6 +345,7 @@ int ngli_program_gl_init(struct program *s, const struct program_params *params)
     struct program_gl *s_priv = (struct program_gl *)s;
 
     int ret = 0;
+    struct bstr *key = NULL;
     struct {
         const char *name;
         GLenum type;
@@ -278,6 +368,22 @@ int ngli_program_gl_init(struct program *s, const struct program_params *params)
 
     s_priv->id = ngli_glCreateProgram(gl);
 
+    if (use_program_binary(s->gpu_ctx, gl)) {
+        key = get_program_binary_key(params);
+        if (!key)
+            return NGL_ERROR_MEMORY;
+        if (load_program_binary(s, key) >= 0) {
+            LOG(DEBUG, "loaded program \"%s\" from cache", params->label ? params->label : "");
+            goto probe;
+        }
+        ngli_glProgramParameteri(gl, s_priv->id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    /*
+     * All the stages are submitted before querying any compile status so that
+     * drivers compiling asynchronously (GL_KHR_parallel_shader_compile or
+     * internal threading) can process them concurrently
+     */
     for (size_t i = 0; i < NGLI_ARRAY_NB(shaders); i++) {
         if (!shaders[i].src)
             continue;
@@ -285,6 +391,12 @@ int ngli_program_gl_init(struct program *s, const struct program_params *params)
         shaders[i].id = shader;
         ngli_glShaderSource(gl, shader, 1, &shaders[i].src, NULL);
         ngli_glCompileShader(gl, shader);
+    }
+
+    for (size_t i = 0; i < NGLI_ARRAY_NB(shaders); i++) {
+        if (!shaders[i].src)
+            continue;
+        const GLuint shader = shaders[i].id;
         ret = program_check_status(gl, shader, GL_COMPILE_STATUS);
         if (ret < 0) {
             char *s_with_numbers = ngli_numbered_lines(shaders[i].src);
@@ -323,6 +435,10 @@ int ngli_program_gl_init(struct program *s, const struct program_params *params)
     for (size_t i = 0; i < NGLI_ARRAY_NB(shaders); i++)
         ngli_glDeleteShader(gl, shaders[i].id);
 
+    if (key)
+        store_program_binary(s, key);
+
+probe:
     s->uniforms = program_probe_uniforms(gl, s_priv->id);
     s->attributes = program_probe_attributes(gl, s_priv->id);
     s->buffer_blocks = program_probe_buffer_blocks(gl, s_priv->id);
@@ -331,11 +447,13 @@ int ngli_program_gl_init(struct program *s, const struct program_params *params)
         goto fail;
     }
 
+    ngli_bstr_freep(&key);
     return 0;
 
 fail:
     for (size_t i = 0; i < NGLI_ARRAY_NB(shaders); i++)
         ngli_glDeleteShader(gl, shaders[i].id);
+    ngli_bstr_freep(&key);
 
     return ret;
 }
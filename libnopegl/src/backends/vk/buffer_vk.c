@@ -28,6 +28,7 @@
 #include "log.h"
 #include "memory.h"
 #include "vkcontext.h"
+#include "vkmemory.h"
 #include "vkutils.h"
 
 static VkResult create_vk_buffer(struct vkcontext *vk,
@@ -35,10 +36,10 @@ static VkResult create_vk_buffer(struct vkcontext *vk,
                                  VkBufferUsageFlags usage,
                                  VkMemoryPropertyFlags mem_props,
                                  VkBuffer *bufferp,
-                                 VkDeviceMemory *memoryp)
+                                 struct vkmemory_alloc *allocp)
 {
     VkBuffer buffer = VK_NULL_HANDLE;
-    VkDeviceMemory memory = VK_NULL_HANDLE;
+    struct vkmemory_alloc alloc = {0};
 
     const VkBufferCreateInfo buffer_create_info = {
         .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -50,41 +51,53 @@ static VkResult create_vk_buffer(struct vkcontext *vk,
     if (res != VK_SUCCESS)
         goto fail;
 
-    VkMemoryRequirements mem_reqs;
-    vkGetBufferMemoryRequirements(vk->device, buffer, &mem_reqs);
+    VkMemoryDedicatedRequirements mem_ded_reqs = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS,
+    };
+    VkMemoryRequirements2 mem_reqs = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = &mem_ded_reqs,
+    };
+    const VkBufferMemoryRequirementsInfo2 mem_reqs_info = {
+        .sType  = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2,
+        .buffer = buffer,
+    };
+    vkGetBufferMemoryRequirements2(vk->device, &mem_reqs_info, &mem_reqs);
+    const uint32_t mem_type_bits = mem_reqs.memoryRequirements.memoryTypeBits;
 
-    int mem_type_index = ngli_vkcontext_find_memory_type(vk, mem_reqs.memoryTypeBits, mem_props);
+    int mem_type_index = ngli_vkcontext_find_memory_type(vk, mem_type_bits, mem_props);
     if (mem_type_index < 0) {
         /* Cached memory might not be supported, falling back on uncached memory */
         mem_props &= ~VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
-        mem_type_index = ngli_vkcontext_find_memory_type(vk, mem_reqs.memoryTypeBits, mem_props);
+        mem_type_index = ngli_vkcontext_find_memory_type(vk, mem_type_bits, mem_props);
         if (mem_type_index < 0) {
             res = VK_ERROR_FORMAT_NOT_SUPPORTED;
             goto fail;
         }
     }
 
-    const VkMemoryAllocateInfo memory_allocate_info = {
-        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize  = mem_reqs.size,
-        .memoryTypeIndex = mem_type_index,
+    const VkMemoryDedicatedAllocateInfo mem_ded_info = {
+        .sType  = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
+        .buffer = buffer,
     };
-    res = vkAllocateMemory(vk->device, &memory_allocate_info, NULL, &memory);
+    const int dedicated = mem_ded_reqs.prefersDedicatedAllocation || mem_ded_reqs.requiresDedicatedAllocation;
+    res = ngli_vkmemory_alloc(vk, &mem_reqs.memoryRequirements, dedicated ? &mem_ded_info : NULL,
+                              (uint32_t)mem_type_index, NGLI_VKMEMORY_RESOURCE_LINEAR, &alloc);
     if (res != VK_SUCCESS)
         goto fail;
 
-    res = vkBindBufferMemory(vk->device, buffer, memory, 0);
+    res = vkBindBufferMemory(vk->device, buffer, alloc.memory, alloc.offset);
     if (res != VK_SUCCESS)
         goto fail;
 
     *bufferp = buffer;
-    *memoryp = memory;
+    *allocp = alloc;
 
     return VK_SUCCESS;
 
 fail:
     vkDestroyBuffer(vk->device, buffer, NULL);
-    vkFreeMemory(vk->device, memory, NULL);
+    ngli_vkmemory_free(vk, &alloc);
     return res;
 }
 
@@ -127,7 +140,7 @@ static VkResult buffer_vk_init(struct buffer *s)
     }
 
     const VkBufferUsageFlags flags = get_vk_buffer_usage_flags(s->usage);
-    return create_vk_buffer(vk, s->size, flags, mem_props, &s_priv->buffer, &s_priv->memory);
+    return create_vk_buffer(vk, s->size, flags, mem_props, &s_priv->buffer, &s_priv->alloc);
 }
 
 int ngli_buffer_vk_init(struct buffer *s)
@@ -147,12 +160,10 @@ static VkResult buffer_vk_upload(struct buffer *s, const void *data, size_t offs
     if (s->usage & NGLI_BUFFER_USAGE_MAP_READ ||
         s->usage & NGLI_BUFFER_USAGE_MAP_WRITE ||
         s->usage & NGLI_BUFFER_USAGE_DYNAMIC_BIT) {
-        void *mapped_data;
-        VkResult res = vkMapMemory(vk->device, s_priv->memory, offset, size, 0, &mapped_data);
+        VkResult res = ngli_gpu_ctx_vk_sync_host_writes(s->gpu_ctx);
         if (res != VK_SUCCESS)
             return res;
-        memcpy(mapped_data, data, size);
-        vkUnmapMemory(vk->device, s_priv->memory);
+        memcpy((uint8_t *)s_priv->alloc.mapped + offset, data, size);
         return VK_SUCCESS;
     }
 
@@ -160,16 +171,12 @@ static VkResult buffer_vk_upload(struct buffer *s, const void *data, size_t offs
     const VkMemoryPropertyFlags mem_props = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                                             VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
     VkResult res = create_vk_buffer(vk, s->size, usage, mem_props,
-                                    &s_priv->staging_buffer, &s_priv->staging_memory);
+                                    &s_priv->staging_buffer, &s_priv->staging_alloc);
     if (res != VK_SUCCESS)
         return res;
 
-    uint8_t *mapped_data;
-    res = vkMapMemory(vk->device, s_priv->staging_memory, 0, s->size, 0, (void *)&mapped_data);
-    if (res != VK_SUCCESS)
-        return res;
+    uint8_t *mapped_data = s_priv->staging_alloc.mapped;
     memcpy(mapped_data + offset, data, size);
-    vkUnmapMemory(vk->device, s_priv->staging_memory);
 
     struct cmd_vk *cmd_vk;
     res = ngli_cmd_vk_begin_transient(s->gpu_ctx, 0, &cmd_vk);
@@ -189,8 +196,7 @@ static VkResult buffer_vk_upload(struct buffer *s, const void *data, size_t offs
 
     vkDestroyBuffer(vk->device, s_priv->staging_buffer, NULL);
     s_priv->staging_buffer = VK_NULL_HANDLE;
-    vkFreeMemory(vk->device, s_priv->staging_memory, NULL);
-    s_priv->staging_memory = VK_NULL_HANDLE;
+    ngli_vkmemory_free(vk, &s_priv->staging_alloc);
 
     return VK_SUCCESS;
 }
@@ -203,30 +209,21 @@ int ngli_buffer_vk_upload(struct buffer *s, const void *data, size_t offset, siz
     return ngli_vk_res2ret(res);
 }
 
-static VkResult buffer_vk_map(struct buffer *s, size_t offset, size_t size, void **data)
+int ngli_buffer_vk_map(struct buffer *s, size_t offset, size_t size, void **data)
 {
-    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
-    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
     struct buffer_vk *s_priv = (struct buffer_vk *)s;
 
-    return vkMapMemory(vk->device, s_priv->memory, offset, size, 0, data);
-}
-
-int ngli_buffer_vk_map(struct buffer *s, size_t offset, size_t size, void **data)
-{
-    VkResult res = buffer_vk_map(s, offset, size, data);
-    if (res != VK_SUCCESS)
-        LOG(ERROR, "unable to map buffer: %s", ngli_vk_res2str(res));
-    return ngli_vk_res2ret(res);
+    /* Host visible memory is persistently mapped by the memory allocator */
+    if (!s_priv->alloc.mapped) {
+        LOG(ERROR, "unable to map buffer: memory is not host visible");
+        return NGL_ERROR_GRAPHICS_UNSUPPORTED;
+    }
+    *data = (uint8_t *)s_priv->alloc.mapped + offset;
+    return 0;
 }
 
 void ngli_buffer_vk_unmap(struct buffer *s)
 {
-    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
-    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
-    struct buffer_vk *s_priv = (struct buffer_vk *)s;
-
-    vkUnmapMemory(vk->device, s_priv->memory);
 }
 
 void ngli_buffer_vk_freep(struct buffer **sp)
@@ -240,8 +237,8 @@ void ngli_buffer_vk_freep(struct buffer **sp)
     struct buffer_vk *s_priv = (struct buffer_vk *)s;
 
     vkDestroyBuffer(vk->device, s_priv->buffer, NULL);
-    vkFreeMemory(vk->device, s_priv->memory, NULL);
+    ngli_vkmemory_free(vk, &s_priv->alloc);
     vkDestroyBuffer(vk->device, s_priv->staging_buffer, NULL);
-    vkFreeMemory(vk->device, s_priv->staging_memory, NULL);
+    ngli_vkmemory_free(vk, &s_priv->staging_alloc);
     ngli_freep(sp);
 }
@@ -25,13 +25,14 @@
 #include <vulkan/vulkan.h>
 
 #include "buffer.h"
+#include "vkmemory.h"
 
 struct buffer_vk {
     struct buffer parent;
     VkBuffer buffer;
-    VkDeviceMemory memory;
+    struct vkmemory_alloc alloc;
     VkBuffer staging_buffer;
-    VkDeviceMemory staging_memory;
+    struct vkmemory_alloc staging_alloc;
 };
 
 struct buffer *ngli_buffer_vk_create(struct gpu_ctx *gpu_ctx);
@@ -23,15 +23,18 @@
 
 #include <string.h>
 #include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
 
 #include <vulkan/vulkan.h>
 
+#include "diskcache.h"
 #include "glslang_utils.h"
 #include "log.h"
 #include "math_utils.h"
 #include "memory.h"
+#include "utils.h"
 
 #include "bindgroup_vk.h"
 #include "buffer_vk.h"
@@ -128,8 +131,8 @@ static VkResult create_rendertarget(struct gpu_ctx *s,
         return VK_ERROR_OUT_OF_HOST_MEMORY;
 
     const struct rendertarget_params params = {
-        .width = config->width,
-        .height = config->height,
+        .width = color->params.width,
+        .height = color->params.height,
         .nb_colors = 1,
         .colors[0] = {
             .attachment     = color,
@@ -173,11 +176,15 @@ static VkResult create_render_resources(struct gpu_ctx *s)
                            : ngli_format_vk_to_ngl(s_priv->surface_format.format);
     const int ds_format = vk->preferred_depth_stencil_format;
 
+    /* The YUV capture conversion samples the resolved color textures */
+    const int yuv_capture = config->capture_format != NGL_CAPTURE_FORMAT_RGBA;
+    const int color_usage = yuv_capture ? COLOR_USAGE | NGLI_TEXTURE_USAGE_SAMPLED_BIT : COLOR_USAGE;
+
     const uint32_t nb_images = config->offscreen ? s_priv->nb_in_flight_frames : s_priv->nb_images;
     for (uint32_t i = 0; i < nb_images; i++) {
         struct texture *color = NULL;
         if (config->offscreen) {
-            VkResult res = create_texture(s, color_format, 0, COLOR_USAGE, &color);
+            VkResult res = create_texture(s, color_format, 0, color_usage, &color);
             if (res != VK_SUCCESS)
                 return res;
         } else {
@@ -258,21 +265,55 @@ static VkResult create_render_resources(struct gpu_ctx *s)
     }
 
     if (config->offscreen) {
-        s_priv->capture_buffer = ngli_buffer_create(s);
-        if (!s_priv->capture_buffer)
+        /* The YUV capture formats are converted into a packed RGBA texture */
+        int32_t capture_width, capture_height;
+        ngli_gpu_ctx_get_capture_dimensions(s, &capture_width, &capture_height);
+
+        if (yuv_capture) {
+            s_priv->capture_texture = ngli_texture_create(s);
+            if (!s_priv->capture_texture)
+                return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+            const struct texture_params params = {
+                .type    = NGLI_TEXTURE_TYPE_2D,
+                .format  = color_format,
+                .width   = capture_width,
+                .height  = capture_height,
+                .usage   = COLOR_USAGE,
+            };
+
+            int ret = ngli_texture_init(s_priv->capture_texture, &params);
+            if (ret < 0)
+                return VK_ERROR_UNKNOWN;
+
+            VkResult res = create_rendertarget(s, s_priv->capture_texture, NULL, NULL,
+                                               NGLI_LOAD_OP_CLEAR, &s_priv->capture_rt);
+            if (res != VK_SUCCESS)
+                return res;
+        }
+
+        s_priv->capture_stagings = ngli_calloc(s_priv->nb_in_flight_frames, sizeof(*s_priv->capture_stagings));
+        if (!s_priv->capture_stagings)
             return VK_ERROR_OUT_OF_HOST_MEMORY;
 
-        s_priv->capture_buffer_size = s_priv->width * s_priv->height * ngli_format_get_bytes_per_pixel(color_format);
-        int ret = ngli_buffer_init(s_priv->capture_buffer,
-                                   s_priv->capture_buffer_size,
-                                   NGLI_BUFFER_USAGE_MAP_READ |
-                                   NGLI_BUFFER_USAGE_TRANSFER_DST_BIT);
-        if (ret < 0)
-            return VK_ERROR_UNKNOWN;
+        s_priv->capture_buffer_size = capture_width * capture_height * ngli_format_get_bytes_per_pixel(color_format);
+        for (uint32_t i = 0; i < s_priv->nb_in_flight_frames; i++) {
+            struct capture_staging_vk *staging = &s_priv->capture_stagings[i];
+            staging->buffer = ngli_buffer_create(s);
+            if (!staging->buffer)
+                return VK_ERROR_OUT_OF_HOST_MEMORY;
 
-        ret = ngli_buffer_map(s_priv->capture_buffer, 0, s_priv->capture_buffer_size, &s_priv->mapped_data);
-        if (ret < 0)
-            return VK_ERROR_UNKNOWN;
+            int ret = ngli_buffer_init(staging->buffer,
+                                       s_priv->capture_buffer_size,
+                                       NGLI_BUFFER_USAGE_MAP_READ |
+                                       NGLI_BUFFER_USAGE_TRANSFER_DST_BIT);
+            if (ret < 0)
+                return VK_ERROR_UNKNOWN;
+
+            ret = ngli_buffer_map(staging->buffer, 0, s_priv->capture_buffer_size, &staging->mapped_data);
+            if (ret < 0)
+                return VK_ERROR_UNKNOWN;
+        }
     }
 
     return VK_SUCCESS;
@@ -288,11 +329,19 @@ static void destroy_render_resources(struct gpu_ctx *s)
     ngli_darray_reset(&s_priv->rts);
     ngli_darray_reset(&s_priv->rts_load);
 
-    if (s_priv->mapped_data) {
-        ngli_buffer_unmap(s_priv->capture_buffer);
-        s_priv->mapped_data = NULL;
+    if (s_priv->capture_stagings) {
+        for (uint32_t i = 0; i < s_priv->nb_in_flight_frames; i++) {
+            struct capture_staging_vk *staging = &s_priv->capture_stagings[i];
+            if (staging->mapped_data)
+                ngli_buffer_unmap(staging->buffer);
+            ngli_buffer_freep(&staging->buffer);
+        }
+        ngli_freep(&s_priv->capture_stagings);
     }
-    ngli_buffer_freep(&s_priv->capture_buffer);
+    s_priv->nb_pending_captures = 0;
+
+    ngli_rendertarget_freep(&s_priv->capture_rt);
+    ngli_texture_freep(&s_priv->capture_texture);
 }
 
 static VkResult create_query_pool(struct gpu_ctx *s)
@@ -317,6 +366,83 @@ static void destroy_query_pool(struct gpu_ctx *s)
     vkDestroyQueryPool(vk->device, s_priv->query_pool, NULL);
 }
 
+static int diskcache_init(struct gpu_ctx *s)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+    struct vkcontext *vk = s_priv->vkcontext;
+
+    /*
+     * The pipeline cache data is only valid for the device and driver that
+     * produced it, and the SPIR-V modules depend on the glslang version
+     */
+    const VkPhysicalDeviceProperties *props = &vk->phy_device_props;
+    char uuid[2 * VK_UUID_SIZE + 1] = {0};
+    for (size_t i = 0; i < VK_UUID_SIZE; i++)
+        snprintf(uuid + 2 * i, 3, "%02x", props->pipelineCacheUUID[i]);
+    char *identity = ngli_asprintf("vk|%" PRIx32 "|%" PRIx32 "|%" PRIx32 "|%s|glslang-%d.%d.%d",
+                                   props->vendorID, props->deviceID, props->driverVersion, uuid,
+                                   GLSLANG_VERSION_MAJOR, GLSLANG_VERSION_MINOR, GLSLANG_VERSION_PATCH);
+    if (!identity)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngli_gpu_ctx_init_diskcache(s, identity);
+    ngli_free(identity);
+    return ret;
+}
+
+static const char pipeline_cache_key[] = "pipeline_cache";
+
+static VkResult create_pipeline_cache(struct gpu_ctx *s)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+    struct vkcontext *vk = s_priv->vkcontext;
+
+    void *data = NULL;
+    size_t size = 0;
+    if (s->diskcache &&
+        ngli_diskcache_load(s->diskcache, "pipelinecache", pipeline_cache_key,
+                            sizeof(pipeline_cache_key) - 1, &data, &size) < 0) {
+        data = NULL;
+        size = 0;
+    }
+
+    /* The driver validates the initial data header and ignores it on mismatch */
+    const VkPipelineCacheCreateInfo create_info = {
+        .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = size,
+        .pInitialData    = data,
+    };
+
+    VkResult res = vkCreatePipelineCache(vk->device, &create_info, NULL, &s_priv->pipeline_cache);
+    ngli_free(data);
+    return res;
+}
+
+static void destroy_pipeline_cache(struct gpu_ctx *s)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+    struct vkcontext *vk = s_priv->vkcontext;
+
+    if (!s_priv->pipeline_cache)
+        return;
+
+    if (s->diskcache) {
+        size_t size = 0;
+        VkResult res = vkGetPipelineCacheData(vk->device, s_priv->pipeline_cache, &size, NULL);
+        void *data = res == VK_SUCCESS && size ? ngli_malloc(size) : NULL;
+        if (data) {
+            res = vkGetPipelineCacheData(vk->device, s_priv->pipeline_cache, &size, data);
+            if (res == VK_SUCCESS)
+                ngli_diskcache_store(s->diskcache, "pipelinecache", pipeline_cache_key,
+                                     sizeof(pipeline_cache_key) - 1, data, size);
+            ngli_free(data);
+        }
+    }
+
+    vkDestroyPipelineCache(vk->device, s_priv->pipeline_cache, NULL);
+    s_priv->pipeline_cache = VK_NULL_HANDLE;
+}
+
 static VkResult create_command_pool_and_buffers(struct gpu_ctx *s)
 {
     struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
@@ -808,6 +934,10 @@ static int vk_init(struct gpu_ctx *s)
             LOG(ERROR, "capture_buffer is not supported by onscreen context");
             return NGL_ERROR_INVALID_ARG;
         }
+        if (config->on_frame) {
+            LOG(ERROR, "on_frame is not supported by onscreen context");
+            return NGL_ERROR_INVALID_ARG;
+        }
     }
 
 #if DEBUG_GPU_CAPTURE
@@ -872,7 +1002,8 @@ static int vk_init(struct gpu_ctx *s)
     s->features = NGLI_FEATURE_COMPUTE |
                   NGLI_FEATURE_IMAGE_LOAD_STORE |
                   NGLI_FEATURE_STORAGE_BUFFER |
-                  NGLI_FEATURE_BUFFER_MAP_PERSISTENT;
+                  NGLI_FEATURE_BUFFER_MAP_PERSISTENT |
+                  NGLI_FEATURE_PARALLEL_PIPELINE_INIT;
 
     const VkPhysicalDeviceLimits *limits = &vk->phy_device_props.limits;
     s->limits.max_vertex_attributes              = limits->maxVertexInputAttributes;
@@ -898,6 +1029,9 @@ static int vk_init(struct gpu_ctx *s)
     s->limits.max_image_units                    = 32;
     s->limits.max_uniform_block_size             = limits->maxUniformBufferRange;
     s->limits.max_storage_block_size             = limits->maxStorageBufferRange;
+    s->limits.max_vertex_storage_blocks          = limits->maxPerStageDescriptorStorageBuffers;
+    s->limits.max_fragment_storage_blocks        = limits->maxPerStageDescriptorStorageBuffers;
+    s->limits.max_compute_storage_blocks         = limits->maxPerStageDescriptorStorageBuffers;
     s->limits.min_uniform_block_offset_alignment = limits->minUniformBufferOffsetAlignment;
     s->limits.min_storage_block_offset_alignment = limits->minStorageBufferOffsetAlignment;
 
@@ -910,12 +1044,24 @@ static int vk_init(struct gpu_ctx *s)
 
     s_priv->width = config->width;
     s_priv->height = config->height;
-    s_priv->nb_in_flight_frames = 1;
+    /*
+     * Asynchronous captures need one staging buffer (and thus one frame) per
+     * capture in flight
+     */
+    s_priv->nb_in_flight_frames = config->offscreen && config->capture_async ? NGL_MAX_FRAMES_IN_FLIGHT : 1;
 
     int ret = ngli_glslang_init();
     if (ret < 0)
         return ret;
 
+    ret = diskcache_init(s);
+    if (ret < 0)
+        return ret;
+
+    res = create_pipeline_cache(s);
+    if (res != VK_SUCCESS)
+        return ngli_vk_res2ret(res);
+
     res = create_query_pool(s);
     if (res != VK_SUCCESS)
         return ngli_vk_res2ret(res);
@@ -1033,13 +1179,18 @@ static int vk_begin_update(struct gpu_ctx *s, double t)
     }
     ngli_darray_clear(&s_priv->pending_cmds);
 
-    struct cmd_vk *cmd_vk = s_priv->cmds[s_priv->cur_frame_index];
-    VkResult res = ngli_cmd_vk_wait(cmd_vk);
+    /*
+     * Only wait for the frame that previously used the slot we are about to
+     * reuse, so that the other frames in flight keep running on the GPU while
+     * this one is prepared
+     */
+    s_priv->cur_frame_index = (s_priv->cur_frame_index + 1) % s_priv->nb_in_flight_frames;
+    s_priv->host_writes_synced = 0;
+
+    VkResult res = ngli_cmd_vk_wait(s_priv->cmds[s_priv->cur_frame_index]);
     if (res != VK_SUCCESS)
         return ngli_vk_res2ret(res);
 
-    s_priv->cur_frame_index = (s_priv->cur_frame_index + 1) % s_priv->nb_in_flight_frames;
-
     s_priv->cur_cmd = s_priv->update_cmds[s_priv->cur_frame_index];
     res = ngli_cmd_vk_begin(s_priv->cur_cmd);
     if (res != VK_SUCCESS)
@@ -1073,11 +1224,113 @@ static int vk_end_update(struct gpu_ctx *s, double t)
     return 0;
 }
 
+static void deliver_capture(struct gpu_ctx *s, const struct capture_staging_vk *staging)
+{
+    const struct ngl_config *config = &s->config;
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+
+    if (config->on_frame) {
+        int32_t capture_width, capture_height;
+        ngli_gpu_ctx_get_capture_dimensions(s, &capture_width, &capture_height);
+        config->on_frame(config->on_frame_opaque, staging->mapped_data, capture_width * 4, staging->t);
+    } else {
+        memcpy(staging->dst, staging->mapped_data, s_priv->capture_buffer_size);
+    }
+}
+
+static int complete_capture(struct gpu_ctx *s, struct capture_staging_vk *staging)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+
+    if (!staging->cmd)
+        return 0;
+
+    VkResult res = ngli_cmd_vk_wait(staging->cmd);
+    if (res == VK_SUCCESS)
+        deliver_capture(s, staging);
+
+    staging->dst = NULL;
+    staging->cmd = NULL;
+    s_priv->nb_pending_captures--;
+
+    return ngli_vk_res2ret(res);
+}
+
+static struct capture_staging_vk *get_oldest_pending_capture(struct gpu_ctx *s)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+
+    struct capture_staging_vk *oldest = NULL;
+    for (uint32_t i = 0; i < s_priv->nb_in_flight_frames; i++) {
+        struct capture_staging_vk *staging = &s_priv->capture_stagings[i];
+        if (staging->cmd && (!oldest || staging->seq < oldest->seq))
+            oldest = staging;
+    }
+    return oldest;
+}
+
+/* Deliver the pending captures in submission order until the staging buffer is free */
+static int release_capture_staging(struct gpu_ctx *s, struct capture_staging_vk *staging)
+{
+    while (staging->cmd) {
+        int ret = complete_capture(s, get_oldest_pending_capture(s));
+        if (ret < 0)
+            return ret;
+    }
+    return 0;
+}
+
+static int vk_wait_captures(struct gpu_ctx *s, size_t max_pending)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+
+    int ret = 0;
+    while (s_priv->nb_pending_captures > max_pending) {
+        int ret_capture = complete_capture(s, get_oldest_pending_capture(s));
+        if (ret_capture < 0)
+            ret = ret_capture;
+    }
+
+    return ret;
+}
+
+VkResult ngli_gpu_ctx_vk_sync_host_writes(struct gpu_ctx *s)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+
+    if (s_priv->nb_in_flight_frames == 1 || s_priv->host_writes_synced)
+        return VK_SUCCESS;
+
+    /* The command buffers are submitted in order, waiting for the latest one is enough */
+    const uint32_t nb_frames = s_priv->nb_in_flight_frames;
+    const uint32_t prev_index = (s_priv->cur_frame_index + nb_frames - 1) % nb_frames;
+    VkResult res = ngli_cmd_vk_wait(s_priv->cmds[prev_index]);
+    if (res != VK_SUCCESS)
+        return res;
+
+    s_priv->host_writes_synced = 1;
+    return VK_SUCCESS;
+}
+
 static int vk_begin_draw(struct gpu_ctx *s, double t)
 {
     struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
     const struct ngl_config *config = &s->config;
 
+    /* The staging buffer of the frame is about to be reused */
+    if (s_priv->capture_stagings) {
+        int ret = release_capture_staging(s, &s_priv->capture_stagings[s_priv->cur_frame_index]);
+        if (ret < 0)
+            return ret;
+    }
+
+    const struct vkmemory_stats *memory_stats = &s_priv->vkcontext->memory.stats;
+    s->memory_stats = (struct gpu_memory_stats){
+        .nb_allocations = memory_stats->nb_allocations,
+        .allocated      = memory_stats->allocated,
+        .used           = memory_stats->used,
+    };
+
     s_priv->cur_cmd = s_priv->cmds[s_priv->cur_frame_index];
     VkResult res = ngli_cmd_vk_begin(s_priv->cur_cmd);
     if (res != VK_SUCCESS)
@@ -1159,20 +1412,32 @@ static int vk_end_draw(struct gpu_ctx *s, double t)
     struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
 
     if (config->offscreen) {
-        if (config->capture_buffer) {
+        if (config->capture_buffer || config->on_frame) {
+            /* The YUV capture formats are already converted into the capture texture */
             struct texture **colors = ngli_darray_data(&s_priv->colors);
-            struct texture *color = colors[s_priv->cur_frame_index];
-            ngli_texture_vk_copy_to_buffer(color, s_priv->capture_buffer);
+            struct texture *color = s_priv->capture_texture ? s_priv->capture_texture
+                                                            : colors[s_priv->cur_frame_index];
+            struct capture_staging_vk *staging = &s_priv->capture_stagings[s_priv->cur_frame_index];
+            ngli_texture_vk_copy_to_buffer(color, staging->buffer);
 
             VkResult res = ngli_cmd_vk_submit(s_priv->cur_cmd);
             if (res != VK_SUCCESS)
                 return ngli_vk_res2ret(res);
 
-            res = ngli_cmd_vk_wait(s_priv->cur_cmd);
-            if (res != VK_SUCCESS)
-                return ngli_vk_res2ret(res);
-
-            memcpy(config->capture_buffer, s_priv->mapped_data, s_priv->capture_buffer_size);
+            staging->dst = config->capture_buffer;
+            staging->t = t;
+            staging->seq = s_priv->capture_seq++;
+            if (config->capture_async) {
+                /* The copy out is deferred to vk_wait_captures() */
+                staging->cmd = s_priv->cur_cmd;
+                s_priv->nb_pending_captures++;
+            } else {
+                res = ngli_cmd_vk_wait(s_priv->cur_cmd);
+                if (res != VK_SUCCESS)
+                    return ngli_vk_res2ret(res);
+
+                deliver_capture(s, staging);
+            }
         } else {
             VkResult res = ngli_cmd_vk_submit(s_priv->cur_cmd);
             if (res != VK_SUCCESS)
@@ -1217,6 +1482,7 @@ static void vk_destroy(struct gpu_ctx *s)
     destroy_render_resources(s);
     destroy_swapchain(s);
     destroy_query_pool(s);
+    destroy_pipeline_cache(s);
 
     ngli_glslang_uninit();
 
@@ -1257,6 +1523,12 @@ static void vk_get_rendertarget_uvcoord_matrix(struct gpu_ctx *s, float *dst)
     memcpy(dst, matrix, 4 * 4 * sizeof(float));
 }
 
+static struct rendertarget *vk_get_capture_rendertarget(struct gpu_ctx *s)
+{
+    struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
+    return s_priv->capture_rt;
+}
+
 static struct rendertarget *vk_get_default_rendertarget(struct gpu_ctx *s, int load_op)
 {
     struct gpu_ctx_vk *s_priv = (struct gpu_ctx_vk *)s;
@@ -1461,6 +1733,7 @@ const struct gpu_ctx_class ngli_gpu_ctx_vk = {
     .begin_draw                         = vk_begin_draw,
     .query_draw_time                    = vk_query_draw_time,
     .end_draw                           = vk_end_draw,
+    .wait_captures                      = vk_wait_captures,
     .wait_idle                          = vk_wait_idle,
     .destroy                            = vk_destroy,
 
@@ -1470,6 +1743,7 @@ const struct gpu_ctx_class ngli_gpu_ctx_vk = {
 
     .get_default_rendertarget           = vk_get_default_rendertarget,
     .get_default_rendertarget_layout    = vk_get_default_rendertarget_layout,
+    .get_capture_rendertarget           = vk_get_capture_rendertarget,
 
     .begin_render_pass                  = vk_begin_render_pass,
     .end_render_pass                    = vk_end_render_pass,
@@ -26,6 +26,15 @@
 #include "vkcontext.h"
 #include "command_vk.h"
 
+struct capture_staging_vk {
+    struct buffer *buffer;
+    void *mapped_data;
+    struct cmd_vk *cmd; // command buffer performing the copy into the staging buffer, set while the capture is pending
+    void *dst;          // destination capture buffer
+    double t;           // time of the captured frame
+    uint64_t seq;       // submission order of the capture, used to deliver them in order
+};
+
 struct gpu_ctx_vk {
     struct gpu_ctx parent;
     struct vkcontext *vkcontext;
@@ -45,6 +54,8 @@ struct gpu_ctx_vk {
 
     VkQueryPool query_pool;
 
+    VkPipelineCache pipeline_cache;
+
     VkSurfaceCapabilitiesKHR surface_caps;
     VkSurfaceFormatKHR surface_format;
     VkPresentModeKHR present_mode;
@@ -60,15 +71,19 @@ struct gpu_ctx_vk {
 
     uint32_t nb_in_flight_frames;
     uint32_t cur_frame_index;
+    int host_writes_synced; // previous frames completed since the beginning of the current one
 
     struct darray colors;
     struct darray ms_colors;
     struct darray depth_stencils;
     struct darray rts;
     struct darray rts_load;
-    struct buffer *capture_buffer;
+    struct texture *capture_texture;    // YUV capture formats only
+    struct rendertarget *capture_rt;    // YUV capture formats only
+    struct capture_staging_vk *capture_stagings; // one per in-flight frame
     int capture_buffer_size;
-    void *mapped_data;
+    size_t nb_pending_captures;
+    uint64_t capture_seq;
 
     struct rendertarget *default_rt;
     struct rendertarget *default_rt_load;
@@ -83,4 +98,11 @@ struct gpu_ctx_vk {
     struct texture *dummy_texture;
 };
 
+/*
+ * Wait for the frames still in flight before the host writes into memory
+ * they may be reading from (dynamic buffers, texture staging buffers). This
+ * is only done once per frame and is a no-op with a single frame in flight.
+ */
+VkResult ngli_gpu_ctx_vk_sync_host_writes(struct gpu_ctx *s);
+
 #endif
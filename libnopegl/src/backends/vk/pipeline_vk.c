@@ -316,7 +316,7 @@ static VkResult pipeline_graphics_init(struct pipeline *s)
         .renderPass          = render_pass,
         .subpass             = 0,
     };
-    res = vkCreateGraphicsPipelines(vk->device, VK_NULL_HANDLE, 1, &pipeline_create_info, NULL, &s_priv->pipeline);
+    res = vkCreateGraphicsPipelines(vk->device, gpu_ctx_vk->pipeline_cache, 1, &pipeline_create_info, NULL, &s_priv->pipeline);
 
     vkDestroyRenderPass(vk->device, render_pass, NULL);
 
@@ -345,7 +345,7 @@ static VkResult pipeline_compute_init(struct pipeline *s)
         .layout = s_priv->pipeline_layout,
     };
 
-    return vkCreateComputePipelines(vk->device, VK_NULL_HANDLE, 1, &pipeline_create_info, NULL, &s_priv->pipeline);
+    return vkCreateComputePipelines(vk->device, gpu_ctx_vk->pipeline_cache, 1, &pipeline_create_info, NULL, &s_priv->pipeline);
 }
 
 static VkResult create_pipeline_layout(struct pipeline *s)
@@ -378,7 +378,7 @@ static VkResult create_pipeline(struct pipeline *s)
     } else {
         ngli_assert(0);
     }
-    return VK_SUCCESS;
+    return res;
 }
 
 struct pipeline *ngli_pipeline_vk_create(struct gpu_ctx *gpu_ctx)
@@ -403,6 +403,11 @@ static VkResult pipeline_vk_init(struct pipeline *s)
 
 int ngli_pipeline_vk_init(struct pipeline *s)
 {
+    /* The program may have been compiled on the thread pool */
+    const struct program_vk *program_vk = (const struct program_vk *)s->program;
+    if (program_vk->compile_ret < 0)
+        return program_vk->compile_ret;
+
     VkResult res = pipeline_vk_init(s);
     if (res != VK_SUCCESS)
         LOG(ERROR, "unable to initialize pipeline: %s", ngli_vk_res2str(res));
@@ -423,7 +428,8 @@ static int prepare_and_bind_descriptor_set(struct pipeline *s, VkCommandBuffer c
 
     NGLI_CMD_VK_REF(cmd_vk, gpu_ctx->bindgroup);
     struct bindgroup_vk *bindgroup_vk = (struct bindgroup_vk *)gpu_ctx->bindgroup;
-    if (bindgroup_vk->desc_set)
+    const uint32_t bind_state = NGLI_GPU_STATE_PIPELINE | NGLI_GPU_STATE_BINDGROUP;
+    if (bindgroup_vk->desc_set && (gpu_ctx->dirty_state & bind_state))
         vkCmdBindDescriptorSets(cmd_buf, s_priv->pipeline_bind_point, s_priv->pipeline_layout, 0,
                                 1, &bindgroup_vk->desc_set,
                                 (uint32_t)gpu_ctx->nb_dynamic_offsets, gpu_ctx->dynamic_offsets);
@@ -436,7 +442,8 @@ static int prepare_and_bind_graphics_pipeline(struct pipeline *s, VkCommandBuffe
     struct gpu_ctx *gpu_ctx = s->gpu_ctx;
     struct pipeline_vk *s_priv = (struct pipeline_vk *)s;
 
-    vkCmdBindPipeline(cmd_buf, s_priv->pipeline_bind_point, s_priv->pipeline);
+    if (gpu_ctx->dirty_state & NGLI_GPU_STATE_PIPELINE)
+        vkCmdBindPipeline(cmd_buf, s_priv->pipeline_bind_point, s_priv->pipeline);
 
     const VkViewport viewport = {
         .x        = (float)gpu_ctx->viewport.x,
@@ -23,6 +23,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "bstr.h"
+#include "diskcache.h"
 #include "glslang_utils.h"
 #include "gpu_ctx_vk.h"
 #include "log.h"
@@ -40,59 +42,162 @@ struct program *ngli_program_vk_create(struct gpu_ctx *gpu_ctx)
     return (struct program *)s;
 }
 
-int ngli_program_vk_init(struct program *s, const struct program_params *params)
+static int compile_shader(struct program *s, int stage, const char *src, void **datap, size_t *sizep)
 {
-    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
-    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
-    struct program_vk *s_priv = (struct program_vk *)s;
+    struct diskcache *diskcache = s->gpu_ctx->diskcache;
+    if (!diskcache)
+        return ngli_glslang_compile(stage, src, datap, sizep);
 
-    const struct {
-        int stage;
-        const char *src;
-    } shaders[] = {
-        {NGLI_PROGRAM_SHADER_VERT, params->vertex},
-        {NGLI_PROGRAM_SHADER_FRAG, params->fragment},
-        {NGLI_PROGRAM_SHADER_COMP, params->compute},
-    };
+    struct bstr *key = ngli_bstr_create();
+    if (!key)
+        return NGL_ERROR_MEMORY;
+    ngli_bstr_printf(key, "%d:", stage);
+    ngli_bstr_print(key, src);
 
-    for (size_t i = 0; i < NGLI_ARRAY_NB(shaders); i++) {
-        if (!shaders[i].src)
-            continue;
+    const char *key_data = ngli_bstr_strptr(key);
+    const size_t key_size = ngli_bstr_len(key);
+    int ret = ngli_diskcache_load(diskcache, "spirv", key_data, key_size, datap, sizep);
+    if (ret >= 0 && *sizep && *sizep % sizeof(uint32_t) == 0)
+        goto end;
+    if (ret >= 0)
+        ngli_freep(datap);
 
-        void *data = NULL;
-        size_t size = 0;
-        int ret = ngli_glslang_compile(shaders[i].stage, shaders[i].src, &data, &size);
-        if (ret < 0) {
-            char *s_with_numbers = ngli_numbered_lines(shaders[i].src);
-            if (s_with_numbers) {
-                LOG(ERROR, "failed to compile shader \"%s\":\n%s",
-                    params->label ? params->label : "", s_with_numbers);
-                ngli_free(s_with_numbers);
-            }
-            return ret;
-        }
+    ret = ngli_glslang_compile(stage, src, datap, sizep);
+    if (ret >= 0)
+        ngli_diskcache_store(diskcache, "spirv", key_data, key_size, *datap, *sizep);
+
+end:
+    ngli_bstr_freep(&key);
+    return ret;
+}
+
+static int create_shader_module(struct program *s, const char *label, int stage, const char *src,
+                                VkShaderModule *shader_module)
+{
+    struct gpu_ctx_vk *gpu_ctx_vk = (struct gpu_ctx_vk *)s->gpu_ctx;
+    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
 
+    void *data = NULL;
+    size_t size = 0;
+    int ret = compile_shader(s, stage, src, &data, &size);
+    if (ret >= 0) {
         const VkShaderModuleCreateInfo shader_module_create_info = {
             .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
             .codeSize = size,
             .pCode    = data,
         };
-        VkResult res = vkCreateShaderModule(vk->device, &shader_module_create_info, NULL, &s_priv->shaders[i]);
+        VkResult res = vkCreateShaderModule(vk->device, &shader_module_create_info, NULL, shader_module);
         ngli_freep(&data);
-        if (res != VK_SUCCESS) {
-            char *s_with_numbers = ngli_numbered_lines(shaders[i].src);
-            if (s_with_numbers) {
-                LOG(ERROR, "failed to compile shader \"%s\":\n%s",
-                    params->label ? params->label : "", s_with_numbers);
-                ngli_free(s_with_numbers);
-            }
-            return ngli_vk_res2ret(res);
+        ret = ngli_vk_res2ret(res);
+    }
+
+    if (ret < 0) {
+        char *s_with_numbers = ngli_numbered_lines(src);
+        if (s_with_numbers) {
+            LOG(ERROR, "failed to compile shader \"%s\":\n%s", label ? label : "", s_with_numbers);
+            ngli_free(s_with_numbers);
         }
     }
 
+    return ret;
+}
+
+struct compile_job {
+    struct program *program;
+    char *label;
+    char *sources[NGLI_PROGRAM_SHADER_NB];
+};
+
+static void compile_job_freep(struct compile_job **jobp)
+{
+    struct compile_job *job = *jobp;
+    if (!job)
+        return;
+    ngli_freep(&job->label);
+    for (size_t i = 0; i < NGLI_ARRAY_NB(job->sources); i++)
+        ngli_freep(&job->sources[i]);
+    ngli_freep(jobp);
+}
+
+static int compile_program(struct program *s, const char *label, const char * const *sources)
+{
+    struct program_vk *s_priv = (struct program_vk *)s;
+
+    for (int i = 0; i < NGLI_PROGRAM_SHADER_NB; i++) {
+        if (!sources[i])
+            continue;
+        int ret = create_shader_module(s, label, i, sources[i], &s_priv->shaders[i]);
+        if (ret < 0)
+            return ret;
+    }
+
     return 0;
 }
 
+static int run_compile_job(void *arg)
+{
+    struct compile_job *job = arg;
+    struct program_vk *s_priv = (struct program_vk *)job->program;
+    const char * const *sources = (const char * const *)job->sources;
+    s_priv->compile_ret = compile_program(job->program, job->label, sources);
+    const int ret = s_priv->compile_ret;
+    compile_job_freep(&job);
+    return ret;
+}
+
+/*
+ * Within a pipeline batch, the compilation is queued on the thread pool; the
+ * pipelines using the program are initialized after the batch waited for it
+ */
+static int submit_compile_job(struct program *s, const char * const *sources, const char *label)
+{
+    struct compile_job *job = ngli_calloc(1, sizeof(*job));
+    if (!job)
+        return NGL_ERROR_MEMORY;
+    job->program = s;
+
+    if (label) {
+        job->label = ngli_strdup(label);
+        if (!job->label)
+            goto fail;
+    }
+
+    for (size_t i = 0; i < NGLI_ARRAY_NB(job->sources); i++) {
+        if (!sources[i])
+            continue;
+        job->sources[i] = ngli_strdup(sources[i]);
+        if (!job->sources[i])
+            goto fail;
+    }
+
+    int ret = ngli_threadpool_submit(s->gpu_ctx->threadpool, run_compile_job, job);
+    if (ret < 0) {
+        compile_job_freep(&job);
+        return ret;
+    }
+
+    return 0;
+
+fail:
+    compile_job_freep(&job);
+    return NGL_ERROR_MEMORY;
+}
+
+int ngli_program_vk_init(struct program *s, const struct program_params *params)
+{
+    const char *sources[NGLI_PROGRAM_SHADER_NB] = {
+        [NGLI_PROGRAM_SHADER_VERT] = params->vertex,
+        [NGLI_PROGRAM_SHADER_FRAG] = params->fragment,
+        [NGLI_PROGRAM_SHADER_COMP] = params->compute,
+    };
+
+    struct gpu_ctx *gpu_ctx = s->gpu_ctx;
+    if (gpu_ctx->threadpool && gpu_ctx->defer_pipelines)
+        return submit_compile_job(s, sources, params->label);
+
+    return compile_program(s, params->label, sources);
+}
+
 void ngli_program_vk_freep(struct program **sp)
 {
     struct program *s = *sp;
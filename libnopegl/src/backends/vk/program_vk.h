@@ -31,6 +31,7 @@ struct gpu_ctx;
 struct program_vk {
     struct program parent;
     VkShaderModule shaders[NGLI_PROGRAM_SHADER_NB];
+    int compile_ret; // result of the compilation when it runs on the thread pool
 };
 
 struct program *ngli_program_vk_create(struct gpu_ctx *gpu_ctx);
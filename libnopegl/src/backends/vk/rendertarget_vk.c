@@ -180,21 +180,36 @@ static VkResult vk_create_compatible_renderpass(struct gpu_ctx *s, const struct
         .pDepthStencilAttachment = has_ds_ref ? &depth_stencil_ref : NULL,
     };
 
+    /*
+     * The depth/stencil attachments stay in the attachment layout between
+     * render passes and may be shared by several of them (transient
+     * attachments), so no layout transition orders their accesses: the
+     * dependencies must cover the fragment tests stages as well
+     */
+    const VkPipelineStageFlags attachment_stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+                                                 | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+                                                 | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    const VkAccessFlags attachment_writes = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+                                          | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    const VkAccessFlags attachment_accesses = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT
+                                            | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                                            | attachment_writes;
+
     const VkSubpassDependency dependencies[2] = {
         {
             .srcSubpass      = VK_SUBPASS_EXTERNAL,
             .dstSubpass      = 0,
-            .srcStageMask    = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-            .dstStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-            .srcAccessMask   = VK_ACCESS_MEMORY_READ_BIT,
-            .dstAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .srcStageMask    = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | attachment_stages,
+            .dstStageMask    = attachment_stages,
+            .srcAccessMask   = VK_ACCESS_MEMORY_READ_BIT | attachment_writes,
+            .dstAccessMask   = attachment_accesses,
             .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT,
         }, {
             .srcSubpass      = 0,
             .dstSubpass      = VK_SUBPASS_EXTERNAL,
-            .srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            .srcStageMask    = attachment_stages,
             .dstStageMask    = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-            .srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .srcAccessMask   = attachment_accesses,
             .dstAccessMask   = VK_ACCESS_MEMORY_READ_BIT,
             .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT,
         }
@@ -31,6 +31,7 @@
 #include "memory.h"
 #include "texture_vk.h"
 #include "utils.h"
+#include "vkmemory.h"
 #include "vkutils.h"
 
 static const VkFilter vk_filter_map[NGLI_NB_FILTER] = {
@@ -395,33 +396,45 @@ static VkResult texture_vk_init(struct texture *s, const struct texture_params *
 
     s_priv->image_layout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-    VkMemoryRequirements mem_reqs;
-    vkGetImageMemoryRequirements(vk->device, s_priv->image, &mem_reqs);
+    VkMemoryDedicatedRequirements mem_ded_reqs = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS,
+    };
+    VkMemoryRequirements2 mem_reqs = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = &mem_ded_reqs,
+    };
+    const VkImageMemoryRequirementsInfo2 mem_reqs_info = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2,
+        .image = s_priv->image,
+    };
+    vkGetImageMemoryRequirements2(vk->device, &mem_reqs_info, &mem_reqs);
+    const uint32_t mem_type_bits = mem_reqs.memoryRequirements.memoryTypeBits;
 
     int mem_type_index = NGL_ERROR_NOT_FOUND;
     if (s->params.usage & NGLI_TEXTURE_USAGE_TRANSIENT_ATTACHMENT_BIT) {
         const VkMemoryPropertyFlags mem_props = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
                                                 VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
-        mem_type_index = ngli_vkcontext_find_memory_type(vk, mem_reqs.memoryTypeBits, mem_props);
+        mem_type_index = ngli_vkcontext_find_memory_type(vk, mem_type_bits, mem_props);
     }
 
     if (mem_type_index < 0) {
         const VkMemoryPropertyFlags mem_pros = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-        mem_type_index = ngli_vkcontext_find_memory_type(vk, mem_reqs.memoryTypeBits, mem_pros);
+        mem_type_index = ngli_vkcontext_find_memory_type(vk, mem_type_bits, mem_pros);
         if (mem_type_index < 0)
             return VK_ERROR_FORMAT_NOT_SUPPORTED;
     }
 
-    const VkMemoryAllocateInfo alloc_info = {
-        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize  = mem_reqs.size,
-        .memoryTypeIndex = mem_type_index,
+    const VkMemoryDedicatedAllocateInfo mem_ded_info = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
+        .image = s_priv->image,
     };
-    res = vkAllocateMemory(vk->device, &alloc_info, NULL, &s_priv->image_memory);
+    const int dedicated = mem_ded_reqs.prefersDedicatedAllocation || mem_ded_reqs.requiresDedicatedAllocation;
+    res = ngli_vkmemory_alloc(vk, &mem_reqs.memoryRequirements, dedicated ? &mem_ded_info : NULL,
+                              (uint32_t)mem_type_index, NGLI_VKMEMORY_RESOURCE_OPTIMAL, &s_priv->image_alloc);
     if (res != VK_SUCCESS)
         return res;
 
-    res = vkBindImageMemory(vk->device, s_priv->image, s_priv->image_memory, 0);
+    res = vkBindImageMemory(vk->device, s_priv->image, s_priv->image_alloc.memory, s_priv->image_alloc.offset);
     if (res != VK_SUCCESS)
         return res;
 
@@ -601,12 +614,15 @@ static VkResult texture_vk_upload(struct texture *s, const uint8_t *data, int li
             return VK_ERROR_UNKNOWN;
     }
 
+    VkResult res = ngli_gpu_ctx_vk_sync_host_writes(s->gpu_ctx);
+    if (res != VK_SUCCESS)
+        return res;
     memcpy(s_priv->staging_buffer_ptr, data, s_priv->staging_buffer->size);
 
     struct cmd_vk *cmd_vk = gpu_ctx_vk->cur_cmd;
     const int cmd_is_transient = cmd_vk ? 0 : 1;
     if (cmd_is_transient) {
-        VkResult res = ngli_cmd_vk_begin_transient(s->gpu_ctx, 0, &cmd_vk);
+        res = ngli_cmd_vk_begin_transient(s->gpu_ctx, 0, &cmd_vk);
         if (res != VK_SUCCESS)
             return res;
     }
@@ -675,7 +691,7 @@ static VkResult texture_vk_upload(struct texture *s, const uint8_t *data, int li
                             &subres_range);
 
     if (cmd_is_transient) {
-        VkResult res = ngli_cmd_vk_execute_transient(&cmd_vk);
+        res = ngli_cmd_vk_execute_transient(&cmd_vk);
         if (res != VK_SUCCESS)
             return res;
     }
@@ -850,7 +866,7 @@ void ngli_texture_vk_freep(struct texture **sp)
         vkDestroyImageView(vk->device, s_priv->image_view, NULL);
     if (!s_priv->wrapped_image)
         vkDestroyImage(vk->device, s_priv->image, NULL);
-    vkFreeMemory(vk->device, s_priv->image_memory, NULL);
+    ngli_vkmemory_free(vk, &s_priv->image_alloc);
 
     if (s_priv->staging_buffer_ptr)
         ngli_buffer_unmap(s_priv->staging_buffer);
@@ -27,6 +27,7 @@
 #include "buffer.h"
 #include "texture.h"
 #include "vkcontext.h"
+#include "vkmemory.h"
 #include "ycbcr_sampler_vk.h"
 
 struct texture_vk_wrap_params {
@@ -48,7 +49,7 @@ struct texture_vk {
     int wrapped_image;
     VkImageLayout default_image_layout;
     VkImageLayout image_layout;
-    VkDeviceMemory image_memory;
+    struct vkmemory_alloc image_alloc;
     VkImageView image_view;
     int wrapped_image_view;
     VkSampler sampler;
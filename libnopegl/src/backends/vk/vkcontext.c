@@ -905,6 +905,8 @@ VkResult ngli_vkcontext_init(struct vkcontext *s, const struct ngl_config *confi
     if (res != VK_SUCCESS)
         return res;
 
+    ngli_vkmemory_init(s);
+
     res = load_functions(s);
     if (res != VK_SUCCESS)
         return res;
@@ -944,6 +946,7 @@ void ngli_vkcontext_freep(struct vkcontext **sp)
 
     if (s->device) {
         vkDeviceWaitIdle(s->device);
+        ngli_vkmemory_reset(s);
         vkDestroyDevice(s->device, NULL);
     }
 
@@ -33,6 +33,7 @@
 #include "nopegl.h"
 #include "rendertarget.h"
 #include "texture.h"
+#include "vkmemory.h"
 
 #define VK_FUNC(name) PFN_vk##name
 #define VK_DECLARE_FUNC(name) VK_FUNC(name) name
@@ -82,6 +83,8 @@ struct vkcontext {
     uint32_t nb_present_modes;
     int support_present_mode_immediate;
 
+    struct vkmemory memory;
+
     /* Device functions */
     VK_DECLARE_FUNC(CreateSamplerYcbcrConversionKHR);
     VK_DECLARE_FUNC(DestroySamplerYcbcrConversionKHR);
@@ -0,0 +1,261 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "log.h"
+#include "memory.h"
+#include "rangealloc.h"
+#include "utils.h"
+#include "vkcontext.h"
+#include "vkmemory.h"
+#include "vkutils.h"
+
+#define MAX_BLOCK_SIZE (64 * 1024 * 1024)
+
+struct vkmemory_block {
+    VkDeviceMemory memory;
+    VkDeviceSize size;
+    void *mapped;
+    struct darray *pool;
+    struct rangealloc ranges;
+};
+
+void ngli_vkmemory_init(struct vkcontext *vk)
+{
+    struct vkmemory *s = &vk->memory;
+    const VkPhysicalDeviceMemoryProperties *props = &vk->phydev_mem_props;
+
+    for (uint32_t i = 0; i < props->memoryTypeCount; i++) {
+        const VkDeviceSize heap_size = props->memoryHeaps[props->memoryTypes[i].heapIndex].size;
+        s->block_sizes[i] = NGLI_MIN(MAX_BLOCK_SIZE, heap_size / 8);
+    }
+    for (uint32_t i = 0; i < VK_MAX_MEMORY_TYPES; i++)
+        for (size_t j = 0; j < NGLI_VKMEMORY_RESOURCE_NB; j++)
+            ngli_darray_init(&s->pools[i][j], sizeof(struct vkmemory_block *), 0);
+    memset(&s->stats, 0, sizeof(s->stats));
+}
+
+static VkResult allocate_device_memory(struct vkcontext *vk, VkDeviceSize size, uint32_t mem_type_index,
+                                       const VkMemoryDedicatedAllocateInfo *dedicated_info,
+                                       VkDeviceMemory *memoryp, void **mappedp)
+{
+    struct vkmemory *s = &vk->memory;
+
+    const VkMemoryAllocateInfo allocate_info = {
+        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext           = dedicated_info,
+        .allocationSize  = size,
+        .memoryTypeIndex = mem_type_index,
+    };
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkResult res = vkAllocateMemory(vk->device, &allocate_info, NULL, &memory);
+    if (res != VK_SUCCESS)
+        return res;
+
+    /*
+     * A device memory object can only be mapped once at a time: host visible
+     * memory is thus mapped persistently and shared by all its ranges.
+     */
+    void *mapped = NULL;
+    const VkMemoryPropertyFlags flags = vk->phydev_mem_props.memoryTypes[mem_type_index].propertyFlags;
+    if (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        res = vkMapMemory(vk->device, memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+        if (res != VK_SUCCESS) {
+            vkFreeMemory(vk->device, memory, NULL);
+            return res;
+        }
+    }
+
+    s->stats.nb_device_memories++;
+    s->stats.allocated += (size_t)size;
+
+    *memoryp = memory;
+    *mappedp = mapped;
+    return VK_SUCCESS;
+}
+
+static void free_device_memory(struct vkcontext *vk, VkDeviceMemory memory, VkDeviceSize size)
+{
+    struct vkmemory *s = &vk->memory;
+
+    /* Freeing a mapped memory object implicitly unmaps it */
+    vkFreeMemory(vk->device, memory, NULL);
+
+    s->stats.nb_device_memories--;
+    s->stats.allocated -= (size_t)size;
+}
+
+static struct vkmemory_block *create_block(struct vkcontext *vk, struct darray *pool,
+                                           VkDeviceSize size, uint32_t mem_type_index)
+{
+    struct vkmemory_block *block = ngli_calloc(1, sizeof(*block));
+    if (!block)
+        return NULL;
+
+    block->size = size;
+    block->pool = pool;
+    if (ngli_rangealloc_init(&block->ranges, size) < 0) {
+        ngli_rangealloc_reset(&block->ranges);
+        ngli_free(block);
+        return NULL;
+    }
+
+    VkResult res = allocate_device_memory(vk, size, mem_type_index, NULL, &block->memory, &block->mapped);
+    if (res != VK_SUCCESS) {
+        ngli_rangealloc_reset(&block->ranges);
+        ngli_free(block);
+        return NULL;
+    }
+
+    if (!ngli_darray_push(pool, &block)) {
+        free_device_memory(vk, block->memory, block->size);
+        ngli_rangealloc_reset(&block->ranges);
+        ngli_free(block);
+        return NULL;
+    }
+
+    return block;
+}
+
+static void destroy_block(struct vkcontext *vk, struct vkmemory_block *block)
+{
+    free_device_memory(vk, block->memory, block->size);
+    ngli_rangealloc_reset(&block->ranges);
+    ngli_free(block);
+}
+
+VkResult ngli_vkmemory_alloc(struct vkcontext *vk, const VkMemoryRequirements *reqs,
+                             const VkMemoryDedicatedAllocateInfo *dedicated_info,
+                             uint32_t mem_type_index, int resource_type, struct vkmemory_alloc *alloc)
+{
+    struct vkmemory *s = &vk->memory;
+
+    ngli_assert(mem_type_index < vk->phydev_mem_props.memoryTypeCount);
+    ngli_assert(resource_type >= 0 && resource_type < NGLI_VKMEMORY_RESOURCE_NB);
+
+    memset(alloc, 0, sizeof(*alloc));
+
+    const VkDeviceSize block_size = s->block_sizes[mem_type_index];
+    const VkMemoryPropertyFlags flags = vk->phydev_mem_props.memoryTypes[mem_type_index].propertyFlags;
+    const int dedicated = dedicated_info ||
+                          reqs->size > block_size / 2 ||
+                          (flags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+
+    if (dedicated) {
+        VkResult res = allocate_device_memory(vk, reqs->size, mem_type_index, dedicated_info,
+                                              &alloc->memory, &alloc->mapped);
+        if (res != VK_SUCCESS)
+            return res;
+        alloc->size = reqs->size;
+        s->stats.nb_allocations++;
+        s->stats.used += (size_t)reqs->size;
+        return VK_SUCCESS;
+    }
+
+    const VkDeviceSize alignment = NGLI_MAX(reqs->alignment, 1);
+    struct darray *pool = &s->pools[mem_type_index][resource_type];
+    struct vkmemory_block **blocks = ngli_darray_data(pool);
+    struct vkmemory_block *block = NULL;
+    VkDeviceSize offset = 0;
+    for (size_t i = 0; i < ngli_darray_count(pool); i++) {
+        if (ngli_rangealloc_alloc(&blocks[i]->ranges, reqs->size, alignment, &offset) == 0) {
+            block = blocks[i];
+            break;
+        }
+    }
+
+    if (!block) {
+        block = create_block(vk, pool, block_size, mem_type_index);
+        if (!block)
+            return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        if (ngli_rangealloc_alloc(&block->ranges, reqs->size, alignment, &offset) < 0)
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    alloc->memory = block->memory;
+    alloc->offset = offset;
+    alloc->size = reqs->size;
+    alloc->mapped = block->mapped ? (uint8_t *)block->mapped + offset : NULL;
+    alloc->block = block;
+
+    s->stats.nb_allocations++;
+    s->stats.used += (size_t)reqs->size;
+    return VK_SUCCESS;
+}
+
+void ngli_vkmemory_free(struct vkcontext *vk, struct vkmemory_alloc *alloc)
+{
+    struct vkmemory *s = &vk->memory;
+
+    if (!alloc->memory)
+        return;
+
+    s->stats.nb_allocations--;
+    s->stats.used -= (size_t)alloc->size;
+
+    struct vkmemory_block *block = alloc->block;
+    if (!block) {
+        free_device_memory(vk, alloc->memory, alloc->size);
+        memset(alloc, 0, sizeof(*alloc));
+        return;
+    }
+
+    if (ngli_rangealloc_free(&block->ranges, alloc->offset, alloc->size) < 0)
+        LOG(ERROR, "unable to release memory range, %" PRIu64 " bytes will be lost until the block is freed",
+            (uint64_t)alloc->size);
+
+    /* Keep at least one block per pool to avoid allocation churn */
+    struct darray *pool = block->pool;
+    if (!block->ranges.nb_allocations && ngli_darray_count(pool) > 1) {
+        struct vkmemory_block **blocks = ngli_darray_data(pool);
+        for (size_t i = 0; i < ngli_darray_count(pool); i++) {
+            if (blocks[i] == block) {
+                ngli_darray_remove(pool, i);
+                break;
+            }
+        }
+        destroy_block(vk, block);
+    }
+
+    memset(alloc, 0, sizeof(*alloc));
+}
+
+void ngli_vkmemory_reset(struct vkcontext *vk)
+{
+    struct vkmemory *s = &vk->memory;
+
+    for (uint32_t i = 0; i < VK_MAX_MEMORY_TYPES; i++) {
+        for (size_t j = 0; j < NGLI_VKMEMORY_RESOURCE_NB; j++) {
+            struct darray *pool = &s->pools[i][j];
+            struct vkmemory_block **blocks = ngli_darray_data(pool);
+            for (size_t k = 0; k < ngli_darray_count(pool); k++) {
+                if (blocks[k]->ranges.nb_allocations)
+                    LOG(WARNING, "releasing memory block with %zu live allocations",
+                        blocks[k]->ranges.nb_allocations);
+                destroy_block(vk, blocks[k]);
+            }
+            ngli_darray_reset(pool);
+        }
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef VKMEMORY_H
+#define VKMEMORY_H
+
+#include <stdlib.h>
+#include <vulkan/vulkan.h>
+
+#include "darray.h"
+
+struct vkcontext;
+struct vkmemory_block;
+
+enum {
+    NGLI_VKMEMORY_RESOURCE_LINEAR,  /* buffers and linear images */
+    NGLI_VKMEMORY_RESOURCE_OPTIMAL, /* images with an optimal tiling */
+    NGLI_VKMEMORY_RESOURCE_NB
+};
+
+/*
+ * Range of device memory handed out by the allocator. Resources must be bound
+ * at (memory, offset); mapped is non-NULL if the memory is host visible and
+ * points to the start of the range.
+ */
+struct vkmemory_alloc {
+    VkDeviceMemory memory;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    void *mapped;
+    struct vkmemory_block *block; /* NULL for a dedicated allocation */
+};
+
+struct vkmemory_stats {
+    size_t nb_device_memories; /* VkDeviceMemory objects currently allocated */
+    size_t nb_allocations;     /* live ranges handed out by the allocator */
+    size_t allocated;          /* bytes of device memory allocated */
+    size_t used;               /* bytes of device memory bound to resources */
+};
+
+/*
+ * Device memory sub-allocator: resources are placed into large blocks
+ * allocated per memory type and resource type (linear and optimal resources
+ * never share a block so the bufferImageGranularity constraint never applies).
+ * The ranges of each block are handed out by a first-fit range allocator.
+ * Large requests, lazily allocated memory and resources preferring or
+ * requiring it get a dedicated allocation.
+ */
+struct vkmemory {
+    VkDeviceSize block_sizes[VK_MAX_MEMORY_TYPES];
+    struct darray pools[VK_MAX_MEMORY_TYPES][NGLI_VKMEMORY_RESOURCE_NB]; /* struct vkmemory_block * */
+    struct vkmemory_stats stats;
+};
+
+void ngli_vkmemory_init(struct vkcontext *vk);
+/*
+ * dedicated_info must be set (with the resource the memory is allocated for)
+ * when the driver reports that the resource prefers or requires a dedicated
+ * allocation (VkMemoryDedicatedRequirements)
+ */
+VkResult ngli_vkmemory_alloc(struct vkcontext *vk, const VkMemoryRequirements *reqs,
+                             const VkMemoryDedicatedAllocateInfo *dedicated_info,
+                             uint32_t mem_type_index, int resource_type, struct vkmemory_alloc *alloc);
+void ngli_vkmemory_free(struct vkcontext *vk, struct vkmemory_alloc *alloc);
+void ngli_vkmemory_reset(struct vkcontext *vk);
+
+#endif
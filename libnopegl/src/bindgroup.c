@@ -104,7 +104,10 @@ static void bindgroup_freep(struct bindgroup **sp)
     if (!*sp)
         return;
 
-    (*sp)->gpu_ctx->cls->bindgroup_freep(sp);
+    struct gpu_ctx *gpu_ctx = (*sp)->gpu_ctx;
+    if (gpu_ctx->bindgroup == *sp)
+        ngli_gpu_ctx_invalidate_state(gpu_ctx, NGLI_GPU_STATE_BINDGROUP);
+    gpu_ctx->cls->bindgroup_freep(sp);
 }
 
 struct bindgroup *ngli_bindgroup_create(struct gpu_ctx *gpu_ctx)
@@ -150,6 +153,9 @@ int ngli_bindgroup_update_texture(struct bindgroup *s, int32_t index, const stru
         }
     }
 
+    if (s->gpu_ctx->bindgroup == s)
+        ngli_gpu_ctx_invalidate_state(s->gpu_ctx, NGLI_GPU_STATE_BINDGROUP);
+
     return s->gpu_ctx->cls->bindgroup_update_texture(s, index, binding);
 }
 
@@ -186,6 +192,9 @@ int ngli_bindgroup_update_buffer(struct bindgroup *s, int32_t index, const struc
         }
     }
 
+    if (s->gpu_ctx->bindgroup == s)
+        ngli_gpu_ctx_invalidate_state(s->gpu_ctx, NGLI_GPU_STATE_BINDGROUP);
+
     return s->gpu_ctx->cls->bindgroup_update_buffer(s, index, binding);
 }
 
@@ -30,7 +30,10 @@ static void buffer_freep(struct buffer **sp)
     if (!*sp)
         return;
 
-    (*sp)->gpu_ctx->cls->buffer_freep(sp);
+    /* The buffer may still be tracked as a bound vertex or index buffer */
+    struct gpu_ctx *gpu_ctx = (*sp)->gpu_ctx;
+    ngli_gpu_ctx_invalidate_state(gpu_ctx, NGLI_GPU_STATE_VERTEX_BUFFERS | NGLI_GPU_STATE_INDEX_BUFFER);
+    gpu_ctx->cls->buffer_freep(sp);
 }
 
 struct buffer *ngli_buffer_create(struct gpu_ctx *gpu_ctx)
@@ -38,6 +38,7 @@ enum {
     NGLI_BUFFER_USAGE_VERTEX_BUFFER_BIT  = 1 << 6,
     NGLI_BUFFER_USAGE_MAP_READ           = 1 << 7,
     NGLI_BUFFER_USAGE_MAP_WRITE          = 1 << 8,
+    NGLI_BUFFER_USAGE_MAP_PERSISTENT     = 1 << 9,
     NGLI_BUFFER_USAGE_NB
 };
 
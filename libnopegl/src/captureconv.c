@@ -0,0 +1,199 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "captureconv.h"
+#include "colorconv.h"
+#include "gpu_ctx.h"
+#include "image.h"
+#include "internal.h"
+#include "log.h"
+#include "pgcraft.h"
+#include "pipeline_compat.h"
+#include "topology.h"
+#include "type.h"
+#include "utils.h"
+
+/* GLSL fragments as string */
+#include "captureconv_frag.h"
+#include "captureconv_vert.h"
+
+static const int colorspace_map[] = {
+    [NGL_CAPTURE_COLORSPACE_BT709]  = NMD_COL_SPC_BT709,
+    [NGL_CAPTURE_COLORSPACE_BT601]  = NMD_COL_SPC_SMPTE170M,
+    [NGL_CAPTURE_COLORSPACE_BT2020] = NMD_COL_SPC_BT2020_NCL,
+};
+
+int ngli_captureconv_init(struct captureconv *s, struct ngl_ctx *ctx)
+{
+    struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
+    const struct ngl_config *config = &ctx->config;
+    s->ctx = ctx;
+
+    struct rendertarget *rt = ngli_gpu_ctx_get_capture_rendertarget(gpu_ctx);
+    if (!rt) {
+        LOG(ERROR, "backend does not support YUV capture formats");
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    const struct pgcraft_uniform uniforms[] = {
+        {.name = "color_matrix", .type = NGLI_TYPE_MAT4,  .stage = NGLI_PROGRAM_SHADER_FRAG, .data = NULL},
+        {.name = "size",         .type = NGLI_TYPE_IVEC2, .stage = NGLI_PROGRAM_SHADER_FRAG, .data = NULL},
+        {.name = "flip",         .type = NGLI_TYPE_BOOL,  .stage = NGLI_PROGRAM_SHADER_FRAG, .data = NULL},
+        {.name = "planar",       .type = NGLI_TYPE_BOOL,  .stage = NGLI_PROGRAM_SHADER_FRAG, .data = NULL},
+        {.name = "sample_size",  .type = NGLI_TYPE_I32,   .stage = NGLI_PROGRAM_SHADER_FRAG, .data = NULL},
+    };
+
+    const struct pgcraft_texture textures[] = {
+        {
+            .name      = "tex",
+            .type      = NGLI_PGCRAFT_SHADER_TEX_TYPE_2D,
+            .stage     = NGLI_PROGRAM_SHADER_FRAG,
+            .precision = NGLI_PRECISION_HIGH,
+        },
+    };
+
+    const struct pgcraft_params crafter_params = {
+        .program_label    = "nopegl/captureconv",
+        .vert_base        = captureconv_vert,
+        .frag_base        = captureconv_frag,
+        .uniforms         = uniforms,
+        .nb_uniforms      = NGLI_ARRAY_NB(uniforms),
+        .textures         = textures,
+        .nb_textures      = NGLI_ARRAY_NB(textures),
+    };
+
+    s->crafter = ngli_pgcraft_create(ctx);
+    if (!s->crafter)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngli_pgcraft_craft(s->crafter, &crafter_params);
+    if (ret < 0)
+        return ret;
+
+    s->pipeline_compat = ngli_pipeline_compat_create(gpu_ctx);
+    if (!s->pipeline_compat)
+        return NGL_ERROR_MEMORY;
+
+    const struct pipeline_compat_params params = {
+        .type         = NGLI_PIPELINE_TYPE_GRAPHICS,
+        .graphics     = {
+            .topology = NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+            .state    = NGLI_GRAPHICS_STATE_DEFAULTS,
+            .rt_layout    = rt->layout,
+            .vertex_state = ngli_pgcraft_get_vertex_state(s->crafter),
+        },
+        .program      = ngli_pgcraft_get_program(s->crafter),
+        .layout       = ngli_pgcraft_get_pipeline_layout(s->crafter),
+        .resources    = ngli_pgcraft_get_pipeline_resources(s->crafter),
+        .compat_info  = ngli_pgcraft_get_compat_info(s->crafter),
+    };
+
+    ret = ngli_pipeline_compat_init(s->pipeline_compat, &params);
+    if (ret < 0)
+        return ret;
+
+    const struct darray *texture_infos_array = ngli_pgcraft_get_texture_infos(s->crafter);
+    ngli_assert(ngli_darray_count(texture_infos_array) == 1);
+    const struct pgcraft_texture_info *info = ngli_darray_data(texture_infos_array);
+    s->tex_index = info->fields[NGLI_INFO_FIELD_SAMPLER_0].index;
+
+    /* The conversion parameters are constant for the lifetime of the context */
+    const struct color_info color_info = {
+        .space = colorspace_map[config->capture_colorspace],
+        .range = NMD_COL_RNG_LIMITED,
+    };
+
+    /* P010 samples are computed as 10-bit values */
+    const int p010 = config->capture_format == NGL_CAPTURE_FORMAT_P010;
+    const float scale = p010 ? 255.f * 4.f / 1023.f : 1.f;
+    NGLI_ALIGNED_MAT(color_matrix);
+    ngli_colorconv_get_rgb_to_ycbcr_color_matrix(color_matrix, &color_info, scale);
+
+    /* Rendertarget textures sampled with a flipped uvcoord matrix are stored bottom-up */
+    NGLI_ALIGNED_MAT(uvcoord_matrix);
+    ngli_gpu_ctx_get_rendertarget_uvcoord_matrix(gpu_ctx, uvcoord_matrix);
+    const int flip = uvcoord_matrix[5] < 0.f;
+
+    const int32_t size[2] = {config->width, config->height};
+    const int planar = config->capture_format == NGL_CAPTURE_FORMAT_I420;
+    const int32_t sample_size = p010 ? 2 : 1;
+
+    const struct {
+        const char *name;
+        const void *value;
+    } values[] = {
+        {"color_matrix", color_matrix},
+        {"size",         size},
+        {"flip",         &flip},
+        {"planar",       &planar},
+        {"sample_size",  &sample_size},
+    };
+    for (size_t i = 0; i < NGLI_ARRAY_NB(values); i++) {
+        const int32_t index = ngli_pgcraft_get_uniform_index(s->crafter, values[i].name, NGLI_PROGRAM_SHADER_FRAG);
+        ret = ngli_pipeline_compat_update_uniform(s->pipeline_compat, index, values[i].value);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+int ngli_captureconv_convert(struct captureconv *s, struct texture *texture)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
+
+    int ret = ngli_pipeline_compat_update_texture(s->pipeline_compat, s->tex_index, texture);
+    if (ret < 0)
+        return ret;
+
+    struct rendertarget *rt = ngli_gpu_ctx_get_capture_rendertarget(gpu_ctx);
+    ngli_gpu_ctx_begin_render_pass(gpu_ctx, rt);
+
+    const struct viewport prev_vp = ngli_gpu_ctx_get_viewport(gpu_ctx);
+    const struct scissor prev_scissor = ngli_gpu_ctx_get_scissor(gpu_ctx);
+
+    const struct viewport vp = {0, 0, rt->params.width, rt->params.height};
+    const struct scissor scissor = {0, 0, rt->params.width, rt->params.height};
+    ngli_gpu_ctx_set_viewport(gpu_ctx, &vp);
+    ngli_gpu_ctx_set_scissor(gpu_ctx, &scissor);
+
+    ngli_pipeline_compat_draw(s->pipeline_compat, 3, 1);
+
+    ngli_gpu_ctx_end_render_pass(gpu_ctx);
+    ngli_gpu_ctx_set_viewport(gpu_ctx, &prev_vp);
+    ngli_gpu_ctx_set_scissor(gpu_ctx, &prev_scissor);
+
+    return 0;
+}
+
+void ngli_captureconv_reset(struct captureconv *s)
+{
+    if (!s->ctx)
+        return;
+
+    ngli_pipeline_compat_freep(&s->pipeline_compat);
+    ngli_pgcraft_freep(&s->crafter);
+
+    memset(s, 0, sizeof(*s));
+}
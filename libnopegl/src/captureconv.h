@@ -0,0 +1,42 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CAPTURECONV_H
+#define CAPTURECONV_H
+
+#include "pgcraft.h"
+#include "pipeline_compat.h"
+#include "texture.h"
+
+struct ngl_ctx;
+
+struct captureconv {
+    struct ngl_ctx *ctx;
+    struct pgcraft *crafter;
+    struct pipeline_compat *pipeline_compat;
+    int32_t tex_index;
+};
+
+int ngli_captureconv_init(struct captureconv *s, struct ngl_ctx *ctx);
+int ngli_captureconv_convert(struct captureconv *s, struct texture *texture);
+void ngli_captureconv_reset(struct captureconv *s);
+
+#endif
@@ -155,6 +155,44 @@ int ngli_colorconv_get_ycbcr_to_rgb_color_matrix(float *dst, const struct color_
     return 0;
 }
 
+int ngli_colorconv_get_rgb_to_ycbcr_color_matrix(float *dst, const struct color_info *info, float scale)
+{
+    const int colormatrix = get_colormatrix_from_nopemd(info->space);
+    const int video_range = info->range != NMD_COL_RNG_FULL;
+    const struct range_info range = range_infos[video_range];
+    const struct k_constants k = k_constants_infos[colormatrix];
+
+    const float y_scale  = range.y / 255.f * scale;
+    const float cb_scale = range.uv / (255.f * 2 * (1.f - k.b)) * scale;
+    const float cr_scale = range.uv / (255.f * 2 * (1.f - k.r)) * scale;
+
+    /* R factor */
+    dst[ 0 /* Y  */] = y_scale * k.r;
+    dst[ 1 /* Cb */] = -cb_scale * k.r;
+    dst[ 2 /* Cr */] = cr_scale * (1.f - k.r);
+    dst[ 3 /* A  */] = 0;
+
+    /* G factor */
+    dst[ 4 /* Y  */] = y_scale * k.g;
+    dst[ 5 /* Cb */] = -cb_scale * k.g;
+    dst[ 6 /* Cr */] = -cr_scale * k.g;
+    dst[ 7 /* A  */] = 0;
+
+    /* B factor */
+    dst[ 8 /* Y  */] = y_scale * k.b;
+    dst[ 9 /* Cb */] = cb_scale * (1.f - k.b);
+    dst[10 /* Cr */] = -cr_scale * k.b;
+    dst[11 /* A  */] = 0;
+
+    /* Offset */
+    dst[12 /* Y  */] = range.y_off / 255.f * scale;
+    dst[13 /* Cb */] = 128 / 255.f * scale;
+    dst[14 /* Cr */] = 128 / 255.f * scale;
+    dst[15 /* A  */] = 1;
+
+    return 0;
+}
+
 const struct param_choices ngli_colorconv_colorspace_choices = {
     .name = "colorspace",
     .consts = {
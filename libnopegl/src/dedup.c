@@ -0,0 +1,393 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "hmap.h"
+#include "internal.h"
+#include "log.h"
+#include "nopegl.h"
+#include "params.h"
+
+extern const struct node_param ngli_base_node_params[];
+extern const struct param_specs ngli_params_specs[];
+
+struct dedup_ctx {
+    struct hmap *canonicals; /* node address -> node it is merged into (or itself) */
+    struct hmap *hashes;     /* node hash -> first node seen with this hash */
+    struct hmap *merged;     /* merged node address -> node it is merged into */
+    size_t nb_nodes;
+    size_t size;
+};
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME  0x100000001b3ULL
+
+static uint64_t hash_mem(uint64_t h, const void *data, size_t size)
+{
+    const uint8_t *p = data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+static uint64_t hash_str(uint64_t h, const char *s)
+{
+    return s ? hash_mem(h, s, strlen(s) + 1) : hash_mem(h, "", 0);
+}
+
+static struct ngl_node *get_canonical(const struct dedup_ctx *s, const struct ngl_node *node)
+{
+    char key[32];
+    (void)snprintf(key, sizeof(key), "%p", node);
+    return ngli_hmap_get(s->canonicals, key);
+}
+
+static int set_canonical(struct dedup_ctx *s, struct ngl_node *node, struct ngl_node *canonical)
+{
+    char key[32];
+    (void)snprintf(key, sizeof(key), "%p", node);
+    int ret = ngli_hmap_set(s->canonicals, key, canonical);
+    if (ret < 0)
+        return ret;
+    return canonical != node ? ngli_hmap_set(s->merged, key, canonical) : 0;
+}
+
+/*
+ * The children are always deduplicated before their parent, so the slots of
+ * the parent are compared through the nodes their children are merged into
+ */
+static const struct ngl_node *get_slot_canonical(const struct dedup_ctx *s, const struct ngl_node *node)
+{
+    if (!node)
+        return NULL;
+    const struct ngl_node *canonical = get_canonical(s, node);
+    return canonical ? canonical : node;
+}
+
+static int dedup_node(struct dedup_ctx *s, struct ngl_node *node, struct ngl_node **canonicalp);
+
+static int dedup_slot(struct dedup_ctx *s, struct ngl_node *node)
+{
+    if (!node)
+        return 0;
+    struct ngl_node *canonical;
+    return dedup_node(s, node, &canonical);
+}
+
+static int dedup_children(struct dedup_ctx *s, const uint8_t *base_ptr, const struct node_param *par)
+{
+    if (!par)
+        return 0;
+
+    for (; par->key; par++) {
+        const uint8_t *parp = base_ptr + par->offset;
+        int ret = 0;
+
+        if (par->type == NGLI_PARAM_TYPE_NODE || (par->flags & NGLI_PARAM_FLAG_ALLOW_NODE)) {
+            ret = dedup_slot(s, *(struct ngl_node **)parp);
+        } else if (par->type == NGLI_PARAM_TYPE_NODELIST) {
+            struct ngl_node **elems = *(struct ngl_node ***)parp;
+            const size_t nb_elems = *(size_t *)(parp + sizeof(struct ngl_node **));
+            for (size_t i = 0; i < nb_elems && ret >= 0; i++)
+                ret = dedup_slot(s, elems[i]);
+        } else if (par->type == NGLI_PARAM_TYPE_NODEDICT) {
+            const struct hmap *hmap = *(struct hmap **)parp;
+            if (!hmap)
+                continue;
+            const struct hmap_entry *entry = NULL;
+            while (ret >= 0 && (entry = ngli_hmap_next(hmap, entry)))
+                ret = dedup_slot(s, entry->data);
+        }
+
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+static int is_mergeable(const struct ngl_node *node)
+{
+    if (!(node->cls->flags & NGLI_NODE_FLAG_MERGEABLE) || node->ctx)
+        return 0;
+
+    /* Textures without a data source are written by the graph (render targets, compute outputs) */
+    if (node->cls->category == NGLI_NODE_CATEGORY_TEXTURE) {
+        const struct texture_opts *o = node->opts;
+        return o->data_src != NULL;
+    }
+
+    return 1;
+}
+
+/*
+ * Hash and compare the parameters of the nodes; the children are compared by
+ * the address of the node they are merged into since they have already been
+ * deduplicated at this point, and the label is ignored since it has no effect
+ * on the rendering.
+ */
+static uint64_t hash_node(const struct dedup_ctx *s, uint64_t h, const struct ngl_node *node)
+{
+    const struct ngl_node *canonical = get_slot_canonical(s, node);
+    return hash_mem(h, &canonical, sizeof(canonical));
+}
+
+static uint64_t hash_params(const struct dedup_ctx *s, uint64_t h, const uint8_t *base_ptr,
+                            const struct node_param *par, size_t *sizep)
+{
+    for (; par->key; par++) {
+        const uint8_t *parp = base_ptr + par->offset;
+
+        if (par->flags & NGLI_PARAM_FLAG_ALLOW_NODE) {
+            h = hash_node(s, h, *(const struct ngl_node **)parp);
+            parp += sizeof(struct ngl_node *);
+        }
+
+        switch (par->type) {
+        case NGLI_PARAM_TYPE_NODE:
+            h = hash_node(s, h, *(const struct ngl_node **)parp);
+            break;
+        case NGLI_PARAM_TYPE_STR: {
+            const char *str = *(const char **)parp;
+            h = hash_str(h, str);
+            *sizep += str ? strlen(str) : 0;
+            break;
+        }
+        case NGLI_PARAM_TYPE_DATA: {
+            const uint8_t *data = *(const uint8_t **)parp;
+            const size_t size = *(const size_t *)(parp + sizeof(uint8_t *));
+            h = hash_mem(h, &size, sizeof(size));
+            h = hash_mem(h, data, size);
+            *sizep += size;
+            break;
+        }
+        case NGLI_PARAM_TYPE_NODELIST: {
+            struct ngl_node * const *elems = *(struct ngl_node ***)parp;
+            const size_t nb_elems = *(const size_t *)(parp + sizeof(struct ngl_node **));
+            h = hash_mem(h, &nb_elems, sizeof(nb_elems));
+            for (size_t i = 0; i < nb_elems; i++)
+                h = hash_node(s, h, elems[i]);
+            break;
+        }
+        case NGLI_PARAM_TYPE_F64LIST: {
+            const double *elems = *(const double **)parp;
+            const size_t nb_elems = *(const size_t *)(parp + sizeof(double *));
+            h = hash_mem(h, &nb_elems, sizeof(nb_elems));
+            h = hash_mem(h, elems, nb_elems * sizeof(*elems));
+            break;
+        }
+        case NGLI_PARAM_TYPE_NODEDICT: {
+            const struct hmap *hmap = *(const struct hmap **)parp;
+            const size_t count = hmap ? ngli_hmap_count(hmap) : 0;
+            h = hash_mem(h, &count, sizeof(count));
+            /* The entries are summed so that the hash does not depend on the insertion order */
+            uint64_t entries_h = 0;
+            const struct hmap_entry *entry = NULL;
+            while (hmap && (entry = ngli_hmap_next(hmap, entry))) {
+                const uint64_t entry_h = hash_str(FNV_OFFSET, entry->key);
+                entries_h += hash_node(s, entry_h, entry->data);
+            }
+            h = hash_mem(h, &entries_h, sizeof(entries_h));
+            break;
+        }
+        default:
+            h = hash_mem(h, parp, ngli_params_specs[par->type].size);
+            break;
+        }
+    }
+    return h;
+}
+
+static int nodes_equal(const struct dedup_ctx *s, const struct ngl_node *node0, const struct ngl_node *node1)
+{
+    return get_slot_canonical(s, node0) == get_slot_canonical(s, node1);
+}
+
+static int params_equal(const struct dedup_ctx *s, const uint8_t *base_ptr0, const uint8_t *base_ptr1,
+                        const struct node_param *par)
+{
+    for (; par->key; par++) {
+        const uint8_t *parp0 = base_ptr0 + par->offset;
+        const uint8_t *parp1 = base_ptr1 + par->offset;
+
+        if (par->flags & NGLI_PARAM_FLAG_ALLOW_NODE) {
+            if (!nodes_equal(s, *(const struct ngl_node **)parp0, *(const struct ngl_node **)parp1))
+                return 0;
+            parp0 += sizeof(struct ngl_node *);
+            parp1 += sizeof(struct ngl_node *);
+        }
+
+        switch (par->type) {
+        case NGLI_PARAM_TYPE_NODE:
+            if (!nodes_equal(s, *(const struct ngl_node **)parp0, *(const struct ngl_node **)parp1))
+                return 0;
+            break;
+        case NGLI_PARAM_TYPE_STR: {
+            const char *str0 = *(const char **)parp0;
+            const char *str1 = *(const char **)parp1;
+            if (!str0 != !str1 || (str0 && strcmp(str0, str1)))
+                return 0;
+            break;
+        }
+        case NGLI_PARAM_TYPE_NODELIST: {
+            struct ngl_node * const *elems0 = *(struct ngl_node ***)parp0;
+            struct ngl_node * const *elems1 = *(struct ngl_node ***)parp1;
+            const size_t nb_elems0 = *(const size_t *)(parp0 + sizeof(struct ngl_node **));
+            const size_t nb_elems1 = *(const size_t *)(parp1 + sizeof(struct ngl_node **));
+            if (nb_elems0 != nb_elems1)
+                return 0;
+            for (size_t i = 0; i < nb_elems0; i++)
+                if (!nodes_equal(s, elems0[i], elems1[i]))
+                    return 0;
+            break;
+        }
+        case NGLI_PARAM_TYPE_DATA:
+        case NGLI_PARAM_TYPE_F64LIST: {
+            const uint8_t *elems0 = *(const uint8_t **)parp0;
+            const uint8_t *elems1 = *(const uint8_t **)parp1;
+            const size_t nb_elems0 = *(const size_t *)(parp0 + sizeof(uint8_t *));
+            const size_t nb_elems1 = *(const size_t *)(parp1 + sizeof(uint8_t *));
+            const size_t elem_size = par->type == NGLI_PARAM_TYPE_DATA ? 1 : sizeof(double);
+            if (nb_elems0 != nb_elems1 || (nb_elems0 && memcmp(elems0, elems1, nb_elems0 * elem_size)))
+                return 0;
+            break;
+        }
+        case NGLI_PARAM_TYPE_NODEDICT: {
+            const struct hmap *hmap0 = *(const struct hmap **)parp0;
+            const struct hmap *hmap1 = *(const struct hmap **)parp1;
+            const size_t count0 = hmap0 ? ngli_hmap_count(hmap0) : 0;
+            const size_t count1 = hmap1 ? ngli_hmap_count(hmap1) : 0;
+            if (count0 != count1)
+                return 0;
+            const struct hmap_entry *entry = NULL;
+            while (hmap0 && (entry = ngli_hmap_next(hmap0, entry))) {
+                const struct ngl_node *node1 = ngli_hmap_get(hmap1, entry->key);
+                if (!node1 || !nodes_equal(s, entry->data, node1))
+                    return 0;
+            }
+            break;
+        }
+        default:
+            if (memcmp(parp0, parp1, ngli_params_specs[par->type].size))
+                return 0;
+            break;
+        }
+    }
+    return 1;
+}
+
+static int merge_node(struct dedup_ctx *s, struct ngl_node *node, struct ngl_node **canonicalp)
+{
+    size_t size = 0;
+    uint64_t h = hash_mem(FNV_OFFSET, &node->cls->id, sizeof(node->cls->id));
+    if (node->cls->params)
+        h = hash_params(s, h, node->opts, node->cls->params, &size);
+
+    char key[32];
+    (void)snprintf(key, sizeof(key), "%016" PRIx64, h);
+    struct ngl_node *candidate = ngli_hmap_get(s->hashes, key);
+    if (!candidate) {
+        *canonicalp = node;
+        return ngli_hmap_set(s->hashes, key, node);
+    }
+
+    /* A hash collision (which is unlikely) only prevents the merge */
+    if (candidate->cls != node->cls ||
+        (node->cls->params && !params_equal(s, candidate->opts, node->opts, node->cls->params))) {
+        *canonicalp = node;
+        return 0;
+    }
+
+    LOG(DEBUG, "merging %s into %s", node->label, candidate->label);
+    s->nb_nodes++;
+    s->size += size;
+    *canonicalp = candidate;
+    return 0;
+}
+
+static int dedup_node(struct dedup_ctx *s, struct ngl_node *node, struct ngl_node **canonicalp)
+{
+    struct ngl_node *canonical = get_canonical(s, node);
+    if (canonical) {
+        *canonicalp = canonical;
+        return 0;
+    }
+
+    int ret;
+    if ((ret = dedup_children(s, node->opts, node->cls->params)) < 0 ||
+        (ret = dedup_children(s, (const uint8_t *)node, ngli_base_node_params)) < 0)
+        return ret;
+
+    canonical = node;
+    if (is_mergeable(node) && (ret = merge_node(s, node, &canonical)) < 0)
+        return ret;
+
+    ret = set_canonical(s, node, canonical);
+    if (ret < 0)
+        return ret;
+
+    *canonicalp = canonical;
+    return 0;
+}
+
+/*
+ * Find the structurally identical nodes of the scene without modifying it:
+ * every merged node is stored in the merged map (indexed by its address) along
+ * with the node it is merged into
+ */
+int ngli_scene_dedup(const struct ngl_scene *scene, struct hmap *merged, size_t *nb_nodesp, size_t *sizep)
+{
+    *nb_nodesp = 0;
+    *sizep = 0;
+
+    struct ngl_node *root = scene->params.root;
+    if (!root)
+        return 0;
+
+    struct dedup_ctx s = {
+        .canonicals = ngli_hmap_create(),
+        .hashes     = ngli_hmap_create(),
+        .merged     = merged,
+    };
+
+    int ret = NGL_ERROR_MEMORY;
+    if (!s.canonicals || !s.hashes)
+        goto end;
+
+    struct ngl_node *canonical;
+    ret = dedup_node(&s, root, &canonical);
+    if (ret < 0)
+        goto end;
+    ngli_assert(canonical == root);
+
+    *nb_nodesp = s.nb_nodes;
+    *sizep = s.size;
+
+end:
+    ngli_hmap_freep(&s.canonicals);
+    ngli_hmap_freep(&s.hashes);
+    return ret;
+}
@@ -648,3 +648,335 @@ end:
     ngli_free(sstart);
     return ret;
 }
+
+struct breader {
+    const uint8_t *p;
+    const uint8_t *end;
+    int error;
+};
+
+static const uint8_t *br_read(struct breader *r, size_t n)
+{
+    if (r->error || n > (size_t)(r->end - r->p)) {
+        r->error = NGL_ERROR_INVALID_DATA;
+        return NULL;
+    }
+    const uint8_t *p = r->p;
+    r->p += n;
+    return p;
+}
+
+static uint8_t br_u8(struct breader *r)
+{
+    const uint8_t *p = br_read(r, 1);
+    return p ? p[0] : 0;
+}
+
+static uint32_t br_u32(struct breader *r)
+{
+    const uint8_t *p = br_read(r, 4);
+    return p ? (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24 : 0;
+}
+
+static uint64_t br_u64(struct breader *r)
+{
+    const uint64_t lo = br_u32(r);
+    const uint64_t hi = br_u32(r);
+    return lo | hi << 32;
+}
+
+static int32_t br_i32(struct breader *r)
+{
+    return (int32_t)br_u32(r);
+}
+
+static float br_f32(struct breader *r)
+{
+    const union { uint32_t i; float f; } u = {.i = br_u32(r)};
+    return u.f;
+}
+
+static double br_f64(struct breader *r)
+{
+    const union { uint64_t i; double f; } u = {.i = br_u64(r)};
+    return u.f;
+}
+
+/* Return a NUL-terminated copy of a length prefixed string */
+static char *br_str(struct breader *r)
+{
+    const uint32_t len = br_u32(r);
+    const uint8_t *p = br_read(r, len);
+    if (!p)
+        return NULL;
+    char *s = ngli_malloc(len + 1);
+    if (!s) {
+        r->error = NGL_ERROR_MEMORY;
+        return NULL;
+    }
+    memcpy(s, p, len);
+    s[len] = 0;
+    return s;
+}
+
+static struct ngl_node *br_node(struct breader *r, struct darray *nodes_array)
+{
+    const uint32_t id = br_u32(r);
+    if (r->error)
+        return NULL;
+    if (id >= ngli_darray_count(nodes_array)) {
+        r->error = NGL_ERROR_INVALID_DATA;
+        return NULL;
+    }
+    struct ngl_node **nodes = ngli_darray_data(nodes_array);
+    return nodes[id];
+}
+
+static int parse_param_bin(struct breader *r, struct darray *nodes_array, const uint8_t *data, size_t data_size,
+                           uint8_t *dstp, const struct node_param *par)
+{
+    int ret = 0;
+
+    switch (par->type) {
+    case NGLI_PARAM_TYPE_I32:      ret = ngli_params_set_i32(dstp, par, br_i32(r));  break;
+    case NGLI_PARAM_TYPE_U32:      ret = ngli_params_set_u32(dstp, par, br_u32(r));  break;
+    case NGLI_PARAM_TYPE_BOOL:     ret = ngli_params_set_bool(dstp, par, br_i32(r)); break;
+    case NGLI_PARAM_TYPE_F32:      ret = ngli_params_set_f32(dstp, par, br_f32(r));  break;
+    case NGLI_PARAM_TYPE_F64:      ret = ngli_params_set_f64(dstp, par, br_f64(r));  break;
+    case NGLI_PARAM_TYPE_RATIONAL: {
+        const int32_t num = br_i32(r);
+        const int32_t den = br_i32(r);
+        ret = ngli_params_set_rational(dstp, par, num, den);
+        break;
+    }
+    case NGLI_PARAM_TYPE_FLAGS:
+    case NGLI_PARAM_TYPE_SELECT:
+    case NGLI_PARAM_TYPE_STR: {
+        char *s = br_str(r);
+        if (!s)
+            break;
+        if (par->type == NGLI_PARAM_TYPE_FLAGS)
+            ret = ngli_params_set_flags(dstp, par, s);
+        else if (par->type == NGLI_PARAM_TYPE_SELECT)
+            ret = ngli_params_set_select(dstp, par, s);
+        else
+            ret = ngli_params_set_str(dstp, par, s);
+        ngli_free(s);
+        break;
+    }
+    case NGLI_PARAM_TYPE_DATA: {
+        const uint64_t offset = br_u64(r);
+        const uint64_t size = br_u64(r);
+        if (r->error)
+            break;
+        if (offset > data_size || size > data_size - offset)
+            return NGL_ERROR_INVALID_DATA;
+        ret = ngli_params_set_data(dstp, par, (size_t)size, data + offset);
+        break;
+    }
+    case NGLI_PARAM_TYPE_IVEC2:
+    case NGLI_PARAM_TYPE_IVEC3:
+    case NGLI_PARAM_TYPE_IVEC4: {
+        int32_t v[4];
+        for (int i = 0; i < par->type - NGLI_PARAM_TYPE_IVEC2 + 2; i++)
+            v[i] = br_i32(r);
+        ret = par->type == NGLI_PARAM_TYPE_IVEC2 ? ngli_params_set_ivec2(dstp, par, v)
+            : par->type == NGLI_PARAM_TYPE_IVEC3 ? ngli_params_set_ivec3(dstp, par, v)
+            :                                      ngli_params_set_ivec4(dstp, par, v);
+        break;
+    }
+    case NGLI_PARAM_TYPE_UVEC2:
+    case NGLI_PARAM_TYPE_UVEC3:
+    case NGLI_PARAM_TYPE_UVEC4: {
+        uint32_t v[4];
+        for (int i = 0; i < par->type - NGLI_PARAM_TYPE_UVEC2 + 2; i++)
+            v[i] = br_u32(r);
+        ret = par->type == NGLI_PARAM_TYPE_UVEC2 ? ngli_params_set_uvec2(dstp, par, v)
+            : par->type == NGLI_PARAM_TYPE_UVEC3 ? ngli_params_set_uvec3(dstp, par, v)
+            :                                      ngli_params_set_uvec4(dstp, par, v);
+        break;
+    }
+    case NGLI_PARAM_TYPE_VEC2:
+    case NGLI_PARAM_TYPE_VEC3:
+    case NGLI_PARAM_TYPE_VEC4:
+    case NGLI_PARAM_TYPE_MAT4: {
+        float v[16];
+        const int n = par->type == NGLI_PARAM_TYPE_MAT4 ? 16 : par->type - NGLI_PARAM_TYPE_VEC2 + 2;
+        for (int i = 0; i < n; i++)
+            v[i] = br_f32(r);
+        ret = par->type == NGLI_PARAM_TYPE_VEC2 ? ngli_params_set_vec2(dstp, par, v)
+            : par->type == NGLI_PARAM_TYPE_VEC3 ? ngli_params_set_vec3(dstp, par, v)
+            : par->type == NGLI_PARAM_TYPE_VEC4 ? ngli_params_set_vec4(dstp, par, v)
+            :                                     ngli_params_set_mat4(dstp, par, v);
+        break;
+    }
+    case NGLI_PARAM_TYPE_NODE: {
+        struct ngl_node *node = br_node(r, nodes_array);
+        if (node)
+            ret = ngli_params_set_node(dstp, par, node);
+        break;
+    }
+    case NGLI_PARAM_TYPE_NODELIST: {
+        const uint32_t nb_nodes = br_u32(r);
+        for (uint32_t i = 0; i < nb_nodes && !r->error && ret >= 0; i++) {
+            struct ngl_node *node = br_node(r, nodes_array);
+            if (node)
+                ret = ngli_params_add_nodes(dstp, par, 1, &node);
+        }
+        break;
+    }
+    case NGLI_PARAM_TYPE_F64LIST: {
+        const uint32_t nb_elems = br_u32(r);
+        for (uint32_t i = 0; i < nb_elems && !r->error && ret >= 0; i++) {
+            const double v = br_f64(r);
+            ret = ngli_params_add_f64s(dstp, par, 1, &v);
+        }
+        break;
+    }
+    case NGLI_PARAM_TYPE_NODEDICT: {
+        const uint32_t nb_nodes = br_u32(r);
+        for (uint32_t i = 0; i < nb_nodes && !r->error && ret >= 0; i++) {
+            char *key = br_str(r);
+            struct ngl_node *node = br_node(r, nodes_array);
+            if (key && node)
+                ret = ngli_params_set_dict(dstp, par, key, node);
+            ngli_free(key);
+        }
+        break;
+    }
+    default:
+        LOG(ERROR, "cannot deserialize %s: unsupported parameter type", par->key);
+        return NGL_ERROR_INVALID_DATA;
+    }
+
+    return ret < 0 ? ret : r->error;
+}
+
+static int set_node_params_bin(struct breader *r, struct darray *nodes_array,
+                               const uint8_t *data, size_t data_size, struct ngl_node *node)
+{
+    const uint32_t nb_params = br_u32(r);
+    for (uint32_t i = 0; i < nb_params; i++) {
+        char key[UINT8_MAX + 1];
+        const uint8_t key_len = br_u8(r);
+        const uint8_t *key_data = br_read(r, key_len);
+        const uint8_t kind = br_u8(r);
+        if (r->error)
+            return r->error;
+        memcpy(key, key_data, key_len);
+        key[key_len] = 0;
+
+        uint8_t *base_ptr;
+        const struct node_param *par = ngli_node_param_find(node, key, &base_ptr);
+        if (!par)
+            return NGL_ERROR_INVALID_DATA;
+
+        int ret;
+        uint8_t *dstp = base_ptr + par->offset;
+        if (kind == NGLI_SCENE_BIN_NODE_REF && (par->flags & NGLI_PARAM_FLAG_ALLOW_NODE)) {
+            struct ngl_node *src_node = br_node(r, nodes_array);
+            ret = src_node ? ngli_params_set_node(dstp, par, src_node) : r->error;
+        } else if (kind == par->type) {
+            ret = parse_param_bin(r, nodes_array, data, data_size, dstp, par);
+        } else {
+            LOG(ERROR, "mismatching type for parameter %s.%s", node->cls->name, key);
+            ret = NGL_ERROR_INVALID_DATA;
+        }
+        if (ret < 0) {
+            LOG(ERROR, "unable to set node param %s.%s: %s",
+                node->cls->name, key, NGLI_RET_STR(ret));
+            return ret;
+        }
+    }
+    return 0;
+}
+
+int ngli_scene_deserialize_binary(struct ngl_scene *s, const uint8_t *data, size_t size)
+{
+    struct breader r = {.p = data, .end = data + size};
+    struct ngl_scene_params params = ngl_scene_default_params(NULL);
+
+    const uint8_t *magic = br_read(&r, 4);
+    if (!magic || memcmp(magic, NGLI_SCENE_BIN_MAGIC, 4)) {
+        LOG(ERROR, "invalid binary serialized scene");
+        return NGL_ERROR_INVALID_DATA;
+    }
+
+    const uint32_t version = br_u32(&r);
+    const uint32_t ngl_version = br_u32(&r);
+    const uint32_t nb_nodes = br_u32(&r);
+    params.duration = br_f64(&r);
+    params.framerate[0] = br_i32(&r);
+    params.framerate[1] = br_i32(&r);
+    params.aspect_ratio[0] = br_i32(&r);
+    params.aspect_ratio[1] = br_i32(&r);
+    const uint64_t nodes_offset = br_u64(&r);
+    const uint64_t nodes_size = br_u64(&r);
+    const uint64_t data_offset = br_u64(&r);
+    if (r.error ||
+        nodes_offset > size || nodes_size > size - nodes_offset ||
+        data_offset > size || data_offset < nodes_offset + nodes_size) {
+        LOG(ERROR, "invalid binary serialized scene header");
+        return NGL_ERROR_INVALID_DATA;
+    }
+    if (version != NGLI_SCENE_BIN_VERSION) {
+        LOG(ERROR, "unsupported binary scene format version %u", version);
+        return NGL_ERROR_UNSUPPORTED;
+    }
+    if (ngl_version != NGL_VERSION_INT) {
+        LOG(ERROR, "mismatching version: %d.%d.%d != %d.%d.%d",
+            ngl_version >> 16, ngl_version >> 8 & 0xff, ngl_version & 0xff,
+            NGL_VERSION_MAJOR, NGL_VERSION_MINOR, NGL_VERSION_MICRO);
+        return NGL_ERROR_INVALID_DATA;
+    }
+    if (!nb_nodes) {
+        LOG(ERROR, "binary serialized scene has no root node");
+        return NGL_ERROR_INVALID_DATA;
+    }
+
+    int ret = 0;
+    struct ngl_node *node = NULL;
+    struct darray nodes_array;
+    ngli_darray_init(&nodes_array, sizeof(struct ngl_node *), 0);
+
+    r.p = data + nodes_offset;
+    r.end = r.p + nodes_size;
+    for (uint32_t i = 0; i < nb_nodes; i++) {
+        const uint32_t type = br_u32(&r);
+        if (r.error) {
+            ret = r.error;
+            node = NULL;
+            break;
+        }
+
+        node = ngl_node_create(type);
+        if (!node) {
+            ret = NGL_ERROR_INVALID_DATA;
+            break;
+        }
+
+        if (!ngli_darray_push(&nodes_array, &node)) {
+            ngl_node_unrefp(&node);
+            ret = NGL_ERROR_MEMORY;
+            break;
+        }
+
+        ret = set_node_params_bin(&r, &nodes_array, data + data_offset, size - data_offset, node);
+        if (ret < 0) {
+            node = NULL;
+            break;
+        }
+    }
+
+    if (node) {
+        params.root = node;
+        ret = ngl_scene_init(s, &params);
+    }
+
+    struct ngl_node **nodes = ngli_darray_data(&nodes_array);
+    for (size_t i = 0; i < ngli_darray_count(&nodes_array); i++)
+        ngl_node_unrefp(&nodes[i]);
+    ngli_darray_reset(&nodes_array);
+
+    return ret;
+}
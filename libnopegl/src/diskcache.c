@@ -0,0 +1,266 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "diskcache.h"
+#include "log.h"
+#include "memory.h"
+#include "nopegl.h"
+#include "pthread_compat.h"
+#include "utils.h"
+
+#define DISKCACHE_MAGIC   NGLI_FOURCC('N','G','L','C')
+#define DISKCACHE_VERSION 1
+
+enum {
+    HDR_MAGIC,
+    HDR_VERSION,
+    HDR_IDENTITY_SIZE,
+    HDR_KEY_SIZE,
+    HDR_DATA_SIZE,
+    HDR_DATA_CRC,
+    HDR_NB
+};
+
+struct diskcache {
+    char *dir;
+    char *identity;
+    uint32_t identity_size;
+    uint32_t identity_crc;
+    pthread_mutex_t lock;
+    int lock_initialized;
+    uint32_t tmp_count;
+};
+
+struct diskcache *ngli_diskcache_create(void)
+{
+    struct diskcache *s = ngli_calloc(1, sizeof(*s));
+    return s;
+}
+
+static int make_dir(const char *dir)
+{
+#ifdef _WIN32
+    if (_mkdir(dir) < 0 && errno != EEXIST)
+        return NGL_ERROR_IO;
+#else
+    if (mkdir(dir, 0755) < 0 && errno != EEXIST)
+        return NGL_ERROR_IO;
+#endif
+    return 0;
+}
+
+int ngli_diskcache_init(struct diskcache *s, const char *dir, const char *identity)
+{
+    int ret = make_dir(dir);
+    if (ret < 0) {
+        LOG(ERROR, "unable to create cache directory \"%s\"", dir);
+        return ret;
+    }
+
+    s->dir = ngli_strdup(dir);
+    s->identity = ngli_strdup(identity);
+    if (!s->dir || !s->identity)
+        return NGL_ERROR_MEMORY;
+    s->identity_size = (uint32_t)strlen(identity);
+    s->identity_crc = ngli_crc32(identity);
+
+    if (pthread_mutex_init(&s->lock, NULL))
+        return NGL_ERROR_EXTERNAL;
+    s->lock_initialized = 1;
+
+    return 0;
+}
+
+static char *get_entry_path(const struct diskcache *s, const char *name, const void *key, size_t key_size)
+{
+    const uint32_t key_crc = ngli_crc32_mem(key, key_size);
+    return ngli_asprintf("%s/%s-%08" PRIx32 "%08" PRIx32 ".bin", s->dir, name, s->identity_crc, key_crc);
+}
+
+static int read_entry(struct diskcache *s, FILE *fp, const void *key, size_t key_size,
+                      void **datap, size_t *sizep)
+{
+    uint32_t hdr[HDR_NB];
+    if (fread(hdr, sizeof(hdr), 1, fp) != 1)
+        return NGL_ERROR_INVALID_DATA;
+
+    if (hdr[HDR_MAGIC] != DISKCACHE_MAGIC || hdr[HDR_VERSION] != DISKCACHE_VERSION ||
+        hdr[HDR_IDENTITY_SIZE] != s->identity_size || hdr[HDR_KEY_SIZE] != key_size)
+        return NGL_ERROR_INVALID_DATA;
+
+    const size_t size = hdr[HDR_DATA_SIZE];
+    const size_t check_size = s->identity_size + key_size;
+
+    /* Reject truncated or corrupted entries before trusting the data size */
+    const long pos = ftell(fp);
+    if (pos < 0 || fseek(fp, 0, SEEK_END) < 0)
+        return NGL_ERROR_INVALID_DATA;
+    const long end = ftell(fp);
+    if (end < pos || fseek(fp, pos, SEEK_SET) < 0 ||
+        (size_t)(end - pos) != check_size + size)
+        return NGL_ERROR_INVALID_DATA;
+
+    uint8_t *buf = ngli_malloc(NGLI_MAX(check_size, size) + 1);
+    if (!buf)
+        return NGL_ERROR_MEMORY;
+
+    if (fread(buf, 1, check_size, fp) != check_size ||
+        memcmp(buf, s->identity, s->identity_size) ||
+        memcmp(buf + s->identity_size, key, key_size) ||
+        fread(buf, 1, size, fp) != size ||
+        ngli_crc32_mem(buf, size) != hdr[HDR_DATA_CRC]) {
+        ngli_free(buf);
+        return NGL_ERROR_INVALID_DATA;
+    }
+
+    *datap = buf;
+    *sizep = size;
+    return 0;
+}
+
+int ngli_diskcache_load(struct diskcache *s, const char *name, const void *key, size_t key_size,
+                        void **datap, size_t *sizep)
+{
+    char *path = get_entry_path(s, name, key, key_size);
+    if (!path)
+        return NGL_ERROR_MEMORY;
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        ngli_free(path);
+        return NGL_ERROR_NOT_FOUND;
+    }
+
+    int ret = read_entry(s, fp, key, key_size, datap, sizep);
+    if (ret == NGL_ERROR_INVALID_DATA)
+        LOG(DEBUG, "ignoring mismatching or corrupted cache entry %s", path);
+    fclose(fp);
+    ngli_free(path);
+    return ret;
+}
+
+static int write_entry(const struct diskcache *s, FILE *fp, const void *key, size_t key_size,
+                       const void *data, size_t size)
+{
+    const uint32_t hdr[HDR_NB] = {
+        [HDR_MAGIC]         = DISKCACHE_MAGIC,
+        [HDR_VERSION]       = DISKCACHE_VERSION,
+        [HDR_IDENTITY_SIZE] = s->identity_size,
+        [HDR_KEY_SIZE]      = (uint32_t)key_size,
+        [HDR_DATA_SIZE]     = (uint32_t)size,
+        [HDR_DATA_CRC]      = ngli_crc32_mem(data, size),
+    };
+
+    if (fwrite(hdr, sizeof(hdr), 1, fp) != 1 ||
+        fwrite(s->identity, 1, s->identity_size, fp) != s->identity_size ||
+        fwrite(key, 1, key_size, fp) != key_size ||
+        fwrite(data, 1, size, fp) != size)
+        return NGL_ERROR_IO;
+
+    return 0;
+}
+
+static int rename_file(const char *src, const char *dst)
+{
+#ifdef _WIN32
+    if (!MoveFileExA(src, dst, MOVEFILE_REPLACE_EXISTING))
+        return NGL_ERROR_IO;
+#else
+    if (rename(src, dst) < 0)
+        return NGL_ERROR_IO;
+#endif
+    return 0;
+}
+
+int ngli_diskcache_store(struct diskcache *s, const char *name, const void *key, size_t key_size,
+                         const void *data, size_t size)
+{
+    if (key_size > UINT32_MAX || size > UINT32_MAX)
+        return NGL_ERROR_LIMIT_EXCEEDED;
+
+    char *path = get_entry_path(s, name, key, key_size);
+    if (!path)
+        return NGL_ERROR_MEMORY;
+
+    pthread_mutex_lock(&s->lock);
+    const uint32_t tmp_id = s->tmp_count++;
+    pthread_mutex_unlock(&s->lock);
+
+#ifdef _WIN32
+    const int pid = _getpid();
+#else
+    const int pid = getpid();
+#endif
+    char *tmp_path = ngli_asprintf("%s.%d-%" PRIu32 ".tmp", path, pid, tmp_id);
+    if (!tmp_path) {
+        ngli_free(path);
+        return NGL_ERROR_MEMORY;
+    }
+
+    int ret = 0;
+    FILE *fp = fopen(tmp_path, "wb");
+    if (!fp) {
+        ret = NGL_ERROR_IO;
+        goto end;
+    }
+
+    ret = write_entry(s, fp, key, key_size, data, size);
+    if (fclose(fp) && ret >= 0)
+        ret = NGL_ERROR_IO;
+    if (ret >= 0)
+        ret = rename_file(tmp_path, path);
+    if (ret < 0)
+        remove(tmp_path);
+
+end:
+    if (ret < 0)
+        LOG(WARNING, "unable to write cache entry %s", path);
+    ngli_free(tmp_path);
+    ngli_free(path);
+    return ret;
+}
+
+void ngli_diskcache_freep(struct diskcache **sp)
+{
+    struct diskcache *s = *sp;
+    if (!s)
+        return;
+    if (s->lock_initialized)
+        pthread_mutex_destroy(&s->lock);
+    ngli_freep(&s->identity);
+    ngli_freep(&s->dir);
+    ngli_freep(sp);
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef DISKCACHE_H
+#define DISKCACHE_H
+
+#include <stddef.h>
+
+/*
+ * Persistent key/value store backed by a directory, used to keep compiled
+ * shaders and pipelines across runs. Entries are bound to an identity string
+ * (typically describing the driver and the device) provided at init.
+ *
+ * Each entry is stored in its own file, named after a hash of the identity and
+ * the key; the complete identity and key are also saved in the file and checked
+ * when loading, so a hash collision only results in a cache miss. Entries are
+ * written in a temporary file renamed once complete, so that concurrent
+ * processes sharing the same directory never read partially written entries.
+ */
+struct diskcache;
+
+struct diskcache *ngli_diskcache_create(void);
+int ngli_diskcache_init(struct diskcache *s, const char *dir, const char *identity);
+int ngli_diskcache_load(struct diskcache *s, const char *name, const void *key, size_t key_size,
+                        void **datap, size_t *sizep);
+int ngli_diskcache_store(struct diskcache *s, const char *name, const void *key, size_t key_size,
+                         const void *data, size_t size);
+void ngli_diskcache_freep(struct diskcache **sp);
+
+#endif
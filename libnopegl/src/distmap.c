@@ -41,6 +41,7 @@
 #include "pgcraft.h"
 #include "pipeline_compat.h"
 #include "rendertarget.h"
+#include "skyline.h"
 #include "texture.h"
 #include "topology.h"
 #include "type.h"
@@ -58,6 +59,9 @@ struct bezier3 {
 
 struct shape {
     int32_t width, height;
+    int32_t x, y; // position of the padded shape in the texture
+    int32_t bezier_start, bezier_count;
+    int32_t beziergroup_start, beziergroup_count;
 };
 
 struct distmap {
@@ -65,16 +69,17 @@ struct distmap {
 
     int32_t pad;
     int32_t max_shape_w, max_shape_h;
-    int32_t max_shape_padded_w, max_shape_padded_h;
+    int32_t ref_shape_w, ref_shape_h; // maximum shape dimensions the padding and scale are derived from
     int32_t texture_w, texture_h;
-    int32_t nb_rows, nb_cols;
     float scale;
+    int32_t nb_rendered_shapes;
+    int incremental;
 
     struct darray shapes;              // struct shape
-    struct darray bezier_x;            // struct bezier3
-    struct darray bezier_y;            // struct bezier3
+    struct darray bezier_x;            // struct bezier3, not normalized
+    struct darray bezier_y;            // struct bezier3, not normalized
     struct darray bezier_counts;       // int32_t
-    struct darray beziergroup_counts;  // int32_t
+    struct skyline skyline;
 
     struct texture *texture;
     struct rendertarget *rt;
@@ -86,6 +91,9 @@ struct distmap {
     struct buffer *frag_buffer;
     size_t frag_offset;
     struct pipeline_compat *pipeline_compat;
+    int32_t bezier_max_count;          // capacity of the bezier fields of the frag block
+    int32_t beziergroup_max_count;     // capacity of the bezier counts field of the frag block
+    int32_t buffer_max_count;          // number of shapes the uniform buffers can hold
 };
 
 struct distmap *ngli_distmap_create(struct ngl_ctx *ctx)
@@ -98,7 +106,7 @@ struct distmap *ngli_distmap_create(struct ngl_ctx *ctx)
     ngli_darray_init(&s->bezier_x, sizeof(struct bezier3), 0);
     ngli_darray_init(&s->bezier_y, sizeof(struct bezier3), 0);
     ngli_darray_init(&s->bezier_counts, sizeof(int32_t), 0);
-    ngli_darray_init(&s->beziergroup_counts, sizeof(int32_t), 0);
+    ngli_skyline_init(&s->skyline);
     return s;
 }
 
@@ -133,6 +141,9 @@ int ngli_distmap_add_shape(struct distmap *s, int32_t shape_w, int32_t shape_h,
         return NGL_ERROR_INVALID_ARG;
     }
 
+    const int32_t bezier_start = (int32_t)ngli_darray_count(&s->bezier_x);
+    const int32_t beziergroup_start = (int32_t)ngli_darray_count(&s->bezier_counts);
+
     int32_t nb_beziers = 0, nb_beziergroups = 0;
     const struct darray *segments_array = ngli_path_get_segments(path);
     const struct path_segment *segments = ngli_darray_data(segments_array);
@@ -193,9 +204,15 @@ int ngli_distmap_add_shape(struct distmap *s, int32_t shape_w, int32_t shape_h,
 
     ngli_assert(nb_beziers == 0);
 
-    const struct shape shape = {.width=shape_w, .height=shape_h};
-    if (!ngli_darray_push(&s->shapes, &shape) ||
-        !ngli_darray_push(&s->beziergroup_counts, &nb_beziergroups))
+    const struct shape shape = {
+        .width             = shape_w,
+        .height            = shape_h,
+        .bezier_start      = bezier_start,
+        .bezier_count      = (int32_t)ngli_darray_count(&s->bezier_x) - bezier_start,
+        .beziergroup_start = beziergroup_start,
+        .beziergroup_count = nb_beziergroups,
+    };
+    if (!ngli_darray_push(&s->shapes, &shape))
         return NGL_ERROR_MEMORY;
 
     s->max_shape_w = NGLI_MAX(shape_w, s->max_shape_w);
@@ -205,71 +222,26 @@ int ngli_distmap_add_shape(struct distmap *s, int32_t shape_w, int32_t shape_h,
     return 0;
 }
 
-static int32_t get_beziergroup_start(const struct distmap *s, int32_t shape_id)
-{
-    const int32_t *group_counts = ngli_darray_data(&s->beziergroup_counts);
-    int32_t group_count = 0;
-    for (int32_t i = 0; i < shape_id; i++)
-        group_count += group_counts[i];
-    return group_count;
-}
-
-static int32_t get_beziergroup_end(const struct distmap *s, int32_t shape_id)
-{
-    const int32_t group_start = get_beziergroup_start(s, shape_id);
-    const int32_t *group_counts = ngli_darray_data(&s->beziergroup_counts);
-    return group_start + group_counts[shape_id];
-}
-
-static int32_t get_bezier_start(const struct distmap *s, int32_t shape_id)
-{
-    const int32_t group_start = get_beziergroup_start(s, shape_id);
-    const int32_t *counts = ngli_darray_data(&s->bezier_counts);
-    int32_t start = 0;
-    for (int32_t i = 0; i < group_start; i++)
-        start += abs(counts[i]);
-    return start;
-}
-
-static int32_t get_bezier_end(const struct distmap *s, int32_t shape_id)
-{
-    const int32_t group_end = get_beziergroup_end(s, shape_id);
-    const int32_t *counts = ngli_darray_data(&s->bezier_counts);
-    int32_t end = 0;
-    for (int32_t i = 0; i < group_end; i++)
-        end += abs(counts[i]);
-    return end;
-}
-
 /*
- * Get the maximum number of beziers across all shapes. This is useful to
- * get how large the bezier uniform buffer must be (it will be re-used for
- * each shape).
+ * Get the maximum number of beziers across the shapes starting at shape_start.
+ * This is useful to get how large the bezier uniform buffer must be (it will
+ * be re-used for each shape).
  */
-static int32_t get_max_beziers_per_shape(const struct distmap *s)
+static int32_t get_max_beziers_per_shape(const struct distmap *s, int32_t shape_start)
 {
     int32_t max_beziers = 0;
-    const int32_t *counts = ngli_darray_data(&s->bezier_counts);
-    const int32_t *group_counts = ngli_darray_data(&s->beziergroup_counts);
-    for (size_t i = 0; i < ngli_darray_count(&s->beziergroup_counts); i++) {
-        const int32_t group_count = group_counts[i];
-
-        int32_t sum = 0;
-        for (int32_t j = 0; j < group_count; j++)
-            sum += abs(counts[j]);
-        counts += group_count;
-
-        max_beziers = NGLI_MAX(max_beziers, sum);
-    }
+    const struct shape *shapes = ngli_darray_data(&s->shapes);
+    for (size_t i = shape_start; i < ngli_darray_count(&s->shapes); i++)
+        max_beziers = NGLI_MAX(max_beziers, shapes[i].bezier_count);
     return max_beziers;
 }
 
-static int32_t get_max_beziergroups_per_shape(const struct distmap *s)
+static int32_t get_max_beziergroups_per_shape(const struct distmap *s, int32_t shape_start)
 {
     int32_t max_groups = 0;
-    const int32_t *group_counts = ngli_darray_data(&s->beziergroup_counts);
-    for (size_t i = 0; i < ngli_darray_count(&s->beziergroup_counts); i++)
-        max_groups = NGLI_MAX(max_groups, group_counts[i]);
+    const struct shape *shapes = ngli_darray_data(&s->shapes);
+    for (size_t i = shape_start; i < ngli_darray_count(&s->shapes); i++)
+        max_groups = NGLI_MAX(max_groups, shapes[i].beziergroup_count);
     return max_groups;
 }
 
@@ -286,97 +258,106 @@ enum {
     BEZIERGROUP_COUNT_INDEX,
 };
 
-static void load_buffers_data(struct distmap *s, uint8_t *vert_data, uint8_t *frag_data)
+static struct bezier3 scaled_bezier(struct bezier3 bezier, float scale)
+{
+    bezier.p0 *= scale;
+    bezier.p1 *= scale;
+    bezier.p2 *= scale;
+    bezier.p3 *= scale;
+    return bezier;
+}
+
+static void load_buffers_data(struct distmap *s, int32_t shape_start,
+                              uint8_t *vert_data, uint8_t *frag_data,
+                              struct bezier3 *tmp_bezier_x, struct bezier3 *tmp_bezier_y)
 {
     const int32_t *bezier_counts = ngli_darray_data(&s->bezier_counts);
     const struct bezier3 *bezier_x = ngli_darray_data(&s->bezier_x);
     const struct bezier3 *bezier_y = ngli_darray_data(&s->bezier_y);
 
-    const float qw = 1.f / (float)s->nb_cols;
-    const float qh = 1.f / (float)s->nb_rows;
-
     const int32_t nb_shapes = (int32_t)ngli_darray_count(&s->shapes);
-    int32_t shape_id = 0;
-
-    for (int32_t y = 0; y < s->nb_rows; y++) {
-        for (int32_t x = 0; x < s->nb_cols; x++) {
-            if (shape_id == nb_shapes)
-                return;
-
-            const int32_t beziergroup_start_idx = get_beziergroup_start(s, shape_id);
-            const int32_t beziergroup_end_idx   = get_beziergroup_end(s, shape_id);
-            const int32_t beziergroup_count     = beziergroup_end_idx - beziergroup_start_idx;
-
-            const int32_t bezier_start_idx      = get_bezier_start(s, shape_id);
-            const int32_t bezier_end_idx        = get_bezier_end(s, shape_id);
-            const int32_t bezier_count          = bezier_end_idx - bezier_start_idx;
-
-            const struct shape *shape = ngli_darray_get(&s->shapes, shape_id);
-
-            /*
-             * Defines the quad coordinates of the atlas into which the glyph
-             * distance must be drawn. The geometry respects the proportions of
-             * the shape and is located on a grid of cells of the maximum size.
-             */
-            const int32_t padded_w = 2*s->pad + shape->width + 1;
-            const int32_t padded_h = 2*s->pad + shape->height + 1;
-            const float xr = (float)padded_w / (float)s->max_shape_padded_w;
-            const float yr = (float)padded_h / (float)s->max_shape_padded_h;
-            const float x0 = (float)x * qw;
-            const float y0 = (float)y * qh;
-            const float x1 = x0 + qw * xr;
-            const float y1 = y0 + qh * yr;
-            const float vertices[] = {x0, y0, x1, y1};
-
-            /*
-             * Given p for padding and m for pixel width or height, we have:
-             * x₀ = p      (start of the shape, in pixels, without padding)
-             * x₁ = p + m  (end of the shape, in pixels, without padding)
-             *
-             * If we consider 0 to be the start of the padded shape, and 1 its
-             * width or height (basically the UV of the geometry), we can
-             * identify the boundaries of the shape without padding:
-             *
-             * start = linear(x₀,x₁,0)    = -p/m
-             * end   = linear(x₀,x₁,m+2p) = 1+p/m
-             *
-             * The +0.5 is used to take into account the extra texel used for
-             * safe picking.
-             */
-            const float pad_w = ((float)s->pad + .5f) / (float)shape->width;
-            const float pad_h = ((float)s->pad + .5f) / (float)shape->height;
-            const float coords[] = {-pad_w, -pad_h, 1.f + pad_w, 1.f + pad_h};
-
-            const float scale[] = {(float)shape->width * s->scale, (float)shape->height * s->scale};
-
-            const struct block_field_data vert_data_src[] = {
-                [VERTICES_INDEX] = {.data=vertices},
-            };
-
-            const struct block_field_data frag_data_src[] = {
-                [COORDS_INDEX]            = {.data = coords},
-                [SCALE_INDEX]             = {.data = scale},
-                [BEZIER_X_BUF_INDEX]      = {.data = bezier_x + bezier_start_idx, .count = bezier_count},
-                [BEZIER_Y_BUF_INDEX]      = {.data = bezier_y + bezier_start_idx, .count = bezier_count},
-                [BEZIER_COUNTS_INDEX]     = {.data = bezier_counts + beziergroup_start_idx, .count = beziergroup_count},
-                [BEZIERGROUP_COUNT_INDEX] = {.data = &beziergroup_count},
-            };
-
-            ngli_block_fields_copy(&s->vert_block, vert_data_src, vert_data);
-            vert_data += s->vert_offset;
-            ngli_block_fields_copy(&s->frag_block, frag_data_src, frag_data);
-            frag_data += s->frag_offset;
-
-            shape_id++;
+    for (int32_t shape_id = shape_start; shape_id < nb_shapes; shape_id++) {
+        const struct shape *shape = ngli_darray_get(&s->shapes, shape_id);
+
+        /*
+         * Defines the quad coordinates of the atlas into which the glyph
+         * distance must be drawn. The geometry respects the proportions of
+         * the shape and is located where the packer placed it.
+         */
+        const int32_t padded_w = 2*s->pad + shape->width + 1;
+        const int32_t padded_h = 2*s->pad + shape->height + 1;
+        const float x0 = (float)shape->x / (float)s->texture_w;
+        const float y0 = (float)shape->y / (float)s->texture_h;
+        const float x1 = (float)(shape->x + padded_w) / (float)s->texture_w;
+        const float y1 = (float)(shape->y + padded_h) / (float)s->texture_h;
+        const float vertices[] = {x0, y0, x1, y1};
+
+        /*
+         * Given p for padding and m for pixel width or height, we have:
+         * x₀ = p      (start of the shape, in pixels, without padding)
+         * x₁ = p + m  (end of the shape, in pixels, without padding)
+         *
+         * If we consider 0 to be the start of the padded shape, and 1 its
+         * width or height (basically the UV of the geometry), we can
+         * identify the boundaries of the shape without padding:
+         *
+         * start = linear(x₀,x₁,0)    = -p/m
+         * end   = linear(x₀,x₁,m+2p) = 1+p/m
+         *
+         * The +0.5 is used to take into account the extra texel used for
+         * safe picking.
+         */
+        const float pad_w = ((float)s->pad + .5f) / (float)shape->width;
+        const float pad_h = ((float)s->pad + .5f) / (float)shape->height;
+        const float coords[] = {-pad_w, -pad_h, 1.f + pad_w, 1.f + pad_h};
+
+        const float scale[] = {(float)shape->width * s->scale, (float)shape->height * s->scale};
+
+        /*
+         * We normalize the coordinates with regards to the container shape so
+         * that distances are within [0;1] while remaining proportionnal
+         * against each others. This help making effects consistent accross
+         * all shapes. The original coordinates are kept so that the shapes
+         * can be rendered again if the normalization changes.
+         */
+        for (int32_t i = 0; i < shape->bezier_count; i++) {
+            tmp_bezier_x[i] = scaled_bezier(bezier_x[shape->bezier_start + i], s->scale);
+            tmp_bezier_y[i] = scaled_bezier(bezier_y[shape->bezier_start + i], s->scale);
         }
+
+        const struct block_field_data vert_data_src[] = {
+            [VERTICES_INDEX] = {.data=vertices},
+        };
+
+        const struct block_field_data frag_data_src[] = {
+            [COORDS_INDEX]            = {.data = coords},
+            [SCALE_INDEX]             = {.data = scale},
+            [BEZIER_X_BUF_INDEX]      = {.data = tmp_bezier_x, .count = shape->bezier_count},
+            [BEZIER_Y_BUF_INDEX]      = {.data = tmp_bezier_y, .count = shape->bezier_count},
+            [BEZIER_COUNTS_INDEX]     = {.data = bezier_counts + shape->beziergroup_start, .count = shape->beziergroup_count},
+            [BEZIERGROUP_COUNT_INDEX] = {.data = &shape->beziergroup_count},
+        };
+
+        ngli_block_fields_copy(&s->vert_block, vert_data_src, vert_data);
+        vert_data += s->vert_offset;
+        ngli_block_fields_copy(&s->frag_block, frag_data_src, frag_data);
+        frag_data += s->frag_offset;
     }
 }
 
-static int map_and_load_buffers_data(struct distmap *s)
+static int map_and_load_buffers_data(struct distmap *s, int32_t shape_start)
 {
     uint8_t *vert_data = NULL;
     uint8_t *frag_data = NULL;
 
+    struct bezier3 *tmp_bezier_x = ngli_calloc(s->bezier_max_count, sizeof(*tmp_bezier_x));
+    struct bezier3 *tmp_bezier_y = ngli_calloc(s->bezier_max_count, sizeof(*tmp_bezier_y));
+    if (!tmp_bezier_x || !tmp_bezier_y) {
+        ngli_freep(&tmp_bezier_x);
+        ngli_freep(&tmp_bezier_y);
+        return NGL_ERROR_MEMORY;
+    }
+
     int ret = ngli_buffer_map(s->frag_buffer, 0, s->frag_buffer->size, (void **)&frag_data);
     if (ret < 0)
         goto end;
@@ -385,13 +366,15 @@ static int map_and_load_buffers_data(struct distmap *s)
     if (ret < 0)
         goto end;
 
-    load_buffers_data(s, vert_data, frag_data);
+    load_buffers_data(s, shape_start, vert_data, frag_data, tmp_bezier_x, tmp_bezier_y);
 
 end:
     if (vert_data)
         ngli_buffer_unmap(s->vert_buffer);
     if (frag_data)
         ngli_buffer_unmap(s->frag_buffer);
+    ngli_freep(&tmp_bezier_x);
+    ngli_freep(&tmp_bezier_y);
     return ret;
 }
 
@@ -399,71 +382,58 @@ end:
  * Multiple draw calls (one for each shape) are executed instead of just a big
  * one wrapping them all because the number of beziers in the array can be
  * too large on certain platforms.
+ *
+ * The triangle covering each quad overflows it, so every draw is scissored
+ * to its shape to preserve the other shapes of the atlas.
  */
-static int draw_glyphs(struct distmap *s)
+static int draw_glyphs(struct distmap *s, int32_t shape_start)
 {
-    int ret = map_and_load_buffers_data(s);
+    int ret = map_and_load_buffers_data(s, shape_start);
     if (ret < 0)
         return ret;
 
     ngli_pipeline_compat_update_buffer(s->pipeline_compat, 0, s->vert_buffer, 0, (int)s->vert_offset);
     ngli_pipeline_compat_update_buffer(s->pipeline_compat, 1, s->frag_buffer, 0, (int)s->frag_offset);
 
+    struct gpu_ctx *gpu_ctx = s->ctx->gpu_ctx;
     const int32_t nb_shapes = (int32_t)ngli_darray_count(&s->shapes);
-    int32_t shape_id = 0;
-
-    for (int32_t y = 0; y < s->nb_rows; y++) {
-        for (int32_t x = 0; x < s->nb_cols; x++) {
-            if (shape_id == nb_shapes)
-                return 0;
-
-            const uint32_t offsets[] = {shape_id * (uint32_t)s->vert_offset, shape_id * (uint32_t)s->frag_offset};
-            ret = ngli_pipeline_compat_update_dynamic_offsets(s->pipeline_compat, offsets, NGLI_ARRAY_NB(offsets));
-            if (ret < 0)
-                return ret;
-            ngli_pipeline_compat_draw(s->pipeline_compat, 3, 1);
-            shape_id++;
-        }
+    for (int32_t i = 0; i < nb_shapes - shape_start; i++) {
+        const struct shape *shape = ngli_darray_get(&s->shapes, shape_start + i);
+        const struct scissor scissor = {
+            .x      = shape->x,
+            .y      = shape->y,
+            .width  = 2*s->pad + shape->width + 1,
+            .height = 2*s->pad + shape->height + 1,
+        };
+        ngli_gpu_ctx_set_scissor(gpu_ctx, &scissor);
+
+        const uint32_t offsets[] = {i * (uint32_t)s->vert_offset, i * (uint32_t)s->frag_offset};
+        ret = ngli_pipeline_compat_update_dynamic_offsets(s->pipeline_compat, offsets, NGLI_ARRAY_NB(offsets));
+        if (ret < 0)
+            return ret;
+        ngli_pipeline_compat_draw(s->pipeline_compat, 3, 1);
     }
 
     return 0;
 }
 
-static void reset_tmp_data(struct distmap *s)
+static void reset_pipeline(struct distmap *s)
 {
-    ngli_darray_reset(&s->bezier_x);
-    ngli_darray_reset(&s->bezier_y);
-    ngli_darray_reset(&s->bezier_counts);
-    ngli_darray_reset(&s->beziergroup_counts);
-
     ngli_pipeline_compat_freep(&s->pipeline_compat);
     ngli_block_reset(&s->vert_block);
     ngli_buffer_freep(&s->vert_buffer);
     ngli_block_reset(&s->frag_block);
     ngli_buffer_freep(&s->frag_buffer);
     ngli_pgcraft_freep(&s->crafter);
-    ngli_rendertarget_freep(&s->rt);
+    s->bezier_max_count = 0;
+    s->beziergroup_max_count = 0;
+    s->buffer_max_count = 0;
 }
 
-static struct bezier3 scaled_bezier(struct bezier3 bezier, float scale)
-{
-    bezier.p0 *= scale;
-    bezier.p1 *= scale;
-    bezier.p2 *= scale;
-    bezier.p3 *= scale;
-    return bezier;
-}
-
-static void normalize_coordinates(struct distmap *s)
+static void reset_tmp_data(struct distmap *s)
 {
-    struct bezier3 *bezier_x = ngli_darray_data(&s->bezier_x);
-    struct bezier3 *bezier_y = ngli_darray_data(&s->bezier_y);
-    const size_t count = ngli_darray_count(&s->bezier_x);
-    ngli_assert(count == ngli_darray_count(&s->bezier_y));
-    for (size_t i = 0; i < count; i++) {
-        bezier_x[i] = scaled_bezier(bezier_x[i], s->scale);
-        bezier_y[i] = scaled_bezier(bezier_y[i], s->scale);
-    }
+    reset_pipeline(s);
+    ngli_rendertarget_freep(&s->rt);
 }
 
 #define DISTMAP_FEATURES (NGLI_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |               \
@@ -487,107 +457,31 @@ static int get_prefered_distmap_format(const struct distmap *s)
     ngli_assert(0);
 }
 
-int ngli_distmap_finalize(struct distmap *s)
+/*
+ * The pipeline and its uniform buffers are only rebuilt when the shapes to
+ * render are more complex or numerous than what they have been sized for.
+ */
+static int prepare_pipeline(struct distmap *s, int32_t shape_start)
 {
-    if (s->texture) {
-        LOG(ERROR, "texture already generated");
-        return NGL_ERROR_INVALID_USAGE;
-    }
-
-    const int32_t nb_shapes = (int32_t)ngli_darray_count(&s->shapes);
-    if (!nb_shapes)
-        return 0;
-
-    /*
-     * Assuming the path points are all within the view box
-     * (0,0,max_shape_w,max_shape_h), the computed distance will never be larger
-     * than the following:
-     */
-    const float longest_distance = hypotf(
-        (float)(s->max_shape_w + s->pad) + .5f,
-        (float)(s->max_shape_h + s->pad) + .5f
-    );
-    s->scale = 1.f / (float)longest_distance;
-
-    /*
-     * Define texture dimension (mostly squared).
-     * TODO shapes are assumed to be square when balancing the number of rows
-     * and cols, we're not taking into account max_shape_padded_[wh] as we should
-     */
-    s->nb_rows = (int32_t)lrintf(sqrtf((float)nb_shapes));
-    s->nb_cols = (int32_t)ceilf((float)nb_shapes / (float)s->nb_rows);
-    ngli_assert(s->nb_rows * s->nb_cols >= nb_shapes);
-
-    /*
-     * Padding needs to be the same length in both directions and for all
-     * shapes so that effects are consistent whatever the ratio or size of a
-     * given shape.
-     */
-    s->pad = NGLI_MAX(s->max_shape_w, s->max_shape_h) * PCENT_PADDING / 100;
-
-    /*
-     * +1 represents the extra half texel on each side used to prevent texture
-     * bleeding between shapes because of the linear filtering.
-     */
-    s->max_shape_padded_w = s->max_shape_w + 2 * s->pad + 1;
-    s->max_shape_padded_h = s->max_shape_h + 2 * s->pad + 1;
-
-    /*
-     * We normalize the coordinates with regards to the container shape so that
-     * distances are within [0;1] while remaining proportionnal against each
-     * others. This help making effects consistent accross all shapes.
-     */
-    normalize_coordinates(s);
-
-    s->texture_w = s->max_shape_padded_w * s->nb_cols;
-    s->texture_h = s->max_shape_padded_h * s->nb_rows;
-
-    /*
-     * Build pipeline and execute the computation of the complete signed
-     * distance map.
-     */
     struct gpu_ctx *gpu_ctx = s->ctx->gpu_ctx;
 
-    const struct texture_params tex_params = {
-        .type       = NGLI_TEXTURE_TYPE_2D,
-        .width      = s->texture_w,
-        .height     = s->texture_h,
-        .format     = get_prefered_distmap_format(s),
-        .min_filter = NGLI_FILTER_LINEAR,
-        .mag_filter = NGLI_FILTER_LINEAR,
-        .usage      = NGLI_TEXTURE_USAGE_TRANSFER_SRC_BIT
-                    | NGLI_TEXTURE_USAGE_TRANSFER_DST_BIT
-                    | NGLI_TEXTURE_USAGE_COLOR_ATTACHMENT_BIT
-                    | NGLI_TEXTURE_USAGE_SAMPLED_BIT,
-    };
-
-    s->texture = ngli_texture_create(gpu_ctx);
-    if (!s->texture)
-        return NGL_ERROR_MEMORY;
-
-    int ret = ngli_texture_init(s->texture, &tex_params);
-    if (ret < 0)
-        return ret;
+    const int32_t nb_shapes = (int32_t)ngli_darray_count(&s->shapes) - shape_start;
+    const int32_t bezier_max_count = get_max_beziers_per_shape(s, shape_start);
+    const int32_t beziergroup_max_count = get_max_beziergroups_per_shape(s, shape_start);
 
-    const struct rendertarget_params rt_params = {
-        .width = s->texture_w,
-        .height = s->texture_h,
-        .nb_colors = 1,
-        .colors[0] = {
-            .attachment = s->texture,
-            .load_op    = NGLI_LOAD_OP_CLEAR,
-            .store_op   = NGLI_STORE_OP_STORE,
-        },
-    };
-    s->rt = ngli_rendertarget_create(gpu_ctx);
-    if (!s->rt)
-        return NGL_ERROR_MEMORY;
-    ret = ngli_rendertarget_init(s->rt, &rt_params);
-    if (ret < 0)
-        return ret;
+    if (s->pipeline_compat &&
+        bezier_max_count <= s->bezier_max_count &&
+        beziergroup_max_count <= s->beziergroup_max_count &&
+        nb_shapes <= s->buffer_max_count)
+        return 0;
 
-    const int32_t bezier_max_count = get_max_beziers_per_shape(s);
-    const int32_t beziergroup_max_count = get_max_beziergroups_per_shape(s);
+    const int32_t new_bezier_max_count = NGLI_MAX(bezier_max_count, s->bezier_max_count);
+    const int32_t new_beziergroup_max_count = NGLI_MAX(beziergroup_max_count, s->beziergroup_max_count);
+    const int32_t new_buffer_max_count = NGLI_MAX(nb_shapes, s->buffer_max_count);
+    reset_pipeline(s);
+    s->bezier_max_count = new_bezier_max_count;
+    s->beziergroup_max_count = new_beziergroup_max_count;
+    s->buffer_max_count = new_buffer_max_count;
 
     const struct block_field vert_fields[] = {
         [VERTICES_INDEX] = {.name="vertices", .type=NGLI_TYPE_VEC4},
@@ -596,15 +490,16 @@ int ngli_distmap_finalize(struct distmap *s)
     const struct block_field frag_fields[] = {
         [COORDS_INDEX]            = {.name="coords",            .type=NGLI_TYPE_VEC4},
         [SCALE_INDEX]             = {.name="scale",             .type=NGLI_TYPE_VEC2},
-        [BEZIER_X_BUF_INDEX]      = {.name="bezier_x_buf",      .type=NGLI_TYPE_VEC4, .count=bezier_max_count},
-        [BEZIER_Y_BUF_INDEX]      = {.name="bezier_y_buf",      .type=NGLI_TYPE_VEC4, .count=bezier_max_count},
-        [BEZIER_COUNTS_INDEX]     = {.name="bezier_counts",     .type=NGLI_TYPE_I32,  .count=beziergroup_max_count},
+        [BEZIER_X_BUF_INDEX]      = {.name="bezier_x_buf",      .type=NGLI_TYPE_VEC4, .count=s->bezier_max_count},
+        [BEZIER_Y_BUF_INDEX]      = {.name="bezier_y_buf",      .type=NGLI_TYPE_VEC4, .count=s->bezier_max_count},
+        [BEZIER_COUNTS_INDEX]     = {.name="bezier_counts",     .type=NGLI_TYPE_I32,  .count=s->beziergroup_max_count},
         [BEZIERGROUP_COUNT_INDEX] = {.name="beziergroup_count", .type=NGLI_TYPE_I32},
     };
 
     ngli_block_init(gpu_ctx, &s->vert_block, NGLI_BLOCK_LAYOUT_STD140);
     ngli_block_init(gpu_ctx, &s->frag_block, NGLI_BLOCK_LAYOUT_STD140);
 
+    int ret;
     if ((ret = ngli_block_add_fields(&s->vert_block, vert_fields, NGLI_ARRAY_NB(vert_fields))) < 0 ||
         (ret = ngli_block_add_fields(&s->frag_block, frag_fields, NGLI_ARRAY_NB(frag_fields))))
         return ret;
@@ -618,8 +513,8 @@ int ngli_distmap_finalize(struct distmap *s)
     s->frag_offset = ngli_block_get_aligned_size(&s->frag_block, 0);
 
     static const int usage = NGLI_BUFFER_USAGE_UNIFORM_BUFFER_BIT | NGLI_BUFFER_USAGE_MAP_WRITE;
-    if ((ret = ngli_buffer_init(s->vert_buffer, nb_shapes * s->vert_offset, usage)) < 0 ||
-        (ret = ngli_buffer_init(s->frag_buffer, nb_shapes * s->frag_offset, usage)) < 0)
+    if ((ret = ngli_buffer_init(s->vert_buffer, s->buffer_max_count * s->vert_offset, usage)) < 0 ||
+        (ret = ngli_buffer_init(s->frag_buffer, s->buffer_max_count * s->frag_offset, usage)) < 0)
         return ret;
 
     const struct pgcraft_block crafter_blocks[] = {
@@ -663,11 +558,14 @@ int ngli_distmap_finalize(struct distmap *s)
     if (!s->pipeline_compat)
         return NGL_ERROR_MEMORY;
 
+    struct graphics_state state = NGLI_GRAPHICS_STATE_DEFAULTS;
+    state.scissor_test = 1;
+
     const struct pipeline_compat_params params = {
         .type = NGLI_PIPELINE_TYPE_GRAPHICS,
         .graphics = {
             .topology     = NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
-            .state        = NGLI_GRAPHICS_STATE_DEFAULTS,
+            .state        = state,
             .rt_layout    = s->rt->layout,
             .vertex_state = ngli_pgcraft_get_vertex_state(s->crafter),
         },
@@ -677,7 +575,37 @@ int ngli_distmap_finalize(struct distmap *s)
         .compat_info = ngli_pgcraft_get_compat_info(s->crafter),
     };
 
-    ret = ngli_pipeline_compat_init(s->pipeline_compat, &params);
+    return ngli_pipeline_compat_init(s->pipeline_compat, &params);
+}
+
+/*
+ * Render the shapes starting at shape_start into the texture. Only the area
+ * covered by these shapes is touched: the rest of the texture is either
+ * cleared (new texture) or preserved (incremental update).
+ */
+static int render_shapes(struct distmap *s, int32_t shape_start, int clear)
+{
+    struct gpu_ctx *gpu_ctx = s->ctx->gpu_ctx;
+
+    const struct rendertarget_params rt_params = {
+        .width = s->texture_w,
+        .height = s->texture_h,
+        .nb_colors = 1,
+        .colors[0] = {
+            .attachment = s->texture,
+            .load_op    = clear ? NGLI_LOAD_OP_CLEAR : NGLI_LOAD_OP_LOAD,
+            .store_op   = NGLI_STORE_OP_STORE,
+        },
+    };
+    ngli_rendertarget_freep(&s->rt);
+    s->rt = ngli_rendertarget_create(gpu_ctx);
+    if (!s->rt)
+        return NGL_ERROR_MEMORY;
+    int ret = ngli_rendertarget_init(s->rt, &rt_params);
+    if (ret < 0)
+        return ret;
+
+    ret = prepare_pipeline(s, shape_start);
     if (ret < 0)
         return ret;
 
@@ -687,18 +615,225 @@ int ngli_distmap_finalize(struct distmap *s)
     const struct viewport vp = {0, 0, s->rt->width, s->rt->height};
     ngli_gpu_ctx_set_viewport(gpu_ctx, &vp);
 
-    ret = draw_glyphs(s);
-    if (ret < 0)
-        return ret;
+    const struct scissor prev_scissor = ngli_gpu_ctx_get_scissor(gpu_ctx);
+
+    ret = draw_glyphs(s, shape_start);
 
     ngli_gpu_ctx_end_render_pass(gpu_ctx);
     ngli_gpu_ctx_set_viewport(gpu_ctx, &prev_vp);
+    ngli_gpu_ctx_set_scissor(gpu_ctx, &prev_scissor);
+
+    return ret;
+}
+
+static int create_texture(struct distmap *s)
+{
+    struct gpu_ctx *gpu_ctx = s->ctx->gpu_ctx;
+
+    const int32_t max_dimension = gpu_ctx->limits.max_texture_dimension_2d;
+    if (s->texture_w > max_dimension || s->texture_h > max_dimension) {
+        LOG(ERROR, "distmap texture dimensions (%dx%d) exceed device limits (%dx%d)",
+            s->texture_w, s->texture_h, max_dimension, max_dimension);
+        return NGL_ERROR_GRAPHICS_LIMIT_EXCEEDED;
+    }
+
+    const struct texture_params tex_params = {
+        .type       = NGLI_TEXTURE_TYPE_2D,
+        .width      = s->texture_w,
+        .height     = s->texture_h,
+        .format     = get_prefered_distmap_format(s),
+        .min_filter = NGLI_FILTER_LINEAR,
+        .mag_filter = NGLI_FILTER_LINEAR,
+        .usage      = NGLI_TEXTURE_USAGE_TRANSFER_SRC_BIT
+                    | NGLI_TEXTURE_USAGE_TRANSFER_DST_BIT
+                    | NGLI_TEXTURE_USAGE_COLOR_ATTACHMENT_BIT
+                    | NGLI_TEXTURE_USAGE_SAMPLED_BIT,
+    };
 
     /*
-     * Now that the distmap is rendered, the pipeline and other related
-     * allocations are not needed anymore, we just have to keep the texture.
+     * The previous texture may still be referenced by the users of the
+     * distmap until they fetch the new one
      */
-    reset_tmp_data(s);
+    ngli_rendertarget_freep(&s->rt);
+    ngli_texture_freep(&s->texture);
+    s->texture = ngli_texture_create(gpu_ctx);
+    if (!s->texture)
+        return NGL_ERROR_MEMORY;
+
+    return ngli_texture_init(s->texture, &tex_params);
+}
+
+static int cmp_shape_height(const void *a, const void *b)
+{
+    const struct shape *shape_a = *(const struct shape **)a;
+    const struct shape *shape_b = *(const struct shape **)b;
+    return shape_b->height - shape_a->height;
+}
+
+/*
+ * Derive the padding and normalization scale from the largest shape and pack
+ * all the shapes from scratch into a texture large enough to hold them.
+ */
+static int pack_all_shapes(struct distmap *s)
+{
+    s->ref_shape_w = s->max_shape_w;
+    s->ref_shape_h = s->max_shape_h;
+
+    /*
+     * Assuming the path points are all within the view box
+     * (0,0,max_shape_w,max_shape_h), the computed distance will never be larger
+     * than the following:
+     */
+    const float longest_distance = hypotf(
+        (float)s->ref_shape_w + .5f,
+        (float)s->ref_shape_h + .5f
+    );
+    s->scale = 1.f / (float)longest_distance;
+
+    /*
+     * Padding needs to be the same length in both directions and for all
+     * shapes so that effects are consistent whatever the ratio or size of a
+     * given shape.
+     */
+    s->pad = NGLI_MAX(s->ref_shape_w, s->ref_shape_h) * PCENT_PADDING / 100;
+
+    const size_t nb_shapes = ngli_darray_count(&s->shapes);
+    struct shape **sorted = ngli_calloc(nb_shapes, sizeof(*sorted));
+    if (!sorted)
+        return NGL_ERROR_MEMORY;
+
+    /*
+     * +1 represents the extra half texel on each side used to prevent texture
+     * bleeding between shapes because of the linear filtering.
+     */
+    int64_t area = 0;
+    int32_t max_padded_w = 0;
+    struct shape *shapes = ngli_darray_data(&s->shapes);
+    for (size_t i = 0; i < nb_shapes; i++) {
+        const int32_t padded_w = 2*s->pad + shapes[i].width + 1;
+        const int32_t padded_h = 2*s->pad + shapes[i].height + 1;
+        area += (int64_t)padded_w * padded_h;
+        max_padded_w = NGLI_MAX(max_padded_w, padded_w);
+        sorted[i] = &shapes[i];
+    }
+
+    /* Tallest shapes first for a tighter packing */
+    qsort(sorted, nb_shapes, sizeof(*sorted), cmp_shape_height);
+
+    /* Mostly squared texture, with a height only bounded by the content */
+    s->texture_w = NGLI_MAX(max_padded_w, (int32_t)ceil(sqrt((double)area)));
+
+    ngli_skyline_reset(&s->skyline);
+    ngli_skyline_init(&s->skyline);
+    int ret = ngli_skyline_resize(&s->skyline, s->texture_w, INT32_MAX);
+    if (ret < 0)
+        goto end;
+
+    for (size_t i = 0; i < nb_shapes; i++) {
+        struct shape *shape = sorted[i];
+        const int32_t padded_w = 2*s->pad + shape->width + 1;
+        const int32_t padded_h = 2*s->pad + shape->height + 1;
+        ret = ngli_skyline_pack(&s->skyline, padded_w, padded_h, &shape->x, &shape->y);
+        if (ret < 0)
+            goto end;
+    }
+
+    s->texture_h = ngli_skyline_get_used_height(&s->skyline);
+    ret = ngli_skyline_resize(&s->skyline, s->texture_w, s->texture_h);
+
+end:
+    ngli_free(sorted);
+    return ret;
+}
+
+/*
+ * Pack the shapes starting at shape_start into the free space of the
+ * texture, enlarging it if needed. The shapes already placed keep their
+ * position.
+ */
+static int pack_new_shapes(struct distmap *s, int32_t shape_start, int *grown)
+{
+    *grown = 0;
+
+    const int32_t nb_shapes = (int32_t)ngli_darray_count(&s->shapes);
+    for (int32_t i = shape_start; i < nb_shapes; i++) {
+        struct shape *shape = ngli_darray_get(&s->shapes, i);
+        const int32_t padded_w = 2*s->pad + shape->width + 1;
+        const int32_t padded_h = 2*s->pad + shape->height + 1;
+        for (;;) {
+            int ret = ngli_skyline_pack(&s->skyline, padded_w, padded_h, &shape->x, &shape->y);
+            if (ret == 0)
+                break;
+            if (ret != NGL_ERROR_LIMIT_EXCEEDED)
+                return ret;
+
+            /* Grow the smallest dimension to keep the texture mostly squared */
+            if (s->texture_w <= s->texture_h)
+                s->texture_w *= 2;
+            else
+                s->texture_h *= 2;
+            ret = ngli_skyline_resize(&s->skyline, s->texture_w, s->texture_h);
+            if (ret < 0)
+                return ret;
+            *grown = 1;
+        }
+    }
+
+    return 0;
+}
+
+int ngli_distmap_finalize(struct distmap *s)
+{
+    const int32_t nb_shapes = (int32_t)ngli_darray_count(&s->shapes);
+    if (s->nb_rendered_shapes == nb_shapes)
+        return 0;
+
+    /*
+     * The shapes added since the last call are packed into the free space of
+     * the current texture and rendered in place. The whole texture needs to
+     * be rendered again only if it has to be enlarged (the previous content
+     * is re-rendered in the new texture) or if a new shape is larger than the
+     * one the padding and normalization were derived from (all the shapes
+     * are then repacked).
+     */
+    int ret;
+    int32_t shape_start = s->nb_rendered_shapes;
+    if (!s->texture || s->max_shape_w > s->ref_shape_w || s->max_shape_h > s->ref_shape_h) {
+        ret = pack_all_shapes(s);
+        if (ret < 0)
+            return ret;
+        shape_start = 0;
+    } else {
+        int grown;
+        ret = pack_new_shapes(s, shape_start, &grown);
+        if (ret < 0)
+            return ret;
+        if (grown)
+            shape_start = 0;
+        s->incremental = 1;
+    }
+
+    if (shape_start == 0) {
+        ret = create_texture(s);
+        if (ret < 0)
+            return ret;
+    }
+
+    ret = render_shapes(s, shape_start, shape_start == 0);
+    if (ret < 0)
+        return ret;
+
+    s->nb_rendered_shapes = nb_shapes;
+
+    /*
+     * Unless the distmap is being updated incrementally, the pipeline and
+     * other related allocations are not needed anymore, we just have to keep
+     * the texture.
+     */
+    if (!s->incremental)
+        reset_tmp_data(s);
+    else
+        ngli_rendertarget_freep(&s->rt);
 
     return 0;
 }
@@ -711,10 +846,8 @@ struct texture *ngli_distmap_get_texture(const struct distmap *s)
 void ngli_distmap_get_shape_coords(const struct distmap *s, int32_t shape_id, int32_t *dst)
 {
     const struct shape *shape = ngli_darray_get(&s->shapes, shape_id);
-    const int32_t col = shape_id % s->nb_cols;
-    const int32_t row = shape_id / s->nb_cols;
-    const int32_t x0 = col * s->max_shape_padded_w;
-    const int32_t y0 = row * s->max_shape_padded_h;
+    const int32_t x0 = shape->x;
+    const int32_t y0 = shape->y;
     const int32_t x1 = x0 + 2*s->pad + shape->width + 1;
     const int32_t y1 = y0 + 2*s->pad + shape->height + 1;
     const int32_t coords[] = {x0, y0, x1, y1};
@@ -740,6 +873,10 @@ void ngli_distmap_freep(struct distmap **dp)
     reset_tmp_data(s);
 
     ngli_darray_reset(&s->shapes);
+    ngli_darray_reset(&s->bezier_x);
+    ngli_darray_reset(&s->bezier_y);
+    ngli_darray_reset(&s->bezier_counts);
+    ngli_skyline_reset(&s->skyline);
     ngli_texture_freep(&s->texture);
     ngli_freep(dp);
 }
@@ -37,6 +37,15 @@ struct distmap *ngli_distmap_create(struct ngl_ctx *ctx);
 int ngli_distmap_init(struct distmap *s);
 int ngli_distmap_add_shape(struct distmap *s, int32_t shape_w, int32_t shape_h,
                            const struct path *path, uint32_t flags, int32_t *shape_id);
+
+/*
+ * Render the shapes added since the previous call. Shapes can keep being added
+ * after a first finalization: they are rendered in the free space of the
+ * current texture, which is only reallocated (and its returned pointer
+ * changed) when it needs to grow or when the new shapes are larger than all
+ * the previous ones. In the latter case, the coordinates of all the shapes
+ * may change.
+ */
 int ngli_distmap_finalize(struct distmap *s);
 
 struct texture *ngli_distmap_get_texture(const struct distmap *s);
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Every output texel packs 4 consecutive bytes of the final 4:2:0 frame: the
+ * luma plane followed by either the interleaved chroma plane (semi-planar) or
+ * the Cb and Cr planes (planar). Each sample is 1 byte, or 2 bytes (10-bit
+ * value in the most significant bits, little-endian) if sample_size is 2.
+ */
+
+vec3 load_rgb(ivec2 pos)
+{
+    if (flip)
+        pos.y = size.y - 1 - pos.y;
+    return texelFetch(tex, pos, 0).rgb;
+}
+
+float get_luma(int index)
+{
+    ivec2 pos = ivec2(index % size.x, index / size.x);
+    return (color_matrix * vec4(load_rgb(pos), 1.0)).x;
+}
+
+vec2 get_chroma(int index)
+{
+    int chroma_width = size.x / 2;
+    ivec2 pos = 2 * ivec2(index % chroma_width, index / chroma_width);
+    vec3 rgb = (load_rgb(pos) +
+                load_rgb(pos + ivec2(1, 0)) +
+                load_rgb(pos + ivec2(0, 1)) +
+                load_rgb(pos + ivec2(1, 1))) * 0.25;
+    return (color_matrix * vec4(rgb, 1.0)).yz;
+}
+
+float get_sample(int index)
+{
+    int luma_size = size.x * size.y;
+    if (index < luma_size)
+        return get_luma(index);
+    index -= luma_size;
+
+    if (planar) {
+        int chroma_size = luma_size / 4;
+        return index < chroma_size ? get_chroma(index).x : get_chroma(index - chroma_size).y;
+    }
+
+    vec2 cbcr = get_chroma(index / 2);
+    return index % 2 == 0 ? cbcr.x : cbcr.y;
+}
+
+void main()
+{
+    ivec2 pos = ivec2(gl_FragCoord.xy);
+    int texel_index = pos.y * (size.x * sample_size / 4) + pos.x;
+
+    if (sample_size == 2) {
+        int index = texel_index * 2;
+        vec2 v = floor(clamp(vec2(get_sample(index), get_sample(index + 1)), 0.0, 1.0) * 1023.0 + 0.5) * 64.0;
+        vec2 hi = floor(v / 256.0);
+        vec2 lo = v - hi * 256.0;
+        ngl_out_color = vec4(lo.x, hi.x, lo.y, hi.y) / 255.0;
+    } else {
+        int index = texel_index * 4;
+        ngl_out_color = vec4(get_sample(index),
+                             get_sample(index + 1),
+                             get_sample(index + 2),
+                             get_sample(index + 3));
+    }
+}
@@ -20,6 +20,7 @@
  * under the License.
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "gpu_ctx.h"
@@ -91,9 +92,43 @@ struct gpu_ctx *ngli_gpu_ctx_create(const struct ngl_config *config)
     return s;
 }
 
+static int check_capture_format(const struct ngl_config *config)
+{
+    if (config->capture_format < 0 || config->capture_format > NGL_CAPTURE_FORMAT_P010) {
+        LOG(ERROR, "invalid capture format %d", config->capture_format);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    if (config->capture_colorspace < 0 || config->capture_colorspace > NGL_CAPTURE_COLORSPACE_BT2020) {
+        LOG(ERROR, "invalid capture color space %d", config->capture_colorspace);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    if (config->capture_format == NGL_CAPTURE_FORMAT_RGBA)
+        return 0;
+
+    if (!config->offscreen || config->capture_buffer_type != NGL_CAPTURE_BUFFER_TYPE_CPU) {
+        LOG(ERROR, "YUV capture formats are only supported with offscreen CPU capture buffers");
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    const int32_t width_align = config->capture_format == NGL_CAPTURE_FORMAT_P010 ? 2 : 4;
+    if (config->width % width_align || config->height % 2) {
+        LOG(ERROR, "YUV capture formats require a width multiple of %d and an even height (got %dx%d)",
+            width_align, config->width, config->height);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    return 0;
+}
+
 int ngli_gpu_ctx_init(struct gpu_ctx *s)
 {
-    int ret = s->cls->init(s);
+    int ret = check_capture_format(&s->config);
+    if (ret < 0)
+        return ret;
+
+    ret = s->cls->init(s);
     if (ret < 0)
         return ret;
 
@@ -102,6 +137,47 @@ int ngli_gpu_ctx_init(struct gpu_ctx *s)
     if (!s->vertex_buffers)
         return NGL_ERROR_MEMORY;
 
+    s->uniform_ring = ngli_uniform_ring_create(s);
+    if (!s->uniform_ring)
+        return NGL_ERROR_MEMORY;
+
+    ret = ngli_uniform_ring_init(s->uniform_ring);
+    if (ret < 0)
+        return ret;
+
+    ngli_darray_init(&s->pending_pipelines, sizeof(struct pipeline *), 0);
+
+    if (s->features & NGLI_FEATURE_PARALLEL_PIPELINE_INIT) {
+        s->threadpool = ngli_threadpool_create();
+        if (!s->threadpool)
+            return NGL_ERROR_MEMORY;
+
+        ret = ngli_threadpool_init(s->threadpool, 0);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+int ngli_gpu_ctx_init_diskcache(struct gpu_ctx *s, const char *identity)
+{
+    const char *dir = s->config.cache_dir;
+    if (!dir)
+        dir = getenv("NGL_CACHE_DIR");
+    if (!dir || !*dir)
+        return 0;
+
+    s->diskcache = ngli_diskcache_create();
+    if (!s->diskcache)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngli_diskcache_init(s->diskcache, dir, identity);
+    if (ret < 0) {
+        LOG(WARNING, "unable to use %s as cache directory, disabling disk cache", dir);
+        ngli_diskcache_freep(&s->diskcache);
+    }
+
     return 0;
 }
 
@@ -119,7 +195,14 @@ int ngli_gpu_ctx_set_capture_buffer(struct gpu_ctx *s, void *capture_buffer)
 
 int ngli_gpu_ctx_begin_update(struct gpu_ctx *s, double t)
 {
-    return s->cls->begin_update(s, t);
+    int ret = s->cls->begin_update(s, t);
+    if (ret < 0)
+        return ret;
+
+    /* The backend waited for the frame reusing this ring region */
+    ngli_uniform_ring_begin_frame(s->uniform_ring);
+
+    return 0;
 }
 
 int ngli_gpu_ctx_end_update(struct gpu_ctx *s, double t)
@@ -129,6 +212,7 @@ int ngli_gpu_ctx_end_update(struct gpu_ctx *s, double t)
 
 int ngli_gpu_ctx_begin_draw(struct gpu_ctx *s, double t)
 {
+    memset(&s->bind_stats, 0, sizeof(s->bind_stats));
     return s->cls->begin_draw(s, t);
 }
 
@@ -137,6 +221,18 @@ int ngli_gpu_ctx_end_draw(struct gpu_ctx *s, double t)
     return s->cls->end_draw(s, t);
 }
 
+/*
+ * Complete the oldest asynchronous captures (see ngl_config.capture_async)
+ * until at most max_pending of them are still in flight
+ */
+int ngli_gpu_ctx_wait_captures(struct gpu_ctx *s, size_t max_pending)
+{
+    const struct gpu_ctx_class *cls = s->cls;
+    if (!cls->wait_captures)
+        return 0;
+    return cls->wait_captures(s, max_pending);
+}
+
 int ngli_gpu_ctx_query_draw_time(struct gpu_ctx *s, int64_t *time)
 {
     return s->cls->query_draw_time(s, time);
@@ -147,18 +243,74 @@ void ngli_gpu_ctx_wait_idle(struct gpu_ctx *s)
     s->cls->wait_idle(s);
 }
 
+/*
+ * Start deferring the pipeline initializations: the backend is free to queue
+ * the program compilations on the thread pool in the meantime
+ */
+void ngli_gpu_ctx_begin_pipeline_batch(struct gpu_ctx *s)
+{
+    s->defer_pipelines = 1;
+}
+
+static int init_pipeline_job(void *arg)
+{
+    struct pipeline *pipeline = arg;
+    return pipeline->gpu_ctx->cls->pipeline_init(pipeline);
+}
+
+int ngli_gpu_ctx_end_pipeline_batch(struct gpu_ctx *s)
+{
+    s->defer_pipelines = 0;
+
+    /* Programs must be compiled before their pipelines are created */
+    int ret = s->threadpool ? ngli_threadpool_wait(s->threadpool) : 0;
+
+    struct pipeline **pipelines = ngli_darray_data(&s->pending_pipelines);
+    const size_t nb_pipelines = ngli_darray_count(&s->pending_pipelines);
+    if (ret >= 0) {
+        LOG(DEBUG, "initializing %zu deferred pipelines", nb_pipelines);
+        for (size_t i = 0; i < nb_pipelines; i++) {
+            if (s->threadpool) {
+                ret = ngli_threadpool_submit(s->threadpool, init_pipeline_job, pipelines[i]);
+            } else {
+                ret = s->cls->pipeline_init(pipelines[i]);
+            }
+            if (ret < 0)
+                break;
+        }
+        if (s->threadpool) {
+            const int wait_ret = ngli_threadpool_wait(s->threadpool);
+            if (ret >= 0)
+                ret = wait_ret;
+        }
+    }
+
+    for (size_t i = 0; i < nb_pipelines; i++)
+        pipelines[i]->deferred = 0;
+    ngli_darray_clear(&s->pending_pipelines);
+
+    return ret;
+}
+
 void ngli_gpu_ctx_freep(struct gpu_ctx **sp)
 {
     if (!*sp)
         return;
 
     struct gpu_ctx *s = *sp;
+
+    /* Jobs may still reference backend objects */
+    ngli_threadpool_freep(&s->threadpool);
+    ngli_darray_reset(&s->pending_pipelines);
+
     ngli_freep(&s->vertex_buffers);
+    ngli_uniform_ring_freep(&s->uniform_ring);
 
     const struct gpu_ctx_class *cls = s->cls;
     if (cls)
         cls->destroy(s);
 
+    ngli_diskcache_freep(&s->diskcache);
     ngli_config_reset(&s->config);
     ngli_freep(sp);
 }
@@ -179,6 +331,7 @@ void ngli_gpu_ctx_begin_render_pass(struct gpu_ctx *s, struct rendertarget *rt)
     ngli_assert(!s->rendertarget);
 
     s->rendertarget = rt;
+    s->dirty_state = NGLI_GPU_STATE_ALL;
     s->cls->begin_render_pass(s, rt);
 }
 
@@ -186,6 +339,7 @@ void ngli_gpu_ctx_end_render_pass(struct gpu_ctx *s)
 {
     s->cls->end_render_pass(s);
     s->rendertarget = NULL;
+    s->dirty_state = NGLI_GPU_STATE_ALL;
 }
 
 void ngli_gpu_ctx_get_rendertarget_uvcoord_matrix(struct gpu_ctx *s, float *dst)
@@ -203,6 +357,41 @@ const struct rendertarget_layout *ngli_gpu_ctx_get_default_rendertarget_layout(s
     return s->cls->get_default_rendertarget_layout(s);
 }
 
+/*
+ * Rendertarget in which the YUV capture formats are converted before being
+ * read back, NULL with the default RGBA capture format
+ */
+struct rendertarget *ngli_gpu_ctx_get_capture_rendertarget(struct gpu_ctx *s)
+{
+    const struct gpu_ctx_class *cls = s->cls;
+    if (!cls->get_capture_rendertarget)
+        return NULL;
+    return cls->get_capture_rendertarget(s);
+}
+
+/*
+ * The YUV capture formats are packed into a RGBA8 texture so they can be read
+ * back like the RGBA captures, each texel holding 4 bytes of the final frame
+ */
+void ngli_gpu_ctx_get_capture_dimensions(const struct gpu_ctx *s, int32_t *width, int32_t *height)
+{
+    const struct ngl_config *config = &s->config;
+    switch (config->capture_format) {
+    case NGL_CAPTURE_FORMAT_NV12:
+    case NGL_CAPTURE_FORMAT_I420:
+        *width  = config->width / 4;
+        *height = config->height * 3 / 2;
+        break;
+    case NGL_CAPTURE_FORMAT_P010:
+        *width  = config->width / 2;
+        *height = config->height * 3 / 2;
+        break;
+    default:
+        *width  = config->width;
+        *height = config->height;
+    }
+}
+
 void ngli_gpu_ctx_set_viewport(struct gpu_ctx *s, const struct viewport *viewport)
 {
     s->viewport = *viewport;
@@ -238,17 +427,42 @@ uint32_t ngli_gpu_ctx_get_format_features(struct gpu_ctx *s, int format)
     return s->cls->get_format_features(s, format);
 }
 
+/*
+ * Binds are only filtered inside a render pass, where the backend state is
+ * known to be preserved from one command to the next; outside of it (compute
+ * dispatches, transfers) every bind is forwarded
+ */
+static int skip_bind(struct gpu_ctx *s, uint32_t state, int unchanged)
+{
+    if (s->rendertarget && unchanged && !(s->dirty_state & state)) {
+        s->bind_stats.nb_skipped++;
+        return 1;
+    }
+    s->dirty_state |= state;
+    s->bind_stats.nb_issued++;
+    return 0;
+}
+
 void ngli_gpu_ctx_set_pipeline(struct gpu_ctx *s, struct pipeline *pipeline)
 {
+    if (skip_bind(s, NGLI_GPU_STATE_PIPELINE, s->pipeline == pipeline))
+        return;
+
     s->pipeline = pipeline;
     s->cls->set_pipeline(s, pipeline);
 }
 
 void ngli_gpu_ctx_set_bindgroup(struct gpu_ctx *s, struct bindgroup *bindgroup, const uint32_t *offsets, size_t nb_offsets)
 {
-    s->bindgroup = bindgroup;
-
     ngli_assert(bindgroup->layout->nb_dynamic_offsets == nb_offsets);
+
+    const int unchanged = s->bindgroup == bindgroup &&
+                          s->nb_dynamic_offsets == nb_offsets &&
+                          !memcmp(s->dynamic_offsets, offsets, nb_offsets * sizeof(*s->dynamic_offsets));
+    if (skip_bind(s, NGLI_GPU_STATE_BINDGROUP, unchanged))
+        return;
+
+    s->bindgroup = bindgroup;
     memcpy(s->dynamic_offsets, offsets, nb_offsets * sizeof(*s->dynamic_offsets));
     s->nb_dynamic_offsets = nb_offsets;
 
@@ -275,6 +489,7 @@ void ngli_gpu_ctx_draw(struct gpu_ctx *s, int nb_vertices, int nb_instances)
     ngli_assert(ngli_bindgroup_layout_is_compatible(p_layout, b_layout));
 
     s->cls->draw(s, nb_vertices, nb_instances);
+    s->dirty_state = 0;
 }
 
 void ngli_gpu_ctx_draw_indexed(struct gpu_ctx *s, int nb_indices, int nb_instances)
@@ -287,6 +502,7 @@ void ngli_gpu_ctx_draw_indexed(struct gpu_ctx *s, int nb_indices, int nb_instanc
     ngli_assert(ngli_bindgroup_layout_is_compatible(p_layout, b_layout));
 
     s->cls->draw_indexed(s, nb_indices, nb_instances);
+    s->dirty_state = 0;
 }
 
 void ngli_gpu_ctx_dispatch(struct gpu_ctx *s, uint32_t nb_group_x, uint32_t nb_group_y, uint32_t nb_group_z)
@@ -304,13 +520,30 @@ void ngli_gpu_ctx_set_vertex_buffer(struct gpu_ctx *s, uint32_t index, const str
 {
     struct gpu_limits *limits = &s->limits;
     ngli_assert(index < limits->max_vertex_attributes);
+    if (skip_bind(s, NGLI_GPU_STATE_VERTEX_BUFFERS, s->vertex_buffers[index] == buffer))
+        return;
+
     s->vertex_buffers[index] = buffer;
     s->cls->set_vertex_buffer(s, index, buffer);
 }
 
 void ngli_gpu_ctx_set_index_buffer(struct gpu_ctx *s, const struct buffer *buffer, int format)
 {
+    const int unchanged = s->index_buffer == buffer && s->index_format == format;
+    if (skip_bind(s, NGLI_GPU_STATE_INDEX_BUFFER, unchanged))
+        return;
+
     s->index_buffer = buffer;
     s->index_format = format;
     s->cls->set_index_buffer(s, buffer, format);
 }
+
+/*
+ * Force the next binds of the given state to be forwarded to the backend, to
+ * be used whenever the tracked objects may not reflect the backend state
+ * anymore (object content updated or destroyed, native bindings altered)
+ */
+void ngli_gpu_ctx_invalidate_state(struct gpu_ctx *s, uint32_t state)
+{
+    s->dirty_state |= state;
+}
@@ -26,12 +26,16 @@
 #include <stdint.h>
 
 #include "bindgroup.h"
+#include "darray.h"
+#include "diskcache.h"
 #include "buffer.h"
 #include "gpu_limits.h"
 #include "nopegl.h"
 #include "pipeline.h"
 #include "rendertarget.h"
 #include "texture.h"
+#include "threadpool.h"
+#include "uniform_ring.h"
 
 struct viewport {
     int32_t x, y, width, height;
@@ -49,6 +53,33 @@ int ngli_viewport_is_valid(const struct viewport *viewport);
 #define NGLI_FEATURE_STORAGE_BUFFER                    (1 << 3)
 #define NGLI_FEATURE_BUFFER_MAP_PERSISTENT             (1 << 4)
 #define NGLI_FEATURE_DEPTH_STENCIL_RESOLVE             (1 << 5)
+#define NGLI_FEATURE_PARALLEL_PIPELINE_INIT            (1 << 6) // programs and pipelines can be initialized from worker threads
+
+/*
+ * Bound state that must be (re)applied by the backend at the next draw. Inside
+ * a render pass, the set_* functions filter out the binds of objects which are
+ * already current and leave the corresponding flag cleared.
+ */
+#define NGLI_GPU_STATE_PIPELINE                        (1 << 0)
+#define NGLI_GPU_STATE_BINDGROUP                       (1 << 1)
+#define NGLI_GPU_STATE_VERTEX_BUFFERS                  (1 << 2)
+#define NGLI_GPU_STATE_INDEX_BUFFER                    (1 << 3)
+#define NGLI_GPU_STATE_ALL                             ((1 << 4) - 1)
+
+struct gpu_bind_stats {
+    size_t nb_issued;
+    size_t nb_skipped;
+};
+
+/*
+ * Device memory handed out by the backend memory allocator, left to zero by
+ * the backends which do not manage the device memory themselves.
+ */
+struct gpu_memory_stats {
+    size_t nb_allocations;
+    size_t allocated;
+    size_t used;
+};
 
 struct gpu_ctx_class {
     const char *name;
@@ -61,6 +92,7 @@ struct gpu_ctx_class {
     int (*end_update)(struct gpu_ctx *s, double t);
     int (*begin_draw)(struct gpu_ctx *s, double t);
     int (*end_draw)(struct gpu_ctx *s, double t);
+    int (*wait_captures)(struct gpu_ctx *s, size_t max_pending);
     int (*query_draw_time)(struct gpu_ctx *s, int64_t *time);
     void (*wait_idle)(struct gpu_ctx *s);
     void (*destroy)(struct gpu_ctx *s);
@@ -71,6 +103,7 @@ struct gpu_ctx_class {
 
     struct rendertarget *(*get_default_rendertarget)(struct gpu_ctx *s, int load_op);
     const struct rendertarget_layout *(*get_default_rendertarget_layout)(struct gpu_ctx *s);
+    struct rendertarget *(*get_capture_rendertarget)(struct gpu_ctx *s);
 
     void (*begin_render_pass)(struct gpu_ctx *s, struct rendertarget *rt);
     void (*end_render_pass)(struct gpu_ctx *s);
@@ -136,6 +169,18 @@ struct gpu_ctx {
     uint64_t features;
     struct gpu_limits limits;
 
+    struct uniform_ring *uniform_ring;
+    struct diskcache *diskcache;
+    struct threadpool *threadpool; // only with NGLI_FEATURE_PARALLEL_PIPELINE_INIT
+
+    /*
+     * Within a pipeline batch, the pipeline initializations are deferred to the
+     * end of the batch so that the program compilations queued in the
+     * meantime can run concurrently
+     */
+    int defer_pipelines;
+    struct darray pending_pipelines;
+
 #if DEBUG_GPU_CAPTURE
     struct gpu_capture_ctx *gpu_capture_ctx;
     int gpu_capture;
@@ -152,10 +197,18 @@ struct gpu_ctx {
     int index_format;
     struct viewport viewport;
     struct scissor scissor;
+    uint32_t dirty_state;
+
+    /* Bind commands forwarded to/filtered out from the backend since begin_draw */
+    struct gpu_bind_stats bind_stats;
+
+    /* Device memory usage, refreshed by the backend at begin_draw */
+    struct gpu_memory_stats memory_stats;
 };
 
 struct gpu_ctx *ngli_gpu_ctx_create(const struct ngl_config *config);
 int ngli_gpu_ctx_init(struct gpu_ctx *s);
+int ngli_gpu_ctx_init_diskcache(struct gpu_ctx *s, const char *identity);
 int ngli_gpu_ctx_resize(struct gpu_ctx *s, int32_t width, int32_t height, const int32_t *viewport);
 int ngli_gpu_ctx_set_capture_buffer(struct gpu_ctx *s, void *capture_buffer);
 int ngli_gpu_ctx_begin_update(struct gpu_ctx *s, double t);
@@ -163,7 +216,10 @@ int ngli_gpu_ctx_end_update(struct gpu_ctx *s, double t);
 int ngli_gpu_ctx_begin_draw(struct gpu_ctx *s, double t);
 int ngli_gpu_ctx_query_draw_time(struct gpu_ctx *s, int64_t *time);
 int ngli_gpu_ctx_end_draw(struct gpu_ctx *s, double t);
+int ngli_gpu_ctx_wait_captures(struct gpu_ctx *s, size_t max_pending);
 void ngli_gpu_ctx_wait_idle(struct gpu_ctx *s);
+void ngli_gpu_ctx_begin_pipeline_batch(struct gpu_ctx *s);
+int ngli_gpu_ctx_end_pipeline_batch(struct gpu_ctx *s);
 void ngli_gpu_ctx_freep(struct gpu_ctx **sp);
 
 int ngli_gpu_ctx_transform_cull_mode(struct gpu_ctx *s, int cull_mode);
@@ -172,6 +228,8 @@ void ngli_gpu_ctx_get_rendertarget_uvcoord_matrix(struct gpu_ctx *s, float *dst)
 
 struct rendertarget *ngli_gpu_ctx_get_default_rendertarget(struct gpu_ctx *s, int load_op);
 const struct rendertarget_layout *ngli_gpu_ctx_get_default_rendertarget_layout(struct gpu_ctx *s);
+struct rendertarget *ngli_gpu_ctx_get_capture_rendertarget(struct gpu_ctx *s);
+void ngli_gpu_ctx_get_capture_dimensions(const struct gpu_ctx *s, int32_t *width, int32_t *height);
 
 void ngli_gpu_ctx_begin_render_pass(struct gpu_ctx *s, struct rendertarget *rt);
 void ngli_gpu_ctx_end_render_pass(struct gpu_ctx *s);
@@ -194,4 +252,6 @@ void ngli_gpu_ctx_dispatch(struct gpu_ctx *s, uint32_t nb_group_x, uint32_t nb_g
 void ngli_gpu_ctx_set_vertex_buffer(struct gpu_ctx *s, uint32_t index, const struct buffer *buffer);
 void ngli_gpu_ctx_set_index_buffer(struct gpu_ctx *s, const struct buffer *buffer, int format);
 
+void ngli_gpu_ctx_invalidate_state(struct gpu_ctx *s, uint32_t state);
+
 #endif
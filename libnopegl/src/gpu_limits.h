@@ -42,6 +42,9 @@ struct gpu_limits {
     uint32_t max_uniform_block_size;
     size_t min_uniform_block_offset_alignment;
     uint32_t max_storage_block_size;
+    uint32_t max_vertex_storage_blocks;
+    uint32_t max_fragment_storage_blocks;
+    uint32_t max_compute_storage_blocks;
     size_t min_storage_block_offset_alignment;
     uint32_t max_samples;
     uint32_t max_texture_dimension_1d;
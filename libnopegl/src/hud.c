@@ -89,6 +89,11 @@ struct hud {
 #define MEMORY_WIDGET_TEXT_LEN      25
 #define ACTIVITY_WIDGET_TEXT_LEN    12
 #define DRAWCALL_WIDGET_TEXT_LEN    12
+#define BIND_WIDGET_TEXT_LEN        12
+#define UPDATE_WIDGET_TEXT_LEN      12
+
+/* Number of frames between 2 samples of the (costly) resident buffers size */
+#define MEMORY_RESIDENT_SAMPLING_PERIOD 30
 
 enum {
     LATENCY_UPDATE_CPU,
@@ -101,9 +106,13 @@ enum {
 enum {
     MEMORY_BUFFERS_CPU,
     MEMORY_BUFFERS_GPU,
+    MEMORY_BUFFERS_MAPPED,
+    MEMORY_BUFFERS_RESIDENT,
     MEMORY_BLOCKS_CPU,
     MEMORY_BLOCKS_GPU,
     MEMORY_TEXTURES,
+    MEMORY_DEVICE_ALLOCATED,
+    MEMORY_DEVICE_USED,
     NB_MEMORY
 };
 
@@ -123,6 +132,12 @@ enum {
     NB_DRAWCALL
 };
 
+enum {
+    BIND_ISSUED,
+    BIND_SKIPPED,
+    NB_BIND
+};
+
 #define BUFFER_NODES                \
     NGL_NODE_ANIMATEDBUFFERFLOAT,   \
     NGL_NODE_ANIMATEDBUFFERVEC2,    \
@@ -184,6 +199,16 @@ static const struct {
         .node_types=(const uint32_t[]){BUFFER_NODES, NGLI_NODE_NONE},
         .color=0x3284FFFF,
     },
+    [MEMORY_BUFFERS_MAPPED] = {
+        .label="Buf. mapped",
+        .node_types=(const uint32_t[]){BUFFER_NODES, NGLI_NODE_NONE},
+        .color=0x9E32FFFF,
+    },
+    [MEMORY_BUFFERS_RESIDENT] = {
+        .label="Buf. resident",
+        .node_types=(const uint32_t[]){BUFFER_NODES, NGLI_NODE_NONE},
+        .color=0x32D6FFFF,
+    },
     [MEMORY_BLOCKS_CPU] = {
         .label="Blocks CPU",
         .node_types=(const uint32_t[]){NGL_NODE_BLOCK, NGLI_NODE_NONE},
@@ -199,6 +224,16 @@ static const struct {
         .node_types=(const uint32_t[]){NGL_NODE_TEXTURE2D, NGL_NODE_TEXTURE3D, NGLI_NODE_NONE},
         .color=0xFF3232FF,
     },
+    [MEMORY_DEVICE_ALLOCATED] = {
+        .label="Dev. alloc",
+        .node_types=(const uint32_t[]){NGLI_NODE_NONE},
+        .color=0xFF9E32FF,
+    },
+    [MEMORY_DEVICE_USED] = {
+        .label="Dev. used",
+        .node_types=(const uint32_t[]){NGLI_NODE_NONE},
+        .color=0xFFD632FF,
+    },
 };
 
 static const struct activity_spec {
@@ -255,16 +290,26 @@ static const struct drawcall_spec {
     },
 };
 
+static const struct bind_spec {
+    const char *label;
+} bind_specs[] = {
+    [BIND_ISSUED]  = {.label="Binds"},
+    [BIND_SKIPPED] = {.label="Skip binds"},
+};
+
 NGLI_STATIC_ASSERT(hud_nb_latency,  NGLI_ARRAY_NB(latency_specs)  == NB_LATENCY);
 NGLI_STATIC_ASSERT(hud_nb_memory,   NGLI_ARRAY_NB(memory_specs)   == NB_MEMORY);
 NGLI_STATIC_ASSERT(hud_nb_activity, NGLI_ARRAY_NB(activity_specs) == NB_ACTIVITY);
 NGLI_STATIC_ASSERT(hud_nb_drawcall, NGLI_ARRAY_NB(drawcall_specs) == NB_DRAWCALL);
+NGLI_STATIC_ASSERT(hud_nb_bind,     NGLI_ARRAY_NB(bind_specs)     == NB_BIND);
 
 enum widget_type {
     WIDGET_LATENCY,
     WIDGET_MEMORY,
     WIDGET_ACTIVITY,
     WIDGET_DRAWCALL,
+    WIDGET_BIND,
+    WIDGET_UPDATE,
 };
 
 struct data_graph {
@@ -292,6 +337,7 @@ struct widget_latency {
 struct widget_memory {
     struct darray nodes[NB_MEMORY];
     size_t sizes[NB_MEMORY];
+    int resident_countdown;
 };
 
 struct widget_activity {
@@ -304,6 +350,14 @@ struct widget_drawcall {
     int nb_draws;
 };
 
+struct widget_bind {
+    size_t nb_binds;
+};
+
+struct widget_update {
+    size_t nb_parallel_updates;
+};
+
 struct widget {
     enum widget_type type;
     struct rect rect;
@@ -435,6 +489,16 @@ static int widget_drawcall_init(struct hud *s, struct widget *widget)
     return make_nodes_set(scene, &priv->nodes, node_types);
 }
 
+static int widget_bind_init(struct hud *s, struct widget *widget)
+{
+    return 0;
+}
+
+static int widget_update_init(struct hud *s, struct widget *widget)
+{
+    return 0;
+}
+
 /* Widget update */
 
 static void register_time(struct hud *s, struct latency_measure *m, int64_t t)
@@ -474,6 +538,25 @@ static void widget_memory_make_stats(struct hud *s, struct widget *widget)
     for (size_t i = 0; i < ngli_darray_count(nodes_buf_array_gpu); i++)
         priv->sizes[MEMORY_BUFFERS_GPU] += ngli_node_buffer_get_gpu_size(nodes_buf_gpu[i]);
 
+    struct darray *nodes_buf_array_map = &priv->nodes[MEMORY_BUFFERS_MAPPED];
+    struct ngl_node **nodes_buf_map = ngli_darray_data(nodes_buf_array_map);
+    priv->sizes[MEMORY_BUFFERS_MAPPED] = 0;
+    for (size_t i = 0; i < ngli_darray_count(nodes_buf_array_map); i++)
+        priv->sizes[MEMORY_BUFFERS_MAPPED] += ngli_node_buffer_get_mapped_size(nodes_buf_map[i]);
+
+    /*
+     * The residency of the file mappings is queried page per page, so it is
+     * only sampled periodically and the previous value is kept in between
+     */
+    if (priv->resident_countdown-- <= 0) {
+        struct darray *nodes_buf_array_res = &priv->nodes[MEMORY_BUFFERS_RESIDENT];
+        struct ngl_node **nodes_buf_res = ngli_darray_data(nodes_buf_array_res);
+        priv->sizes[MEMORY_BUFFERS_RESIDENT] = 0;
+        for (size_t i = 0; i < ngli_darray_count(nodes_buf_array_res); i++)
+            priv->sizes[MEMORY_BUFFERS_RESIDENT] += ngli_node_buffer_get_resident_size(nodes_buf_res[i]);
+        priv->resident_countdown = MEMORY_RESIDENT_SAMPLING_PERIOD - 1;
+    }
+
     struct darray *nodes_blk_array_cpu = &priv->nodes[MEMORY_BLOCKS_CPU];
     struct ngl_node **nodes_blk_cpu = ngli_darray_data(nodes_blk_array_cpu);
     priv->sizes[MEMORY_BLOCKS_CPU] = 0;
@@ -495,6 +578,10 @@ static void widget_memory_make_stats(struct hud *s, struct widget *widget)
         priv->sizes[MEMORY_TEXTURES] += ngli_image_get_memory_size(&texture->image)
                                       * tex_node->is_active;
     }
+
+    const struct gpu_memory_stats *memory_stats = &s->ctx->gpu_ctx->memory_stats;
+    priv->sizes[MEMORY_DEVICE_ALLOCATED] = memory_stats->allocated;
+    priv->sizes[MEMORY_DEVICE_USED] = memory_stats->used;
 }
 
 static void widget_activity_make_stats(struct hud *s, struct widget *widget)
@@ -517,6 +604,21 @@ static void widget_drawcall_make_stats(struct hud *s, struct widget *widget)
         priv->nb_draws += nodes[i]->draw_count;
 }
 
+static void widget_bind_make_stats(struct hud *s, struct widget *widget)
+{
+    const struct ngl_ctx *ctx = s->ctx;
+    const struct gpu_bind_stats *stats = &ctx->gpu_ctx->bind_stats;
+    const struct bind_spec *spec = widget->user_data;
+    struct widget_bind *priv = widget->priv_data;
+    priv->nb_binds = spec == &bind_specs[BIND_ISSUED] ? stats->nb_issued : stats->nb_skipped;
+}
+
+static void widget_update_make_stats(struct hud *s, struct widget *widget)
+{
+    struct widget_update *priv = widget->priv_data;
+    priv->nb_parallel_updates = s->ctx->nb_parallel_updates;
+}
+
 /* Draw utils */
 
 static inline uint8_t *set_color(uint8_t *p, uint32_t rgba)
@@ -734,6 +836,37 @@ static void widget_drawcall_draw(struct hud *s, struct widget *widget)
     draw_block_graph(s, d, &widget->graph_rect, d->amin, d->amax, color);
 }
 
+static void widget_bind_draw(struct hud *s, struct widget *widget)
+{
+    struct widget_bind *priv = widget->priv_data;
+    const struct bind_spec *spec = widget->user_data;
+    const uint32_t color = 0xf4983dff;
+
+    char buf[BIND_WIDGET_TEXT_LEN + 1];
+    snprintf(buf, sizeof(buf), "%zu", priv->nb_binds);
+    print_text(s, widget->text_x, widget->text_y, spec->label, color);
+    print_text(s, widget->text_x, widget->text_y + NGLI_FONT_H, buf, color);
+
+    struct data_graph *d = &widget->data_graph[0];
+    register_graph_value(d, priv->nb_binds);
+    draw_block_graph(s, d, &widget->graph_rect, d->amin, d->amax, color);
+}
+
+static void widget_update_draw(struct hud *s, struct widget *widget)
+{
+    struct widget_update *priv = widget->priv_data;
+    const uint32_t color = 0x3dc8f4ff;
+
+    char buf[UPDATE_WIDGET_TEXT_LEN + 1];
+    snprintf(buf, sizeof(buf), "%zu", priv->nb_parallel_updates);
+    print_text(s, widget->text_x, widget->text_y, "Par. updates", color);
+    print_text(s, widget->text_x, widget->text_y + NGLI_FONT_H, buf, color);
+
+    struct data_graph *d = &widget->data_graph[0];
+    register_graph_value(d, priv->nb_parallel_updates);
+    draw_block_graph(s, d, &widget->graph_rect, d->amin, d->amax, color);
+}
+
 /* Widget CSV header */
 
 static void widget_latency_csv_header(struct hud *s, struct widget *widget, struct bstr *dst)
@@ -760,6 +893,17 @@ static void widget_drawcall_csv_header(struct hud *s, struct widget *widget, str
     ngli_bstr_print(dst, spec->label);
 }
 
+static void widget_bind_csv_header(struct hud *s, struct widget *widget, struct bstr *dst)
+{
+    const struct bind_spec *spec = widget->user_data;
+    ngli_bstr_print(dst, spec->label);
+}
+
+static void widget_update_csv_header(struct hud *s, struct widget *widget, struct bstr *dst)
+{
+    ngli_bstr_print(dst, "Par. updates");
+}
+
 /* Widget CSV report */
 
 static void widget_latency_csv_report(struct hud *s, struct widget *widget, struct bstr *dst)
@@ -792,6 +936,18 @@ static void widget_drawcall_csv_report(struct hud *s, struct widget *widget, str
     ngli_bstr_printf(dst, "%d", priv->nb_draws);
 }
 
+static void widget_bind_csv_report(struct hud *s, struct widget *widget, struct bstr *dst)
+{
+    const struct widget_bind *priv = widget->priv_data;
+    ngli_bstr_printf(dst, "%zu", priv->nb_binds);
+}
+
+static void widget_update_csv_report(struct hud *s, struct widget *widget, struct bstr *dst)
+{
+    const struct widget_update *priv = widget->priv_data;
+    ngli_bstr_printf(dst, "%zu", priv->nb_parallel_updates);
+}
+
 /* Widget uninit */
 
 static void widget_latency_uninit(struct hud *s, struct widget *widget)
@@ -820,6 +976,14 @@ static void widget_drawcall_uninit(struct hud *s, struct widget *widget)
     ngli_darray_reset(&priv->nodes);
 }
 
+static void widget_bind_uninit(struct hud *s, struct widget *widget)
+{
+}
+
+static void widget_update_uninit(struct hud *s, struct widget *widget)
+{
+}
+
 static const struct widget_spec widget_specs[] = {
     [WIDGET_LATENCY] = {
         .text_cols     = LATENCY_WIDGET_TEXT_LEN,
@@ -873,6 +1037,32 @@ static const struct widget_spec widget_specs[] = {
         .csv_report    = widget_drawcall_csv_report,
         .uninit        = widget_drawcall_uninit,
     },
+    [WIDGET_BIND]      = {
+        .text_cols     = BIND_WIDGET_TEXT_LEN,
+        .text_rows     = 2,
+        .graph_h       = 40,
+        .nb_data_graph = 1,
+        .priv_size     = sizeof(struct widget_bind),
+        .init          = widget_bind_init,
+        .make_stats    = widget_bind_make_stats,
+        .draw          = widget_bind_draw,
+        .csv_header    = widget_bind_csv_header,
+        .csv_report    = widget_bind_csv_report,
+        .uninit        = widget_bind_uninit,
+    },
+    [WIDGET_UPDATE]    = {
+        .text_cols     = UPDATE_WIDGET_TEXT_LEN,
+        .text_rows     = 2,
+        .graph_h       = 40,
+        .nb_data_graph = 1,
+        .priv_size     = sizeof(struct widget_update),
+        .init          = widget_update_init,
+        .make_stats    = widget_update_make_stats,
+        .draw          = widget_update_draw,
+        .csv_header    = widget_update_csv_header,
+        .csv_report    = widget_update_csv_report,
+        .uninit        = widget_update_uninit,
+    },
 };
 
 static inline int get_widget_width(enum widget_type type)
@@ -972,7 +1162,10 @@ static int widgets_init(struct hud *s)
     const int latency_width  = get_widget_width(WIDGET_LATENCY);
     const int memory_width   = get_widget_width(WIDGET_MEMORY);
     const int activity_width = get_widget_width(WIDGET_ACTIVITY) * NB_ACTIVITY + WIDGET_MARGIN * (NB_ACTIVITY - 1);
-    const int drawcall_width = get_widget_width(WIDGET_DRAWCALL) * NB_DRAWCALL + WIDGET_MARGIN * (NB_DRAWCALL - 1);
+    const int drawcall_width = get_widget_width(WIDGET_DRAWCALL) * NB_DRAWCALL
+                             + get_widget_width(WIDGET_BIND) * NB_BIND
+                             + get_widget_width(WIDGET_UPDATE)
+                             + WIDGET_MARGIN * (NB_DRAWCALL + NB_BIND);
 
     s->canvas.w = WIDGET_MARGIN * 2
                 + NGLI_MAX(NGLI_MAX(NGLI_MAX(latency_width, memory_width), activity_width), drawcall_width);
@@ -1019,6 +1212,21 @@ static int widgets_init(struct hud *s)
         x_drawcall += x_drawcall_step;
     }
 
+    /* Bind commands counter widgets following the draw-calls ones */
+    int x_bind = x_drawcall;
+    const int x_bind_step = get_widget_width(WIDGET_BIND) + WIDGET_MARGIN;
+    for (size_t i = 0; i < NB_BIND; i++) {
+        ret = create_widget(s, WIDGET_BIND, &bind_specs[i], x_bind, y_drawcall);
+        if (ret < 0)
+            return ret;
+        x_bind += x_bind_step;
+    }
+
+    /* Parallel updates counter widget following the bind ones */
+    ret = create_widget(s, WIDGET_UPDATE, NULL, x_bind, y_drawcall);
+    if (ret < 0)
+        return ret;
+
     /* Call init on every widget */
     struct darray *widgets_array = &s->widgets;
     struct widget *widgets = ngli_darray_data(widgets_array);
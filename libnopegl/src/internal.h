@@ -40,6 +40,7 @@
 
 #include "animation.h"
 #include "block.h"
+#include "captureconv.h"
 #include "drawutils.h"
 #include "graphics_state.h"
 #include "hmap.h"
@@ -59,11 +60,18 @@
 #include "rnode.h"
 #include "rtt.h"
 #include "texture.h"
+#include "threadpool.h"
 
 struct node_class;
 
 typedef int (*cmd_func_type)(struct ngl_ctx *s, void *arg);
 
+struct async_frame {
+    double t;
+    void *capture_buffer;
+    int ret;
+};
+
 struct api_impl {
     int (*configure)(struct ngl_ctx *s, const struct ngl_config *config);
     int (*resize)(struct ngl_ctx *s, int32_t width, int32_t height, const int32_t *viewport);
@@ -71,6 +79,7 @@ struct api_impl {
     int (*set_scene)(struct ngl_ctx *s, struct ngl_scene *scene);
     int (*prepare_draw)(struct ngl_ctx *s, double t);
     int (*draw)(struct ngl_ctx *s, double t);
+    int (*draw_async)(struct ngl_ctx *s, double t, void *capture_buffer);
     void (*reset)(struct ngl_ctx *s, int action);
 
     /* OpenGL */
@@ -100,8 +109,16 @@ struct ngl_ctx {
     struct rendertarget *available_rendertargets[2];
     struct rendertarget *current_rendertarget;
     int render_pass_started;
+    struct draw_batch *draw_batch;
     struct darray modelview_matrix_stack;
     struct darray projection_matrix_stack;
+    uint64_t draw_id; // incremented at every drawn frame
+
+    /*
+     * Merged node address -> node it is merged into, only set while the scene
+     * is attached (see ngl_config.dedup_nodes)
+     */
+    struct hmap *merged_nodes;
 
     /*
      * Array of nodes that are candidate to either prefetch (active) or release
@@ -110,9 +127,30 @@ struct ngl_ctx {
      */
     struct darray activitycheck_nodes;
 
+    /*
+     * Active nodes flagged with NGLI_NODE_FLAG_PARALLEL_UPDATE, updated on the
+     * update_pool threads before the regular update (see
+     * ngl_config.update_threads). They are inserted from the leaves up to the
+     * root and updated by waves: a wave contains the nodes whose subtree is
+     * already up-to-date.
+     */
+    struct threadpool *update_pool;
+    struct darray parallel_update_nodes;
+    struct darray parallel_update_wave;
+    int time_remapping_depth;   // number of NGLI_NODE_FLAG_TIME_REMAPPING nodes in the current visit branch
+    size_t nb_parallel_updates; // nodes updated on the update_pool threads for the last frame
+
+    /*
+     * Private attachments shared by the non-interrupted render passes of the
+     * RenderToTexture and Texture nodes (see rtt.c)
+     */
+    struct darray transient_attachments;
+
     struct hmap *text_builtin_atlasses; // struct text_builtin_atlas
+    struct text_external_cache *text_external_cache;
 
     struct pgcache pgcache;
+    struct captureconv captureconv;
 #if defined(HAVE_VAAPI)
     struct vaapi_ctx vaapi_ctx;
 #endif
@@ -131,12 +169,25 @@ struct ngl_ctx {
     cmd_func_type cmd_func;
     void *cmd_arg;
     int cmd_ret;
+
+    /*
+     * Ring of frames submitted with ngl_draw_async(): the oldest frame is at
+     * async_wait_index, the last nb_async_queued frames are still waiting to
+     * be drawn by the worker, and the nb_async_pending frames preceding them
+     * are drawn but their capture is not completed yet.
+     */
+    struct async_frame async_frames[NGL_MAX_FRAMES_IN_FLIGHT];
+    size_t async_wait_index;
+    size_t nb_async_frames;
+    size_t nb_async_queued;
+    size_t nb_async_pending;
 };
 
 #define NGLI_ACTION_KEEP_SCENE  0
 #define NGLI_ACTION_UNREF_SCENE 1
 
 int ngli_ctx_dispatch_cmd(struct ngl_ctx *s, cmd_func_type cmd_func, void *arg);
+int ngli_ctx_draw_async(struct ngl_ctx *s, double t, void *capture_buffer);
 int ngli_ctx_configure(struct ngl_ctx *s, const struct ngl_config *config);
 int ngli_ctx_resize(struct ngl_ctx *s, int32_t width, int32_t height, const int32_t *viewport);
 int ngli_ctx_set_capture_buffer(struct ngl_ctx *s, void *capture_buffer);
@@ -145,6 +196,10 @@ int ngli_ctx_prepare_draw(struct ngl_ctx *s, double t);
 int ngli_ctx_draw(struct ngl_ctx *s, double t);
 void ngli_ctx_reset(struct ngl_ctx *s, int action);
 
+int64_t ngli_ctx_get_nb_frames(const struct ngl_ctx *s);
+double ngli_ctx_get_frame_time(const struct ngl_ctx *s, int64_t frame);
+int64_t ngli_ctx_get_frame_index(const struct ngl_ctx *s, double t);
+
 #define NGLI_NODE_NONE 0xffffffff
 
 struct ngl_node {
@@ -158,6 +213,7 @@ struct ngl_node {
 
     double visit_time;
     double last_update_time;
+    int time_dependent;
 
     int draw_count;
 
@@ -167,6 +223,14 @@ struct ngl_node {
     struct darray children;
     struct darray parents;
 
+    /*
+     * Node this node is merged into while it is attached to a context (see
+     * ngl_config.dedup_nodes): the merged node is never initialized, it
+     * shares the private data of that node and forwards its prepare, visit,
+     * update and draw to it
+     */
+    struct ngl_node *merged_into;
+
     char *label;
 
     void *priv_data;
@@ -197,6 +261,8 @@ struct buffer_layout {
 
 #define NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD (1 << 0) /* The buffer is responsible for uploading its data to the GPU */
 #define NGLI_BUFFER_INFO_FLAG_DYNAMIC    (1 << 1) /* The buffer CPU data may change at every update */
+#define NGLI_BUFFER_INFO_FLAG_RESIDENT   (1 << 2) /* The whole stream is meant to live in GPU memory, the consumer selects the current chunk */
+#define NGLI_BUFFER_INFO_FLAG_MAPPED     (1 << 3) /* The buffer CPU data is a read-only mapping of a file */
 
 struct buffer_info {
     struct buffer_layout layout;
@@ -215,6 +281,13 @@ struct buffer_info {
 void ngli_node_buffer_extend_usage(struct ngl_node *node, int usage);
 size_t ngli_node_buffer_get_cpu_size(struct ngl_node *node);
 size_t ngli_node_buffer_get_gpu_size(struct ngl_node *node);
+size_t ngli_node_buffer_get_mapped_size(struct ngl_node *node);
+size_t ngli_node_buffer_get_resident_size(struct ngl_node *node);
+
+size_t ngli_node_streamedbuffer_get_index(const struct ngl_node *node);
+size_t ngli_node_streamedbuffer_get_nb_chunks(const struct ngl_node *node);
+const uint8_t *ngli_node_streamedbuffer_get_chunk(const struct ngl_node *node, size_t index);
+int ngli_node_streamedbuffer_has_same_clock(const struct ngl_node *node, const struct ngl_node *other);
 
 struct livectl {
     union ngl_livectl_data val;
@@ -246,6 +319,19 @@ struct variable_info {
 
 int ngli_velocity_evaluate(struct ngl_node *node, void *dst, double t);
 
+/*
+ * Sample the animation at every frame of the scene (see
+ * ngl_config.bake_animations). A parent only reading the values from its
+ * baked buffers registers itself as a consumer of the baked values with
+ * ngli_node_animated_ref_baked() and releases itself with
+ * ngli_node_animated_unref_baked(). When all the parents of the node are such
+ * consumers, the node skips its evaluation at the frame times.
+ */
+int ngli_node_animated_can_bake(const struct ngl_node *node);
+int ngli_node_animated_bake(struct ngl_node *node, void *dst, size_t dst_stride, size_t nb_frames);
+void ngli_node_animated_ref_baked(struct ngl_node *node);
+void ngli_node_animated_unref_baked(struct ngl_node *node);
+
 struct block_info {
     struct block block;
 
@@ -254,6 +340,8 @@ struct block_info {
     int usage;
 
     struct buffer *buffer;
+    size_t buffer_offset;   // offset of the bound block data in buffer
+    size_t buffer_size;     // size of the bound block data in buffer (0 means the whole buffer)
     size_t buffer_rev;
 };
 
@@ -329,6 +417,21 @@ struct transform {
     NGLI_ALIGNED_MAT(matrix);
 };
 
+/*
+ * Run of consecutive sibling render nodes drawn with a single instanced draw
+ * (see node_group.c). While ctx->draw_batch is set, the render nodes record
+ * their per instance data into the pipeline prepared by the leader of the run
+ * on the batch rnode, and the leader draws all of them when the batch is
+ * flushed.
+ */
+struct draw_batch {
+    struct ngl_node *leader;
+    struct rnode *rnode;
+};
+
+int ngli_node_renderother_batch_is_compatible(const struct ngl_node *leader, const struct ngl_node *node);
+void ngli_node_renderother_batch_flush(const struct draw_batch *batch);
+
 struct io_opts {
     int precision_out;
     int precision_in;
@@ -518,6 +621,45 @@ enum {
  */
 #define NGLI_NODE_FLAG_LIVECTL (1 << 0)
 
+/*
+ * The node update depends on the time (animations, streams, medias, ...).
+ *
+ * A node is considered time dependent if its class is flagged as such or if
+ * any of its children is time dependent. Once updated, the other nodes are
+ * only updated again after a live change in their branch or a release.
+ */
+#define NGLI_NODE_FLAG_TIME_DEPENDENT (1 << 1)
+
+/*
+ * The update callback only reads the node options and writes its private
+ * data: it does not update any node outside its subtree nor access the GPU
+ * context, and can thus run on a worker thread (see
+ * ngl_config.update_threads). The GPU side of the update must be implemented
+ * in the commit callback.
+ *
+ * A node with children is only updated on a worker thread once its children
+ * are up-to-date for the frame time.
+ */
+#define NGLI_NODE_FLAG_PARALLEL_UPDATE (1 << 2)
+
+/*
+ * The node behaviour only depends on its parameters and children, and it is
+ * never written by the graph: 2 such nodes of the same class with equal
+ * parameters can be merged into a single instance (see
+ * ngl_config.dedup_nodes). The class must not expose any parameter flagged
+ * with NGLI_PARAM_FLAG_ALLOW_LIVE_CHANGE.
+ */
+#define NGLI_NODE_FLAG_MERGEABLE (1 << 3)
+
+/*
+ * The update callback updates all the children itself, at times remapped from
+ * the frame time (typically the Text effects). The children are thus never
+ * updated in parallel at the frame time, and such a node flagged with
+ * NGLI_NODE_FLAG_PARALLEL_UPDATE is only updated on a worker thread if no node
+ * of its subtree is shared with another parent.
+ */
+#define NGLI_NODE_FLAG_TIME_REMAPPING (1 << 4)
+
 /*
  * Specifications of a node.
  *
@@ -631,6 +773,18 @@ struct node_class {
      */
     int (*update)(struct ngl_node *node, double t);
 
+    /*
+     * Upload the result of the update to the GPU. Only meaningful for nodes
+     * flagged with NGLI_NODE_FLAG_PARALLEL_UPDATE, for which the update may
+     * have run on a worker thread.
+     *
+     * reentrant: no (called once after each update)
+     * execution-order: loose
+     * dispatch: managed
+     * when: straight after the update, on the rendering thread
+     */
+    int (*commit)(struct ngl_node *node);
+
     /*
      * Apply transforms and execute graphics and compute pipelines.
      *
@@ -683,10 +837,29 @@ struct node_class {
     const char *file;
 };
 
+/*
+ * Binary scene format (all values little-endian):
+ * - header (NGLI_SCENE_BIN_HEADER_SIZE bytes): magic, format version, library
+ *   version, number of nodes, duration, framerate, aspect ratio, then the
+ *   offset and size of the node table and the offset of the data section
+ * - node table: one record per node, dependencies first, holding the node
+ *   type, the number of non-default parameters and the typed parameters
+ * - data section: raw blobs of the data parameters, each aligned on
+ *   NGLI_SCENE_BIN_DATA_ALIGN bytes from the start of the file
+ */
+#define NGLI_SCENE_BIN_MAGIC       "NGLB"
+#define NGLI_SCENE_BIN_VERSION     1
+#define NGLI_SCENE_BIN_HEADER_SIZE 64
+#define NGLI_SCENE_BIN_DATA_ALIGN  64
+#define NGLI_SCENE_BIN_NODE_REF    0xff /* parameter kind of a node set in place of a value */
+
 /* Internal scene API */
 int ngli_scene_deserialize(struct ngl_scene *s, const char *str);
+int ngli_scene_deserialize_binary(struct ngl_scene *s, const uint8_t *data, size_t size);
 char *ngli_scene_serialize(const struct ngl_scene *s);
+int ngli_scene_serialize_binary(const struct ngl_scene *s, uint8_t **datap, size_t *sizep);
 char *ngli_scene_dot(const struct ngl_scene *s);
+int ngli_scene_dedup(const struct ngl_scene *s, struct hmap *merged, size_t *nb_nodesp, size_t *sizep);
 
 void ngli_node_print_specs(void);
 
@@ -694,6 +867,7 @@ int ngli_node_prepare(struct ngl_node *node);
 int ngli_node_prepare_children(struct ngl_node *node);
 int ngli_node_visit(struct ngl_node *node, int is_active, double t);
 int ngli_node_honor_release_prefetch(struct ngl_node *scene, double t);
+int ngli_node_update_parallel(struct ngl_node *scene, double t);
 int ngli_node_update(struct ngl_node *node, double t);
 int ngli_node_update_children(struct ngl_node *node, double t);
 void *ngli_node_get_data_ptr(struct ngl_node *var_node, void *data_fallback);
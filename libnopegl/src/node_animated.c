@@ -21,11 +21,13 @@
 
 #include <float.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include "animation.h"
 #include "colorconv.h"
 #include "log.h"
 #include "math_utils.h"
+#include "memory.h"
 #include "nopegl.h"
 #include "internal.h"
 #include "path.h"
@@ -104,6 +106,10 @@ struct animated_priv {
     double dval;
     struct animation anim;
     struct animation anim_eval;
+    size_t nb_baked_refs;
+    int all_consumers_baked;
+    const struct path *path;
+    int path_arc_hint;
 };
 
 NGLI_STATIC_ASSERT(variable_info_is_first, offsetof(struct animated_priv, var) == 0);
@@ -126,15 +132,26 @@ static void mix_float(void *user_arg, void *dst,
     dstd[0] = (float)NGLI_MIX_F64(kf0->scalar, kf1->scalar, ratio);
 }
 
+static void mix_float_batch(void *user_arg, void *dst, size_t dst_stride,
+                            const struct animkeyframe_opts *kf0,
+                            const struct animkeyframe_opts *kf1,
+                            const double *ratios, size_t nb_ratios)
+{
+    uint8_t *dstp = dst;
+    for (size_t i = 0; i < nb_ratios; i++) {
+        *(float *)dstp = (float)NGLI_MIX_F64(kf0->scalar, kf1->scalar, ratios[i]);
+        dstp += dst_stride;
+    }
+}
+
 static void mix_path(void *user_arg, void *dst,
                      const struct animkeyframe_opts *kf0,
                      const struct animkeyframe_opts *kf1,
                      double ratio)
 {
     const float t = (float)NGLI_MIX_F64(kf0->scalar, kf1->scalar, ratio);
-    const struct variable_opts *o = user_arg;
-    struct path *path = *(struct path **)o->path_node->priv_data;
-    ngli_path_evaluate(path, dst, t);
+    struct animated_priv *s = user_arg;
+    ngli_path_evaluate(s->path, dst, t, &s->path_arc_hint);
 }
 
 static void mix_quat(void *user_arg, void *dst,
@@ -171,6 +188,28 @@ static void mix_##space(void *user_arg, void *dst,              \
     };                                                          \
     ngli_colorconv_linear2srgb(dst, mixed);                     \
 }                                                               \
+                                                                \
+static void mix_##space##_batch(void *user_arg, void *dst,      \
+        size_t dst_stride,                                      \
+        const struct animkeyframe_opts *kf0,                    \
+        const struct animkeyframe_opts *kf1,                    \
+        const double *ratios, size_t nb_ratios)                 \
+{                                                               \
+    float rgb0[3], rgb1[3];                                     \
+    ngli_colorconv_##space##2linear(rgb0, kf0->value);          \
+    ngli_colorconv_##space##2linear(rgb1, kf1->value);          \
+    uint8_t *dstp = dst;                                        \
+    for (size_t i = 0; i < nb_ratios; i++) {                    \
+        const float ratio = (float)ratios[i];                   \
+        const float mixed[3] = {                                \
+            NGLI_MIX_F32(rgb0[0], rgb1[0], ratio),              \
+            NGLI_MIX_F32(rgb0[1], rgb1[1], ratio),              \
+            NGLI_MIX_F32(rgb0[2], rgb1[2], ratio),              \
+        };                                                      \
+        ngli_colorconv_linear2srgb((float *)dstp, mixed);       \
+        dstp += dst_stride;                                     \
+    }                                                           \
+}                                                               \
 
 DECLARE_COLOR_MIX_FUNCS(srgb)
 DECLARE_COLOR_MIX_FUNCS(hsl)
@@ -195,6 +234,23 @@ static void mix_vec##len(void *user_arg, void *dst,             \
     mix_vector(user_arg, dst, kf0, kf1, ratio, len);            \
 }                                                               \
                                                                 \
+static void mix_vec##len##_batch(void *user_arg, void *dst,     \
+        size_t dst_stride,                                      \
+        const struct animkeyframe_opts *kf0,                    \
+        const struct animkeyframe_opts *kf1,                    \
+        const double *ratios, size_t nb_ratios)                 \
+{                                                               \
+    uint8_t *dstp = dst;                                        \
+    for (size_t i = 0; i < nb_ratios; i++) {                    \
+        float *dstf = (float *)dstp;                            \
+        const float ratio = (float)ratios[i];                   \
+        for (size_t j = 0; j < len; j++)                        \
+            dstf[j] = NGLI_MIX_F32(kf0->value[j],               \
+                                   kf1->value[j], ratio);       \
+        dstp += dst_stride;                                     \
+    }                                                           \
+}                                                               \
+                                                                \
 static void cpy_vec##len(void *user_arg, void *dst,             \
                          const struct animkeyframe_opts *kf)    \
 {                                                               \
@@ -208,9 +264,8 @@ DECLARE_VEC_MIX_AND_CPY_FUNCS(4)
 static void cpy_path(void *user_arg, void *dst,
                      const struct animkeyframe_opts *kf)
 {
-    const struct variable_opts *o = user_arg;
-    struct path *path = *(struct path **)o->path_node->priv_data;
-    ngli_path_evaluate(path, dst, (float)kf->scalar);
+    struct animated_priv *s = user_arg;
+    ngli_path_evaluate(s->path, dst, (float)kf->scalar, &s->path_arc_hint);
 }
 
 static void cpy_time(void *user_arg, void *dst,
@@ -235,6 +290,16 @@ static ngli_animation_mix_func_type get_color_mix_func(int space)
     return NULL;
 }
 
+static ngli_animation_mix_batch_func_type get_color_mix_batch_func(int space)
+{
+    switch (space) {
+    case NGLI_COLORCONV_SPACE_SRGB:  return mix_srgb_batch;
+    case NGLI_COLORCONV_SPACE_HSL:   return mix_hsl_batch;
+    case NGLI_COLORCONV_SPACE_HSV:   return mix_hsv_batch;
+    }
+    return NULL;
+}
+
 static ngli_animation_cpy_func_type get_color_cpy_func(int space)
 {
     switch (space) {
@@ -260,6 +325,18 @@ static ngli_animation_mix_func_type get_mix_func(const struct variable_opts *o,
     return NULL;
 }
 
+static ngli_animation_mix_batch_func_type get_mix_batch_func(const struct variable_opts *o, int node_class)
+{
+    switch (node_class) {
+        case NGL_NODE_ANIMATEDFLOAT: return mix_float_batch;
+        case NGL_NODE_ANIMATEDVEC2:  return mix_vec2_batch;
+        case NGL_NODE_ANIMATEDVEC3:  return mix_vec3_batch;
+        case NGL_NODE_ANIMATEDVEC4:  return mix_vec4_batch;
+        case NGL_NODE_ANIMATEDCOLOR: return get_color_mix_batch_func(o->space);
+    }
+    return NULL;
+}
+
 static ngli_animation_cpy_func_type get_cpy_func(const struct variable_opts *o, int node_class)
 {
     switch (node_class) {
@@ -275,19 +352,39 @@ static ngli_animation_cpy_func_type get_cpy_func(const struct variable_opts *o,
     return NULL;
 }
 
-int ngl_anim_evaluate(struct ngl_node *node, void *dst, double t)
+static int is_velocity_node(const struct ngl_node *node)
 {
-    if (node->cls->id == NGL_NODE_VELOCITYFLOAT ||
-        node->cls->id == NGL_NODE_VELOCITYVEC2 ||
-        node->cls->id == NGL_NODE_VELOCITYVEC3 ||
-        node->cls->id == NGL_NODE_VELOCITYVEC4)
-        return ngli_velocity_evaluate(node, dst, t);
+    return node->cls->id == NGL_NODE_VELOCITYFLOAT ||
+           node->cls->id == NGL_NODE_VELOCITYVEC2 ||
+           node->cls->id == NGL_NODE_VELOCITYVEC3 ||
+           node->cls->id == NGL_NODE_VELOCITYVEC4;
+}
+
+static size_t get_eval_size(const struct ngl_node *node)
+{
+    switch (node->cls->id) {
+    case NGL_NODE_ANIMATEDFLOAT:
+    case NGL_NODE_VELOCITYFLOAT: return 1 * sizeof(float);
+    case NGL_NODE_ANIMATEDVEC2:
+    case NGL_NODE_VELOCITYVEC2:  return 2 * sizeof(float);
+    case NGL_NODE_ANIMATEDVEC3:
+    case NGL_NODE_ANIMATEDCOLOR:
+    case NGL_NODE_VELOCITYVEC3:  return 3 * sizeof(float);
+    case NGL_NODE_ANIMATEDVEC4:
+    case NGL_NODE_ANIMATEDQUAT:
+    case NGL_NODE_VELOCITYVEC4:  return 4 * sizeof(float);
+    }
+    return 0;
+}
 
+static int init_anim_eval(struct ngl_node *node)
+{
     if (node->cls->id != NGL_NODE_ANIMATEDFLOAT &&
         node->cls->id != NGL_NODE_ANIMATEDVEC2 &&
         node->cls->id != NGL_NODE_ANIMATEDVEC3 &&
         node->cls->id != NGL_NODE_ANIMATEDVEC4 &&
-        node->cls->id != NGL_NODE_ANIMATEDQUAT)
+        node->cls->id != NGL_NODE_ANIMATEDQUAT &&
+        node->cls->id != NGL_NODE_ANIMATEDCOLOR)
         return NGL_ERROR_INVALID_ARG;
 
     struct animated_priv *s = node->priv_data;
@@ -307,6 +404,7 @@ int ngl_anim_evaluate(struct ngl_node *node, void *dst, double t)
                                       get_cpy_func(o, node->cls->id));
         if (ret < 0)
             return ret;
+        s->anim_eval.mix_batch_func = get_mix_batch_func(o, node->cls->id);
     }
 
     struct animkeyframe_priv *kf0 = o->animkf[0]->priv_data;
@@ -318,15 +416,113 @@ int ngl_anim_evaluate(struct ngl_node *node, void *dst, double t)
         }
     }
 
+    return 0;
+}
+
+int ngl_anim_evaluate(struct ngl_node *node, void *dst, double t)
+{
+    if (is_velocity_node(node))
+        return ngli_velocity_evaluate(node, dst, t);
+
+    int ret = init_anim_eval(node);
+    if (ret < 0)
+        return ret;
+
+    struct animated_priv *s = node->priv_data;
     return ngli_animation_evaluate(&s->anim_eval, dst, t);
 }
 
+int ngl_anim_evaluate_batch(struct ngl_node *node, const double *ts, size_t nb_ts, void *dst)
+{
+    if (is_velocity_node(node)) {
+        const size_t size = get_eval_size(node);
+        uint8_t *dstp = dst;
+        for (size_t i = 0; i < nb_ts; i++) {
+            int ret = ngli_velocity_evaluate(node, dstp, ts[i]);
+            if (ret < 0)
+                return ret;
+            dstp += size;
+        }
+        return 0;
+    }
+
+    int ret = init_anim_eval(node);
+    if (ret < 0)
+        return ret;
+
+    struct animated_priv *s = node->priv_data;
+    return ngli_animation_evaluate_batch(&s->anim_eval, dst, get_eval_size(node), ts, nb_ts);
+}
+
+int ngli_node_animated_can_bake(const struct ngl_node *node)
+{
+    return node->cls->id == NGL_NODE_ANIMATEDFLOAT ||
+           node->cls->id == NGL_NODE_ANIMATEDVEC2 ||
+           node->cls->id == NGL_NODE_ANIMATEDVEC3 ||
+           node->cls->id == NGL_NODE_ANIMATEDVEC4 ||
+           node->cls->id == NGL_NODE_ANIMATEDCOLOR;
+}
+
+int ngli_node_animated_bake(struct ngl_node *node, void *dst, size_t dst_stride, size_t nb_frames)
+{
+    ngli_assert(ngli_node_animated_can_bake(node));
+
+    int ret = init_anim_eval(node);
+    if (ret < 0)
+        return ret;
+
+    double *ts = ngli_calloc(nb_frames, sizeof(*ts));
+    if (!ts)
+        return NGL_ERROR_MEMORY;
+    for (size_t i = 0; i < nb_frames; i++)
+        ts[i] = ngli_ctx_get_frame_time(node->ctx, (int64_t)i);
+
+    struct animated_priv *s = node->priv_data;
+    ret = ngli_animation_evaluate_batch(&s->anim_eval, dst, dst_stride, ts, nb_frames);
+    ngli_free(ts);
+    return ret;
+}
+
+static void update_baked_state(struct ngl_node *node)
+{
+    struct animated_priv *s = node->priv_data;
+
+    /*
+     * A parent may reference the node several times (typically in both the
+     * vertex and fragment resources of a Render) but is a single consumer
+     */
+    size_t nb_consumers = 0;
+    struct ngl_node **parents = ngli_darray_data(&node->parents);
+    for (size_t i = 0; i < ngli_darray_count(&node->parents); i++) {
+        size_t j = 0;
+        while (j < i && parents[j] != parents[i])
+            j++;
+        nb_consumers += j == i;
+    }
+    s->all_consumers_baked = s->nb_baked_refs && s->nb_baked_refs == nb_consumers;
+}
+
+void ngli_node_animated_ref_baked(struct ngl_node *node)
+{
+    struct animated_priv *s = node->priv_data;
+    s->nb_baked_refs++;
+    update_baked_state(node);
+}
+
+void ngli_node_animated_unref_baked(struct ngl_node *node)
+{
+    struct animated_priv *s = node->priv_data;
+    ngli_assert(s->nb_baked_refs > 0);
+    s->nb_baked_refs--;
+    update_baked_state(node);
+}
+
 static int animation_init(struct ngl_node *node)
 {
     struct animated_priv *s = node->priv_data;
     const struct variable_opts *o = node->opts;
     s->var.dynamic = 1;
-    return ngli_animation_init(&s->anim, node->opts,
+    return ngli_animation_init(&s->anim, s,
                                o->animkf, o->nb_animkf,
                                get_mix_func(o, node->cls->id),
                                get_cpy_func(o, node->cls->id));
@@ -395,15 +591,25 @@ static int animatedquat_init(struct ngl_node *node)
 static int animatedpath_init(struct ngl_node *node)
 {
     struct animated_priv *s = node->priv_data;
+    const struct variable_opts *o = node->opts;
     s->var.data = s->vector;
     s->var.data_size = 3 * sizeof(*s->vector);
     s->var.data_type = NGLI_TYPE_VEC3;
+    s->path = *(struct path **)o->path_node->priv_data;
     return animation_init(node);
 }
 
 static int animation_update(struct ngl_node *node, double t)
 {
     struct animated_priv *s = node->priv_data;
+
+    /*
+     * If all the parents fetch the values from their baked buffers, the
+     * evaluation is only needed for the times not matching a frame
+     */
+    if (s->all_consumers_baked && ngli_ctx_get_frame_index(node->ctx, t) >= 0)
+        return 0;
+
     return ngli_animation_evaluate(&s->anim, s->var.data, t);
 }
 
@@ -415,6 +621,16 @@ static int animation_update(struct ngl_node *node, double t)
 #define animatedpath_update  animation_update
 #define animatedcolor_update animation_update
 
+#define ANIMATED_FLAGS (NGLI_NODE_FLAG_TIME_DEPENDENT | NGLI_NODE_FLAG_PARALLEL_UPDATE | NGLI_NODE_FLAG_MERGEABLE)
+#define animatedtime_flags  ANIMATED_FLAGS
+#define animatedfloat_flags ANIMATED_FLAGS
+#define animatedvec2_flags  ANIMATED_FLAGS
+#define animatedvec3_flags  ANIMATED_FLAGS
+#define animatedvec4_flags  ANIMATED_FLAGS
+#define animatedquat_flags  ANIMATED_FLAGS
+#define animatedcolor_flags ANIMATED_FLAGS
+#define animatedpath_flags  ANIMATED_FLAGS
+
 static int animatedquat_update(struct ngl_node *node, double t)
 {
     struct animated_priv *s = node->priv_data;
@@ -437,6 +653,7 @@ const struct node_class ngli_animated##type##_class = {         \
     .opts_size = sizeof(struct variable_opts),                  \
     .priv_size = sizeof(struct animated_priv),                  \
     .params    = animated##type##_params,                       \
+    .flags     = animated##type##_flags,                        \
     .file      = __FILE__,                                      \
 };
 
@@ -80,10 +80,13 @@ static int animatedbuffer_update(struct ngl_node *node, double t)
 {
     struct animatedbuffer_priv *s = node->priv_data;
     struct buffer_info *info = &s->buf;
-    int ret = ngli_animation_evaluate(&s->anim, info->data, t);
-    if (ret < 0)
-        return ret;
+    return ngli_animation_evaluate(&s->anim, info->data, t);
+}
 
+static int animatedbuffer_commit(struct ngl_node *node)
+{
+    struct animatedbuffer_priv *s = node->priv_data;
+    struct buffer_info *info = &s->buf;
     if (!(info->flags & NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD))
         return 0;
 
@@ -186,10 +189,12 @@ const struct node_class ngli_animatedbuffer##type_name##_class = {
     .init      = animatedbuffer##type_name##_init,                                 \
     .prepare   = animatedbuffer_prepare,                                           \
     .update    = animatedbuffer_update,                                            \
+    .commit    = animatedbuffer_commit,                                            \
     .uninit    = animatedbuffer_uninit,                                            \
     .opts_size = sizeof(struct animatedbuffer_opts),                               \
     .priv_size = sizeof(struct animatedbuffer_priv),                               \
     .params    = animatedbuffer_params,                                            \
+    .flags     = NGLI_NODE_FLAG_TIME_DEPENDENT | NGLI_NODE_FLAG_PARALLEL_UPDATE,   \
     .params_id = "AnimatedBuffer",                                                 \
     .file      = __FILE__,                                                         \
 };                                                                                 \
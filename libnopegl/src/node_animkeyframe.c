@@ -584,6 +584,7 @@ const struct node_class ngli_animkeyframe##type##_class = { \
     .opts_size = sizeof(struct animkeyframe_opts),          \
     .priv_size = sizeof(struct animkeyframe_priv),          \
     .params    = animkeyframe##type##_params,               \
+    .flags     = NGLI_NODE_FLAG_MERGEABLE,                  \
     .file      = __FILE__,                                  \
 };
 
@@ -109,6 +109,11 @@ static const struct param_choices layout_choices = {
 struct block_priv {
     struct block_info blk;
     int force_update;
+
+    /* Resident mode: one copy of the block per chunk of the streamed fields */
+    const struct ngl_node *clock_node;
+    size_t nb_chunks;
+    size_t chunk_size;
 };
 
 struct block_opts {
@@ -144,8 +149,8 @@ size_t ngli_node_block_get_cpu_size(struct ngl_node *node)
 
 size_t ngli_node_block_get_gpu_size(struct ngl_node *node)
 {
-    struct block_info *s = node->priv_data;
-    return s->data_size;
+    struct block_priv *s = node->priv_data;
+    return s->clock_node ? s->nb_chunks * s->chunk_size : s->blk.data_size;
 }
 
 static int get_node_data_type(const struct ngl_node *node)
@@ -197,6 +202,14 @@ static const uint8_t *get_buffer_data_ptr(const struct ngl_node *node)
     return buffer->data;
 }
 
+static int is_resident_buffer(const struct ngl_node *node)
+{
+    if (node->cls->category != NGLI_NODE_CATEGORY_BUFFER)
+        return 0;
+    const struct buffer_info *buffer = node->priv_data;
+    return buffer->flags & NGLI_BUFFER_INFO_FLAG_RESIDENT;
+}
+
 static int field_is_dynamic(const struct ngl_node *node, const struct block_field *fi)
 {
     return fi->count ? is_dynamic_buffer(node) : is_dynamic_variable(node);
@@ -226,6 +239,76 @@ static int update_block_data(struct ngl_node *node, int forced)
     return has_changed;
 }
 
+static int init_resident(struct ngl_node *node)
+{
+    struct block_priv *s = node->priv_data;
+    struct block_info *info = &s->blk;
+    const struct block_opts *o = node->opts;
+
+    for (size_t i = 0; i < o->nb_fields; i++) {
+        const struct ngl_node *field_node = o->fields[i];
+        if (!is_resident_buffer(field_node))
+            continue;
+        if (!s->clock_node) {
+            s->clock_node = field_node;
+        } else if (!ngli_node_streamedbuffer_has_same_clock(s->clock_node, field_node)) {
+            LOG(ERROR, "resident fields of %s must share the same timestamps, timebase and time remapping",
+                node->label);
+            return NGL_ERROR_INVALID_ARG;
+        }
+    }
+
+    if (!s->clock_node)
+        return 0;
+
+    const struct block_field *field_info = ngli_darray_data(&info->block.fields);
+    for (size_t i = 0; i < o->nb_fields; i++) {
+        const struct ngl_node *field_node = o->fields[i];
+        if (field_is_dynamic(field_node, &field_info[i]) && !is_resident_buffer(field_node)) {
+            LOG(ERROR, "dynamic field %s.%s can not be mixed with resident fields",
+                node->label, field_node->label);
+            return NGL_ERROR_INVALID_ARG;
+        }
+    }
+
+    s->nb_chunks = ngli_node_streamedbuffer_get_nb_chunks(s->clock_node);
+    s->chunk_size = ngli_block_get_aligned_size(&info->block, 0);
+    info->buffer_size = info->data_size;
+    LOG(DEBUG, "%s is resident: %zu chunks of %zu bytes", node->label, s->nb_chunks, s->chunk_size);
+
+    return 0;
+}
+
+static int upload_resident(struct ngl_node *node)
+{
+    struct block_priv *s = node->priv_data;
+    struct block_info *info = &s->blk;
+    const struct block_opts *o = node->opts;
+    const struct block_field *field_info = ngli_darray_data(&info->block.fields);
+
+    const size_t size = s->nb_chunks * s->chunk_size;
+    uint8_t *data = ngli_calloc(1, size);
+    if (!data)
+        return NGL_ERROR_MEMORY;
+
+    update_block_data(node, 1);
+    for (size_t i = 0; i < s->nb_chunks; i++) {
+        uint8_t *dst = data + s->chunk_size * i;
+        memcpy(dst, info->data, info->data_size);
+        for (size_t j = 0; j < o->nb_fields; j++) {
+            const struct ngl_node *field_node = o->fields[j];
+            if (!is_resident_buffer(field_node))
+                continue;
+            const struct block_field *fi = &field_info[j];
+            ngli_block_field_copy(fi, dst + fi->offset, ngli_node_streamedbuffer_get_chunk(field_node, i));
+        }
+    }
+
+    int ret = ngli_buffer_upload(info->buffer, data, 0, size);
+    ngli_free(data);
+    return ret;
+}
+
 static int cmp_str(const void *a, const void *b)
 {
     const char *s0 = *(const char * const *)a;
@@ -308,9 +391,6 @@ static int block_init(struct ngl_node *node)
         const struct block_field *fi = &fields[i];
         LOG(DEBUG, "%s.field[%zu]: %s offset=%zu size=%zu stride=%zu",
             node->label, i, field_node->label, fi->offset, fi->size, fi->stride);
-
-        if (field_is_dynamic(field_node, fi))
-            info->usage |= NGLI_BUFFER_USAGE_DYNAMIC_BIT;
     }
 
     info->data_size = info->block.size;
@@ -319,6 +399,20 @@ static int block_init(struct ngl_node *node)
     if (!info->data)
         return NGL_ERROR_MEMORY;
 
+    ret = init_resident(node);
+    if (ret < 0)
+        return ret;
+
+    if (!s->clock_node) {
+        const struct block_field *field_info = ngli_darray_data(&info->block.fields);
+        for (size_t i = 0; i < o->nb_fields; i++) {
+            if (field_is_dynamic(o->fields[i], &field_info[i])) {
+                info->usage |= NGLI_BUFFER_USAGE_DYNAMIC_BIT;
+                break;
+            }
+        }
+    }
+
     update_block_data(node, 1);
     s->force_update = 1; /* First update will need an upload */
 
@@ -339,7 +433,8 @@ static int block_prepare(struct ngl_node *node)
     if (info->buffer->size)
         return 0;
 
-    int ret = ngli_buffer_init(info->buffer, info->data_size, info->usage);
+    const size_t size = s->clock_node ? s->nb_chunks * s->chunk_size : info->data_size;
+    int ret = ngli_buffer_init(info->buffer, size, info->usage);
     if (ret < 0)
         return ret;
 
@@ -364,6 +459,23 @@ static int block_update(struct ngl_node *node, double t)
     if (ret < 0)
         return ret;
 
+    if (s->clock_node) {
+        if (s->force_update) {
+            ret = upload_resident(node);
+            if (ret < 0)
+                return ret;
+            s->force_update = 0;
+        }
+
+        const size_t index = ngli_node_streamedbuffer_get_index(s->clock_node);
+        const size_t offset = s->chunk_size * index;
+        if (info->buffer_offset != offset) {
+            info->buffer_offset = offset;
+            info->buffer_rev++;
+        }
+        return 0;
+    }
+
     const int has_changed = update_block_data(node, s->force_update);
     s->force_update = 0;
 
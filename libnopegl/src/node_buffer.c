@@ -46,7 +46,7 @@ struct buffer_opts {
 
 struct buffer_priv {
     struct buffer_info buf;
-    FILE *fp;
+    struct file_map map;
 };
 
 NGLI_STATIC_ASSERT(buffer_info_is_first, offsetof(struct buffer_priv, buf) == 0);
@@ -81,7 +81,7 @@ void ngli_node_buffer_extend_usage(struct ngl_node *node, int usage)
 size_t ngli_node_buffer_get_cpu_size(struct ngl_node *node)
 {
     struct buffer_info *s = node->priv_data;
-    return s->block ? 0 : s->data_size;
+    return s->block || (s->flags & NGLI_BUFFER_INFO_FLAG_MAPPED) ? 0 : s->data_size;
 }
 
 size_t ngli_node_buffer_get_gpu_size(struct ngl_node *node)
@@ -90,6 +90,21 @@ size_t ngli_node_buffer_get_gpu_size(struct ngl_node *node)
     return s->block || !(s->flags & NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD) ? 0 : s->data_size;
 }
 
+size_t ngli_node_buffer_get_mapped_size(struct ngl_node *node)
+{
+    struct buffer_info *s = node->priv_data;
+    return s->flags & NGLI_BUFFER_INFO_FLAG_MAPPED ? s->data_size : 0;
+}
+
+size_t ngli_node_buffer_get_resident_size(struct ngl_node *node)
+{
+    struct buffer_info *info = node->priv_data;
+    if (!(info->flags & NGLI_BUFFER_INFO_FLAG_MAPPED))
+        return 0;
+    struct buffer_priv *s = node->priv_data;
+    return ngli_file_map_get_resident_size(&s->map);
+}
+
 static int buffer_init_from_data(struct ngl_node *node)
 {
     struct buffer_priv *s = node->priv_data;
@@ -117,17 +132,13 @@ static int buffer_init_from_filename(struct ngl_node *node)
     const struct buffer_opts *o = node->opts;
     struct buffer_layout *layout = &s->buf.layout;
 
-    int64_t size;
-    int ret = ngli_get_filesize(o->filename, &size);
+    int ret = ngli_file_map(o->filename, &s->map);
     if (ret < 0)
         return ret;
 
-    if (size > SIZE_MAX) {
-        LOG(ERROR, "'%s' size (%" PRId64 ") exceeds supported limit (%zu)", o->filename, size, SIZE_MAX);
-        return NGL_ERROR_UNSUPPORTED;
-    }
-
-    s->buf.data_size = (size_t)size;
+    s->buf.data = s->map.data;
+    s->buf.data_size = s->map.size;
+    s->buf.flags |= NGLI_BUFFER_INFO_FLAG_MAPPED;
     layout->count = layout->count ? layout->count : s->buf.data_size / layout->stride;
 
     if (s->buf.data_size != layout->count * layout->stride) {
@@ -139,25 +150,9 @@ static int buffer_init_from_filename(struct ngl_node *node)
         return NGL_ERROR_INVALID_DATA;
     }
 
-    s->buf.data = ngli_calloc(layout->count, layout->stride);
-    if (!s->buf.data)
-        return NGL_ERROR_MEMORY;
-
-    s->fp = fopen(o->filename, "rb");
-    if (!s->fp) {
-        LOG(ERROR, "could not open '%s'", o->filename);
-        return NGL_ERROR_IO;
-    }
-
-    size_t n = fread(s->buf.data, 1, s->buf.data_size, s->fp);
-    if (n != s->buf.data_size) {
-        LOG(ERROR, "could not read '%s'", o->filename);
-        return NGL_ERROR_IO;
-    }
-
-    if (n != s->buf.data_size) {
-        LOG(ERROR, "read %zu bytes does not match expected size of %zu bytes", n, s->buf.data_size);
-        return NGL_ERROR_IO;
+    if (!s->buf.data) {
+        LOG(ERROR, "'%s' is empty", o->filename);
+        return NGL_ERROR_INVALID_DATA;
     }
 
     return 0;
@@ -202,6 +197,11 @@ static int buffer_init_from_block(struct ngl_node *node)
         return NGL_ERROR_INVALID_USAGE;
     }
 
+    if (block_info->buffer_size) {
+        LOG(ERROR, "%s is bound with a dynamic offset and can not be referenced by a buffer", o->block->label);
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
     const struct block_field *fi = get_block_field(&block->fields, o->block_field);
     if (!fi) {
         LOG(ERROR, "field %s not found in %s", o->block_field, o->block->label);
@@ -307,6 +307,9 @@ static int buffer_prepare(struct ngl_node *node)
     if (ret < 0)
         return ret;
 
+    /* The whole mapping is about to be read: start paging it in */
+    ngli_file_map_prefetch(&s->map);
+
     ret = ngli_buffer_upload(info->buffer, info->data, 0, info->data_size);
     if (ret < 0)
         return ret;
@@ -324,18 +327,13 @@ static void buffer_uninit(struct ngl_node *node)
     else
         ngli_buffer_freep(&s->buf.buffer);
 
-    if (!o->data && !o->block)
-        ngli_freep(&s->buf.data);
-
-    if (o->filename) {
+    if (s->buf.flags & NGLI_BUFFER_INFO_FLAG_MAPPED) {
+        ngli_file_unmap(&s->map);
+        s->buf.data = NULL;
         s->buf.data_size = 0;
-
-        if (s->fp) {
-            int ret = fclose(s->fp);
-            if (ret < 0) {
-                LOG(ERROR, "could not properly close '%s'", o->filename);
-            }
-        }
+        s->buf.flags &= ~NGLI_BUFFER_INFO_FLAG_MAPPED;
+    } else if (!o->data && !o->block) {
+        ngli_freep(&s->buf.data);
     }
 }
 
@@ -359,6 +357,7 @@ const struct node_class ngli_buffer##type_name##_class = {      \
     .opts_size = sizeof(struct buffer_opts),                    \
     .priv_size = sizeof(struct buffer_priv),                    \
     .params    = buffer_params,                                 \
+    .flags     = NGLI_NODE_FLAG_MERGEABLE,                      \
     .params_id = "Buffer",                                      \
     .file      = __FILE__,                                      \
 };
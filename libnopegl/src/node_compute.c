@@ -161,6 +161,17 @@ static int compute_prepare(struct ngl_node *node)
     return ngli_pass_prepare(&s->pass);
 }
 
+static int compute_update(struct ngl_node *node, double t)
+{
+    struct compute_priv *s = node->priv_data;
+
+    int ret = ngli_node_update_children(node, t);
+    if (ret < 0)
+        return ret;
+
+    return ngli_pass_update(&s->pass, t);
+}
+
 static void compute_uninit(struct ngl_node *node)
 {
     struct compute_priv *s = node->priv_data;
@@ -179,7 +190,7 @@ const struct node_class ngli_compute_class = {
     .init      = compute_init,
     .prepare   = compute_prepare,
     .uninit    = compute_uninit,
-    .update    = ngli_node_update_children,
+    .update    = compute_update,
     .draw      = compute_draw,
     .opts_size = sizeof(struct compute_opts),
     .priv_size = sizeof(struct compute_priv),
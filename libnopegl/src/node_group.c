@@ -25,11 +25,24 @@
 #include "nopegl.h"
 #include "internal.h"
 
+/* Minimum number of consecutive compatible children to draw them at once */
+#define MIN_BATCH_SIZE 4
+
 struct group_opts {
     struct ngl_node **children;
     size_t nb_children;
 };
 
+struct batch_run {
+    size_t start;
+    size_t count;
+    struct ngl_node *leader;
+};
+
+struct group_priv {
+    struct darray batch_runs; // struct batch_run
+};
+
 #define OFFSET(x) offsetof(struct group_opts, x)
 static const struct node_param group_params[] = {
     {"children", NGLI_PARAM_TYPE_NODELIST, OFFSET(children),
@@ -37,9 +50,72 @@ static const struct node_param group_params[] = {
     {NULL}
 };
 
+/*
+ * Get the render node at the end of the transform chain of a child; the
+ * transforms only affect the modelview matrix, which is recorded per instance
+ */
+static struct ngl_node *get_batch_leaf(struct ngl_node *node)
+{
+    while (node) {
+        switch (node->cls->id) {
+        case NGL_NODE_ROTATE:
+        case NGL_NODE_ROTATEQUAT:
+        case NGL_NODE_SCALE:
+        case NGL_NODE_SKEW:
+        case NGL_NODE_TRANSFORM:
+        case NGL_NODE_TRANSLATE: {
+            const struct transform *trf = node->priv_data;
+            node = trf->child;
+            break;
+        }
+        default:
+            return node;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Detect the runs of consecutive children ending with compatible render nodes
+ * (same program, geometry and graphics state), which can be merged into a
+ * single instanced draw
+ */
+static int group_init(struct ngl_node *node)
+{
+    struct group_priv *s = node->priv_data;
+    const struct group_opts *o = node->opts;
+
+    ngli_darray_init(&s->batch_runs, sizeof(struct batch_run), 0);
+
+    if (node->ctx->config.disable_batching)
+        return 0;
+
+    size_t i = 0;
+    while (i < o->nb_children) {
+        struct ngl_node *leader = get_batch_leaf(o->children[i]);
+        size_t count = 1;
+        while (leader && i + count < o->nb_children) {
+            const struct ngl_node *leaf = get_batch_leaf(o->children[i + count]);
+            if (!leaf || !ngli_node_renderother_batch_is_compatible(leader, leaf))
+                break;
+            count++;
+        }
+
+        if (count >= MIN_BATCH_SIZE) {
+            const struct batch_run run = {.start = i, .count = count, .leader = leader};
+            if (!ngli_darray_push(&s->batch_runs, &run))
+                return NGL_ERROR_MEMORY;
+        }
+        i += count;
+    }
+
+    return 0;
+}
+
 static int group_prepare(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
+    struct group_priv *s = node->priv_data;
     const struct group_opts *o = node->opts;
 
     int ret = 0;
@@ -56,6 +132,20 @@ static int group_prepare(struct ngl_node *node)
             goto done;
     }
 
+    /* The batch rnodes follow the rnodes of the children */
+    const struct batch_run *runs = ngli_darray_data(&s->batch_runs);
+    for (size_t i = 0; i < ngli_darray_count(&s->batch_runs); i++) {
+        struct rnode *rnode = ngli_rnode_add_child(rnode_pos);
+        if (!rnode)
+            return NGL_ERROR_MEMORY;
+        rnode->batch = 1;
+        ctx->rnode_pos = rnode;
+
+        ret = ngli_node_prepare(runs[i].leader);
+        if (ret < 0)
+            goto done;
+    }
+
 done:
     ctx->rnode_pos = rnode_pos;
     return ret;
@@ -64,25 +154,62 @@ done:
 static void group_draw(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
+    struct group_priv *s = node->priv_data;
     const struct group_opts *o = node->opts;
 
     struct rnode *rnode_pos = ctx->rnode_pos;
     struct rnode *rnodes = ngli_darray_data(&rnode_pos->children);
-    for (size_t i = 0; i < o->nb_children; i++) {
+    const struct batch_run *runs = ngli_darray_data(&s->batch_runs);
+    const size_t nb_runs = ngli_darray_count(&s->batch_runs);
+    size_t run_index = 0;
+    size_t i = 0;
+    while (i < o->nb_children) {
+        if (run_index < nb_runs && runs[run_index].start == i) {
+            const struct batch_run *run = &runs[run_index];
+            struct draw_batch batch = {
+                .leader = run->leader,
+                .rnode  = &rnodes[o->nb_children + run_index],
+            };
+
+            struct draw_batch *prev_batch = ctx->draw_batch;
+            ctx->draw_batch = &batch;
+            for (size_t j = run->start; j < run->start + run->count; j++) {
+                ctx->rnode_pos = &rnodes[j];
+                ngli_node_draw(o->children[j]);
+            }
+            ctx->draw_batch = prev_batch;
+
+            ngli_node_renderother_batch_flush(&batch);
+
+            i += run->count;
+            run_index++;
+            continue;
+        }
+
         ctx->rnode_pos = &rnodes[i];
         struct ngl_node *child = o->children[i];
         ngli_node_draw(child);
+        i++;
     }
     ctx->rnode_pos = rnode_pos;
 }
 
+static void group_uninit(struct ngl_node *node)
+{
+    struct group_priv *s = node->priv_data;
+    ngli_darray_reset(&s->batch_runs);
+}
+
 const struct node_class ngli_group_class = {
     .id        = NGL_NODE_GROUP,
     .name      = "Group",
+    .init      = group_init,
     .prepare   = group_prepare,
     .update    = ngli_node_update_children,
     .draw      = group_draw,
+    .uninit    = group_uninit,
     .opts_size = sizeof(struct group_opts),
+    .priv_size = sizeof(struct group_priv),
     .params    = group_params,
     .file      = __FILE__,
 };
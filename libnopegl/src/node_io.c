@@ -61,6 +61,7 @@ const struct node_class ngli_io##type_id##_class = {            \
     .priv_size = sizeof(struct io_priv),                        \
     .params    = io_params,                                     \
     .params_id = "IOVar",                                       \
+    .flags     = NGLI_NODE_FLAG_MERGEABLE,                      \
     .file      = __FILE__,                                      \
 };
 
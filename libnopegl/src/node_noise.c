@@ -125,6 +125,8 @@ static int init_noise_generators(struct noise_priv *s, const struct noise_opts *
     return 0;
 }
 
+#define NOISE_FLAGS (NGLI_NODE_FLAG_TIME_DEPENDENT | NGLI_NODE_FLAG_PARALLEL_UPDATE)
+
 #define DEFINE_NOISE_CLASS(class_id, class_name, type, dtype, count)        \
 static int noise##type##_init(struct ngl_node *node)                        \
 {                                                                           \
@@ -146,6 +148,7 @@ const struct node_class ngli_noise##type##_class = {                        \
     .opts_size = sizeof(struct noise_opts),                                 \
     .priv_size = sizeof(struct noise_priv),                                 \
     .params    = noise_params,                                              \
+    .flags     = NOISE_FLAGS,                                               \
     .params_id = "Noise",                                                   \
     .file      = __FILE__,                                                  \
 };
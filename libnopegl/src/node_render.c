@@ -124,11 +124,16 @@ struct render_priv {
                                                NGL_NODE_VELOCITYVEC4,        \
                                                NGLI_NODE_NONE}
 
-#define ATTRIBUTES_TYPES_LIST (const uint32_t[]){NGL_NODE_BUFFERFLOAT,   \
-                                                 NGL_NODE_BUFFERVEC2,    \
-                                                 NGL_NODE_BUFFERVEC3,    \
-                                                 NGL_NODE_BUFFERVEC4,    \
-                                                 NGL_NODE_BUFFERMAT4,    \
+#define ATTRIBUTES_TYPES_LIST (const uint32_t[]){NGL_NODE_BUFFERFLOAT,           \
+                                                 NGL_NODE_BUFFERVEC2,            \
+                                                 NGL_NODE_BUFFERVEC3,            \
+                                                 NGL_NODE_BUFFERVEC4,            \
+                                                 NGL_NODE_BUFFERMAT4,            \
+                                                 NGL_NODE_STREAMEDBUFFERFLOAT,   \
+                                                 NGL_NODE_STREAMEDBUFFERVEC2,    \
+                                                 NGL_NODE_STREAMEDBUFFERVEC3,    \
+                                                 NGL_NODE_STREAMEDBUFFERVEC4,    \
+                                                 NGL_NODE_STREAMEDBUFFERMAT4,    \
                                                  NGLI_NODE_NONE}
 
 #define GEOMETRY_TYPES_LIST (const uint32_t[]){NGL_NODE_CIRCLE,          \
@@ -220,6 +225,17 @@ static int render_prepare(struct ngl_node *node)
     return ngli_pass_prepare(&s->pass);
 }
 
+static int render_update(struct ngl_node *node, double t)
+{
+    struct render_priv *s = node->priv_data;
+
+    int ret = ngli_node_update_children(node, t);
+    if (ret < 0)
+        return ret;
+
+    return ngli_pass_update(&s->pass, t);
+}
+
 static void render_uninit(struct ngl_node *node)
 {
     struct render_priv *s = node->priv_data;
@@ -239,7 +255,7 @@ const struct node_class ngli_render_class = {
     .init      = render_init,
     .prepare   = render_prepare,
     .uninit    = render_uninit,
-    .update    = ngli_node_update_children,
+    .update    = render_update,
     .draw      = render_draw,
     .opts_size = sizeof(struct render_opts),
     .priv_size = sizeof(struct render_priv),
@@ -25,6 +25,7 @@
 #include <string.h>
 
 #include "blending.h"
+#include "bstr.h"
 #include "darray.h"
 #include "filterschain.h"
 #include "geometry.h"
@@ -65,6 +66,12 @@
                                                NGL_NODE_TRIANGLE,        \
                                                NGLI_NODE_NONE}
 
+/* Upper bound of instances drawn at once by a batch pipeline */
+#define MAX_BATCH_INSTANCES 256
+
+/* Room left in the uniform blocks for the fields shared by all the instances */
+#define BATCH_SHARED_FIELDS_SIZE 1024
+
 #define FILTERS_TYPES_LIST (const uint32_t[]){NGL_NODE_FILTERALPHA,          \
                                               NGL_NODE_FILTERCOLORMAP,       \
                                               NGL_NODE_FILTERCONTRAST,       \
@@ -103,6 +110,9 @@ struct pipeline_desc {
     struct darray blocks_map; // struct resource_map
     struct darray textures_map; // struct texture_map
     struct darray uniforms; // struct pgcraft_uniform
+    size_t batch_capacity;
+    size_t batch_count;
+    struct darray batch_uniforms; // int32_t, indices of the per instance uniforms
 };
 
 struct render_common_opts {
@@ -113,8 +123,9 @@ struct render_common_opts {
 };
 
 struct render_common {
+    const struct render_common_opts *opts;
     uint32_t helpers;
-    void (*draw)(struct render_common *s, struct pipeline_compat *pl_compat);
+    void (*draw)(struct render_common *s, struct pipeline_compat *pl_compat, int nb_instances);
     struct filterschain *filterschain;
     char *combined_fragment;
     struct pgcraft_attribute position_attr;
@@ -557,17 +568,17 @@ static int combine_filters_code(struct render_common *s, const struct render_com
     return 0;
 }
 
-static void draw_simple(struct render_common *s, struct pipeline_compat *pl_compat)
+static void draw_simple(struct render_common *s, struct pipeline_compat *pl_compat, int nb_instances)
 {
-    ngli_pipeline_compat_draw(pl_compat, s->nb_vertices, 1);
+    ngli_pipeline_compat_draw(pl_compat, s->nb_vertices, nb_instances);
 }
 
-static void draw_indexed(struct render_common *s, struct pipeline_compat *pl_compat)
+static void draw_indexed(struct render_common *s, struct pipeline_compat *pl_compat, int nb_instances)
 {
     ngli_pipeline_compat_draw_indexed(pl_compat,
                                       s->geometry->indices_buffer,
                                       s->geometry->indices_layout.format,
-                                      (int)s->geometry->indices_layout.count, 1);
+                                      (int)s->geometry->indices_layout.count, nb_instances);
 }
 
 static void reset_pipeline_desc(void *user_arg, void *data)
@@ -579,6 +590,7 @@ static void reset_pipeline_desc(void *user_arg, void *data)
     ngli_darray_reset(&desc->uniforms_map);
     ngli_darray_reset(&desc->blocks_map);
     ngli_darray_reset(&desc->textures_map);
+    ngli_darray_reset(&desc->batch_uniforms);
 }
 
 static int init(struct ngl_node *node,
@@ -588,6 +600,8 @@ static int init(struct ngl_node *node,
     struct ngl_ctx *ctx = node->ctx;
     struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
 
+    s->opts = o;
+
     ngli_darray_init(&s->pipeline_descs, sizeof(struct pipeline_desc), 0);
     ngli_darray_set_free_func(&s->pipeline_descs, reset_pipeline_desc, NULL);
 
@@ -761,6 +775,7 @@ static int init_desc(struct ngl_node *node, struct render_common *s,
     ngli_darray_init(&desc->uniforms, sizeof(struct pgcraft_uniform), 0);
     ngli_darray_init(&desc->uniforms_map, sizeof(struct uniform_map), 0);
     ngli_darray_init(&desc->blocks_map, sizeof(struct resource_map), 0);
+    ngli_darray_init(&desc->batch_uniforms, sizeof(int32_t), 0);
 
     /* register source uniforms */
     for (size_t i = 0; i < nb_uniforms; i++)
@@ -802,6 +817,144 @@ static int build_uniforms_map(struct pipeline_desc *desc)
     return 0;
 }
 
+/*
+ * The uniforms specific to each node of a batch are turned into arrays indexed
+ * by the instance; the projection matrix and the aspect ratio are common to
+ * all of them.
+ */
+static int is_instance_uniform(const struct pgcraft_uniform *uniform)
+{
+    return uniform->data || !strcmp(uniform->name, "modelview_matrix");
+}
+
+static int get_batch_capacity(struct gpu_ctx *gpu_ctx, const struct pgcraft_params *params, size_t *capacityp)
+{
+    struct block blocks[NGLI_PROGRAM_SHADER_NB] = {0};
+    for (size_t i = 0; i < NGLI_ARRAY_NB(blocks); i++)
+        ngli_block_init(gpu_ctx, &blocks[i], NGLI_BLOCK_LAYOUT_STD140);
+
+    int ret = 0;
+    for (size_t i = 0; i < params->nb_uniforms; i++) {
+        const struct pgcraft_uniform *uniform = &params->uniforms[i];
+        if (!is_instance_uniform(uniform))
+            continue;
+        ret = ngli_block_add_field(&blocks[uniform->stage], uniform->name, uniform->type, 1);
+        if (ret < 0)
+            goto end;
+    }
+
+    size_t instance_size = 0;
+    for (size_t i = 0; i < NGLI_ARRAY_NB(blocks); i++)
+        instance_size = NGLI_MAX(instance_size, ngli_block_get_size(&blocks[i], 0));
+
+    const size_t max_block_size = gpu_ctx->limits.max_uniform_block_size;
+    size_t capacity = MAX_BATCH_INSTANCES;
+    if (instance_size && max_block_size > BATCH_SHARED_FIELDS_SIZE)
+        capacity = (max_block_size - BATCH_SHARED_FIELDS_SIZE) / instance_size;
+    *capacityp = NGLI_MAX(NGLI_MIN(capacity, MAX_BATCH_INSTANCES), 1);
+
+end:
+    for (size_t i = 0; i < NGLI_ARRAY_NB(blocks); i++)
+        ngli_block_reset(&blocks[i]);
+    return ret;
+}
+
+/*
+ * The per instance uniforms are exposed to the original shader code as global
+ * variables, loaded from the instance arrays before calling the original main
+ * function. The instance index is forwarded to the fragment stage through the
+ * ngl_batch_id flat output.
+ */
+static void print_batch_shader(struct bstr *b, const struct pgcraft_params *params, int stage, const char *base)
+{
+    const char *instance_index = stage == NGLI_PROGRAM_SHADER_VERT ? "ngl_instance_index" : "ngl_batch_id";
+
+    for (size_t i = 0; i < params->nb_uniforms; i++) {
+        const struct pgcraft_uniform *uniform = &params->uniforms[i];
+        if (uniform->stage == stage && is_instance_uniform(uniform))
+            ngli_bstr_printf(b, "%s %s;\n", ngli_type_get_name(uniform->type), uniform->name);
+    }
+
+    ngli_bstr_printf(b, "#define main ngl_batch_main\n%s\n#undef main\n", base);
+
+    ngli_bstr_print(b, "void main()\n{\n");
+    if (stage == NGLI_PROGRAM_SHADER_VERT)
+        ngli_bstr_print(b, "    ngl_batch_id = ngl_instance_index;\n");
+    for (size_t i = 0; i < params->nb_uniforms; i++) {
+        const struct pgcraft_uniform *uniform = &params->uniforms[i];
+        if (uniform->stage == stage && is_instance_uniform(uniform))
+            ngli_bstr_printf(b, "    %s = ngl_batch_%s[%s];\n", uniform->name, uniform->name, instance_index);
+    }
+    ngli_bstr_print(b, "    ngl_batch_main();\n}\n");
+}
+
+static int craft_batch(struct ngl_ctx *ctx, struct pipeline_desc *desc, const struct pgcraft_params *params)
+{
+    int ret = get_batch_capacity(ctx->gpu_ctx, params, &desc->batch_capacity);
+    if (ret < 0)
+        return ret;
+
+    struct pgcraft_uniform *uniforms = ngli_calloc(params->nb_uniforms, sizeof(*uniforms));
+    struct pgcraft_iovar *vert_out_vars = ngli_calloc(params->nb_vert_out_vars + 1, sizeof(*vert_out_vars));
+    struct bstr *vert_base = ngli_bstr_create();
+    struct bstr *frag_base = ngli_bstr_create();
+    if (!uniforms || !vert_out_vars || !vert_base || !frag_base) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    for (size_t i = 0; i < params->nb_uniforms; i++) {
+        uniforms[i] = params->uniforms[i];
+        if (!is_instance_uniform(&uniforms[i]))
+            continue;
+        snprintf(uniforms[i].name, sizeof(uniforms[i].name), "ngl_batch_%s", params->uniforms[i].name);
+        uniforms[i].count = desc->batch_capacity;
+    }
+
+    memcpy(vert_out_vars, params->vert_out_vars, params->nb_vert_out_vars * sizeof(*vert_out_vars));
+    vert_out_vars[params->nb_vert_out_vars] = (struct pgcraft_iovar){.name = "ngl_batch_id", .type = NGLI_TYPE_I32};
+
+    print_batch_shader(vert_base, params, NGLI_PROGRAM_SHADER_VERT, params->vert_base);
+    print_batch_shader(frag_base, params, NGLI_PROGRAM_SHADER_FRAG, params->frag_base);
+    if ((ret = ngli_bstr_check(vert_base)) < 0 ||
+        (ret = ngli_bstr_check(frag_base)) < 0)
+        goto end;
+
+    struct pgcraft_params batch_params = *params;
+    batch_params.vert_base        = ngli_bstr_strptr(vert_base);
+    batch_params.frag_base        = ngli_bstr_strptr(frag_base);
+    batch_params.uniforms         = uniforms;
+    batch_params.vert_out_vars    = vert_out_vars;
+    batch_params.nb_vert_out_vars = params->nb_vert_out_vars + 1;
+
+    ret = ngli_pgcraft_craft(desc->crafter, &batch_params);
+
+end:
+    ngli_freep(&uniforms);
+    ngli_freep(&vert_out_vars);
+    ngli_bstr_freep(&vert_base);
+    ngli_bstr_freep(&frag_base);
+    return ret;
+}
+
+static int build_batch_uniforms(struct pipeline_desc *desc)
+{
+    const struct pgcraft_uniform *uniforms = ngli_darray_data(&desc->uniforms);
+    for (size_t i = 0; i < ngli_darray_count(&desc->uniforms); i++) {
+        const struct pgcraft_uniform *uniform = &uniforms[i];
+        if (!is_instance_uniform(uniform))
+            continue;
+
+        char name[MAX_ID_LEN];
+        snprintf(name, sizeof(name), "ngl_batch_%s", uniform->name);
+        const int32_t index = ngli_pgcraft_get_uniform_index(desc->crafter, name, uniform->stage);
+        if (!ngli_darray_push(&desc->batch_uniforms, &index))
+            return NGL_ERROR_MEMORY;
+    }
+
+    return 0;
+}
+
 static int finalize_pipeline(struct ngl_node *node,
                              struct render_common *s, const struct render_common_opts *o,
                              const struct pgcraft_params *crafter_params)
@@ -821,7 +974,10 @@ static int finalize_pipeline(struct ngl_node *node,
     if (!desc->crafter)
         return NGL_ERROR_MEMORY;
 
-    ret = ngli_pgcraft_craft(desc->crafter, crafter_params);
+    if (rnode->batch)
+        ret = craft_batch(ctx, desc, crafter_params);
+    else
+        ret = ngli_pgcraft_craft(desc->crafter, crafter_params);
     if (ret < 0)
         return ret;
 
@@ -843,9 +999,12 @@ static int finalize_pipeline(struct ngl_node *node,
         .compat_info = ngli_pgcraft_get_compat_info(desc->crafter),
     };
 
-    ret = ngli_node_prepare_children(node);
-    if (ret < 0)
-        return ret;
+    /* The children are already prepared through the regular path of the batch leader */
+    if (!rnode->batch) {
+        ret = ngli_node_prepare_children(node);
+        if (ret < 0)
+            return ret;
+    }
 
     ret = ngli_pipeline_compat_init(desc->pipeline_compat, &params);
     if (ret < 0)
@@ -855,6 +1014,12 @@ static int finalize_pipeline(struct ngl_node *node,
     if (ret < 0)
         return ret;
 
+    if (rnode->batch) {
+        ret = build_batch_uniforms(desc);
+        if (ret < 0)
+            return ret;
+    }
+
     desc->modelview_matrix_index = ngli_pgcraft_get_uniform_index(desc->crafter, "modelview_matrix", NGLI_PROGRAM_SHADER_VERT);
     desc->projection_matrix_index = ngli_pgcraft_get_uniform_index(desc->crafter, "projection_matrix", NGLI_PROGRAM_SHADER_VERT);
     desc->aspect_index = ngli_pgcraft_get_uniform_index(desc->crafter, "aspect", NGLI_PROGRAM_SHADER_FRAG);
@@ -1315,21 +1480,12 @@ static int renderwaveform_prepare(struct ngl_node *node)
     return 0;
 }
 
-static void renderother_draw(struct ngl_node *node, struct render_common *s, const struct render_common_opts *o)
+static void update_pipeline_resources(struct ngl_node *node, struct pipeline_desc *desc)
 {
-    struct ngl_node **draw_resources = ngli_darray_data(&s->draw_resources);
-    for (size_t i = 0; i < ngli_darray_count(&s->draw_resources); i++)
-        ngli_node_draw(draw_resources[i]);
-
     struct ngl_ctx *ctx = node->ctx;
-    struct pipeline_desc *descs = ngli_darray_data(&s->pipeline_descs);
-    struct pipeline_desc *desc = &descs[ctx->rnode_pos->id];
     struct pipeline_compat *pl_compat = desc->pipeline_compat;
 
-    const float *modelview_matrix  = ngli_darray_tail(&ctx->modelview_matrix_stack);
     const float *projection_matrix = ngli_darray_tail(&ctx->projection_matrix_stack);
-
-    ngli_pipeline_compat_update_uniform(pl_compat, desc->modelview_matrix_index, modelview_matrix);
     ngli_pipeline_compat_update_uniform(pl_compat, desc->projection_matrix_index, projection_matrix);
 
     if (desc->aspect_index >= 0) {
@@ -1357,7 +1513,8 @@ static void renderother_draw(struct ngl_node *node, struct render_common *s, con
     for (size_t i = 0; i < ngli_darray_count(&desc->blocks_map); i++) {
         const struct block_info *info = resource_map[i].info;
         if (resource_map[i].buffer_rev != info->buffer_rev) {
-            ngli_pipeline_compat_update_buffer(pl_compat, resource_map[i].index, info->buffer, 0, 0);
+            ngli_pipeline_compat_update_buffer(pl_compat, resource_map[i].index, info->buffer,
+                                               info->buffer_offset, info->buffer_size);
             resource_map[i].buffer_rev = info->buffer_rev;
         }
     }
@@ -1367,8 +1524,124 @@ static void renderother_draw(struct ngl_node *node, struct render_common *s, con
         ngli_gpu_ctx_begin_render_pass(gpu_ctx, ctx->current_rendertarget);
         ctx->render_pass_started = 1;
     }
+}
+
+static int is_batchable(const struct ngl_node *node)
+{
+    switch (node->cls->id) {
+    case NGL_NODE_RENDERCOLOR:
+    case NGL_NODE_RENDERDISPLACE:
+    case NGL_NODE_RENDERGRADIENT:
+    case NGL_NODE_RENDERGRADIENT4:
+    case NGL_NODE_RENDERHISTOGRAM:
+    case NGL_NODE_RENDERNOISE:
+    case NGL_NODE_RENDERTEXTURE:
+    case NGL_NODE_RENDERWAVEFORM:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* Merged nodes share the private data of the node they are merged into (see ngl_config.dedup_nodes) */
+static int is_same_node(const struct ngl_node *a, const struct ngl_node *b)
+{
+    return a == b || (a && b && a->priv_data == b->priv_data);
+}
+
+int ngli_node_renderother_batch_is_compatible(const struct ngl_node *leader, const struct ngl_node *node)
+{
+    if (!is_batchable(leader) || node->cls != leader->cls)
+        return 0;
+
+    const struct render_common *a = leader->priv_data;
+    const struct render_common *b = node->priv_data;
+    if (a->opts->blending != b->opts->blending ||
+        !is_same_node(a->opts->geometry, b->opts->geometry) ||
+        strcmp(a->combined_fragment, b->combined_fragment))
+        return 0;
+
+    const size_t nb_resources = ngli_darray_count(&a->draw_resources);
+    if (nb_resources != ngli_darray_count(&b->draw_resources))
+        return 0;
+    const struct ngl_node **resources_a = ngli_darray_data(&a->draw_resources);
+    const struct ngl_node **resources_b = ngli_darray_data(&b->draw_resources);
+    for (size_t i = 0; i < nb_resources; i++)
+        if (!is_same_node(resources_a[i], resources_b[i]))
+            return 0;
+
+    return 1;
+}
+
+static struct pipeline_desc *get_batch_desc(const struct draw_batch *batch)
+{
+    struct render_common *s = batch->leader->priv_data;
+    struct pipeline_desc *descs = ngli_darray_data(&s->pipeline_descs);
+    return &descs[batch->rnode->id];
+}
+
+void ngli_node_renderother_batch_flush(const struct draw_batch *batch)
+{
+    struct pipeline_desc *desc = get_batch_desc(batch);
+    if (!desc->batch_count)
+        return;
+
+    struct render_common *s = batch->leader->priv_data;
+    update_pipeline_resources(batch->leader, desc);
+    s->draw(s, desc->pipeline_compat, (int)desc->batch_count);
+    desc->batch_count = 0;
+}
+
+static void batch_record(struct ngl_node *node, struct render_common *s, const struct draw_batch *batch)
+{
+    struct pipeline_desc *batch_desc = get_batch_desc(batch);
+    if (batch_desc->batch_count == batch_desc->batch_capacity)
+        ngli_node_renderother_batch_flush(batch);
+
+    struct ngl_ctx *ctx = node->ctx;
+    const struct pipeline_desc *descs = ngli_darray_data(&s->pipeline_descs);
+    const struct pipeline_desc *desc = &descs[ctx->rnode_pos->id];
+    const float *modelview_matrix = ngli_darray_tail(&ctx->modelview_matrix_stack);
+
+    const int32_t *indices = ngli_darray_data(&batch_desc->batch_uniforms);
+    const struct pgcraft_uniform *uniforms = ngli_darray_data(&desc->uniforms);
+    size_t index = 0;
+    for (size_t i = 0; i < ngli_darray_count(&desc->uniforms); i++) {
+        const struct pgcraft_uniform *uniform = &uniforms[i];
+        if (!is_instance_uniform(uniform))
+            continue;
+        const void *data = uniform->data ? uniform->data : modelview_matrix;
+        ngli_pipeline_compat_update_uniform_element(batch_desc->pipeline_compat, indices[index++],
+                                                    batch_desc->batch_count, data);
+    }
+    batch_desc->batch_count++;
+}
+
+static void renderother_draw(struct ngl_node *node, struct render_common *s, const struct render_common_opts *o)
+{
+    struct ngl_ctx *ctx = node->ctx;
+
+    /* The resources may draw render nodes which are not part of the batch */
+    struct draw_batch *batch = ctx->draw_batch;
+    ctx->draw_batch = NULL;
+    struct ngl_node **draw_resources = ngli_darray_data(&s->draw_resources);
+    for (size_t i = 0; i < ngli_darray_count(&s->draw_resources); i++)
+        ngli_node_draw(draw_resources[i]);
+    ctx->draw_batch = batch;
+
+    if (batch) {
+        batch_record(node, s, batch);
+        return;
+    }
+
+    struct pipeline_desc *descs = ngli_darray_data(&s->pipeline_descs);
+    struct pipeline_desc *desc = &descs[ctx->rnode_pos->id];
+
+    const float *modelview_matrix = ngli_darray_tail(&ctx->modelview_matrix_stack);
+    ngli_pipeline_compat_update_uniform(desc->pipeline_compat, desc->modelview_matrix_index, modelview_matrix);
+    update_pipeline_resources(node, desc);
 
-    s->draw(s, desc->pipeline_compat);
+    s->draw(s, desc->pipeline_compat, 1);
 }
 
 static void renderother_uninit(struct ngl_node *node, struct render_common *s)
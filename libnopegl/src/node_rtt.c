@@ -30,6 +30,7 @@
 #include "rendertarget.h"
 #include "format.h"
 #include "gpu_ctx.h"
+#include "hmap.h"
 #include "log.h"
 #include "nopegl.h"
 #include "internal.h"
@@ -43,6 +44,7 @@ struct rtt_opts {
     struct ngl_node *depth_texture;
     int32_t samples;
     float clear_color[4];
+    int cache;
 };
 
 struct rtt_priv {
@@ -54,6 +56,30 @@ struct rtt_priv {
     struct rendertarget_layout layout;
     struct rtt_params rtt_params;
     struct rtt_ctx *rtt_ctx;
+
+    int time_invariant;
+    int cached;
+    uint64_t draw_id;
+    float modelview_matrix[4 * 4];
+    float projection_matrix[4 * 4];
+};
+
+enum {
+    RTT_CACHE_AUTO,
+    RTT_CACHE_ALWAYS,
+    RTT_CACHE_NEVER,
+};
+
+static const struct param_choices cache_choices = {
+    .name = "cache_mode",
+    .consts = {
+        {"auto",   RTT_CACHE_AUTO,   .desc=NGLI_DOCSTRING("render `child` again only if it is time dependent, or if it is drawn "
+                                                          "with different transforms or more than once per frame")},
+        {"always", RTT_CACHE_ALWAYS, .desc=NGLI_DOCSTRING("render `child` only once, even if it is time dependent or drawn with "
+                                                          "different transforms")},
+        {"never",  RTT_CACHE_NEVER,  .desc=NGLI_DOCSTRING("render `child` at every draw")},
+        {NULL}
+    }
 };
 
 #define OFFSET(x) offsetof(struct rtt_opts, x)
@@ -72,6 +98,10 @@ static const struct node_param rtt_params[] = {
                       .desc=NGLI_DOCSTRING("number of samples used for multisampling anti-aliasing")},
     {"clear_color",   NGLI_PARAM_TYPE_VEC4, OFFSET(clear_color),
                       .desc=NGLI_DOCSTRING("color used to clear the `color_texture`")},
+    {"cache",         NGLI_PARAM_TYPE_SELECT, OFFSET(cache), {.i32=RTT_CACHE_NEVER},
+                      .choices=&cache_choices,
+                      .desc=NGLI_DOCSTRING("keep the rendered textures across draws until a live change "
+                                           "or a prefetch happens in the `child` branch")},
     {NULL}
 };
 
@@ -403,6 +433,7 @@ static int rtt_resize(struct ngl_node *node)
     s->height = height;
     s->rtt_params = rtt_params;
     s->rtt_ctx = rtt_ctx;
+    s->cached = 0;
 
     for (size_t i = 0; i < o->nb_color_textures; i++) {
         const struct rtt_texture_info info = get_rtt_texture_info(o->color_textures[i]);
@@ -438,8 +469,96 @@ fail:
     return ret;
 }
 
+static int collect_nodes(struct hmap *nodes, struct ngl_node *node)
+{
+    char key[32];
+    (void)snprintf(key, sizeof(key), "%p", node);
+    if (ngli_hmap_get(nodes, key))
+        return 0;
+
+    int ret = ngli_hmap_set(nodes, key, node);
+    if (ret < 0)
+        return ret;
+
+    struct ngl_node **children = ngli_darray_data(&node->children);
+    for (size_t i = 0; i < ngli_darray_count(&node->children); i++) {
+        ret = collect_nodes(nodes, children[i]);
+        if (ret < 0)
+            return ret;
+    }
+    return 0;
+}
+
+/*
+ * The child scene renders the same content at every draw if none of its nodes
+ * depends on the time, if it does not contain any compute node (which may
+ * accumulate results across dispatches) and if none of its resources can be
+ * written from outside of it (by another render to texture or compute node).
+ * Text nodes are always flagged as time dependent, so a child scene containing
+ * one is never detected as time invariant.
+ */
+static int is_time_invariant(struct ngl_node *child)
+{
+    if (child->time_dependent)
+        return 0;
+
+    struct hmap *nodes = ngli_hmap_create();
+    if (!nodes)
+        return 0;
+
+    int invariant = collect_nodes(nodes, child) >= 0;
+
+    const struct hmap_entry *entry = NULL;
+    while (invariant && (entry = ngli_hmap_next(nodes, entry))) {
+        const struct ngl_node *node = entry->data;
+        if (node->cls->id == NGL_NODE_COMPUTE) {
+            invariant = 0;
+            break;
+        }
+
+        const int category = node->cls->category;
+        if (category != NGLI_NODE_CATEGORY_TEXTURE &&
+            category != NGLI_NODE_CATEGORY_BUFFER &&
+            category != NGLI_NODE_CATEGORY_BLOCK &&
+            node->cls->id != NGL_NODE_TEXTUREVIEW)
+            continue;
+
+        struct ngl_node **parents = ngli_darray_data(&node->parents);
+        for (size_t i = 0; i < ngli_darray_count(&node->parents); i++) {
+            char key[32];
+            (void)snprintf(key, sizeof(key), "%p", parents[i]);
+            if (!ngli_hmap_get(nodes, key)) {
+                invariant = 0;
+                break;
+            }
+        }
+    }
+
+    ngli_hmap_freep(&nodes);
+    return invariant;
+}
+
+static int rtt_update(struct ngl_node *node, double t)
+{
+    struct rtt_priv *s = node->priv_data;
+    const struct rtt_opts *o = node->opts;
+
+    /*
+     * The update time is reset when the node is prefetched, and when a live
+     * change or a prefetch happens in its branch: the cached textures are
+     * outdated and the graph may have changed
+     */
+    if (node->last_update_time == -1.) {
+        s->cached = 0;
+        s->time_invariant = o->cache == RTT_CACHE_AUTO && is_time_invariant(o->child);
+    }
+
+    return ngli_node_update_children(node, t);
+}
+
 static void rtt_draw(struct ngl_node *node)
 {
+    struct ngl_ctx *ctx = node->ctx;
     struct rtt_priv *s = node->priv_data;
     const struct rtt_opts *o = node->opts;
 
@@ -449,15 +568,41 @@ static void rtt_draw(struct ngl_node *node)
             return;
     }
 
+    /*
+     * The child draws also depend on the transforms inherited from the
+     * ancestors of the node: the automatic cache is dropped when they change,
+     * and disabled if the node is drawn at several places of the graph
+     */
+    const float *modelview_matrix  = ngli_darray_tail(&ctx->modelview_matrix_stack);
+    const float *projection_matrix = ngli_darray_tail(&ctx->projection_matrix_stack);
+    if (o->cache == RTT_CACHE_AUTO) {
+        if (s->draw_id == ctx->draw_id)
+            s->time_invariant = 0;
+        if (!s->time_invariant ||
+            memcmp(s->modelview_matrix, modelview_matrix, sizeof(s->modelview_matrix)) ||
+            memcmp(s->projection_matrix, projection_matrix, sizeof(s->projection_matrix)))
+            s->cached = 0;
+    }
+    s->draw_id = ctx->draw_id;
+
+    if (s->cached)
+        return;
+
+    memcpy(s->modelview_matrix, modelview_matrix, sizeof(s->modelview_matrix));
+    memcpy(s->projection_matrix, projection_matrix, sizeof(s->projection_matrix));
+
     ngli_rtt_begin(s->rtt_ctx);
     ngli_node_draw(o->child);
     ngli_rtt_end(s->rtt_ctx);
+
+    s->cached = o->cache == RTT_CACHE_ALWAYS || s->time_invariant;
 }
 
 static void rtt_release(struct ngl_node *node)
 {
     struct rtt_priv *s = node->priv_data;
     ngli_rtt_freep(&s->rtt_ctx);
+    s->cached = 0;
 }
 
 const struct node_class ngli_rtt_class = {
@@ -466,7 +611,7 @@ const struct node_class ngli_rtt_class = {
     .init      = rtt_init,
     .prepare   = rtt_prepare,
     .prefetch  = rtt_prefetch,
-    .update    = ngli_node_update_children,
+    .update    = rtt_update,
     .draw      = rtt_draw,
     .release   = rtt_release,
     .opts_size = sizeof(struct rtt_opts),
@@ -35,11 +35,13 @@ struct streamedbuffer_opts {
     struct ngl_node *buffer_node;
     int32_t timebase[2];
     struct ngl_node *time_anim;
+    int resident;
 };
 
 struct streamedbuffer_priv {
     struct buffer_info buf;
     size_t last_index;
+    size_t uploaded_index;
 };
 
 NGLI_STATIC_ASSERT(buffer_info_is_first, offsetof(struct streamedbuffer_priv, buf) == 0);
@@ -61,6 +63,10 @@ static const struct node_param streamedbuffer##name##_params[] = {
     {"time_anim",  NGLI_PARAM_TYPE_NODE, OFFSET(time_anim),                                               \
                    .node_types=(const uint32_t[]){NGL_NODE_ANIMATEDTIME, NGLI_NODE_NONE},                 \
                    .desc=NGLI_DOCSTRING("time remapping animation (must use a `linear` interpolation)")}, \
+    {"resident",   NGLI_PARAM_TYPE_BOOL, OFFSET(resident),                                                \
+                   .desc=NGLI_DOCSTRING("upload the whole stream once in GPU memory and select the "      \
+                                        "current chunk with a buffer binding offset; only honored when "  \
+                                        "used as a `Block` field")},                                      \
     {NULL}                                                                                                \
 };
 
@@ -131,10 +137,47 @@ static int streamedbuffer_update(struct ngl_node *node, double t)
     const struct buffer_layout *layout = &info->layout;
     info->data = buffer_info->data + layout->stride * layout->count * index;
 
-    if (!(info->flags & NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD))
+    if (!(info->flags & NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD) || index == s->uploaded_index)
         return 0;
 
-    return ngli_buffer_upload(info->buffer, info->data, 0, info->data_size);
+    int ret = ngli_buffer_upload(info->buffer, info->data, 0, info->data_size);
+    if (ret < 0)
+        return ret;
+    s->uploaded_index = index;
+
+    return 0;
+}
+
+size_t ngli_node_streamedbuffer_get_index(const struct ngl_node *node)
+{
+    const struct streamedbuffer_priv *s = node->priv_data;
+    return s->last_index;
+}
+
+size_t ngli_node_streamedbuffer_get_nb_chunks(const struct ngl_node *node)
+{
+    const struct streamedbuffer_opts *o = node->opts;
+    const struct buffer_info *timestamps_priv = o->timestamps->priv_data;
+    return timestamps_priv->layout.count;
+}
+
+const uint8_t *ngli_node_streamedbuffer_get_chunk(const struct ngl_node *node, size_t index)
+{
+    const struct streamedbuffer_priv *s = node->priv_data;
+    const struct streamedbuffer_opts *o = node->opts;
+    const struct buffer_info *buffer_info = o->buffer_node->priv_data;
+    const struct buffer_layout *layout = &s->buf.layout;
+    ngli_assert(index < ngli_node_streamedbuffer_get_nb_chunks(node));
+    return buffer_info->data + layout->stride * layout->count * index;
+}
+
+int ngli_node_streamedbuffer_has_same_clock(const struct ngl_node *node, const struct ngl_node *other)
+{
+    const struct streamedbuffer_opts *o0 = node->opts;
+    const struct streamedbuffer_opts *o1 = other->opts;
+    return o0->timestamps == o1->timestamps &&
+           o0->time_anim == o1->time_anim &&
+           (int64_t)o0->timebase[0] * o1->timebase[1] == (int64_t)o1->timebase[0] * o0->timebase[1];
 }
 
 static int check_timestamps_buffer(const struct ngl_node *node)
@@ -198,9 +241,13 @@ static int streamedbuffer_init(struct ngl_node *node)
     }
 
     info->data = buffer_info->data;
-    info->data_size = buffer_info->data_size / layout->count;
+    info->data_size = layout->stride * layout->count;
     info->usage = buffer_info->usage;
     info->flags |= NGLI_BUFFER_INFO_FLAG_DYNAMIC;
+    if (o->resident)
+        info->flags |= NGLI_BUFFER_INFO_FLAG_RESIDENT;
+
+    s->uploaded_index = SIZE_MAX;
 
     if (!o->timebase[1]) {
         LOG(ERROR, "invalid timebase: %d/%d", o->timebase[0], o->timebase[1]);
@@ -256,6 +303,7 @@ const struct node_class ngli_streamedbuffer##class_suffix##_class = {       \
     .opts_size = sizeof(struct streamedbuffer_opts),                        \
     .priv_size = sizeof(struct streamedbuffer_priv),                        \
     .params    = streamedbuffer##class_suffix##_params,                     \
+    .flags     = NGLI_NODE_FLAG_TIME_DEPENDENT,                             \
     .file      = __FILE__,                                                  \
 };                                                                          \
 
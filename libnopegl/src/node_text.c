@@ -121,6 +121,7 @@ struct text_priv {
     struct darray pipeline_descs;
     int live_changed;
     struct viewport viewport;
+    double update_time;
 };
 
 static const struct param_choices valign_choices = {
@@ -762,11 +763,29 @@ static int text_prepare(struct ngl_node *node)
     return 0;
 }
 
+/*
+ * Laying out the string uploads the geometry and may grow the atlas shared
+ * with the other texts, so it is done in the commit. The effects are
+ * evaluated here unless the layout is outdated, in which case the commit
+ * evaluates them against the new characters.
+ */
 static int text_update(struct ngl_node *node, double t)
+{
+    struct text_priv *s = node->priv_data;
+
+    s->update_time = t;
+    if (s->live_changed || ngli_text_atlas_outdated(s->text_ctx))
+        return 0;
+
+    return ngli_text_set_time(s->text_ctx, t);
+}
+
+static int text_commit(struct ngl_node *node)
 {
     struct text_priv *s = node->priv_data;
     const struct text_opts *o = node->opts;
 
+    int relayout = 0;
     if (s->live_changed) {
         const struct text_effects_defaults defaults = {
             .color = {NGLI_ARG_VEC3(o->fg_color)},
@@ -778,6 +797,13 @@ static int text_update(struct ngl_node *node, double t)
         if (ret < 0)
             return ret;
         s->live_changed = 0;
+        relayout = 1;
+    } else if (ngli_text_atlas_outdated(s->text_ctx)) {
+        /* Another text grew or rebuilt the shared atlas: lay out the same string against it */
+        int ret = update_text_content(node);
+        if (ret < 0)
+            return ret;
+        relayout = 1;
     }
 
     const struct viewport viewport = ngli_gpu_ctx_get_viewport(node->ctx->gpu_ctx);
@@ -788,15 +814,13 @@ static int text_update(struct ngl_node *node, double t)
             return ret;
     }
 
-    int ret = ngli_text_set_time(s->text_ctx, t);
-    if (ret < 0)
-        return ret;
-
-    ret = apply_effects(s);
-    if (ret < 0)
-        return ret;
+    if (relayout) {
+        int ret = ngli_text_set_time(s->text_ctx, s->update_time);
+        if (ret < 0)
+            return ret;
+    }
 
-    return 0;
+    return apply_effects(s);
 }
 
 static void text_draw(struct ngl_node *node)
@@ -856,12 +880,14 @@ const struct node_class ngli_text_class = {
     .init           = text_init,
     .prepare        = text_prepare,
     .update         = text_update,
+    .commit         = text_commit,
     .draw           = text_draw,
     .uninit         = text_uninit,
     .opts_size      = sizeof(struct text_opts),
     .priv_size      = sizeof(struct text_priv),
     .params         = text_params,
-    .flags          = NGLI_NODE_FLAG_LIVECTL,
+    .flags          = NGLI_NODE_FLAG_LIVECTL | NGLI_NODE_FLAG_TIME_DEPENDENT |
+                      NGLI_NODE_FLAG_PARALLEL_UPDATE | NGLI_NODE_FLAG_TIME_REMAPPING,
     .livectl_offset = OFFSET(live),
     .file           = __FILE__,
 };
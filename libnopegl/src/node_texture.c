@@ -747,6 +747,7 @@ const struct node_class ngli_texture2d_class = {
     .opts_size = sizeof(struct texture_opts),
     .priv_size = sizeof(struct texture_priv),
     .params    = texture2d_params,
+    .flags     = NGLI_NODE_FLAG_MERGEABLE,
     .file      = __FILE__,
 };
 
@@ -761,6 +762,7 @@ const struct node_class ngli_texture2darray_class = {
     .opts_size = sizeof(struct texture_opts),
     .priv_size = sizeof(struct texture_priv),
     .params    = texture2d_array_params,
+    .flags     = NGLI_NODE_FLAG_MERGEABLE,
     .file      = __FILE__,
 };
 
@@ -775,6 +777,7 @@ const struct node_class ngli_texture3d_class = {
     .opts_size = sizeof(struct texture_opts),
     .priv_size = sizeof(struct texture_priv),
     .params    = texture3d_params,
+    .flags     = NGLI_NODE_FLAG_MERGEABLE,
     .file      = __FILE__,
 };
 
@@ -789,5 +792,6 @@ const struct node_class ngli_texturecube_class = {
     .opts_size = sizeof(struct texture_opts),
     .priv_size = sizeof(struct texture_priv),
     .params    = texturecube_params,
+    .flags     = NGLI_NODE_FLAG_MERGEABLE,
     .file      = __FILE__,
 };
@@ -105,5 +105,6 @@ const struct node_class ngli_triangle_class = {
     .opts_size = sizeof(struct triangle_opts),
     .priv_size = sizeof(struct triangle_priv),
     .params    = triangle_params,
+    .flags     = NGLI_NODE_FLAG_MERGEABLE,
     .file      = __FILE__,
 };
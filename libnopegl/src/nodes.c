@@ -159,6 +159,18 @@ struct ngl_node *ngl_node_create(uint32_t type)
     return node;
 }
 
+static void *get_own_priv_data(struct ngl_node *node)
+{
+    const size_t opts_size = NGLI_ALIGN(node->cls->opts_size, NGLI_ALIGN_VAL);
+    return (uint8_t *)node->opts + opts_size;
+}
+
+/* Node actually attached in place of the specified one */
+static struct ngl_node *get_attached_node(struct ngl_node *node)
+{
+    return node && node->merged_into ? node->merged_into : node;
+}
+
 static void node_release(struct ngl_node *node)
 {
     if (node->state != STATE_READY)
@@ -205,7 +217,7 @@ static int track_children(struct ngl_node *node)
 
         switch (par->type) {
             case NGLI_PARAM_TYPE_NODE: {
-                struct ngl_node *child = *(struct ngl_node **)parp;
+                struct ngl_node *child = get_attached_node(*(struct ngl_node **)parp);
                 if (child && !ngli_darray_push(&node->children, &child))
                     return NGL_ERROR_MEMORY;
                 if (child && !ngli_darray_push(&child->parents, &node))
@@ -218,7 +230,7 @@ static int track_children(struct ngl_node *node)
                 struct ngl_node **elems = *(struct ngl_node ***)elems_p;
                 const size_t nb_elems = *(size_t *)nb_elems_p;
                 for (size_t i = 0; i < nb_elems; i++) {
-                    struct ngl_node *child = elems[i];
+                    struct ngl_node *child = get_attached_node(elems[i]);
                     if (!ngli_darray_push(&node->children, &child))
                         return NGL_ERROR_MEMORY;
                     if (!ngli_darray_push(&child->parents, &node))
@@ -232,7 +244,7 @@ static int track_children(struct ngl_node *node)
                     break;
                 const struct hmap_entry *entry = NULL;
                 while ((entry = ngli_hmap_next(hmap, entry))) {
-                    struct ngl_node *child = entry->data;
+                    struct ngl_node *child = get_attached_node(entry->data);
                     if (!ngli_darray_push(&node->children, &child))
                         return NGL_ERROR_MEMORY;
                     if (!ngli_darray_push(&child->parents, &node))
@@ -243,7 +255,7 @@ static int track_children(struct ngl_node *node)
             default: {
                 if (!(par->flags & NGLI_PARAM_FLAG_ALLOW_NODE))
                     break;
-                struct ngl_node *child = *(struct ngl_node **)parp;
+                struct ngl_node *child = get_attached_node(*(struct ngl_node **)parp);
                 if (child && !ngli_darray_push(&node->children, &child))
                     return NGL_ERROR_MEMORY;
                 if (child && !ngli_darray_push(&child->parents, &node))
@@ -308,6 +320,12 @@ static int node_init(struct ngl_node *node)
         return ret;
     }
 
+    /* Children are initialized first so their time dependency is known */
+    node->time_dependent = !!(node->cls->flags & NGLI_NODE_FLAG_TIME_DEPENDENT);
+    struct ngl_node **children = ngli_darray_data(&node->children);
+    for (size_t i = 0; i < ngli_darray_count(&node->children); i++)
+        node->time_dependent |= children[i]->time_dependent;
+
     if (node->cls->prefetch)
         node->state = STATE_INITIALIZED;
     else
@@ -520,6 +538,46 @@ static int node_set_children_ctx(uint8_t *base_ptr, const struct node_param *par
     return 0;
 }
 
+static struct ngl_node *find_merged_into(const struct ngl_ctx *ctx, const struct ngl_node *node)
+{
+    if (!ctx->merged_nodes)
+        return NULL;
+    char key[32];
+    (void)snprintf(key, sizeof(key), "%p", node);
+    return ngli_hmap_get(ctx->merged_nodes, key);
+}
+
+/*
+ * A merged node is attached through the node it is merged into: its own
+ * children are never visited, and it only borrows the private data of that
+ * node until it is detached
+ */
+static int merged_node_set_ctx(struct ngl_node *node, struct ngl_node *merged_into,
+                               struct ngl_ctx *ctx, struct ngl_ctx *pctx)
+{
+    if (!ctx) {
+        if (node->ctx != pctx)
+            return 0;
+        if (node->ctx_refcount-- == 1) {
+            node->priv_data = get_own_priv_data(node);
+            node->merged_into = NULL;
+            node->ctx = NULL;
+        }
+        ngli_assert(node->ctx_refcount >= 0);
+        return node_set_ctx(merged_into, ctx, pctx);
+    }
+
+    int ret = node_set_ctx(merged_into, ctx, pctx);
+    if (ret < 0)
+        return ret;
+
+    node->ctx = ctx;
+    node->merged_into = merged_into;
+    node->priv_data = merged_into->priv_data;
+    node->ctx_refcount++;
+    return 0;
+}
+
 static int node_set_ctx(struct ngl_node *node, struct ngl_ctx *ctx, struct ngl_ctx *pctx)
 {
     int ret;
@@ -536,7 +594,12 @@ static int node_set_ctx(struct ngl_node *node, struct ngl_ctx *ctx, struct ngl_c
             LOG(ERROR, "\"%s\" is associated with another rendering context", node->label);
             return NGL_ERROR_INVALID_USAGE;
         }
+        struct ngl_node *merged_into = node->merged_into ? node->merged_into : find_merged_into(ctx, node);
+        if (merged_into)
+            return merged_node_set_ctx(node, merged_into, ctx, pctx);
     } else {
+        if (node->merged_into)
+            return merged_node_set_ctx(node, node->merged_into, ctx, pctx);
         if (node->state > STATE_UNINITIALIZED) {
             if (node->ctx != pctx)
                 return 0;
@@ -597,6 +660,7 @@ int ngli_node_prepare_children(struct ngl_node *node)
 
 int ngli_node_prepare(struct ngl_node *node)
 {
+    node = get_attached_node(node);
     if (node->cls->prepare) {
         TRACE("PREPARE %s @ %p", node->label, node);
         int ret = node->cls->prepare(node);
@@ -609,8 +673,26 @@ int ngli_node_prepare(struct ngl_node *node)
     return ngli_node_prepare_children(node);
 }
 
+static int visit_children(struct ngl_node *node, int is_active, double t)
+{
+    if (node->cls->visit)
+        return node->cls->visit(node, is_active, t);
+
+    struct darray *children_array = &node->children;
+    struct ngl_node **children = ngli_darray_data(children_array);
+    for (size_t i = 0; i < ngli_darray_count(children_array); i++) {
+        struct ngl_node *child = children[i];
+        int ret = ngli_node_visit(child, is_active, t);
+        if (ret < 0)
+            return ret;
+    }
+    return 0;
+}
+
 int ngli_node_visit(struct ngl_node *node, int is_active, double t)
 {
+    node = get_attached_node(node);
+
     /*
      * If a node is inactive and meant to be, there is no need
      * to check for resources below as we can assume they were already released
@@ -650,20 +732,22 @@ int ngli_node_visit(struct ngl_node *node, int is_active, double t)
         node->is_active |= is_active;
     }
 
-    if (node->cls->visit) {
-        int ret = node->cls->visit(node, is_active, t);
-        if (ret < 0)
-            return ret;
-    } else {
-        struct darray *children_array = &node->children;
-        struct ngl_node **children = ngli_darray_data(children_array);
-        for (size_t i = 0; i < ngli_darray_count(children_array); i++) {
-            struct ngl_node *child = children[i];
-            int ret = ngli_node_visit(child, is_active, t);
-            if (ret < 0)
-                return ret;
-        }
-    }
+    /*
+     * The children of a time remapping node are updated by this node only, so
+     * they must not be queued for the parallel update at the frame time
+     */
+    struct ngl_ctx *ctx = node->ctx;
+    const int time_remapping = !!(node->cls->flags & NGLI_NODE_FLAG_TIME_REMAPPING);
+    ctx->time_remapping_depth += time_remapping;
+    int ret = visit_children(node, is_active, t);
+    ctx->time_remapping_depth -= time_remapping;
+    if (ret < 0)
+        return ret;
+
+    if (queue_node && ctx->update_pool && !ctx->time_remapping_depth &&
+        (node->cls->flags & NGLI_NODE_FLAG_PARALLEL_UPDATE) &&
+        !ngli_darray_push(&ctx->parallel_update_nodes, &node))
+        return NGL_ERROR_MEMORY;
 
     /* Insert children (leaves) first */
     if (queue_node &&
@@ -674,6 +758,24 @@ int ngli_node_visit(struct ngl_node *node, int is_active, double t)
     return 0;
 }
 
+/*
+ * A static node skips its update (and thus the update of its children) once
+ * it has been updated, so its ancestors must be updated again when one of its
+ * descendants is brought back to life after a release. The ancestors of an
+ * already reset node are reset as well, so they are not walked again: this
+ * keeps the reset linear on graphs where nodes are shared.
+ */
+static void reset_update_time_branch(struct ngl_node *node)
+{
+    node->last_update_time = -1.;
+    struct ngl_node **parents = ngli_darray_data(&node->parents);
+    for (size_t i = 0; i < ngli_darray_count(&node->parents); i++) {
+        struct ngl_node *parent = parents[i];
+        if (parent->last_update_time != -1.)
+            reset_update_time_branch(parent);
+    }
+}
+
 static int node_prefetch(struct ngl_node *node)
 {
     if (node->state == STATE_READY)
@@ -693,6 +795,7 @@ static int node_prefetch(struct ngl_node *node)
         }
     }
     node->state = STATE_READY;
+    reset_update_time_branch(node);
 
     return 0;
 }
@@ -702,6 +805,7 @@ int ngli_node_honor_release_prefetch(struct ngl_node *scene, double t)
     /* Build a new list of activity checks nodes */
     struct darray *nodes_array = &scene->ctx->activitycheck_nodes;
     ngli_darray_clear(nodes_array);
+    ngli_darray_clear(&scene->ctx->parallel_update_nodes);
     int ret = ngli_node_visit(scene, 1, t);
     if (ret < 0)
         return ret;
@@ -728,17 +832,188 @@ int ngli_node_honor_release_prefetch(struct ngl_node *scene, double t)
     return 0;
 }
 
+static int node_commit(struct ngl_node *node)
+{
+    if (!node->cls->commit)
+        return 0;
+    int ret = node->cls->commit(node);
+    if (ret < 0) {
+        LOG(ERROR, "committing node %s failed: %s", node->label, NGLI_RET_STR(ret));
+        return ret;
+    }
+    return 0;
+}
+
+struct update_job {
+    struct ngl_node **nodes;
+    size_t nb_nodes;
+    double t;
+};
+
+static int update_nodes_job(void *arg)
+{
+    const struct update_job *job = arg;
+    for (size_t i = 0; i < job->nb_nodes; i++) {
+        struct ngl_node *node = job->nodes[i];
+        TRACE("UPDATE %s @ %p with t=%g (parallel)", node->label, node, job->t);
+        int ret = node->cls->update(node, job->t);
+        if (ret < 0) {
+            LOG(ERROR, "updating node %s failed: %s", node->label, NGLI_RET_STR(ret));
+            return ret;
+        }
+    }
+    return 0;
+}
+
+/*
+ * The subtree of a time remapping node is updated by this node only, at its
+ * own times: it only has to be owned by this node.
+ */
+static int is_subtree_exclusive(const struct ngl_node *node)
+{
+    struct ngl_node **children = ngli_darray_data(&node->children);
+    for (size_t i = 0; i < ngli_darray_count(&node->children); i++) {
+        const struct ngl_node *child = children[i];
+        if (ngli_darray_count(&child->parents) != 1 || !is_subtree_exclusive(child))
+            return 0;
+    }
+    return 1;
+}
+
+/*
+ * Check whether a node can be updated on a worker thread (see
+ * NGLI_NODE_FLAG_PARALLEL_UPDATE). Otherwise, its children must be up-to-date
+ * for the given time: the static ones are moved forward in time here, as the
+ * regular update would do, so that the update of the node only reads them.
+ */
+static int is_ready(struct ngl_node *node, double t)
+{
+    if (node->cls->flags & NGLI_NODE_FLAG_TIME_REMAPPING)
+        return is_subtree_exclusive(node);
+
+    struct ngl_node **children = ngli_darray_data(&node->children);
+    for (size_t i = 0; i < ngli_darray_count(&node->children); i++) {
+        struct ngl_node *child = children[i];
+        if (!child->cls->update)
+            continue;
+        if (!child->time_dependent && child->last_update_time != -1.) {
+            child->last_update_time = t;
+            child->draw_count = 0;
+        } else if (child->last_update_time != t) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int update_wave(struct ngl_ctx *ctx, struct ngl_node **nodes, size_t nb_nodes, double t)
+{
+    struct threadpool *pool = ctx->update_pool;
+
+    /*
+     * Split the nodes in more chunks than there are threads so that the
+     * workers finishing early pick up the remaining ones
+     */
+    struct update_job jobs[64];
+    const size_t nb_threads = ngli_threadpool_get_nb_threads(pool);
+    const size_t nb_jobs = NGLI_MIN(NGLI_MIN(nb_nodes, nb_threads * 4), NGLI_ARRAY_NB(jobs));
+    size_t start = 0;
+    int ret = 0;
+    for (size_t i = 0; i < nb_jobs; i++) {
+        const size_t end = nb_nodes * (i + 1) / nb_jobs;
+        jobs[i] = (struct update_job){.nodes = nodes + start, .nb_nodes = end - start, .t = t};
+        ret = ngli_threadpool_submit(pool, update_nodes_job, &jobs[i]);
+        if (ret < 0)
+            break;
+        start = end;
+    }
+    const int wait_ret = ngli_threadpool_wait(pool);
+    if (ret >= 0)
+        ret = wait_ret;
+    if (ret < 0)
+        return ret;
+
+    for (size_t i = 0; i < nb_nodes; i++) {
+        struct ngl_node *node = nodes[i];
+        ret = node_commit(node);
+        if (ret < 0)
+            return ret;
+        node->last_update_time = t;
+        node->draw_count = 0;
+    }
+    ctx->nb_parallel_updates += nb_nodes;
+
+    return 0;
+}
+
+/*
+ * Update the active nodes collected during the visit which can be updated
+ * concurrently, then commit them sequentially. The nodes are updated by
+ * waves, each wave containing the nodes whose children have been updated by
+ * the previous ones, so that the independent subtrees (typically the siblings of
+ * a Group) are updated concurrently. The nodes never getting ready are left
+ * to the regular update, which skips the others since they are already
+ * updated for that time.
+ */
+int ngli_node_update_parallel(struct ngl_node *scene, double t)
+{
+    struct ngl_ctx *ctx = scene->ctx;
+    ctx->nb_parallel_updates = 0;
+    if (!ctx->update_pool)
+        return 0;
+
+    struct darray *nodes_array = &ctx->parallel_update_nodes;
+    struct ngl_node **nodes = ngli_darray_data(nodes_array);
+    size_t nb_nodes = 0;
+    for (size_t i = 0; i < ngli_darray_count(nodes_array); i++) {
+        struct ngl_node *node = nodes[i];
+        if (node->is_active && node->state == STATE_READY && node->last_update_time != t)
+            nodes[nb_nodes++] = node;
+    }
+
+    struct darray *wave_array = &ctx->parallel_update_wave;
+    while (nb_nodes) {
+        ngli_darray_clear(wave_array);
+        size_t nb_pending = 0;
+        for (size_t i = 0; i < nb_nodes; i++) {
+            struct ngl_node *node = nodes[i];
+            if (!is_ready(node, t))
+                nodes[nb_pending++] = node;
+            else if (!ngli_darray_push(wave_array, &node))
+                return NGL_ERROR_MEMORY;
+        }
+        nb_nodes = nb_pending;
+
+        const size_t nb_wave_nodes = ngli_darray_count(wave_array);
+        if (!nb_wave_nodes)
+            break;
+        int ret = update_wave(ctx, ngli_darray_data(wave_array), nb_wave_nodes, t);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 int ngli_node_update(struct ngl_node *node, double t)
 {
+    node = get_attached_node(node);
     ngli_assert(node->state == STATE_READY);
     if (node->cls->update) {
-        if (node->last_update_time != t) {
+        if (!node->time_dependent && node->last_update_time != -1.) {
+            /* Static subtree already up-to-date, only the time is moved forward */
+            node->last_update_time = t;
+            node->draw_count = 0;
+        } else if (node->last_update_time != t) {
             TRACE("UPDATE %s @ %p with t=%g", node->label, node, t);
             int ret = node->cls->update(node, t);
             if (ret < 0) {
                 LOG(ERROR, "updating node %s failed: %s", node->label, NGLI_RET_STR(ret));
                 return ret;
             }
+            ret = node_commit(node);
+            if (ret < 0)
+                return ret;
             node->last_update_time = t;
             node->draw_count = 0;
         } else {
@@ -772,6 +1047,7 @@ void *ngli_node_get_data_ptr(struct ngl_node *var_node, void *data_fallback)
 
 void ngli_node_draw(struct ngl_node *node)
 {
+    node = get_attached_node(node);
     if (node->cls->draw) {
         TRACE("DRAW %s @ %p", node->label, node);
         node->cls->draw(node);
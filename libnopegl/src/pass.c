@@ -28,6 +28,7 @@
 
 #include "blending.h"
 #include "block.h"
+#include "bstr.h"
 #include "buffer.h"
 #include "darray.h"
 #include "geometry.h"
@@ -36,6 +37,7 @@
 #include "image.h"
 #include "log.h"
 #include "math_utils.h"
+#include "memory.h"
 #include "nopegl.h"
 #include "internal.h"
 #include "pass.h"
@@ -62,6 +64,15 @@ struct texture_map {
     size_t image_rev;
 };
 
+struct baked_uniform {
+    char name[MAX_ID_LEN];
+    struct ngl_node *node;
+    int stage;
+    size_t field_id;
+    int baked;
+    int consumer; // holds the reference of the pass as a consumer of the baked node
+};
+
 struct pipeline_desc {
     struct pgcraft *crafter;
     struct pipeline_compat *pipeline_compat;
@@ -125,6 +136,239 @@ static int register_builtin_uniforms(struct pass *s)
     return 0;
 }
 
+static int register_baked_uniform(struct pass *s, const char *name, struct ngl_node *uniform, int stage)
+{
+    struct baked_uniform baked = {.node = uniform, .stage = stage};
+    snprintf(baked.name, sizeof(baked.name), "%s", name);
+    if (!ngli_darray_push(&s->baked_uniforms, &baked))
+        return NGL_ERROR_MEMORY;
+    return 0;
+}
+
+static int init_baked_block(struct pass *s, int stage, enum block_layout layout)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct block *block = &s->baked_blocks[stage];
+
+    ngli_block_reset(block);
+    ngli_block_init(ctx->gpu_ctx, block, layout);
+
+    struct baked_uniform *baked_uniforms = ngli_darray_data(&s->baked_uniforms);
+    for (size_t i = 0; i < ngli_darray_count(&s->baked_uniforms); i++) {
+        struct baked_uniform *baked = &baked_uniforms[i];
+        if (baked->stage != stage)
+            continue;
+
+        /* The extra element holds the value of the times not matching a frame */
+        const struct variable_info *variable_info = baked->node->priv_data;
+        char field_name[MAX_ID_LEN];
+        snprintf(field_name, sizeof(field_name), "ngl_baked_%s", baked->name);
+        baked->field_id = ngli_darray_count(&block->fields);
+        int ret = ngli_block_add_field(block, field_name, variable_info->data_type, (size_t)s->baked_nb_frames + 1);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+/* Check if one more storage block can be bound to the stage (GLES vertex stages often have none) */
+static int can_use_storage_block(const struct pass *s, int stage)
+{
+    const struct gpu_ctx *gpu_ctx = s->ctx->gpu_ctx;
+    if (!(gpu_ctx->features & NGLI_FEATURE_STORAGE_BUFFER))
+        return 0;
+
+    const struct gpu_limits *limits = &gpu_ctx->limits;
+    const uint32_t max_storage_blocks = stage == NGLI_PROGRAM_SHADER_VERT ? limits->max_vertex_storage_blocks :
+                                        stage == NGLI_PROGRAM_SHADER_FRAG ? limits->max_fragment_storage_blocks :
+                                                                            limits->max_compute_storage_blocks;
+    uint32_t nb_storage_blocks = 0;
+    const struct pgcraft_block *crafter_blocks = ngli_darray_data(&s->crafter_blocks);
+    for (size_t i = 0; i < ngli_darray_count(&s->crafter_blocks); i++) {
+        const struct pgcraft_block *crafter_block = &crafter_blocks[i];
+        if (crafter_block->stage == stage && crafter_block->type == NGLI_TYPE_STORAGE_BUFFER)
+            nb_storage_blocks++;
+    }
+    return nb_storage_blocks < max_storage_blocks;
+}
+
+static int bake_stage_uniforms(struct pass *s, int stage)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct gpu_ctx *gpu_ctx = ctx->gpu_ctx;
+    const struct gpu_limits *limits = &gpu_ctx->limits;
+
+    int ret = init_baked_block(s, stage, NGLI_BLOCK_LAYOUT_STD140);
+    if (ret < 0)
+        return ret;
+
+    struct block *block = &s->baked_blocks[stage];
+    if (!ngli_darray_count(&block->fields))
+        return 0;
+
+    /* Same selection as the Block nodes: UBO if possible, SSBO otherwise */
+    int type = NGLI_TYPE_UNIFORM_BUFFER;
+    size_t block_size = ngli_block_get_size(block, 0);
+    if (block_size > limits->max_uniform_block_size) {
+        type = NGLI_TYPE_STORAGE_BUFFER;
+        const int use_storage_block = can_use_storage_block(s, stage);
+        if (use_storage_block) {
+            ret = init_baked_block(s, stage, NGLI_BLOCK_LAYOUT_STD430);
+            if (ret < 0)
+                return ret;
+            block_size = ngli_block_get_size(block, 0);
+        }
+        if (!use_storage_block || block_size > limits->max_storage_block_size) {
+            LOG(WARNING, "baked animations do not fit in a buffer (%zu bytes), falling back on uniforms", block_size);
+            ngli_block_reset(block);
+            struct baked_uniform *baked_uniforms = ngli_darray_data(&s->baked_uniforms);
+            for (size_t i = 0; i < ngli_darray_count(&s->baked_uniforms); i++) {
+                struct baked_uniform *baked = &baked_uniforms[i];
+                if (baked->stage != stage)
+                    continue;
+                ret = register_uniform(s, baked->name, baked->node, stage);
+                if (ret < 0)
+                    return ret;
+            }
+            return 0;
+        }
+    }
+
+    s->baked_data[stage] = ngli_calloc(1, block_size);
+    if (!s->baked_data[stage])
+        return NGL_ERROR_MEMORY;
+
+    const struct block_field *fields = ngli_darray_data(&block->fields);
+    struct baked_uniform *baked_uniforms = ngli_darray_data(&s->baked_uniforms);
+    for (size_t i = 0; i < ngli_darray_count(&s->baked_uniforms); i++) {
+        struct baked_uniform *baked = &baked_uniforms[i];
+        if (baked->stage != stage)
+            continue;
+        const struct block_field *field = &fields[baked->field_id];
+        ret = ngli_node_animated_bake(baked->node, s->baked_data[stage] + field->offset,
+                                      field->stride, (size_t)s->baked_nb_frames);
+        if (ret < 0)
+            return ret;
+        baked->baked = 1;
+    }
+
+    s->baked_buffers[stage] = ngli_buffer_create(gpu_ctx);
+    if (!s->baked_buffers[stage])
+        return NGL_ERROR_MEMORY;
+
+    const int usage = NGLI_BUFFER_USAGE_TRANSFER_DST_BIT |
+                      (type == NGLI_TYPE_UNIFORM_BUFFER ? NGLI_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+                                                        : NGLI_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    ret = ngli_buffer_init(s->baked_buffers[stage], block_size, usage);
+    if (ret < 0)
+        return ret;
+
+    ret = ngli_buffer_upload(s->baked_buffers[stage], s->baked_data[stage], 0, block_size);
+    if (ret < 0)
+        return ret;
+
+    static const char * const stage_names[NGLI_PROGRAM_SHADER_NB] = {
+        [NGLI_PROGRAM_SHADER_VERT] = "vert",
+        [NGLI_PROGRAM_SHADER_FRAG] = "frag",
+        [NGLI_PROGRAM_SHADER_COMP] = "comp",
+    };
+
+    struct pgcraft_block crafter_block = {
+        /* instance name is empty so the fields are accessed like uniforms */
+        .instance_name = "",
+        .type          = type,
+        .stage         = stage,
+        .block         = block,
+        .buffer        = {
+            .buffer = s->baked_buffers[stage],
+            .size   = block_size,
+        },
+    };
+    snprintf(crafter_block.name, sizeof(crafter_block.name), "ngl_baked_%s", stage_names[stage]);
+    if (!ngli_darray_push(&s->crafter_blocks, &crafter_block))
+        return NGL_ERROR_MEMORY;
+
+    /* Uniform names are shared between the stages, hence the stage suffix */
+    struct pgcraft_uniform crafter_uniform = {
+        .type  = NGLI_TYPE_I32,
+        .stage = stage,
+        .data  = &s->baked_frame,
+    };
+    snprintf(crafter_uniform.name, sizeof(crafter_uniform.name), "ngl_baked_frame_%s", stage_names[stage]);
+    if (!ngli_darray_push(&s->crafter_uniforms, &crafter_uniform))
+        return NGL_ERROR_MEMORY;
+
+    /*
+     * The user code keeps referencing the animations by their resource name:
+     * these are declared as global variables, loaded with the element of the
+     * current frame before calling the user entry point
+     */
+    struct bstr *b = ngli_bstr_create();
+    if (!b)
+        return NGL_ERROR_MEMORY;
+    for (size_t i = 0; i < ngli_darray_count(&s->baked_uniforms); i++) {
+        const struct baked_uniform *baked = &baked_uniforms[i];
+        if (baked->stage != stage)
+            continue;
+        const struct variable_info *variable_info = baked->node->priv_data;
+        ngli_bstr_printf(b, "%s %s;\n", ngli_type_get_name(variable_info->data_type), baked->name);
+    }
+
+    const char **basep = stage == NGLI_PROGRAM_SHADER_VERT ? &s->params.vert_base :
+                         stage == NGLI_PROGRAM_SHADER_FRAG ? &s->params.frag_base :
+                                                             &s->params.comp_base;
+    ngli_bstr_printf(b, "#define main ngl_baked_main\n%s\n#undef main\n", *basep);
+
+    ngli_bstr_print(b, "void main()\n{\n");
+    for (size_t i = 0; i < ngli_darray_count(&s->baked_uniforms); i++) {
+        const struct baked_uniform *baked = &baked_uniforms[i];
+        if (baked->stage == stage)
+            ngli_bstr_printf(b, "    %s = ngl_baked_%s[%s];\n", baked->name, baked->name, crafter_uniform.name);
+    }
+    ngli_bstr_print(b, "    ngl_baked_main();\n}\n");
+    s->baked_shader_bases[stage] = ngli_bstr_strdup(b);
+    ngli_bstr_freep(&b);
+    if (!s->baked_shader_bases[stage])
+        return NGL_ERROR_MEMORY;
+    *basep = s->baked_shader_bases[stage];
+
+    return 0;
+}
+
+static int bake_uniforms(struct pass *s)
+{
+    if (!ngli_darray_count(&s->baked_uniforms))
+        return 0;
+
+    s->baked_nb_frames = ngli_ctx_get_nb_frames(s->ctx);
+    s->baked_time = -1.;
+    for (int i = 0; i < NGLI_PROGRAM_SHADER_NB; i++) {
+        int ret = bake_stage_uniforms(s, i);
+        if (ret < 0)
+            return ret;
+    }
+
+    /*
+     * The pass is a consumer of the baked values of a node only if none of
+     * its stages fell back on the regular uniforms for that node
+     */
+    struct baked_uniform *baked_uniforms = ngli_darray_data(&s->baked_uniforms);
+    const size_t nb_baked_uniforms = ngli_darray_count(&s->baked_uniforms);
+    for (size_t i = 0; i < nb_baked_uniforms; i++) {
+        struct baked_uniform *baked = &baked_uniforms[i];
+        int consumer = 1;
+        for (size_t j = 0; j < nb_baked_uniforms && consumer; j++)
+            if (baked_uniforms[j].node == baked->node && (j < i || !baked_uniforms[j].baked))
+                consumer = 0;
+        if (consumer) {
+            baked->consumer = 1;
+            ngli_node_animated_ref_baked(baked->node);
+        }
+    }
+    return 0;
+}
+
 static int register_texture(struct pass *s, const char *name, struct ngl_node *texture, int stage)
 {
     struct texture_priv *texture_priv = texture->priv_data;
@@ -244,7 +488,8 @@ static int register_block(struct pass *s, const char *name, struct ngl_node *blo
         ngli_assert(0);
 
     const struct buffer *buffer = block_info->buffer;
-    const size_t buffer_size = buffer ? buffer->size : 0;
+    const size_t buffer_size = block_info->buffer_size ? block_info->buffer_size
+                             : buffer ? buffer->size : 0;
     struct pgcraft_block crafter_block = {
         .type     = type,
         .stage    = stage,
@@ -252,6 +497,7 @@ static int register_block(struct pass *s, const char *name, struct ngl_node *blo
         .block    = block,
         .buffer   = {
             .buffer = buffer,
+            .offset = block_info->buffer_offset,
             .size   = buffer_size,
         },
     };
@@ -376,6 +622,10 @@ static int register_resource(struct pass *s, const char *name, struct ngl_node *
 
     switch (node->cls->category) {
     case NGLI_NODE_CATEGORY_VARIABLE:
+        if (s->ctx->config.bake_animations && ngli_node_animated_can_bake(node) &&
+            ngli_ctx_get_nb_frames(s->ctx) > 0)
+            return register_baked_uniform(s, name, node, stage);
+        return register_uniform(s, name, node, stage);
     case NGLI_NODE_CATEGORY_BUFFER:  return register_uniform(s, name, node, stage);
     case NGLI_NODE_CATEGORY_TEXTURE: return register_texture(s, name, node, stage);
     case NGLI_NODE_CATEGORY_BLOCK:   return register_block(s, name, node, stage);
@@ -645,6 +895,7 @@ int ngli_pass_init(struct pass *s, struct ngl_ctx *ctx, const struct pass_params
 
     ngli_darray_init(&s->pipeline_descs, sizeof(struct pipeline_desc), 0);
     ngli_darray_init(&s->draw_resources, sizeof(struct ngl_node *), 0);
+    ngli_darray_init(&s->baked_uniforms, sizeof(struct baked_uniform), 0);
 
     int ret = register_builtin_uniforms(s);
     if (ret < 0)
@@ -655,6 +906,10 @@ int ngli_pass_init(struct pass *s, struct ngl_ctx *ctx, const struct pass_params
     if (ret < 0)
         return ret;
 
+    ret = bake_uniforms(s);
+    if (ret < 0)
+        return ret;
+
     return 0;
 }
 
@@ -681,9 +936,60 @@ void ngli_pass_uninit(struct pass *s)
     ngli_darray_reset(&s->crafter_uniforms);
     ngli_darray_reset(&s->crafter_blocks);
 
+    const struct baked_uniform *baked_uniforms = ngli_darray_data(&s->baked_uniforms);
+    for (size_t i = 0; i < ngli_darray_count(&s->baked_uniforms); i++)
+        if (baked_uniforms[i].consumer)
+            ngli_node_animated_unref_baked(baked_uniforms[i].node);
+    ngli_darray_reset(&s->baked_uniforms);
+    for (int i = 0; i < NGLI_PROGRAM_SHADER_NB; i++) {
+        ngli_block_reset(&s->baked_blocks[i]);
+        ngli_buffer_freep(&s->baked_buffers[i]);
+        ngli_freep(&s->baked_data[i]);
+        ngli_freep(&s->baked_shader_bases[i]);
+    }
+
     memset(s, 0, sizeof(*s));
 }
 
+int ngli_pass_update(struct pass *s, double t)
+{
+    if (!ngli_darray_count(&s->baked_uniforms))
+        return 0;
+
+    const int64_t frame = ngli_ctx_get_frame_index(s->ctx, t);
+    if (frame >= 0) {
+        s->baked_frame = (int32_t)frame;
+        return 0;
+    }
+
+    /*
+     * Off-frame times use the last element of the baked arrays, updated with
+     * the values evaluated by the animation nodes
+     */
+    s->baked_frame = (int32_t)s->baked_nb_frames;
+    if (t == s->baked_time)
+        return 0;
+    s->baked_time = t;
+
+    const struct baked_uniform *baked_uniforms = ngli_darray_data(&s->baked_uniforms);
+    for (size_t i = 0; i < ngli_darray_count(&s->baked_uniforms); i++) {
+        const struct baked_uniform *baked = &baked_uniforms[i];
+        if (!baked->baked)
+            continue;
+        const struct block *block = &s->baked_blocks[baked->stage];
+        const struct block_field *field = ngli_darray_get(&block->fields, baked->field_id);
+        const struct variable_info *variable_info = baked->node->priv_data;
+        const size_t offset = field->offset + (size_t)s->baked_nb_frames * field->stride;
+        uint8_t *dst = s->baked_data[baked->stage] + offset;
+        memcpy(dst, variable_info->data, variable_info->data_size);
+        int ret = ngli_buffer_upload(s->baked_buffers[baked->stage], dst, offset, variable_info->data_size);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 int ngli_pass_exec(struct pass *s)
 {
     struct ngl_node **draw_resources = ngli_darray_data(&s->draw_resources);
@@ -732,7 +1038,8 @@ int ngli_pass_exec(struct pass *s)
     for (size_t i = 0; i < ngli_darray_count(&desc->blocks_map); i++) {
         const struct block_info *info = resource_map[i].info;
         if (resource_map[i].buffer_rev != info->buffer_rev) {
-            ngli_pipeline_compat_update_buffer(pipeline_compat, resource_map[i].index, info->buffer, 0, 0);
+            ngli_pipeline_compat_update_buffer(pipeline_compat, resource_map[i].index, info->buffer,
+                                               info->buffer_offset, info->buffer_size);
             resource_map[i].buffer_rev = info->buffer_rev;
         }
     }
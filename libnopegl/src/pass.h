@@ -77,10 +77,21 @@ struct pass {
     struct darray crafter_blocks;
     struct darray pipeline_descs;
     struct darray draw_resources;
+
+    /* animations baked at every frame (see ngl_config.bake_animations) */
+    struct darray baked_uniforms;
+    struct block baked_blocks[NGLI_PROGRAM_SHADER_NB];
+    struct buffer *baked_buffers[NGLI_PROGRAM_SHADER_NB];
+    uint8_t *baked_data[NGLI_PROGRAM_SHADER_NB];
+    char *baked_shader_bases[NGLI_PROGRAM_SHADER_NB];
+    int64_t baked_nb_frames;
+    int32_t baked_frame;
+    double baked_time;
 };
 
 int ngli_pass_init(struct pass *s, struct ngl_ctx *ctx, const struct pass_params *params);
 int ngli_pass_prepare(struct pass *s);
+int ngli_pass_update(struct pass *s, double t);
 void ngli_pass_uninit(struct pass *s);
 void ngli_pass_update_texture_uniforms(struct pipeline *pipeline, const struct pgcraft_texture_info *info);
 int ngli_pass_exec(struct pass *s);
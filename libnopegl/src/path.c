@@ -45,7 +45,6 @@ enum path_state {
 struct path {
     int32_t precision;
     enum path_state state;
-    int current_arc;            /* cached arc index */
     int *arc_to_segment;        /* map arc indexes to segment indexes */
     struct darray segments;     /* array of struct path_segment */
     struct darray steps;        /* array of struct path_step */
@@ -618,11 +617,11 @@ static float remap(float a, float b, float c, float d, float x)
  * https://pomax.github.io/bezierinfo/#arclengthapprox
  * https://pomax.github.io/bezierinfo/#tracing
  */
-void ngli_path_evaluate(struct path *s, float *dst, float distance)
+void ngli_path_evaluate(const struct path *s, float *dst, float distance, int *arc_hint)
 {
     const float *distances = ngli_darray_data(&s->steps_dist);
     const int nb_dists = (int)ngli_darray_count(&s->steps_dist);
-    const int arc_id = get_vector_id(distances, nb_dists, &s->current_arc, distance);
+    const int arc_id = get_vector_id(distances, nb_dists, arc_hint, distance);
     const int segment_id = s->arc_to_segment[arc_id];
     const struct path_segment *segments = ngli_darray_data(&s->segments);
     const struct path_segment *segment = &segments[segment_id];
@@ -646,7 +645,6 @@ void ngli_path_clear(struct path *s)
 {
     s->state = PATH_STATE_DEFAULT;
     s->precision = 0;
-    s->current_arc = 0;
     ngli_freep(&s->arc_to_segment);
     ngli_darray_clear(&s->segments);
     ngli_darray_clear(&s->steps);
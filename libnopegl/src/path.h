@@ -71,8 +71,12 @@ int ngli_path_finalize(struct path *s);
  */
 int ngli_path_init(struct path *s, int32_t precision);
 
-/* Evaluate an initialized path */
-void ngli_path_evaluate(struct path *s, float *dst, float distance);
+/*
+ * Evaluate an initialized path. The arc hint is owned by the caller (starting
+ * at 0) and speeds up the lookup of successive close distances; since the
+ * path is not modified, it can be evaluated concurrently with distinct hints.
+ */
+void ngli_path_evaluate(const struct path *s, float *dst, float distance, int *arc_hint);
 
 /*
  * Read back every segment. Require the path to be initialized or at least
@@ -688,7 +688,8 @@ static int inject_ublock(struct pgcraft *s, struct bstr *b, int stage)
     struct pgcraft_block pgcraft_block = {
         /* instance name is empty to make field accesses identical to uniform accesses */
         .instance_name = "",
-        .type          = NGLI_TYPE_UNIFORM_BUFFER,
+        /* bound at dynamic offsets of the context uniform ring (see pipeline_compat) */
+        .type          = NGLI_TYPE_UNIFORM_BUFFER_DYNAMIC,
         .stage         = stage,
         .block         = block,
     };
@@ -1280,7 +1281,7 @@ static void probe_ublocks(struct pgcraft *s)
         const struct bindgroup_layout_entry *entries = ngli_darray_data(array);
         for (size_t j = 0; j < ngli_darray_count(array); j++) {
             const struct bindgroup_layout_entry *entry = &entries[j];
-            if (entry->type    == NGLI_TYPE_UNIFORM_BUFFER &&
+            if (entry->type    == NGLI_TYPE_UNIFORM_BUFFER_DYNAMIC &&
                 entry->binding == binding &&
                 entry->stage   == i) {
                 info->uindices[i] = (int32_t)j;
@@ -46,6 +46,19 @@ void ngli_pipeline_graphics_reset(struct pipeline_graphics *graphics)
     memset(graphics, 0, sizeof(*graphics));
 }
 
+static void remove_pending_pipeline(struct pipeline *s)
+{
+    struct darray *pending = &s->gpu_ctx->pending_pipelines;
+    struct pipeline **pipelines = ngli_darray_data(pending);
+    for (size_t i = 0; i < ngli_darray_count(pending); i++) {
+        if (pipelines[i] == s) {
+            ngli_darray_remove(pending, i);
+            break;
+        }
+    }
+    s->deferred = 0;
+}
+
 static void pipeline_freep(struct pipeline **sp)
 {
     if (!*sp)
@@ -54,7 +67,12 @@ static void pipeline_freep(struct pipeline **sp)
     struct pipeline *s = *sp;
     ngli_pipeline_graphics_reset(&s->graphics);
 
-    (*sp)->gpu_ctx->cls->pipeline_freep(sp);
+    struct gpu_ctx *gpu_ctx = s->gpu_ctx;
+    if (gpu_ctx->pipeline == s)
+        ngli_gpu_ctx_invalidate_state(gpu_ctx, NGLI_GPU_STATE_PIPELINE);
+    if (s->deferred)
+        remove_pending_pipeline(s);
+    gpu_ctx->cls->pipeline_freep(sp);
 }
 
 struct pipeline *ngli_pipeline_create(struct gpu_ctx *gpu_ctx)
@@ -75,7 +93,35 @@ int ngli_pipeline_init(struct pipeline *s, const struct pipeline_params *params)
     s->program  = params->program;
     s->layout = params->layout;
 
-    return s->gpu_ctx->cls->pipeline_init(s);
+    struct gpu_ctx *gpu_ctx = s->gpu_ctx;
+    if (gpu_ctx->defer_pipelines) {
+        if (!ngli_darray_push(&gpu_ctx->pending_pipelines, &s))
+            return NGL_ERROR_MEMORY;
+        s->deferred = 1;
+        return 0;
+    }
+
+    return gpu_ctx->cls->pipeline_init(s);
+}
+
+/*
+ * Initialize a pipeline whose initialization was deferred by the current
+ * pipeline batch, typically because it is used before the end of the batch
+ */
+int ngli_pipeline_init_deferred(struct pipeline *s)
+{
+    if (!s->deferred)
+        return 0;
+
+    struct gpu_ctx *gpu_ctx = s->gpu_ctx;
+    if (gpu_ctx->threadpool) {
+        int ret = ngli_threadpool_wait(gpu_ctx->threadpool);
+        if (ret < 0)
+            return ret;
+    }
+
+    remove_pending_pipeline(s);
+    return gpu_ctx->cls->pipeline_init(s);
 }
 
 void ngli_pipeline_freep(struct pipeline **sp)
@@ -88,6 +88,8 @@ struct pipeline {
     struct pipeline_graphics graphics;
     const struct program *program;
     struct pipeline_layout layout;
+
+    int deferred; // initialization deferred to the end of the current pipeline batch
 };
 
 NGLI_RC_CHECK_STRUCT(pipeline);
@@ -97,6 +99,7 @@ void ngli_pipeline_graphics_reset(struct pipeline_graphics *graphics);
 
 struct pipeline *ngli_pipeline_create(struct gpu_ctx *gpu_ctx);
 int ngli_pipeline_init(struct pipeline *s, const struct pipeline_params *params);
+int ngli_pipeline_init_deferred(struct pipeline *s);
 void ngli_pipeline_freep(struct pipeline **sp);
 
 #endif
@@ -29,6 +29,7 @@
 #include "memory.h"
 #include "nopegl.h"
 #include "pipeline_compat.h"
+#include "uniform_ring.h"
 #include "utils.h"
 
 #define NB_BINDGROUPS 16
@@ -52,32 +53,21 @@ struct pipeline_compat {
     size_t nb_buffers;
     uint32_t dynamic_offsets[NGLI_MAX_DYNAMIC_OFFSETS];
     size_t nb_dynamic_offsets;
+    uint32_t user_dynamic_offsets[NGLI_MAX_DYNAMIC_OFFSETS];
+    size_t nb_user_dynamic_offsets;
+    int dynamic_offset_stages[NGLI_MAX_DYNAMIC_OFFSETS];
     int updated;
     int need_pipeline_recreation;
     const struct pgcraft_compat_info *compat_info;
-    struct buffer *ubuffers[NGLI_PROGRAM_SHADER_NB];
-    uint8_t *mapped_datas[NGLI_PROGRAM_SHADER_NB];
+    uint8_t *ublock_datas[NGLI_PROGRAM_SHADER_NB];
+    size_t ublock_sizes[NGLI_PROGRAM_SHADER_NB];
+    size_t ublock_aligned_sizes[NGLI_PROGRAM_SHADER_NB];
+    int ublock_dirty[NGLI_PROGRAM_SHADER_NB];
+    uint64_t ublock_frame_ids[NGLI_PROGRAM_SHADER_NB];
+    const struct buffer *ublock_buffers[NGLI_PROGRAM_SHADER_NB];
+    uint32_t ublock_offsets[NGLI_PROGRAM_SHADER_NB];
 };
 
-static int map_buffer(struct pipeline_compat *s, int stage)
-{
-    if (s->mapped_datas[stage])
-        return 0;
-
-    struct buffer *buffer = s->ubuffers[stage];
-    return ngli_buffer_map(buffer, 0, buffer->size, (void **)&s->mapped_datas[stage]);
-}
-
-static void unmap_buffers(struct pipeline_compat *s)
-{
-    for (size_t i = 0; i < NGLI_PROGRAM_SHADER_NB; i++) {
-        if (s->mapped_datas[i]) {
-            ngli_buffer_unmap(s->ubuffers[i]);
-            s->mapped_datas[i] = NULL;
-        }
-    }
-}
-
 struct pipeline_compat *ngli_pipeline_compat_create(struct gpu_ctx *gpu_ctx)
 {
     struct pipeline_compat *s = ngli_calloc(1, sizeof(*s));
@@ -87,35 +77,88 @@ struct pipeline_compat *ngli_pipeline_compat_create(struct gpu_ctx *gpu_ctx)
     return s;
 }
 
+/*
+ * The uniform blocks are kept in CPU memory and pushed into the context
+ * uniform ring at draw time, where they are bound using dynamic offsets. This
+ * replaces the per-pipeline uniform buffers and their map/unmap on every
+ * draw.
+ */
 static int init_blocks_buffers(struct pipeline_compat *s, const struct pipeline_compat_params *params)
 {
-    struct gpu_ctx *gpu_ctx = s->gpu_ctx;
-
     for (size_t i = 0; i < NGLI_PROGRAM_SHADER_NB; i++) {
-        const size_t block_size = ngli_block_get_size(&s->compat_info->ublocks[i], 0);
-        if (!block_size)
+        const struct block *block = &s->compat_info->ublocks[i];
+        const size_t block_size = ngli_block_get_size(block, 0);
+        if (!block_size || s->compat_info->uindices[i] == -1)
             continue;
 
-        struct buffer *buffer = ngli_buffer_create(gpu_ctx);
-        if (!buffer)
+        s->ublock_datas[i] = ngli_calloc(1, block_size);
+        if (!s->ublock_datas[i])
             return NGL_ERROR_MEMORY;
-        s->ubuffers[i] = buffer;
+        s->ublock_sizes[i] = block_size;
+        s->ublock_aligned_sizes[i] = ngli_block_get_aligned_size(block, 0);
+        s->ublock_dirty[i] = 1;
+    }
+
+    /*
+     * Map every dynamic offset of the layout (ordered as the buffer entries)
+     * to either a uniform block stage or a user provided offset (-1)
+     */
+    size_t nb_dynamic_offsets = 0;
+    size_t nb_user_dynamic_offsets = 0;
+    for (size_t i = 0; i < s->bindgroup_layout_params.nb_buffers; i++) {
+        const struct bindgroup_layout_entry *entry = &s->bindgroup_layout_params.buffers[i];
+        if (entry->type != NGLI_TYPE_UNIFORM_BUFFER_DYNAMIC &&
+            entry->type != NGLI_TYPE_STORAGE_BUFFER_DYNAMIC)
+            continue;
+        ngli_assert(nb_dynamic_offsets < NGLI_MAX_DYNAMIC_OFFSETS);
+        int stage = -1;
+        for (int j = 0; j < NGLI_PROGRAM_SHADER_NB; j++) {
+            if (s->ublock_datas[j] && s->compat_info->uindices[j] == (int32_t)i)
+                stage = j;
+        }
+        if (stage == -1)
+            nb_user_dynamic_offsets++;
+        s->dynamic_offset_stages[nb_dynamic_offsets++] = stage;
+    }
+    s->nb_dynamic_offsets = nb_dynamic_offsets;
+    s->nb_user_dynamic_offsets = nb_user_dynamic_offsets;
+
+    return 0;
+}
+
+static int push_blocks(struct pipeline_compat *s)
+{
+    struct uniform_ring *uniform_ring = s->gpu_ctx->uniform_ring;
+    const uint64_t frame_id = ngli_uniform_ring_get_frame_id(uniform_ring);
+
+    for (size_t i = 0; i < NGLI_PROGRAM_SHADER_NB; i++) {
+        if (!s->ublock_datas[i])
+            continue;
+
+        /* Slices pushed earlier in the same frame can be reused as long as the data is unchanged */
+        if (!s->ublock_dirty[i] && s->ublock_frame_ids[i] == frame_id)
+            continue;
 
-        int ret = ngli_buffer_init(buffer,
-                                   block_size,
-                                   NGLI_BUFFER_USAGE_DYNAMIC_BIT |
-                                   NGLI_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
-                                   NGLI_BUFFER_USAGE_MAP_WRITE);
+        struct buffer *buffer;
+        size_t offset;
+        int ret = ngli_uniform_ring_push(uniform_ring, s->ublock_datas[i], s->ublock_sizes[i],
+                                         s->ublock_aligned_sizes[i], &buffer, &offset);
         if (ret < 0)
             return ret;
 
-        if (gpu_ctx->features & NGLI_FEATURE_BUFFER_MAP_PERSISTENT) {
-            ret = ngli_buffer_map(buffer, 0, buffer->size, (void **)&s->mapped_datas[i]);
-            if (ret < 0)
-                return ret;
+        if (buffer != s->ublock_buffers[i]) {
+            ngli_pipeline_compat_update_buffer(s, s->compat_info->uindices[i], buffer, 0, s->ublock_sizes[i]);
+            s->ublock_buffers[i] = buffer;
         }
+        s->ublock_offsets[i] = (uint32_t)offset;
+        s->ublock_dirty[i] = 0;
+        s->ublock_frame_ids[i] = frame_id;
+    }
 
-        ngli_pipeline_compat_update_buffer(s, s->compat_info->uindices[i], buffer, 0, buffer->size);
+    size_t user_index = 0;
+    for (size_t i = 0; i < s->nb_dynamic_offsets; i++) {
+        const int stage = s->dynamic_offset_stages[i];
+        s->dynamic_offsets[i] = stage >= 0 ? s->ublock_offsets[stage] : s->user_dynamic_offsets[user_index++];
     }
 
     return 0;
@@ -256,8 +299,6 @@ int ngli_pipeline_compat_update_vertex_buffer(struct pipeline_compat *s, int32_t
 
 int ngli_pipeline_compat_update_uniform_count(struct pipeline_compat *s, int32_t index, const void *value, size_t count)
 {
-    struct gpu_ctx *gpu_ctx = s->gpu_ctx;
-
     if (index == -1)
         return NGL_ERROR_NOT_FOUND;
 
@@ -266,14 +307,10 @@ int ngli_pipeline_compat_update_uniform_count(struct pipeline_compat *s, int32_t
     const struct block *block = &s->compat_info->ublocks[stage];
     const struct block_field *fields = ngli_darray_data(&block->fields);
     const struct block_field *field = &fields[field_index];
-    if (value) {
-        if (!(gpu_ctx->features & NGLI_FEATURE_BUFFER_MAP_PERSISTENT)) {
-            int ret = map_buffer(s, stage);
-            if (ret < 0)
-                return ret;
-        }
-        uint8_t *dst = s->mapped_datas[stage] + field->offset;
+    if (value && s->ublock_datas[stage]) {
+        uint8_t *dst = s->ublock_datas[stage] + field->offset;
         ngli_block_field_copy_count(field, dst, value, count);
+        s->ublock_dirty[stage] = 1;
     }
 
     return 0;
@@ -284,6 +321,26 @@ int ngli_pipeline_compat_update_uniform(struct pipeline_compat *s, int32_t index
     return ngli_pipeline_compat_update_uniform_count(s, index, value, 0);
 }
 
+int ngli_pipeline_compat_update_uniform_element(struct pipeline_compat *s, int32_t index, size_t element, const void *value)
+{
+    if (index == -1)
+        return NGL_ERROR_NOT_FOUND;
+
+    const int32_t stage = index >> 16;
+    const int32_t field_index = index & 0xffff;
+    const struct block *block = &s->compat_info->ublocks[stage];
+    const struct block_field *fields = ngli_darray_data(&block->fields);
+    const struct block_field *field = &fields[field_index];
+    ngli_assert(element < NGLI_MAX(field->count, 1));
+    if (value && s->ublock_datas[stage]) {
+        uint8_t *dst = s->ublock_datas[stage] + field->offset + element * field->stride;
+        ngli_block_field_copy_count(field, dst, value, 1);
+        s->ublock_dirty[stage] = 1;
+    }
+
+    return 0;
+}
+
 static int update_texture(struct pipeline_compat *s, int32_t index, const struct texture_binding *binding)
 {
     if (index == -1)
@@ -311,9 +368,8 @@ int ngli_pipeline_compat_update_texture(struct pipeline_compat *s, int32_t index
 
 int ngli_pipeline_compat_update_dynamic_offsets(struct pipeline_compat *s, const uint32_t *offsets, size_t nb_offsets)
 {
-    ngli_assert(s->bindgroup_layout->nb_dynamic_offsets == nb_offsets);
-    memcpy(s->dynamic_offsets, offsets, nb_offsets * sizeof(*s->dynamic_offsets));
-    s->nb_dynamic_offsets = nb_offsets;
+    ngli_assert(s->nb_user_dynamic_offsets == nb_offsets);
+    memcpy(s->user_dynamic_offsets, offsets, nb_offsets * sizeof(*s->user_dynamic_offsets));
     return 0;
 }
 
@@ -440,6 +496,10 @@ static int select_next_available_bindgroup(struct pipeline_compat *s)
 
 static int prepare_bindgroup(struct pipeline_compat *s)
 {
+    int ret = ngli_pipeline_init_deferred(s->pipeline);
+    if (ret < 0)
+        return ret;
+
     if (!s->updated)
         return 0;
 
@@ -448,12 +508,15 @@ static int prepare_bindgroup(struct pipeline_compat *s)
     if (s->need_pipeline_recreation) {
         s->need_pipeline_recreation = 0;
         reset_pipeline(s);
-        int ret = create_pipeline(s);
+        ret = create_pipeline(s);
+        if (ret < 0)
+            return ret;
+        ret = ngli_pipeline_init_deferred(s->pipeline);
         if (ret < 0)
             return ret;
     }
 
-    int ret = select_next_available_bindgroup(s);
+    ret = select_next_available_bindgroup(s);
     if (ret < 0)
         return ret;
 
@@ -476,10 +539,11 @@ void ngli_pipeline_compat_draw(struct pipeline_compat *s, int nb_vertices, int n
 {
     struct gpu_ctx *gpu_ctx = s->gpu_ctx;
 
-    if (!(gpu_ctx->features & NGLI_FEATURE_BUFFER_MAP_PERSISTENT))
-       unmap_buffers(s);
+    int ret = push_blocks(s);
+    if (ret < 0)
+        return;
 
-    int ret = prepare_bindgroup(s);
+    ret = prepare_bindgroup(s);
     if (ret < 0)
         return;
 
@@ -494,10 +558,11 @@ void ngli_pipeline_compat_draw_indexed(struct pipeline_compat *s, const struct b
 {
     struct gpu_ctx *gpu_ctx = s->gpu_ctx;
 
-    if (!(gpu_ctx->features & NGLI_FEATURE_BUFFER_MAP_PERSISTENT))
-       unmap_buffers(s);
+    int ret = push_blocks(s);
+    if (ret < 0)
+        return;
 
-    int ret = prepare_bindgroup(s);
+    ret = prepare_bindgroup(s);
     if (ret < 0)
         return;
 
@@ -513,10 +578,11 @@ void ngli_pipeline_compat_dispatch(struct pipeline_compat *s, uint32_t nb_group_
 {
     struct gpu_ctx *gpu_ctx = s->gpu_ctx;
 
-    if (!(gpu_ctx->features & NGLI_FEATURE_BUFFER_MAP_PERSISTENT))
-       unmap_buffers(s);
+    int ret = push_blocks(s);
+    if (ret < 0)
+        return;
 
-    int ret = prepare_bindgroup(s);
+    ret = prepare_bindgroup(s);
     if (ret < 0)
         return;
 
@@ -543,14 +609,7 @@ void ngli_pipeline_compat_freep(struct pipeline_compat **sp)
     ngli_freep(&s->textures);
     ngli_freep(&s->buffers);
 
-    if (s->compat_info) {
-        for (size_t i = 0; i < NGLI_PROGRAM_SHADER_NB; i++) {
-            if (s->ubuffers[i]) {
-                if (s->mapped_datas[i])
-                    ngli_buffer_unmap(s->ubuffers[i]);
-                ngli_buffer_freep(&s->ubuffers[i]);
-            }
-        }
-    }
+    for (size_t i = 0; i < NGLI_PROGRAM_SHADER_NB; i++)
+        ngli_freep(&s->ublock_datas[i]);
     ngli_freep(sp);
 }
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "nopegl.h"
+#include "rangealloc.h"
+#include "utils.h"
+
+int ngli_rangealloc_init(struct rangealloc *s, uint64_t size)
+{
+    memset(s, 0, sizeof(*s));
+    s->size = size;
+    ngli_darray_init(&s->free_ranges, sizeof(struct rangealloc_range), 0);
+
+    const struct rangealloc_range range = {.offset = 0, .size = size};
+    if (!ngli_darray_push(&s->free_ranges, &range))
+        return NGL_ERROR_MEMORY;
+    return 0;
+}
+
+static int insert_range(struct darray *ranges, size_t index, const struct rangealloc_range *range)
+{
+    if (!ngli_darray_push(ranges, range))
+        return NGL_ERROR_MEMORY;
+    struct rangealloc_range *data = ngli_darray_data(ranges);
+    const size_t count = ngli_darray_count(ranges);
+    memmove(&data[index + 1], &data[index], (count - 1 - index) * sizeof(*data));
+    data[index] = *range;
+    return 0;
+}
+
+int ngli_rangealloc_alloc(struct rangealloc *s, uint64_t size, uint64_t alignment, uint64_t *offsetp)
+{
+    ngli_assert(alignment > 0);
+
+    struct rangealloc_range *ranges = ngli_darray_data(&s->free_ranges);
+    for (size_t i = 0; i < ngli_darray_count(&s->free_ranges); i++) {
+        struct rangealloc_range *range = &ranges[i];
+        const uint64_t offset = NGLI_ALIGN(range->offset, alignment);
+        const uint64_t end = range->offset + range->size;
+        if (offset + size > end)
+            continue;
+
+        const uint64_t padding = offset - range->offset;
+        const uint64_t remaining = end - (offset + size);
+        if (padding && remaining) {
+            range->size = padding;
+            const struct rangealloc_range next = {.offset = offset + size, .size = remaining};
+            if (insert_range(&s->free_ranges, i + 1, &next) < 0) {
+                range->size = end - range->offset;
+                return NGL_ERROR_MEMORY;
+            }
+        } else if (padding) {
+            range->size = padding;
+        } else if (remaining) {
+            range->offset = offset + size;
+            range->size = remaining;
+        } else {
+            ngli_darray_remove(&s->free_ranges, i);
+        }
+
+        s->nb_allocations++;
+        *offsetp = offset;
+        return 0;
+    }
+    return NGL_ERROR_MEMORY;
+}
+
+int ngli_rangealloc_free(struct rangealloc *s, uint64_t offset, uint64_t size)
+{
+    struct rangealloc_range *ranges = ngli_darray_data(&s->free_ranges);
+    const size_t count = ngli_darray_count(&s->free_ranges);
+
+    size_t index = 0;
+    while (index < count && ranges[index].offset < offset)
+        index++;
+
+    const int merge_prev = index > 0 && ranges[index - 1].offset + ranges[index - 1].size == offset;
+    const int merge_next = index < count && offset + size == ranges[index].offset;
+
+    s->nb_allocations--;
+
+    if (merge_prev && merge_next) {
+        ranges[index - 1].size += size + ranges[index].size;
+        ngli_darray_remove(&s->free_ranges, index);
+    } else if (merge_prev) {
+        ranges[index - 1].size += size;
+    } else if (merge_next) {
+        ranges[index].offset = offset;
+        ranges[index].size += size;
+    } else {
+        const struct rangealloc_range range = {.offset = offset, .size = size};
+        return insert_range(&s->free_ranges, index, &range);
+    }
+    return 0;
+}
+
+void ngli_rangealloc_reset(struct rangealloc *s)
+{
+    ngli_darray_reset(&s->free_ranges);
+    memset(s, 0, sizeof(*s));
+}
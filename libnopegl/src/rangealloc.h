@@ -0,0 +1,51 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef RANGEALLOC_H
+#define RANGEALLOC_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "darray.h"
+
+struct rangealloc_range {
+    uint64_t offset;
+    uint64_t size;
+};
+
+/*
+ * First-fit allocator of aligned ranges within a fixed size area: the free
+ * space is tracked as a list of ranges sorted by offset, and a released range
+ * is coalesced with its free neighbours.
+ */
+struct rangealloc {
+    uint64_t size;
+    struct darray free_ranges; // struct rangealloc_range, sorted by offset
+    size_t nb_allocations;
+};
+
+int ngli_rangealloc_init(struct rangealloc *s, uint64_t size);
+int ngli_rangealloc_alloc(struct rangealloc *s, uint64_t size, uint64_t alignment, uint64_t *offsetp);
+int ngli_rangealloc_free(struct rangealloc *s, uint64_t offset, uint64_t size);
+void ngli_rangealloc_reset(struct rangealloc *s);
+
+#endif
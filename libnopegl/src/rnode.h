@@ -30,6 +30,7 @@ struct rnode {
     size_t id;
     struct graphics_state graphics_state;
     struct rendertarget_layout rendertarget_layout;
+    int batch; /* pipelines drawing a run of sibling render nodes at once (see node_group.c) */
     struct darray children;
 };
 
@@ -42,6 +42,7 @@ struct rtt_ctx {
     struct texture *ms_colors[NGLI_MAX_COLOR_ATTACHMENTS];
     size_t nb_ms_colors;
     struct texture *ms_depth;
+    int transient_attachments;
 
     int started;
     struct viewport prev_viewport;
@@ -59,6 +60,121 @@ struct rtt_ctx *ngli_rtt_create(struct ngl_ctx *ctx)
     return s;
 }
 
+/*
+ * The content of the private attachments of a render pass that is never
+ * interrupted does not outlive the render pass itself. Since render passes
+ * cannot overlap (an overlapping render pass would interrupt the other one),
+ * these attachments can be shared between all the non-interrupted render
+ * passes using compatible parameters.
+ */
+static int is_compatible_attachment(const struct texture_params *a, const struct texture_params *b)
+{
+    return a->type    == b->type    &&
+           a->format  == b->format  &&
+           a->width   == b->width   &&
+           a->height  == b->height  &&
+           a->samples == b->samples &&
+           a->usage   == b->usage;
+}
+
+/*
+ * A render pass cannot use the same texture for several of its attachments
+ * (typically multiple multisampled color attachments of the same format).
+ */
+static int is_attachment_in_use(const struct rtt_ctx *s, const struct texture *texture)
+{
+    for (size_t i = 0; i < s->nb_ms_colors; i++)
+        if (s->ms_colors[i] == texture)
+            return 1;
+    return s->ms_depth == texture || s->depth == texture;
+}
+
+static int acquire_transient_attachment(struct rtt_ctx *s, const struct texture_params *params,
+                                        struct texture **texturep)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct darray *attachments = &ctx->transient_attachments;
+    struct transient_attachment *attachments_data = ngli_darray_data(attachments);
+    for (size_t i = 0; i < ngli_darray_count(attachments); i++) {
+        struct transient_attachment *attachment = &attachments_data[i];
+        if (is_compatible_attachment(&attachment->texture->params, params) &&
+            !is_attachment_in_use(s, attachment->texture)) {
+            attachment->nb_users++;
+            *texturep = attachment->texture;
+            return 0;
+        }
+    }
+
+    struct texture *texture = ngli_texture_create(ctx->gpu_ctx);
+    if (!texture)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngli_texture_init(texture, params);
+    if (ret < 0) {
+        ngli_texture_freep(&texture);
+        return ret;
+    }
+
+    const struct transient_attachment attachment = {.texture = texture, .nb_users = 1};
+    if (!ngli_darray_push(attachments, &attachment)) {
+        ngli_texture_freep(&texture);
+        return NGL_ERROR_MEMORY;
+    }
+
+    *texturep = texture;
+    return 0;
+}
+
+static void release_transient_attachment(struct ngl_ctx *ctx, struct texture **texturep)
+{
+    struct texture *texture = *texturep;
+    if (!texture)
+        return;
+
+    struct darray *attachments = &ctx->transient_attachments;
+    struct transient_attachment *attachments_data = ngli_darray_data(attachments);
+    for (size_t i = 0; i < ngli_darray_count(attachments); i++) {
+        struct transient_attachment *attachment = &attachments_data[i];
+        if (attachment->texture != texture)
+            continue;
+        if (--attachment->nb_users == 0) {
+            ngli_texture_freep(&attachment->texture);
+            ngli_darray_remove(attachments, i);
+        }
+        break;
+    }
+    *texturep = NULL;
+}
+
+static int create_attachment(struct rtt_ctx *s, const struct texture_params *params, struct texture **texturep)
+{
+    struct ngl_ctx *ctx = s->ctx;
+
+    if (s->transient_attachments)
+        return acquire_transient_attachment(s, params, texturep);
+
+    struct texture *texture = ngli_texture_create(ctx->gpu_ctx);
+    if (!texture)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngli_texture_init(texture, params);
+    if (ret < 0) {
+        ngli_texture_freep(&texture);
+        return ret;
+    }
+
+    *texturep = texture;
+    return 0;
+}
+
+static void free_attachment(struct rtt_ctx *s, struct texture **texturep)
+{
+    if (s->transient_attachments)
+        release_transient_attachment(s->ctx, texturep);
+    else
+        ngli_texture_freep(texturep);
+}
+
 int ngli_rtt_init(struct rtt_ctx *s, const struct rtt_params *params)
 {
     struct ngl_ctx *ctx = s->ctx;
@@ -67,8 +183,10 @@ int ngli_rtt_init(struct rtt_ctx *s, const struct rtt_params *params)
     s->params = *params;
 
     int transient_usage = 0;
-    if (!params->nb_interruptions)
+    if (!params->nb_interruptions) {
         transient_usage |= NGLI_TEXTURE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        s->transient_attachments = 1;
+    }
 
     struct rendertarget_params rt_params = {
         .width = s->params.width,
@@ -81,11 +199,6 @@ int ngli_rtt_init(struct rtt_ctx *s, const struct rtt_params *params)
             struct texture *texture = attachment->attachment;
             const int texture_layer = attachment->attachment_layer;
 
-            struct texture *ms_texture = ngli_texture_create(gpu_ctx);
-            if (!ms_texture)
-                return NGL_ERROR_MEMORY;
-            s->ms_colors[s->nb_ms_colors++] = ms_texture;
-
             struct texture_params attachment_params = {
                 .type    = NGLI_TEXTURE_TYPE_2D,
                 .format  = texture->params.format,
@@ -94,9 +207,11 @@ int ngli_rtt_init(struct rtt_ctx *s, const struct rtt_params *params)
                 .samples = s->params.samples,
                 .usage   = NGLI_TEXTURE_USAGE_COLOR_ATTACHMENT_BIT | transient_usage,
             };
-            int ret = ngli_texture_init(ms_texture, &attachment_params);
+            struct texture *ms_texture = NULL;
+            int ret = create_attachment(s, &attachment_params, &ms_texture);
             if (ret < 0)
                 return ret;
+            s->ms_colors[s->nb_ms_colors++] = ms_texture;
 
             rt_params.colors[rt_params.nb_colors].attachment = ms_texture;
             rt_params.colors[rt_params.nb_colors].attachment_layer = 0;
@@ -119,11 +234,6 @@ int ngli_rtt_init(struct rtt_ctx *s, const struct rtt_params *params)
             struct texture *texture = attachment->attachment;
             const int texture_layer = attachment->attachment_layer;
 
-            struct texture *ms_texture = ngli_texture_create(gpu_ctx);
-            if (!ms_texture)
-                return NGL_ERROR_MEMORY;
-            s->ms_depth = ms_texture;
-
             struct texture_params attachment_params = {
                 .type    = NGLI_TEXTURE_TYPE_2D,
                 .format  = texture->params.format,
@@ -132,11 +242,11 @@ int ngli_rtt_init(struct rtt_ctx *s, const struct rtt_params *params)
                 .samples = s->params.samples,
                 .usage   = NGLI_TEXTURE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | transient_usage,
             };
-            int ret = ngli_texture_init(ms_texture, &attachment_params);
+            int ret = create_attachment(s, &attachment_params, &s->ms_depth);
             if (ret < 0)
                 return ret;
 
-            rt_params.depth_stencil.attachment = ms_texture;
+            rt_params.depth_stencil.attachment = s->ms_depth;
             rt_params.depth_stencil.attachment_layer = 0;
             rt_params.depth_stencil.resolve_target = texture;
             rt_params.depth_stencil.resolve_target_layer = texture_layer;
@@ -147,11 +257,6 @@ int ngli_rtt_init(struct rtt_ctx *s, const struct rtt_params *params)
             rt_params.depth_stencil = s->params.depth_stencil;
         }
     } else if (s->params.depth_stencil_format != NGLI_FORMAT_UNDEFINED) {
-        struct texture *depth = ngli_texture_create(gpu_ctx);
-        if (!depth)
-            return NGL_ERROR_MEMORY;
-        s->depth = depth;
-
         struct texture_params attachment_params = {
             .type    = NGLI_TEXTURE_TYPE_2D,
             .format  = s->params.depth_stencil_format,
@@ -160,11 +265,11 @@ int ngli_rtt_init(struct rtt_ctx *s, const struct rtt_params *params)
             .samples = s->params.samples,
             .usage   = NGLI_TEXTURE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | transient_usage,
         };
-        int ret = ngli_texture_init(depth, &attachment_params);
+        int ret = create_attachment(s, &attachment_params, &s->depth);
         if (ret < 0)
             return ret;
 
-        rt_params.depth_stencil.attachment = depth;
+        rt_params.depth_stencil.attachment = s->depth;
         rt_params.depth_stencil.load_op = NGLI_LOAD_OP_CLEAR;
         /*
          * For the first rendertarget with load operations set to clear, if
@@ -289,12 +394,12 @@ void ngli_rtt_freep(struct rtt_ctx **sp)
 
     ngli_rendertarget_freep(&s->rt);
     ngli_rendertarget_freep(&s->rt_resume);
-    ngli_texture_freep(&s->depth);
+    free_attachment(s, &s->depth);
 
     for (size_t i = 0; i < s->nb_ms_colors; i++)
-        ngli_texture_freep(&s->ms_colors[i]);
+        free_attachment(s, &s->ms_colors[i]);
     s->nb_ms_colors = 0;
-    ngli_texture_freep(&s->ms_depth);
+    free_attachment(s, &s->ms_depth);
 
     ngli_freep(sp);
 }
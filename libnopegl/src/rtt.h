@@ -44,6 +44,11 @@ struct rtt_params {
     struct attachment depth_stencil;
 };
 
+struct transient_attachment {
+    struct texture *texture;
+    size_t nb_users;
+};
+
 struct rtt_ctx *ngli_rtt_create(struct ngl_ctx *ctx);
 int ngli_rtt_init(struct rtt_ctx *s, const struct rtt_params *params);
 void ngli_rtt_begin(struct rtt_ctx *s);
@@ -19,6 +19,8 @@
  * under the License.
  */
 
+#include <string.h>
+
 #include "nopegl.h"
 #include "internal.h"
 #include "log.h"
@@ -73,6 +75,35 @@ int ngl_scene_init_from_str(struct ngl_scene *s, const char *str)
     return ngli_scene_deserialize(s, str);
 }
 
+int ngl_scene_init_from_file(struct ngl_scene *s, const char *filename)
+{
+    ngl_node_unrefp(&s->params.root);
+
+    struct file_map map = {0};
+    int ret = ngli_file_map(filename, &map);
+    if (ret < 0)
+        return ret;
+
+    if (map.size >= 4 && !memcmp(map.data, NGLI_SCENE_BIN_MAGIC, 4)) {
+        ret = ngli_scene_deserialize_binary(s, map.data, map.size);
+    } else {
+        char *str = ngli_malloc(map.size + 1);
+        if (!str) {
+            ret = NGL_ERROR_MEMORY;
+            goto end;
+        }
+        if (map.size)
+            memcpy(str, map.data, map.size);
+        str[map.size] = 0;
+        ret = ngli_scene_deserialize(s, str);
+        ngli_free(str);
+    }
+
+end:
+    ngli_file_unmap(&map);
+    return ret;
+}
+
 const struct ngl_scene_params *ngl_scene_get_params(const struct ngl_scene *s)
 {
     return &s->params;
@@ -83,6 +114,16 @@ char *ngl_scene_serialize(const struct ngl_scene *s)
     return ngli_scene_serialize(s);
 }
 
+int ngl_scene_serialize_binary(const struct ngl_scene *s, void **datap, size_t *sizep)
+{
+    uint8_t *data;
+    int ret = ngli_scene_serialize_binary(s, &data, sizep);
+    if (ret < 0)
+        return ret;
+    *datap = data;
+    return 0;
+}
+
 char *ngl_scene_dot(const struct ngl_scene *s)
 {
     return ngli_scene_dot(s);
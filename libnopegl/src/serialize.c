@@ -380,12 +380,14 @@ static int serialize_options(struct hmap *nlist,
     return 0;
 }
 
+typedef int (*write_node_func)(void *arg, struct hmap *nlist, const struct ngl_node *node);
+
 static int serialize(struct hmap *nlist,
-                     struct bstr *b,
+                     write_node_func write_node, void *arg,
                      const struct ngl_node *node);
 
 static int serialize_children(struct hmap *nlist,
-                               struct bstr *b,
+                               write_node_func write_node, void *arg,
                                const struct ngl_node *node,
                                uint8_t *priv,
                                const struct node_param *p)
@@ -400,7 +402,7 @@ static int serialize_children(struct hmap *nlist,
             case NGLI_PARAM_TYPE_NODE: {
                 const struct ngl_node *child = *(struct ngl_node **)srcp;
                 if (child) {
-                    int ret = serialize(nlist, b, child);
+                    int ret = serialize(nlist, write_node, arg, child);
                     if (ret < 0)
                         return ret;
                 }
@@ -411,7 +413,7 @@ static int serialize_children(struct hmap *nlist,
                 const size_t nb_children = *(size_t *)(srcp + sizeof(struct ngl_node **));
 
                 for (size_t i = 0; i < nb_children; i++) {
-                    int ret = serialize(nlist, b, children[i]);
+                    int ret = serialize(nlist, write_node, arg, children[i]);
                     if (ret < 0)
                         return ret;
                 }
@@ -432,7 +434,7 @@ static int serialize_children(struct hmap *nlist,
                 const struct item *items = ngli_darray_data(&items_array);
                 for (size_t i = 0; i < ngli_darray_count(&items_array); i++) {
                     const struct item *item = &items[i];
-                    int ret = serialize(nlist, b, item->data);
+                    int ret = serialize(nlist, write_node, arg, item->data);
                     if (ret < 0) {
                         ngli_darray_reset(&items_array);
                         return ret;
@@ -446,7 +448,7 @@ static int serialize_children(struct hmap *nlist,
                     break;
                 struct ngl_node *child = *(struct ngl_node **)srcp;
                 if (child) {
-                    int ret = serialize(nlist, b, child);
+                    int ret = serialize(nlist, write_node, arg, child);
                     if (ret < 0)
                         return ret;
                 }
@@ -458,19 +460,11 @@ static int serialize_children(struct hmap *nlist,
     return 0;
 }
 
-static int serialize(struct hmap *nlist,
-                     struct bstr *b,
-                     const struct ngl_node *node)
+static int write_node_str(void *arg, struct hmap *nlist, const struct ngl_node *node)
 {
-    if (get_node_id(nlist, node) >= 0)
-        return 0;
-
+    struct bstr *b = arg;
     int ret;
 
-    if ((ret = serialize_children(nlist, b, node, (uint8_t *)node, ngli_base_node_params)) < 0 ||
-        (ret = serialize_children(nlist, b, node, node->opts, node->cls->params)) < 0)
-        return ret;
-
     const uint32_t tag = node->cls->id;
     ngli_bstr_printf(b, "%c%c%c%c",
                     tag >> 24 & 0xff,
@@ -483,6 +477,23 @@ static int serialize(struct hmap *nlist,
 
     ngli_bstr_print(b, "\n");
 
+    return 0;
+}
+
+static int serialize(struct hmap *nlist,
+                     write_node_func write_node, void *arg,
+                     const struct ngl_node *node)
+{
+    if (get_node_id(nlist, node) >= 0)
+        return 0;
+
+    int ret;
+
+    if ((ret = serialize_children(nlist, write_node, arg, node, (uint8_t *)node, ngli_base_node_params)) < 0 ||
+        (ret = serialize_children(nlist, write_node, arg, node, node->opts, node->cls->params)) < 0 ||
+        (ret = write_node(arg, nlist, node)) < 0)
+        return ret;
+
     return register_node(nlist, node);
 }
 
@@ -507,7 +518,7 @@ char *ngli_scene_serialize(const struct ngl_scene *s)
     ngli_bstr_printf(b, "# framerate=%d/%d\n", s->params.framerate[0], s->params.framerate[1]);
 
     /* Write nodes (1 line = 1 node) */
-    if (serialize(nlist, b, s->params.root) < 0)
+    if (serialize(nlist, write_node_str, b, s->params.root) < 0)
         goto end;
     str = ngli_bstr_strdup(b);
 
@@ -516,3 +527,346 @@ end:
     ngli_bstr_freep(&b);
     return str;
 }
+
+struct bwriter {
+    uint8_t *data;
+    size_t size;
+    size_t cap;
+    int error;
+};
+
+static void bw_write(struct bwriter *w, const void *p, size_t n)
+{
+    if (w->error || !n)
+        return;
+    if (n > w->cap - w->size) {
+        const size_t cap = NGLI_MAX(NGLI_MAX(w->cap * 2, w->size + n), 4096);
+        uint8_t *data = ngli_realloc(w->data, cap, sizeof(*data));
+        if (!data) {
+            w->error = NGL_ERROR_MEMORY;
+            return;
+        }
+        w->data = data;
+        w->cap = cap;
+    }
+    memcpy(w->data + w->size, p, n);
+    w->size += n;
+}
+
+static void bw_u8(struct bwriter *w, uint8_t v)
+{
+    bw_write(w, &v, sizeof(v));
+}
+
+static void bw_u32(struct bwriter *w, uint32_t v)
+{
+    const uint8_t b[] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+    bw_write(w, b, sizeof(b));
+}
+
+static void bw_u64(struct bwriter *w, uint64_t v)
+{
+    bw_u32(w, (uint32_t)(v & 0xffffffff));
+    bw_u32(w, (uint32_t)(v >> 32));
+}
+
+static void bw_i32(struct bwriter *w, int32_t v)
+{
+    bw_u32(w, (uint32_t)v);
+}
+
+static void bw_f32(struct bwriter *w, float f)
+{
+    const union { uint32_t i; float f; } u = {.f = f};
+    bw_u32(w, u.i);
+}
+
+static void bw_f64(struct bwriter *w, double f)
+{
+    const union { uint64_t i; double f; } u = {.f = f};
+    bw_u64(w, u.i);
+}
+
+static void bw_str(struct bwriter *w, const char *s)
+{
+    const size_t len = strlen(s);
+    bw_u32(w, (uint32_t)len);
+    bw_write(w, s, len);
+}
+
+static void bw_pad(struct bwriter *w, size_t align)
+{
+    static const uint8_t zeros[NGLI_SCENE_BIN_DATA_ALIGN];
+    bw_write(w, zeros, NGLI_ALIGN(w->size, align) - w->size);
+}
+
+static void bw_patch_u32(struct bwriter *w, size_t offset, uint32_t v)
+{
+    if (w->error)
+        return;
+    const uint8_t b[] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+    memcpy(w->data + offset, b, sizeof(b));
+}
+
+struct bin_ctx {
+    struct bwriter nodes;
+    struct bwriter blobs;
+};
+
+static int is_default_param(const uint8_t *srcp, const struct node_param *par, const char *label)
+{
+    switch (par->type) {
+    case NGLI_PARAM_TYPE_SELECT:
+    case NGLI_PARAM_TYPE_FLAGS:
+    case NGLI_PARAM_TYPE_BOOL:
+    case NGLI_PARAM_TYPE_I32:       return *(int *)srcp == par->def_value.i32;
+    case NGLI_PARAM_TYPE_U32:       return *(uint32_t *)srcp == par->def_value.u32;
+    case NGLI_PARAM_TYPE_F32:       return *(float *)srcp == par->def_value.f32;
+    case NGLI_PARAM_TYPE_F64:       return *(double *)srcp == par->def_value.f64;
+    case NGLI_PARAM_TYPE_RATIONAL:  return !memcmp(srcp, par->def_value.r, sizeof(par->def_value.r));
+    case NGLI_PARAM_TYPE_STR: {
+        const char *s = *(char **)srcp;
+        return !s || (par->def_value.str && !strcmp(s, par->def_value.str)) ||
+               (!strcmp(par->key, "label") && ngli_is_default_label(label, s));
+    }
+    case NGLI_PARAM_TYPE_DATA:      return !*(uint8_t **)srcp || !*(size_t *)(srcp + sizeof(uint8_t *));
+    case NGLI_PARAM_TYPE_IVEC2:
+    case NGLI_PARAM_TYPE_IVEC3:
+    case NGLI_PARAM_TYPE_IVEC4:     return !memcmp(srcp, par->def_value.ivec, (par->type - NGLI_PARAM_TYPE_IVEC2 + 2) * sizeof(int32_t));
+    case NGLI_PARAM_TYPE_UVEC2:
+    case NGLI_PARAM_TYPE_UVEC3:
+    case NGLI_PARAM_TYPE_UVEC4:     return !memcmp(srcp, par->def_value.uvec, (par->type - NGLI_PARAM_TYPE_UVEC2 + 2) * sizeof(uint32_t));
+    case NGLI_PARAM_TYPE_VEC2:
+    case NGLI_PARAM_TYPE_VEC3:
+    case NGLI_PARAM_TYPE_VEC4:      return !memcmp(srcp, par->def_value.vec, (par->type - NGLI_PARAM_TYPE_VEC2 + 2) * sizeof(float));
+    case NGLI_PARAM_TYPE_MAT4:      return !memcmp(srcp, par->def_value.mat, 16 * sizeof(float));
+    case NGLI_PARAM_TYPE_NODE:      return !*(struct ngl_node **)srcp;
+    case NGLI_PARAM_TYPE_NODELIST:  return !*(size_t *)(srcp + sizeof(struct ngl_node **));
+    case NGLI_PARAM_TYPE_F64LIST:   return !*(size_t *)(srcp + sizeof(double *));
+    case NGLI_PARAM_TYPE_NODEDICT: {
+        struct hmap *hmap = *(struct hmap **)srcp;
+        return !hmap || !ngli_hmap_count(hmap);
+    }
+    }
+    return 0;
+}
+
+static int serialize_param_bin(struct bin_ctx *c, struct hmap *nlist,
+                               const uint8_t *srcp, const struct node_param *p)
+{
+    struct bwriter *w = &c->nodes;
+
+    switch (p->type) {
+    case NGLI_PARAM_TYPE_SELECT: {
+        const char *s = ngli_params_get_select_str(p->choices->consts, *(int *)srcp);
+        ngli_assert(s);
+        bw_str(w, s);
+        break;
+    }
+    case NGLI_PARAM_TYPE_FLAGS: {
+        char *s = ngli_params_get_flags_str(p->choices->consts, *(int *)srcp);
+        if (!s)
+            return NGL_ERROR_MEMORY;
+        bw_str(w, s);
+        ngli_free(s);
+        break;
+    }
+    case NGLI_PARAM_TYPE_BOOL:
+    case NGLI_PARAM_TYPE_I32:       bw_i32(w, *(int32_t *)srcp);                    break;
+    case NGLI_PARAM_TYPE_U32:       bw_u32(w, *(uint32_t *)srcp);                   break;
+    case NGLI_PARAM_TYPE_F32:       bw_f32(w, *(float *)srcp);                      break;
+    case NGLI_PARAM_TYPE_F64:       bw_f64(w, *(double *)srcp);                     break;
+    case NGLI_PARAM_TYPE_RATIONAL:
+    case NGLI_PARAM_TYPE_IVEC2:
+    case NGLI_PARAM_TYPE_IVEC3:
+    case NGLI_PARAM_TYPE_IVEC4: {
+        const int n = p->type == NGLI_PARAM_TYPE_RATIONAL ? 2 : p->type - NGLI_PARAM_TYPE_IVEC2 + 2;
+        for (int i = 0; i < n; i++)
+            bw_i32(w, ((const int32_t *)srcp)[i]);
+        break;
+    }
+    case NGLI_PARAM_TYPE_UVEC2:
+    case NGLI_PARAM_TYPE_UVEC3:
+    case NGLI_PARAM_TYPE_UVEC4: {
+        const int n = p->type - NGLI_PARAM_TYPE_UVEC2 + 2;
+        for (int i = 0; i < n; i++)
+            bw_u32(w, ((const uint32_t *)srcp)[i]);
+        break;
+    }
+    case NGLI_PARAM_TYPE_VEC2:
+    case NGLI_PARAM_TYPE_VEC3:
+    case NGLI_PARAM_TYPE_VEC4:
+    case NGLI_PARAM_TYPE_MAT4: {
+        const int n = p->type == NGLI_PARAM_TYPE_MAT4 ? 16 : p->type - NGLI_PARAM_TYPE_VEC2 + 2;
+        for (int i = 0; i < n; i++)
+            bw_f32(w, ((const float *)srcp)[i]);
+        break;
+    }
+    case NGLI_PARAM_TYPE_STR:       bw_str(w, *(char **)srcp);                      break;
+    case NGLI_PARAM_TYPE_DATA: {
+        const uint8_t *data = *(uint8_t **)srcp;
+        const size_t size = *(size_t *)(srcp + sizeof(uint8_t *));
+        bw_pad(&c->blobs, NGLI_SCENE_BIN_DATA_ALIGN);
+        bw_u64(w, c->blobs.size);
+        bw_u64(w, size);
+        bw_write(&c->blobs, data, size);
+        break;
+    }
+    case NGLI_PARAM_TYPE_NODE:
+        bw_u32(w, (uint32_t)get_node_id(nlist, *(struct ngl_node **)srcp));
+        break;
+    case NGLI_PARAM_TYPE_NODELIST: {
+        struct ngl_node **nodes = *(struct ngl_node ***)srcp;
+        const size_t nb_nodes = *(size_t *)(srcp + sizeof(struct ngl_node **));
+        bw_u32(w, (uint32_t)nb_nodes);
+        for (size_t i = 0; i < nb_nodes; i++)
+            bw_u32(w, (uint32_t)get_node_id(nlist, nodes[i]));
+        break;
+    }
+    case NGLI_PARAM_TYPE_F64LIST: {
+        const double *elems = *(double **)srcp;
+        const size_t nb_elems = *(size_t *)(srcp + sizeof(double *));
+        bw_u32(w, (uint32_t)nb_elems);
+        for (size_t i = 0; i < nb_elems; i++)
+            bw_f64(w, elems[i]);
+        break;
+    }
+    case NGLI_PARAM_TYPE_NODEDICT: {
+        struct darray items_array;
+        ngli_darray_init(&items_array, sizeof(struct item), 0);
+        int ret = hmap_to_sorted_items(&items_array, *(struct hmap **)srcp);
+        if (ret < 0) {
+            ngli_darray_reset(&items_array);
+            return ret;
+        }
+        const struct item *items = ngli_darray_data(&items_array);
+        bw_u32(w, (uint32_t)ngli_darray_count(&items_array));
+        for (size_t i = 0; i < ngli_darray_count(&items_array); i++) {
+            bw_str(w, items[i].key);
+            bw_u32(w, (uint32_t)get_node_id(nlist, items[i].data));
+        }
+        ngli_darray_reset(&items_array);
+        break;
+    }
+    default:
+        LOG(ERROR, "cannot serialize %s: unsupported parameter type", p->key);
+        return NGL_ERROR_BUG;
+    }
+    return 0;
+}
+
+static void write_param_header(struct bwriter *w, const char *key, uint8_t kind)
+{
+    const size_t len = strlen(key);
+    ngli_assert(len <= UINT8_MAX);
+    bw_u8(w, (uint8_t)len);
+    bw_write(w, key, len);
+    bw_u8(w, kind);
+}
+
+static int serialize_options_bin(struct bin_ctx *c, struct hmap *nlist,
+                                 const struct ngl_node *node, uint8_t *priv,
+                                 const struct node_param *p, uint32_t *nb_paramsp)
+{
+    if (!p)
+        return 0;
+
+    const char *label = node->cls->name;
+    while (p->key) {
+        const uint8_t *srcp = priv + p->offset;
+
+        if (p->flags & NGLI_PARAM_FLAG_ALLOW_NODE) {
+            struct ngl_node *src_node = *(struct ngl_node **)srcp;
+            if (src_node) {
+                write_param_header(&c->nodes, p->key, NGLI_SCENE_BIN_NODE_REF);
+                bw_u32(&c->nodes, (uint32_t)get_node_id(nlist, src_node));
+                (*nb_paramsp)++;
+                p++;
+                continue;
+            }
+            srcp += sizeof(struct ngl_node *);
+        }
+
+        if (!is_default_param(srcp, p, label)) {
+            write_param_header(&c->nodes, p->key, (uint8_t)p->type);
+            int ret = serialize_param_bin(c, nlist, srcp, p);
+            if (ret < 0)
+                return ret;
+            (*nb_paramsp)++;
+        }
+        p++;
+    }
+    return 0;
+}
+
+static int write_node_bin(void *arg, struct hmap *nlist, const struct ngl_node *node)
+{
+    struct bin_ctx *c = arg;
+    struct bwriter *w = &c->nodes;
+
+    bw_u32(w, node->cls->id);
+    const size_t nb_params_offset = w->size;
+    bw_u32(w, 0);
+
+    uint32_t nb_params = 0;
+    int ret;
+    if ((ret = serialize_options_bin(c, nlist, node, node->opts, node->cls->params, &nb_params)) < 0 ||
+        (ret = serialize_options_bin(c, nlist, node, (uint8_t *)node, ngli_base_node_params, &nb_params)) < 0)
+        return ret;
+    bw_patch_u32(w, nb_params_offset, nb_params);
+
+    return w->error;
+}
+
+int ngli_scene_serialize_binary(const struct ngl_scene *s, uint8_t **datap, size_t *sizep)
+{
+    *datap = NULL;
+    *sizep = 0;
+
+    struct bin_ctx c = {0};
+    struct bwriter out = {0};
+    struct hmap *nlist = ngli_hmap_create();
+    if (!nlist)
+        return NGL_ERROR_MEMORY;
+    ngli_hmap_set_free_func(nlist, free_func, NULL);
+
+    int ret = serialize(nlist, write_node_bin, &c, s->params.root);
+    if (ret < 0)
+        goto end;
+    if ((ret = c.blobs.error) < 0)
+        goto end;
+
+    const size_t nodes_offset = NGLI_SCENE_BIN_HEADER_SIZE;
+    const size_t data_offset = NGLI_ALIGN(nodes_offset + c.nodes.size, NGLI_SCENE_BIN_DATA_ALIGN);
+
+    bw_write(&out, NGLI_SCENE_BIN_MAGIC, 4);
+    bw_u32(&out, NGLI_SCENE_BIN_VERSION);
+    bw_u32(&out, NGL_VERSION_INT);
+    bw_u32(&out, (uint32_t)ngli_hmap_count(nlist));
+    bw_f64(&out, s->params.duration);
+    bw_i32(&out, s->params.framerate[0]);
+    bw_i32(&out, s->params.framerate[1]);
+    bw_i32(&out, s->params.aspect_ratio[0]);
+    bw_i32(&out, s->params.aspect_ratio[1]);
+    bw_u64(&out, nodes_offset);
+    bw_u64(&out, c.nodes.size);
+    bw_u64(&out, data_offset);
+    ngli_assert(out.error || out.size == NGLI_SCENE_BIN_HEADER_SIZE);
+
+    bw_write(&out, c.nodes.data, c.nodes.size);
+    bw_pad(&out, NGLI_SCENE_BIN_DATA_ALIGN);
+    bw_write(&out, c.blobs.data, c.blobs.size);
+    if ((ret = out.error) < 0)
+        goto end;
+
+    *datap = out.data;
+    *sizep = out.size;
+    out.data = NULL;
+
+end:
+    ngli_free(out.data);
+    ngli_free(c.nodes.data);
+    ngli_free(c.blobs.data);
+    ngli_hmap_freep(&nlist);
+    return ret;
+}
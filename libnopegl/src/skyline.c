@@ -0,0 +1,176 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "log.h"
+#include "nopegl.h"
+#include "skyline.h"
+#include "utils.h"
+
+struct skyline_node {
+    int32_t x, y, w;
+};
+
+void ngli_skyline_init(struct skyline *s)
+{
+    memset(s, 0, sizeof(*s));
+    ngli_darray_init(&s->nodes, sizeof(struct skyline_node), 0);
+}
+
+int32_t ngli_skyline_get_used_height(const struct skyline *s)
+{
+    const struct skyline_node *nodes = ngli_darray_data(&s->nodes);
+    int32_t height = 0;
+    for (size_t i = 0; i < ngli_darray_count(&s->nodes); i++)
+        height = NGLI_MAX(height, nodes[i].y);
+    return height;
+}
+
+/*
+ * The width can only grow (the new columns on the right are free up to the
+ * bottom of the area), while the height can be adjusted as long as it still
+ * covers the placed rectangles.
+ */
+int ngli_skyline_resize(struct skyline *s, int32_t width, int32_t height)
+{
+    if (width < s->width || height < ngli_skyline_get_used_height(s)) {
+        LOG(ERROR, "skyline cannot shrink from %dx%d to %dx%d", s->width, s->height, width, height);
+        return NGL_ERROR_INVALID_USAGE;
+    }
+
+    if (width > s->width) {
+        const struct skyline_node node = {.x=s->width, .y=0, .w=width - s->width};
+        if (!ngli_darray_push(&s->nodes, &node))
+            return NGL_ERROR_MEMORY;
+    }
+
+    s->width = width;
+    s->height = height;
+    return 0;
+}
+
+/*
+ * Return the lowest position at which a w×h rectangle can be placed with its
+ * left edge on the node at the given index, or -1 if it doesn't fit.
+ */
+static int32_t get_fit_y(const struct skyline *s, size_t index, int32_t w, int32_t h)
+{
+    const struct skyline_node *nodes = ngli_darray_data(&s->nodes);
+    const size_t nb_nodes = ngli_darray_count(&s->nodes);
+
+    if (nodes[index].x + w > s->width)
+        return -1;
+
+    int32_t y = 0;
+    int32_t width_left = w;
+    for (size_t i = index; width_left > 0; i++) {
+        ngli_assert(i < nb_nodes);
+        y = NGLI_MAX(y, nodes[i].y);
+        if (y + h > s->height)
+            return -1;
+        width_left -= nodes[i].w;
+    }
+    return y;
+}
+
+static int insert_node(struct skyline *s, size_t index, const struct skyline_node *node)
+{
+    if (!ngli_darray_push(&s->nodes, NULL))
+        return NGL_ERROR_MEMORY;
+    struct skyline_node *nodes = ngli_darray_data(&s->nodes);
+    const size_t nb_nodes = ngli_darray_count(&s->nodes);
+    memmove(&nodes[index + 1], &nodes[index], (nb_nodes - index - 1) * sizeof(*nodes));
+    nodes[index] = *node;
+    return 0;
+}
+
+/*
+ * Place a w×h rectangle where its top edge is the lowest (ties are broken by
+ * picking the narrowest segment). Return NGL_ERROR_LIMIT_EXCEEDED if there is
+ * no room left for it.
+ */
+int ngli_skyline_pack(struct skyline *s, int32_t w, int32_t h, int32_t *x, int32_t *y)
+{
+    ngli_assert(w > 0 && h > 0);
+
+    const struct skyline_node *nodes = ngli_darray_data(&s->nodes);
+    const size_t nb_nodes = ngli_darray_count(&s->nodes);
+
+    size_t best_index = SIZE_MAX;
+    int32_t best_y = INT32_MAX;
+    int32_t best_w = INT32_MAX;
+    for (size_t i = 0; i < nb_nodes; i++) {
+        const int32_t fit_y = get_fit_y(s, i, w, h);
+        if (fit_y < 0)
+            continue;
+        if (fit_y + h < best_y || (fit_y + h == best_y && nodes[i].w < best_w)) {
+            best_index = i;
+            best_y = fit_y + h;
+            best_w = nodes[i].w;
+        }
+    }
+
+    if (best_index == SIZE_MAX)
+        return NGL_ERROR_LIMIT_EXCEEDED;
+
+    const struct skyline_node node = {.x=nodes[best_index].x, .y=best_y, .w=w};
+    int ret = insert_node(s, best_index, &node);
+    if (ret < 0)
+        return ret;
+
+    /* Shrink or remove the nodes now covered by the new one */
+    struct skyline_node *cur = ngli_darray_data(&s->nodes);
+    size_t i = best_index + 1;
+    while (i < ngli_darray_count(&s->nodes)) {
+        const int32_t shrink = node.x + node.w - cur[i].x;
+        if (shrink <= 0)
+            break;
+        if (shrink < cur[i].w) {
+            cur[i].x += shrink;
+            cur[i].w -= shrink;
+            break;
+        }
+        ngli_darray_remove(&s->nodes, i);
+    }
+
+    /* Merge the neighbours sharing the same height */
+    i = 0;
+    while (i + 1 < ngli_darray_count(&s->nodes)) {
+        if (cur[i].y == cur[i + 1].y) {
+            cur[i].w += cur[i + 1].w;
+            ngli_darray_remove(&s->nodes, i + 1);
+        } else {
+            i++;
+        }
+    }
+
+    *x = node.x;
+    *y = node.y - h;
+    return 0;
+}
+
+void ngli_skyline_reset(struct skyline *s)
+{
+    ngli_darray_reset(&s->nodes);
+    memset(s, 0, sizeof(*s));
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef SKYLINE_H
+#define SKYLINE_H
+
+#include <stdint.h>
+
+#include "darray.h"
+
+/*
+ * Bottom-left skyline rectangle packer: the free space of the area is tracked
+ * as the list of the top edges of the already placed rectangles. Placed
+ * rectangles never move, and growing the area keeps them all valid.
+ */
+struct skyline {
+    int32_t width, height;
+    struct darray nodes; // struct skyline_node, sorted by x
+};
+
+void ngli_skyline_init(struct skyline *s);
+int ngli_skyline_resize(struct skyline *s, int32_t width, int32_t height);
+int ngli_skyline_pack(struct skyline *s, int32_t w, int32_t h, int32_t *x, int32_t *y);
+int32_t ngli_skyline_get_used_height(const struct skyline *s);
+void ngli_skyline_reset(struct skyline *s);
+
+#endif
@@ -97,6 +97,17 @@ static int compare_matrices(const float *a, const float *b)
     return fail ? -fail : 0;
 }
 
+static void mul_matrices(float *dst, const float *a, const float *b)
+{
+    for (size_t c = 0; c < 4; c++) {
+        for (size_t r = 0; r < 4; r++) {
+            dst[c * 4 + r] = 0.f;
+            for (size_t k = 0; k < 4; k++)
+                dst[c * 4 + r] += a[k * 4 + r] * b[c * 4 + k];
+        }
+    }
+}
+
 int main(void)
 {
     int fail = 0;
@@ -114,6 +125,23 @@ int main(void)
                 printf(">>>> DIFF IS TOO HIGH <<<<\n\n");
                 fail++;
             }
+
+            /* RGB -> YCbCr -> RGB must be an identity */
+            float rgb2yuv[4 * 4], roundtrip[4 * 4];
+            if (ngli_colorconv_get_rgb_to_ycbcr_color_matrix(rgb2yuv, &cinfo, 1.f) < 0)
+                return 1;
+            mul_matrices(roundtrip, mat, rgb2yuv);
+            static const float identity[4 * 4] = {
+                1.f, 0.f, 0.f, 0.f,
+                0.f, 1.f, 0.f, 0.f,
+                0.f, 0.f, 1.f, 0.f,
+                0.f, 0.f, 0.f, 1.f,
+            };
+            printf("%s %s roundtrip:\n" NGLI_FMT_MAT4 "\n\n", spaces[s].name, ranges[r].name, NGLI_ARG_MAT4(roundtrip));
+            if (compare_matrices(roundtrip, identity) < 0) {
+                printf(">>>> DIFF IS TOO HIGH <<<<\n\n");
+                fail++;
+            }
         }
     }
     return fail;
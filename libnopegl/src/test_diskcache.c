@@ -0,0 +1,105 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "diskcache.h"
+#include "memory.h"
+#include "nopegl.h"
+#include "utils.h"
+
+static struct diskcache *open_cache(const char *dir, const char *identity)
+{
+    struct diskcache *s = ngli_diskcache_create();
+    ngli_assert(s);
+    ngli_assert(ngli_diskcache_init(s, dir, identity) == 0);
+    return s;
+}
+
+static void check_entry(struct diskcache *s, const char *key, const char *expected)
+{
+    void *data = NULL;
+    size_t size = 0;
+    int ret = ngli_diskcache_load(s, "test", key, strlen(key), &data, &size);
+    if (!expected) {
+        ngli_assert(ret == NGL_ERROR_NOT_FOUND || ret == NGL_ERROR_INVALID_DATA);
+        return;
+    }
+    ngli_assert(ret == 0);
+    ngli_assert(size == strlen(expected));
+    ngli_assert(!memcmp(data, expected, size));
+    ngli_free(data);
+}
+
+static void corrupt_entry(const char *dir, const char *identity, const char *key)
+{
+    char *path = ngli_asprintf("%s/test-%08x%08x.bin", dir, ngli_crc32(identity),
+                               ngli_crc32_mem((const uint8_t *)key, strlen(key)));
+    ngli_assert(path);
+    FILE *fp = fopen(path, "r+b");
+    ngli_assert(fp);
+    ngli_assert(fseek(fp, -1, SEEK_END) == 0);
+    ngli_assert(fputc('#', fp) != EOF);
+    fclose(fp);
+    ngli_free(path);
+}
+
+int main(int ac, char **av)
+{
+    if (ac != 2) {
+        fprintf(stderr, "Usage: %s <cache_dir>\n", av[0]);
+        return -1;
+    }
+
+    const char *dir = av[1];
+    static const char identity[] = "driver A";
+
+    struct diskcache *s = open_cache(dir, identity);
+    ngli_assert(ngli_diskcache_store(s, "test", "foo", 3, "hello", 5) == 0);
+    ngli_assert(ngli_diskcache_store(s, "test", "bar", 3, "world", 5) == 0);
+    ngli_assert(ngli_diskcache_store(s, "test", "bar", 3, "lorem ipsum", 11) == 0);
+    check_entry(s, "foo", "hello");
+    check_entry(s, "bar", "lorem ipsum");
+    check_entry(s, "baz", NULL);
+    ngli_diskcache_freep(&s);
+    ngli_assert(!s);
+
+    /* Entries persist across instances bound to the same identity */
+    s = open_cache(dir, identity);
+    check_entry(s, "foo", "hello");
+    ngli_diskcache_freep(&s);
+
+    /* Entries from another driver are never returned */
+    s = open_cache(dir, "driver B");
+    check_entry(s, "foo", NULL);
+    ngli_diskcache_freep(&s);
+
+    /* Corrupted entries are rejected */
+    corrupt_entry(dir, identity, "foo");
+    s = open_cache(dir, identity);
+    check_entry(s, "foo", NULL);
+    check_entry(s, "bar", "lorem ipsum");
+    ngli_diskcache_freep(&s);
+
+    return 0;
+}
@@ -29,10 +29,10 @@
 #define NB_REFS (16 + 2)
 #define MAX_ERR 1e-5
 
-static int check_value(struct path *path, float t, const float *ref)
+static int check_value(const struct path *path, int *arc_hint, float t, const float *ref)
 {
     float value[3];
-    ngli_path_evaluate(path, value, t);
+    ngli_path_evaluate(path, value, t, arc_hint);
     if (!ref) {
         fprintf(stderr, "got:("NGLI_FMT_VEC3")\n", NGLI_ARG_VEC3(value));
         return 1;
@@ -55,11 +55,12 @@ static int evaluate_points(struct path *path, const float *refs, const char *tit
     printf("test: %s\n", title);
 
     int ret = 0;
+    int arc_hint = 0;
     for (int i = 0; i < NB_REFS; i++) {
         /* We make sure t starts before 0 and ends after 1 to check for
          * outbounds */
         const float t = (float)(i - 1) / ((NB_REFS - 2) - 1.f);
-        ret |= check_value(path, t, refs ? &refs[i * 3] : NULL);
+        ret |= check_value(path, &arc_hint, t, refs ? &refs[i * 3] : NULL);
     }
 
     if (ret) {
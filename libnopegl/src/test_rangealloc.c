@@ -0,0 +1,205 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "nopegl.h"
+#include "rangealloc.h"
+#include "utils.h"
+
+#define NB_ALLOCS 256
+#define NB_ITERATIONS 20000
+
+struct alloc {
+    uint64_t offset;
+    uint64_t size;
+};
+
+static int check_free_ranges(const struct rangealloc *s, const struct rangealloc_range *expected, size_t nb_expected)
+{
+    const struct rangealloc_range *ranges = ngli_darray_data(&s->free_ranges);
+    const size_t nb_ranges = ngli_darray_count(&s->free_ranges);
+    int ret = nb_ranges == nb_expected ? 0 : -1;
+    for (size_t i = 0; ret == 0 && i < nb_ranges; i++)
+        if (ranges[i].offset != expected[i].offset || ranges[i].size != expected[i].size)
+            ret = -1;
+    if (ret < 0) {
+        fprintf(stderr, "unexpected free ranges:");
+        for (size_t i = 0; i < nb_ranges; i++)
+            fprintf(stderr, " [%" PRIu64 ",+%" PRIu64 "]", ranges[i].offset, ranges[i].size);
+        fprintf(stderr, "\n");
+    }
+    return ret;
+}
+
+#define CHECK_FREE_RANGES(s, ...) do {                                                  \
+    const struct rangealloc_range expected[] = {__VA_ARGS__};                           \
+    if (check_free_ranges(s, expected, NGLI_ARRAY_NB(expected)) < 0)                   \
+        return -1;                                                                      \
+} while (0)
+
+static int test_coalescing(void)
+{
+    struct rangealloc s;
+    ngli_assert(ngli_rangealloc_init(&s, 1024) == 0);
+
+    uint64_t offsets[4];
+    for (size_t i = 0; i < NGLI_ARRAY_NB(offsets); i++) {
+        ngli_assert(ngli_rangealloc_alloc(&s, 256, 1, &offsets[i]) == 0);
+        ngli_assert(offsets[i] == i * 256);
+    }
+    ngli_assert(ngli_darray_count(&s.free_ranges) == 0);
+
+    uint64_t offset;
+    ngli_assert(ngli_rangealloc_alloc(&s, 1, 1, &offset) == NGL_ERROR_MEMORY);
+
+    /* No free neighbour */
+    ngli_assert(ngli_rangealloc_free(&s, offsets[1], 256) == 0);
+    CHECK_FREE_RANGES(&s, {256, 256});
+
+    /* No free neighbour, inserted after the existing range */
+    ngli_assert(ngli_rangealloc_free(&s, offsets[3], 256) == 0);
+    CHECK_FREE_RANGES(&s, {256, 256}, {768, 256});
+
+    /* Merged with both neighbours */
+    ngli_assert(ngli_rangealloc_free(&s, offsets[2], 256) == 0);
+    CHECK_FREE_RANGES(&s, {256, 768});
+
+    /* Merged with the next range */
+    ngli_assert(ngli_rangealloc_free(&s, offsets[0], 256) == 0);
+    CHECK_FREE_RANGES(&s, {0, 1024});
+    ngli_assert(s.nb_allocations == 0);
+
+    /* Merged with the previous range */
+    ngli_assert(ngli_rangealloc_alloc(&s, 512, 1, &offsets[0]) == 0);
+    ngli_assert(ngli_rangealloc_alloc(&s, 512, 1, &offsets[1]) == 0);
+    ngli_assert(ngli_rangealloc_free(&s, offsets[0], 512) == 0);
+    ngli_assert(ngli_rangealloc_free(&s, offsets[1], 512) == 0);
+    CHECK_FREE_RANGES(&s, {0, 1024});
+
+    ngli_rangealloc_reset(&s);
+    return 0;
+}
+
+static int test_alignment(void)
+{
+    struct rangealloc s;
+    ngli_assert(ngli_rangealloc_init(&s, 1024) == 0);
+
+    /* The alignment padding stays available for smaller allocations */
+    uint64_t offsets[3];
+    ngli_assert(ngli_rangealloc_alloc(&s, 10, 1, &offsets[0]) == 0);
+    ngli_assert(ngli_rangealloc_alloc(&s, 16, 64, &offsets[1]) == 0);
+    ngli_assert(offsets[1] == 64);
+    CHECK_FREE_RANGES(&s, {10, 54}, {80, 944});
+
+    ngli_assert(ngli_rangealloc_alloc(&s, 54, 2, &offsets[2]) == 0);
+    ngli_assert(offsets[2] == 10);
+    CHECK_FREE_RANGES(&s, {80, 944});
+
+    ngli_assert(ngli_rangealloc_free(&s, offsets[1], 16) == 0);
+    CHECK_FREE_RANGES(&s, {64, 960});
+    ngli_assert(ngli_rangealloc_free(&s, offsets[0], 10) == 0);
+    CHECK_FREE_RANGES(&s, {0, 10}, {64, 960});
+    ngli_assert(ngli_rangealloc_free(&s, offsets[2], 54) == 0);
+    CHECK_FREE_RANGES(&s, {0, 1024});
+
+    ngli_rangealloc_reset(&s);
+    return 0;
+}
+
+static int check_allocs(const struct alloc *allocs, size_t nb_allocs, uint64_t size)
+{
+    for (size_t i = 0; i < nb_allocs; i++) {
+        const struct alloc *a = &allocs[i];
+        if (!a->size)
+            continue;
+        if (a->offset + a->size > size) {
+            fprintf(stderr, "range %zu is out of the area\n", i);
+            return -1;
+        }
+        for (size_t j = 0; j < i; j++) {
+            const struct alloc *b = &allocs[j];
+            if (b->size && a->offset < b->offset + b->size && b->offset < a->offset + a->size) {
+                fprintf(stderr, "range %zu overlaps range %zu\n", i, j);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int test_random(void)
+{
+    const uint64_t size = 1 << 20;
+    struct rangealloc s;
+    ngli_assert(ngli_rangealloc_init(&s, size) == 0);
+
+    struct alloc *allocs = calloc(NB_ALLOCS, sizeof(*allocs));
+    ngli_assert(allocs);
+
+    srand(0);
+    int ret = 0;
+    for (int i = 0; ret == 0 && i < NB_ITERATIONS; i++) {
+        struct alloc *a = &allocs[rand() % NB_ALLOCS];
+        if (a->size) {
+            ngli_assert(ngli_rangealloc_free(&s, a->offset, a->size) == 0);
+            a->size = 0;
+            continue;
+        }
+        const uint64_t alloc_size = 1 + rand() % 8192;
+        const uint64_t alignment = 1ULL << (rand() % 9);
+        if (ngli_rangealloc_alloc(&s, alloc_size, alignment, &a->offset) < 0)
+            continue;
+        a->size = alloc_size;
+        if (a->offset % alignment) {
+            fprintf(stderr, "range at %" PRIu64 " is not aligned to %" PRIu64 "\n", a->offset, alignment);
+            ret = -1;
+        }
+        if (i % 100 == 0 && ret == 0)
+            ret = check_allocs(allocs, NB_ALLOCS, size);
+    }
+    if (ret == 0)
+        ret = check_allocs(allocs, NB_ALLOCS, size);
+
+    /* Once everything is released, the free ranges must be coalesced back into the whole area */
+    for (int i = 0; i < NB_ALLOCS; i++)
+        if (allocs[i].size)
+            ngli_assert(ngli_rangealloc_free(&s, allocs[i].offset, allocs[i].size) == 0);
+    ngli_assert(s.nb_allocations == 0);
+    if (ret == 0)
+        ret = check_free_ranges(&s, &(const struct rangealloc_range){0, size}, 1);
+
+    free(allocs);
+    ngli_rangealloc_reset(&s);
+    return ret;
+}
+
+int main(void)
+{
+    if (test_coalescing() < 0 ||
+        test_alignment() < 0 ||
+        test_random() < 0)
+        return 1;
+    return 0;
+}
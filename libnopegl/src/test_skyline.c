@@ -0,0 +1,126 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "nopegl.h"
+#include "skyline.h"
+#include "utils.h"
+
+#define NB_RECTS 500
+
+struct rect {
+    int32_t x, y, w, h;
+};
+
+static int check_rects(const struct rect *rects, int nb_rects, int32_t width, int32_t height)
+{
+    for (int i = 0; i < nb_rects; i++) {
+        const struct rect *a = &rects[i];
+        if (a->x < 0 || a->y < 0 || a->x + a->w > width || a->y + a->h > height) {
+            fprintf(stderr, "rect %d (%d,%d %dx%d) is out of the %dx%d area\n",
+                    i, a->x, a->y, a->w, a->h, width, height);
+            return -1;
+        }
+        for (int j = 0; j < i; j++) {
+            const struct rect *b = &rects[j];
+            if (a->x < b->x + b->w && b->x < a->x + a->w &&
+                a->y < b->y + b->h && b->y < a->y + a->h) {
+                fprintf(stderr, "rect %d (%d,%d %dx%d) overlaps rect %d (%d,%d %dx%d)\n",
+                        i, a->x, a->y, a->w, a->h, j, b->x, b->y, b->w, b->h);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int test_fixed_area(void)
+{
+    struct skyline skyline;
+    ngli_skyline_init(&skyline);
+    ngli_assert(ngli_skyline_resize(&skyline, 64, 64) == 0);
+
+    /* 16 squares fill the area exactly, the 17th one must be rejected */
+    struct rect rects[16];
+    for (int i = 0; i < 16; i++) {
+        struct rect *r = &rects[i];
+        r->w = r->h = 16;
+        ngli_assert(ngli_skyline_pack(&skyline, r->w, r->h, &r->x, &r->y) == 0);
+    }
+    int32_t x, y;
+    ngli_assert(ngli_skyline_pack(&skyline, 16, 16, &x, &y) == NGL_ERROR_LIMIT_EXCEEDED);
+    ngli_assert(ngli_skyline_get_used_height(&skyline) == 64);
+    ngli_assert(ngli_skyline_resize(&skyline, 32, 64) == NGL_ERROR_INVALID_USAGE);
+
+    const int ret = check_rects(rects, 16, 64, 64);
+    ngli_skyline_reset(&skyline);
+    return ret;
+}
+
+static int test_growing_area(void)
+{
+    struct skyline skyline;
+    ngli_skyline_init(&skyline);
+    ngli_assert(ngli_skyline_resize(&skyline, 32, 32) == 0);
+
+    struct rect *rects = calloc(NB_RECTS, sizeof(*rects));
+    ngli_assert(rects);
+
+    srand(0);
+    int64_t area = 0;
+    for (int i = 0; i < NB_RECTS; i++) {
+        struct rect *r = &rects[i];
+        r->w = 1 + rand() % 40;
+        r->h = 1 + rand() % 40;
+        area += r->w * r->h;
+
+        /* Grow the area the same way the distmap atlas does when it is full */
+        while (ngli_skyline_pack(&skyline, r->w, r->h, &r->x, &r->y) < 0) {
+            int32_t width = skyline.width, height = skyline.height;
+            if (width <= height)
+                width *= 2;
+            else
+                height *= 2;
+            ngli_assert(ngli_skyline_resize(&skyline, width, height) == 0);
+        }
+    }
+
+    int ret = check_rects(rects, NB_RECTS, skyline.width, skyline.height);
+    if (ret == 0) {
+        const int64_t total = (int64_t)skyline.width * skyline.height;
+        printf("packed %d rects in %dx%d (%d%% used)\n",
+               NB_RECTS, skyline.width, skyline.height, (int)(area * 100 / total));
+    }
+
+    free(rects);
+    ngli_skyline_reset(&skyline);
+    return ret;
+}
+
+int main(void)
+{
+    if (test_fixed_area() < 0 ||
+        test_growing_area() < 0)
+        return 1;
+    return 0;
+}
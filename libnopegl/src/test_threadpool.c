@@ -0,0 +1,98 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "nopegl.h"
+#include "pthread_compat.h"
+#include "threadpool.h"
+#include "utils.h"
+
+#define NB_JOBS 1000
+
+struct job_data {
+    int id;
+    int result;
+};
+
+static int square_job(void *arg)
+{
+    struct job_data *data = arg;
+    data->result = data->id * data->id;
+    return 0;
+}
+
+static int failing_job(void *arg)
+{
+    struct job_data *data = arg;
+    data->result = -1;
+    return data->id % 100 == 42 ? NGL_ERROR_INVALID_DATA : 0;
+}
+
+static void run_jobs(struct threadpool *pool, int (*func)(void *arg), struct job_data *jobs, int expected_ret)
+{
+    for (int i = 0; i < NB_JOBS; i++) {
+        jobs[i] = (struct job_data){.id = i};
+        ngli_assert(ngli_threadpool_submit(pool, func, &jobs[i]) == 0);
+    }
+    ngli_assert(ngli_threadpool_wait(pool) == expected_ret);
+}
+
+int main(void)
+{
+    static struct job_data jobs[NB_JOBS];
+
+    static const size_t nb_threads[] = {1, 3, 0};
+    for (size_t n = 0; n < NGLI_ARRAY_NB(nb_threads); n++) {
+        struct threadpool *pool = ngli_threadpool_create();
+        ngli_assert(pool);
+        ngli_assert(ngli_threadpool_init(pool, nb_threads[n]) == 0);
+        ngli_assert(ngli_threadpool_get_nb_threads(pool) >= 1);
+
+        /* Nothing submitted */
+        ngli_assert(ngli_threadpool_wait(pool) == 0);
+
+        run_jobs(pool, square_job, jobs, 0);
+        for (int i = 0; i < NB_JOBS; i++)
+            ngli_assert(jobs[i].result == i * i);
+
+        /* The error is reported once, and every job is still executed */
+        run_jobs(pool, failing_job, jobs, NGL_ERROR_INVALID_DATA);
+        for (int i = 0; i < NB_JOBS; i++)
+            ngli_assert(jobs[i].result == -1);
+        ngli_assert(ngli_threadpool_wait(pool) == 0);
+
+        /* Pending jobs are completed before the pool is destroyed */
+        for (int i = 0; i < NB_JOBS; i++) {
+            jobs[i] = (struct job_data){.id = i};
+            ngli_assert(ngli_threadpool_submit(pool, square_job, &jobs[i]) == 0);
+        }
+        ngli_threadpool_freep(&pool);
+        ngli_assert(!pool);
+        for (int i = 0; i < NB_JOBS; i++)
+            ngli_assert(jobs[i].result == i * i);
+
+        printf("%zu thread(s): OK\n", nb_threads[n]);
+    }
+
+    return 0;
+}
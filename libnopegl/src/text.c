@@ -537,6 +537,11 @@ end:
     return ret;
 }
 
+int ngli_text_atlas_outdated(const struct text *s)
+{
+    return s->cls->atlas_outdated ? s->cls->atlas_outdated(s) : 0;
+}
+
 int ngli_text_set_time(struct text *s, double t)
 {
     if (!ngli_darray_count(&s->chars))
@@ -96,6 +96,7 @@ struct text_cls {
     int (*init)(struct text *text);
     int (*set_string)(struct text *text, const char *str, struct darray *chars_dst);
     void (*reset)(struct text *text);
+    int (*atlas_outdated)(const struct text *text); // whether the atlas has been replaced since the last set_string()
     size_t priv_size;
     uint32_t flags; // combination of NGLI_TEXT_FLAG_*
 };
@@ -146,8 +147,17 @@ void ngli_text_update_effects_defaults(struct text *s, const struct text_effects
 
 int ngli_text_set_string(struct text *s, const char *str);
 
+/*
+ * Whether the atlas shared with other texts has been replaced, in which case
+ * the string must be set again to refresh the atlas texture and coordinates
+ */
+int ngli_text_atlas_outdated(const struct text *s);
+
 int ngli_text_set_time(struct text *s, double t);
 
 void ngli_text_freep(struct text **sp);
 
+struct text_external_cache;
+void ngli_text_external_cache_freep(struct text_external_cache **sp);
+
 #endif
@@ -29,38 +29,210 @@
 #include <fribidi.h>
 #endif
 
+#include "bstr.h"
 #include "darray.h"
 #include "distmap.h"
 #include "hmap.h"
+#include "internal.h"
 #include "log.h"
 #include "memory.h"
 #include "nopegl.h"
 #include "path.h"
 #include "text.h"
+#include "texture.h"
 #include "utils.h"
 
 #if HAVE_TEXT_LIBRARIES
-struct text_external {
+/* Maximum number of shaped strings kept around, the least recently used are dropped first */
+#define SHAPING_CACHE_SIZE 64
+
+enum run_type {
+    RUN_TYPE_WORD,
+    RUN_TYPE_WORDSEP,
+    RUN_TYPE_LINEBREAK,
+};
+
+struct text_run {
+    enum run_type type;
+    size_t face_id;
+    hb_buffer_t *buffer;
+    const hb_glyph_info_t *glyph_infos;
+    const hb_glyph_position_t *glyph_positions;
+};
+
+struct text_face {
+    uint32_t id;
+    FT_Face ft_face;
+    hb_font_t *hb_font;
+};
+
+struct glyph {
+    int32_t shape_id; // index in the distmap texture, -1 if the glyph has no visible outline
+    int32_t width, height; // in 26.6
+    int32_t bearing_x, bearing_y; // in 26.6
+};
+
+struct shaped_text {
+    struct darray runs; // struct text_run, each holding a reference on its HarfBuzz buffer
+    uint64_t last_use;
+};
+
+/*
+ * Font faces, glyphs and distance field atlas shared by all the Text nodes of
+ * a context using external fonts
+ */
+struct text_external_cache {
     FT_Library ft_library;
-    struct darray ft_faces; // FT_Face (hidden pointer)
-    struct darray hb_fonts; // hb_font_t*
+    struct hmap *faces;  // struct text_face, indexed by size, resolution and font file
+    struct hmap *glyphs; // struct glyph, indexed by GLYPH_UID_STRING()
+    uint32_t nb_faces;
+    size_t nb_pending_glyphs; // glyphs not yet rendered in the atlas
     struct distmap *distmap;
+    struct hmap *shaped_texts; // struct shaped_text, indexed by get_shaping_key()
+    uint64_t shaping_clock;
 };
 
-static int load_font(struct text *text, const char *font_file)
+struct text_external {
+    struct text_external_cache *cache;
+    struct darray ft_faces; // FT_Face (hidden pointer), owned by the cache
+    struct darray hb_fonts; // hb_font_t*, owned by the cache
+    struct darray face_ids; // uint32_t
+    struct texture *atlas_texture; // reference on the atlas texture the chars were laid out against
+};
+
+static void free_face(void *user_arg, void *data)
+{
+    struct text_face *face = data;
+    hb_font_destroy(face->hb_font);
+    FT_Done_Face(face->ft_face);
+    ngli_free(face);
+}
+
+static void free_glyph(void *user_arg, void *data)
+{
+    struct glyph *glyph = data;
+    ngli_freep(&glyph);
+}
+
+static void reset_runs(struct darray *runs_array)
+{
+    struct text_run *runs = ngli_darray_data(runs_array);
+    for (size_t i = 0; i < ngli_darray_count(runs_array); i++)
+        hb_buffer_destroy(runs[i].buffer);
+    ngli_darray_reset(runs_array);
+}
+
+static void free_shaped_text(void *user_arg, void *data)
+{
+    struct shaped_text *shaped_text = data;
+    reset_runs(&shaped_text->runs);
+    ngli_free(shaped_text);
+}
+
+static struct glyph *create_glyph(void)
+{
+    struct glyph *glyph = ngli_calloc(1, sizeof(*glyph));
+    return glyph;
+}
+
+/*
+ * Drop all the glyphs and start over with an empty atlas. The Text nodes laid
+ * out against the previous atlas keep a reference on its texture until they
+ * notice the change and register their glyphs again.
+ */
+static int reset_glyphs(struct ngl_ctx *ctx, struct text_external_cache *cache)
+{
+    ngli_distmap_freep(&cache->distmap);
+    ngli_hmap_freep(&cache->glyphs);
+    cache->nb_pending_glyphs = 0;
+
+    int ret;
+    cache->glyphs = ngli_hmap_create();
+    cache->distmap = ngli_distmap_create(ctx);
+    if (!cache->glyphs || !cache->distmap) {
+        ret = NGL_ERROR_MEMORY;
+        goto fail;
+    }
+    ngli_hmap_set_free_func(cache->glyphs, free_glyph, NULL);
+
+    ret = ngli_distmap_init(cache->distmap);
+    if (ret < 0)
+        goto fail;
+
+    return 0;
+
+fail:
+    ngli_distmap_freep(&cache->distmap);
+    ngli_hmap_freep(&cache->glyphs);
+    return ret;
+}
+
+static int get_cache(struct ngl_ctx *ctx, struct text_external_cache **cachep)
+{
+    if (ctx->text_external_cache) {
+        *cachep = ctx->text_external_cache;
+        return 0;
+    }
+
+    struct text_external_cache *cache = ngli_calloc(1, sizeof(*cache));
+    if (!cache)
+        return NGL_ERROR_MEMORY;
+    ctx->text_external_cache = cache;
+
+    FT_Error ft_error = FT_Init_FreeType(&cache->ft_library);
+    if (ft_error) {
+        LOG(ERROR, "unable to initialize FreeType");
+        ngli_text_external_cache_freep(&ctx->text_external_cache);
+        return NGL_ERROR_EXTERNAL;
+    }
+
+    cache->faces = ngli_hmap_create();
+    cache->shaped_texts = ngli_hmap_create();
+    if (!cache->faces || !cache->shaped_texts) {
+        ngli_text_external_cache_freep(&ctx->text_external_cache);
+        return NGL_ERROR_MEMORY;
+    }
+    ngli_hmap_set_free_func(cache->faces, free_face, NULL);
+    ngli_hmap_set_free_func(cache->shaped_texts, free_shaped_text, NULL);
+
+    int ret = reset_glyphs(ctx, cache);
+    if (ret < 0) {
+        ngli_text_external_cache_freep(&ctx->text_external_cache);
+        return ret;
+    }
+
+    *cachep = cache;
+    return 0;
+}
+
+void ngli_text_external_cache_freep(struct text_external_cache **sp)
+{
+    struct text_external_cache *s = *sp;
+    if (!s)
+        return;
+
+    ngli_distmap_freep(&s->distmap);
+    ngli_hmap_freep(&s->shaped_texts);
+    ngli_hmap_freep(&s->glyphs);
+    ngli_hmap_freep(&s->faces);
+    if (s->ft_library)
+        FT_Done_FreeType(s->ft_library);
+    ngli_freep(sp);
+}
+
+static int create_face(struct text *text, const char *font_file, struct text_face **facep)
 {
     struct text_external *s = text->priv_data;
+    struct text_external_cache *cache = s->cache;
 
     /* This limitation simplifies the UID computation in GLYPH_UID_STRING() */
-    if (ngli_darray_count(&s->ft_faces) == 0xff) {
-        LOG(ERROR, "maximum number of fonts reached (256)");
+    if (cache->nb_faces == 0xffff) {
+        LOG(ERROR, "maximum number of fonts reached (65535)");
         return NGL_ERROR_LIMIT_EXCEEDED;
     }
 
     FT_Face ft_face = NULL;
-    hb_font_t *hb_font = NULL;
-
-    FT_Error ft_error = FT_New_Face(s->ft_library, font_file, 0, &ft_face);
+    FT_Error ft_error = FT_New_Face(cache->ft_library, font_file, 0, &ft_face);
     if (ft_error) {
         LOG(ERROR, "unable to initialize FreeType with font %s", font_file);
         return NGL_ERROR_EXTERNAL;
@@ -68,12 +240,8 @@ static int load_font(struct text *text, const char *font_file)
 
     if (!FT_IS_SCALABLE(ft_face)) {
         LOG(ERROR, "only scalable faces are supported");
-        return NGL_ERROR_UNSUPPORTED;
-    }
-
-    if (!ngli_darray_push(&s->ft_faces, &ft_face)) {
         FT_Done_Face(ft_face);
-        return NGL_ERROR_MEMORY;
+        return NGL_ERROR_UNSUPPORTED;
     }
 
     const int32_t pt_size = text->config.pt_size;
@@ -83,6 +251,7 @@ static int load_font(struct text *text, const char *font_file)
     ft_error = FT_Set_Char_Size(ft_face, chr_w, chr_h, res, res);
     if (ft_error) {
         LOG(ERROR, "unable to set char size to %d points in %u DPI", pt_size, res);
+        FT_Done_Face(ft_face);
         return NGL_ERROR_EXTERNAL;
     }
 
@@ -102,28 +271,60 @@ static int load_font(struct text *text, const char *font_file)
     LOG(DEBUG, "* underline_[position:%d thickness:%d]",
         ft_face->underline_position, ft_face->underline_thickness);
 
-    hb_font = hb_ft_font_create(ft_face, NULL);
-    if (!hb_font)
+    hb_font_t *hb_font = hb_ft_font_create(ft_face, NULL);
+    if (!hb_font) {
+        FT_Done_Face(ft_face);
         return NGL_ERROR_MEMORY;
+    }
 
-    if (!ngli_darray_push(&s->hb_fonts, &hb_font)) {
+    struct text_face *face = ngli_calloc(1, sizeof(*face));
+    if (!face) {
         hb_font_destroy(hb_font);
+        FT_Done_Face(ft_face);
         return NGL_ERROR_MEMORY;
     }
+    face->id = cache->nb_faces++;
+    face->ft_face = ft_face;
+    face->hb_font = hb_font;
 
+    *facep = face;
     return 0;
 }
 
-static void free_ft_face(void *user_arg, void *data)
+static int load_font(struct text *text, const char *font_file)
 {
-    FT_Face *face = data;
-    FT_Done_Face(*face);
-}
+    struct text_external *s = text->priv_data;
+    struct text_external_cache *cache = s->cache;
 
-static void free_hb_font(void *user_arg, void *data)
-{
-    struct hb_font_t **fontp = data;
-    hb_font_destroy(*fontp);
+    /* The face size is set once for all, so it is part of the face identifier */
+    char *face_uid = ngli_asprintf("%d:%d:%s", text->config.pt_size, text->config.dpi, font_file);
+    if (!face_uid)
+        return NGL_ERROR_MEMORY;
+
+    int ret = 0;
+    struct text_face *face = ngli_hmap_get(cache->faces, face_uid);
+    if (!face) {
+        ret = create_face(text, font_file, &face);
+        if (ret < 0)
+            goto end;
+
+        ret = ngli_hmap_set(cache->faces, face_uid, face);
+        if (ret < 0) {
+            free_face(NULL, face);
+            goto end;
+        }
+    }
+
+    if (!ngli_darray_push(&s->ft_faces, &face->ft_face) ||
+        !ngli_darray_push(&s->hb_fonts, &face->hb_font) ||
+        !ngli_darray_push(&s->face_ids, &face->id)) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+end:
+    ngli_free(face_uid);
+    return ret;
 }
 
 static int text_external_init(struct text *text)
@@ -133,15 +334,11 @@ static int text_external_init(struct text *text)
 
     ngli_darray_init(&s->ft_faces, sizeof(FT_Face), 0);
     ngli_darray_init(&s->hb_fonts, sizeof(hb_font_t *), 0);
+    ngli_darray_init(&s->face_ids, sizeof(uint32_t), 0);
 
-    ngli_darray_set_free_func(&s->ft_faces, free_ft_face, NULL);
-    ngli_darray_set_free_func(&s->hb_fonts, free_hb_font, NULL);
-
-    FT_Error ft_error = FT_Init_FreeType(&s->ft_library);
-    if (ft_error) {
-        LOG(ERROR, "unable to initialize FreeType");
-        return NGL_ERROR_EXTERNAL;
-    }
+    ret = get_cache(text->ctx, &s->cache);
+    if (ret < 0)
+        return ret;
 
     /* Duplicate the font files specifications so that we can inject '\0' into it */
     char *font_files = ngli_strdup(text->config.font_files);
@@ -167,30 +364,14 @@ end:
     return ret;
 }
 
-struct glyph {
-    int32_t shape_id; // index in the distmap texture
-    int32_t width, height; // in 26.6
-    int32_t bearing_x, bearing_y; // in 26.6
-};
-
-static void free_glyph(void *user_arg, void *data)
-{
-    struct glyph *glyph = data;
-    ngli_freep(&glyph);
-}
-
-static struct glyph *create_glyph(void)
-{
-    struct glyph *glyph = ngli_calloc(1, sizeof(*glyph));
-    return glyph;
-}
-
 static const char *hex = "0123456789abcdef";
 
 /* Compute a unique glyph identifier string using the face and glyph IDs */
 #define GLYPH_UID_STRING(fid, gid) {  \
-    hex[(fid) >> 4U & 0xf],     \
-    hex[(fid)       & 0xf],     \
+    hex[(fid) >> 12U & 0xf],    \
+    hex[(fid) >>  8U & 0xf],    \
+    hex[(fid) >>  4U & 0xf],    \
+    hex[(fid)        & 0xf],    \
     '-',                        \
     hex[(gid) >> 28U & 0xf],    \
     hex[(gid) >> 24U & 0xf],    \
@@ -203,20 +384,6 @@ static const char *hex = "0123456789abcdef";
     '\0'                        \
 }
 
-enum run_type {
-    RUN_TYPE_WORD,
-    RUN_TYPE_WORDSEP,
-    RUN_TYPE_LINEBREAK,
-};
-
-struct text_run {
-    enum run_type type;
-    size_t face_id;
-    hb_buffer_t *buffer;
-    const hb_glyph_info_t *glyph_infos;
-    const hb_glyph_position_t *glyph_positions;
-};
-
 struct outline_ctx {
     struct path *path;
     FT_BBox cbox; // current glyph control box
@@ -279,22 +446,20 @@ static const FT_Outline_Funcs outline_funcs = {
     .cubic_to = cubic_to_cb,
 };
 
-static int build_glyph_index(struct text *text, struct hmap *glyph_index, const struct darray *runs_array)
+/* Register in the cache the glyphs of the runs which have never been seen before */
+static int register_glyphs(struct text *text, const struct darray *runs_array)
 {
-    int ret = 0;
     struct text_external *s = text->priv_data;
+    struct text_external_cache *cache = s->cache;
 
-    struct path *path = ngli_path_create();
-    if (!path)
-        return NGL_ERROR_MEMORY;
-
+    const FT_Face *ft_faces = ngli_darray_data(&s->ft_faces);
+    const uint32_t *face_ids = ngli_darray_data(&s->face_ids);
     const struct text_run *runs = ngli_darray_data(runs_array);
     for (size_t i = 0; i < ngli_darray_count(runs_array); i++) {
         const struct text_run *run = &runs[i];
         if (run->face_id == SIZE_MAX)
             continue;
 
-        const FT_Face *ft_faces = ngli_darray_data(&s->ft_faces);
         const FT_Face ft_face = ft_faces[run->face_id];
         const size_t nb_glyphs = hb_buffer_get_length(run->buffer);
         const hb_glyph_info_t *glyph_infos = run->glyph_infos;
@@ -306,8 +471,8 @@ static int build_glyph_index(struct text *text, struct hmap *glyph_index, const
              * the glyphs (see ttf-hanazono 20170904 for an example of this).
              */
             const hb_codepoint_t glyph_id = glyph_infos[j].codepoint;
-            const char glyph_uid[] = GLYPH_UID_STRING(run->face_id, glyph_id);
-            if (ngli_hmap_get(glyph_index, glyph_uid))
+            const char glyph_uid[] = GLYPH_UID_STRING(face_ids[run->face_id], glyph_id);
+            if (ngli_hmap_get(cache->glyphs, glyph_uid))
                 continue;
 
             /*
@@ -323,70 +488,80 @@ static int build_glyph_index(struct text *text, struct hmap *glyph_index, const
                  * character code).
                  */
                 LOG(ERROR, "unable to load glyph id %u", glyph_id);
-                ret = NGL_ERROR_EXTERNAL;
-                goto end;
+                return NGL_ERROR_EXTERNAL;
             }
 
             const FT_GlyphSlot slot = ft_face->glyph;
 
-            ngli_path_clear(path);
+            struct glyph *glyph = create_glyph();
+            if (!glyph)
+                return NGL_ERROR_MEMORY;
+            glyph->shape_id = -1;
 
             FT_BBox cbox;
             FT_Outline_Get_CBox(&slot->outline, &cbox);
 
-            const struct outline_ctx ft_ctx = {.path=path,.cbox=cbox};
-            FT_Outline_Decompose(&slot->outline, &outline_funcs, (void *)&ft_ctx);
-
-            ret = ngli_path_finalize(path);
-            if (ret < 0)
-                goto end;
-
             const int32_t shape_w_26d6 = (int32_t)(cbox.xMax - cbox.xMin);
             const int32_t shape_h_26d6 = (int32_t)(cbox.yMax - cbox.yMin);
             const int32_t shape_w = NGLI_I26D6_TO_I32_TRUNCATED(shape_w_26d6);
             const int32_t shape_h = NGLI_I26D6_TO_I32_TRUNCATED(shape_h_26d6);
 
             // An empty space glyph doesn't need to be rasterized
-            if (shape_w <= 0 || shape_h <= 0)
-                continue;
+            if (shape_w > 0 && shape_h > 0) {
+                struct path *path = ngli_path_create();
+                if (!path) {
+                    free_glyph(NULL, glyph);
+                    return NGL_ERROR_MEMORY;
+                }
 
-            int32_t shape_id;
-            int ret = ngli_distmap_add_shape(s->distmap, shape_w, shape_h, path, NGLI_DISTMAP_FLAG_PATH_AUTO_CLOSE, &shape_id);
-            if (ret < 0)
-                goto end;
+                const struct outline_ctx ft_ctx = {.path=path, .cbox=cbox};
+                FT_Outline_Decompose(&slot->outline, &outline_funcs, (void *)&ft_ctx);
+
+                int ret = ngli_path_finalize(path);
+                if (ret >= 0)
+                    ret = ngli_distmap_add_shape(cache->distmap, shape_w, shape_h, path,
+                                                 NGLI_DISTMAP_FLAG_PATH_AUTO_CLOSE, &glyph->shape_id);
+                ngli_path_freep(&path);
+                if (ret < 0) {
+                    free_glyph(NULL, glyph);
+                    return ret;
+                }
 
-            /* Save the rasterized glyph in the index */
-            struct glyph *glyph = create_glyph();
-            if (!glyph) {
-                ret = NGL_ERROR_MEMORY;
-                goto end;
+                glyph->width     = shape_w_26d6;
+                glyph->height    = shape_h_26d6;
+                glyph->bearing_x = (int32_t)ft_ctx.cbox.xMin;
+                glyph->bearing_y = (int32_t)ft_ctx.cbox.yMin;
+                cache->nb_pending_glyphs++;
             }
 
-            glyph->shape_id  = shape_id;
-            glyph->width     = shape_w_26d6;
-            glyph->height    = shape_h_26d6;
-            glyph->bearing_x = (int32_t)ft_ctx.cbox.xMin;
-            glyph->bearing_y = (int32_t)ft_ctx.cbox.yMin;
-
-            ret = ngli_hmap_set(glyph_index, glyph_uid, glyph);
+            int ret = ngli_hmap_set(cache->glyphs, glyph_uid, glyph);
             if (ret < 0) {
                 free_glyph(NULL, glyph);
-                goto end;
+                return ret;
             }
         }
     }
 
-end:
-    ngli_path_freep(&path);
-    return ret;
+    return 0;
 }
 
-static void reset_runs(struct darray *runs_array)
+/*
+ * Render the glyphs registered since the last update into the shared atlas.
+ * If the atlas texture has to be reallocated, the previous one remains alive
+ * as long as some Text nodes are still referencing it.
+ */
+static int update_atlas(struct text_external_cache *cache)
 {
-    struct text_run *runs = ngli_darray_data(runs_array);
-    for (size_t i = 0; i < ngli_darray_count(runs_array); i++)
-        hb_buffer_destroy(runs[i].buffer);
-    ngli_darray_reset(runs_array);
+    if (!cache->nb_pending_glyphs)
+        return 0;
+
+    int ret = ngli_distmap_finalize(cache->distmap);
+    if (ret < 0)
+        return ret;
+
+    LOG(DEBUG, "rendered %zu new glyphs in the shared atlas", cache->nb_pending_glyphs);
+    cache->nb_pending_glyphs = 0;
+    return 0;
 }
 
 /* Make sure we can hold the whole Unicode codepoints */
@@ -697,9 +872,11 @@ end:
 #define GET_LINE_ADVANCE(face_id) ((int32_t)(ft_faces[face_id]->size->metrics.height))
 
 static int register_chars(struct text *text, const char *str, struct darray *chars_dst,
-                          const struct darray *runs_array, const struct hmap *glyph_index)
+                          const struct darray *runs_array)
 {
     struct text_external *s = text->priv_data;
+    const struct hmap *glyph_index = s->cache->glyphs;
+    const uint32_t *face_ids = ngli_darray_data(&s->face_ids);
 
     const int32_t adv_sign = text->config.writing_mode == NGLI_TEXT_WRITING_MODE_VERTICAL_LR ? 1 : -1;
 
@@ -748,16 +925,19 @@ static int register_chars(struct text *text, const char *str, struct darray *cha
             }
 
             const hb_codepoint_t glyph_id = run->glyph_infos[j].codepoint;
-            const char glyph_uid[] = GLYPH_UID_STRING(run->face_id, glyph_id);
-            const struct glyph *glyph = ngli_hmap_get(glyph_index, glyph_uid);
-            if (glyph) {
+            const struct glyph *glyph = NULL;
+            if (run->face_id != SIZE_MAX) {
+                const char glyph_uid[] = GLYPH_UID_STRING(face_ids[run->face_id], glyph_id);
+                glyph = ngli_hmap_get(glyph_index, glyph_uid);
+            }
+            if (glyph && glyph->shape_id >= 0) {
                 chr.tags |= NGLI_TEXT_CHAR_TAG_GLYPH;
                 chr.x = x_cur + glyph->bearing_x + pos->x_offset;
                 chr.y = y_cur + glyph->bearing_y + pos->y_offset;
                 chr.w = glyph->width;
                 chr.h = glyph->height;
-                ngli_distmap_get_shape_coords(s->distmap, glyph->shape_id, chr.atlas_coords);
-                ngli_distmap_get_shape_scale(s->distmap, glyph->shape_id, chr.scale);
+                ngli_distmap_get_shape_coords(s->cache->distmap, glyph->shape_id, chr.atlas_coords);
+                ngli_distmap_get_shape_scale(s->cache->distmap, glyph->shape_id, chr.scale);
             }
 
             if (!ngli_darray_push(chars_dst, &chr))
@@ -770,65 +950,194 @@ static int register_chars(struct text *text, const char *str, struct darray *cha
     return 0;
 }
 
+/*
+ * The shaping of a string only depends on its content, the fonts it is shaped
+ * with (face identifiers, which include their size and resolution), and the
+ * writing mode. No HarfBuzz feature is passed to the shaper, so they are not
+ * part of the key.
+ */
+static char *get_shaping_key(const struct text *text, const char *str)
+{
+    const struct text_external *s = text->priv_data;
+
+    struct bstr *b = ngli_bstr_create();
+    if (!b)
+        return NULL;
+
+    ngli_bstr_printf(b, "%d:", text->config.writing_mode);
+    const uint32_t *face_ids = ngli_darray_data(&s->face_ids);
+    for (size_t i = 0; i < ngli_darray_count(&s->face_ids); i++)
+        ngli_bstr_printf(b, "%x,", face_ids[i]);
+    ngli_bstr_printf(b, ":%s", str);
+
+    char *key = ngli_bstr_check(b) < 0 ? NULL : ngli_bstr_strdup(b);
+    ngli_bstr_freep(&b);
+    return key;
+}
+
+static int copy_runs(struct darray *dst, const struct darray *src)
+{
+    const struct text_run *runs = ngli_darray_data(src);
+    for (size_t i = 0; i < ngli_darray_count(src); i++) {
+        struct text_run run = runs[i];
+        run.buffer = hb_buffer_reference(run.buffer);
+        if (!ngli_darray_push(dst, &run)) {
+            hb_buffer_destroy(run.buffer);
+            return NGL_ERROR_MEMORY;
+        }
+    }
+    return 0;
+}
+
+static int store_shaped_text(struct text_external_cache *cache, const char *key, const struct darray *runs_array)
+{
+    /* Evict the least recently used entry */
+    if (ngli_hmap_count(cache->shaped_texts) >= SHAPING_CACHE_SIZE) {
+        const struct hmap_entry *oldest = NULL;
+        const struct hmap_entry *entry = NULL;
+        while ((entry = ngli_hmap_next(cache->shaped_texts, entry))) {
+            const struct shaped_text *shaped_text = entry->data;
+            if (!oldest || shaped_text->last_use < ((const struct shaped_text *)oldest->data)->last_use)
+                oldest = entry;
+        }
+        char *oldest_key = ngli_strdup(oldest->key);
+        if (!oldest_key)
+            return NGL_ERROR_MEMORY;
+        ngli_hmap_set(cache->shaped_texts, oldest_key, NULL);
+        ngli_free(oldest_key);
+    }
+
+    struct shaped_text *shaped_text = ngli_calloc(1, sizeof(*shaped_text));
+    if (!shaped_text)
+        return NGL_ERROR_MEMORY;
+    ngli_darray_init(&shaped_text->runs, sizeof(struct text_run), 0);
+    shaped_text->last_use = cache->shaping_clock++;
+
+    int ret = copy_runs(&shaped_text->runs, runs_array);
+    if (ret < 0) {
+        free_shaped_text(NULL, shaped_text);
+        return ret;
+    }
+
+    ret = ngli_hmap_set(cache->shaped_texts, key, shaped_text);
+    if (ret < 0) {
+        free_shaped_text(NULL, shaped_text);
+        return ret;
+    }
+
+    return 0;
+}
+
+/*
+ * Livectl driven texts typically alternate between a small set of values, so
+ * the runs shaped for the recent strings are kept in the shared cache: their
+ * HarfBuzz buffers are never modified after shaping, so they can be
+ * referenced by any number of Text nodes.
+ */
+static int get_text_runs(struct text *text, const char *str, struct darray *runs_array)
+{
+    struct text_external *s = text->priv_data;
+    struct text_external_cache *cache = s->cache;
+
+    char *key = get_shaping_key(text, str);
+    if (!key)
+        return NGL_ERROR_MEMORY;
+
+    int ret;
+    struct shaped_text *shaped_text = ngli_hmap_get(cache->shaped_texts, key);
+    if (shaped_text) {
+        shaped_text->last_use = cache->shaping_clock++;
+        ret = copy_runs(runs_array, &shaped_text->runs);
+    } else {
+        ret = build_text_runs(text, str, runs_array);
+        if (ret >= 0)
+            ret = store_shaped_text(cache, key, runs_array);
+    }
+
+    ngli_free(key);
+    return ret;
+}
+
 static int text_external_set_string(struct text *text, const char *str, struct darray *chars_dst)
 {
     struct text_external *s = text->priv_data;
-    struct hmap *glyph_index = NULL;
+    struct text_external_cache *cache = s->cache;
 
     struct darray runs_array;
     ngli_darray_init(&runs_array, sizeof(struct text_run), 0);
 
-    /* Re-entrance reset */
-    ngli_distmap_freep(&s->distmap);
-
-    int ret = build_text_runs(text, str, &runs_array);
+    int ret = get_text_runs(text, str, &runs_array);
     if (ret < 0)
         goto end;
 
-    s->distmap = ngli_distmap_create(text->ctx);
-    if (!s->distmap) {
-        ret = NGL_ERROR_MEMORY;
-        goto end;
+    /* A previous failure to reset the glyphs left the cache without atlas */
+    if (!cache->distmap) {
+        ret = reset_glyphs(text->ctx, cache);
+        if (ret < 0)
+            goto end;
     }
-    ret = ngli_distmap_init(s->distmap);
+
+    ret = register_glyphs(text, &runs_array);
     if (ret < 0)
         goto end;
 
-    glyph_index = ngli_hmap_create();
-    if (!glyph_index) {
-        ret = NGL_ERROR_MEMORY;
-        goto end;
+    ret = update_atlas(cache);
+    if (ret == NGL_ERROR_GRAPHICS_LIMIT_EXCEEDED) {
+        /*
+         * The glyphs accumulated since the creation of the atlas do not fit
+         * anymore: rebuild it from the glyphs of this string only, the other
+         * Text nodes register theirs again once they notice the atlas change
+         */
+        LOG(WARNING, "shared glyph atlas is full, rebuilding it from the live glyphs");
+        ret = reset_glyphs(text->ctx, cache);
+        if (ret >= 0)
+            ret = register_glyphs(text, &runs_array);
+        if (ret >= 0)
+            ret = update_atlas(cache);
     }
-    ngli_hmap_set_free_func(glyph_index, free_glyph, NULL);
-    ret = build_glyph_index(text, glyph_index, &runs_array);
-    if (ret < 0)
+    if (ret < 0) {
+        /*
+         * The distmap may have repacked its shapes before failing: the
+         * coordinates of the registered glyphs can not be trusted anymore
+         */
+        reset_glyphs(text->ctx, cache);
         goto end;
+    }
 
-    ret = ngli_distmap_finalize(s->distmap);
-    if (ret < 0)
-        goto end;
-    text->atlas_texture = ngli_distmap_get_texture(s->distmap);
+    struct texture *atlas_texture = ngli_distmap_get_texture(cache->distmap);
+    if (s->atlas_texture != atlas_texture) {
+        NGLI_RC_UNREFP(&s->atlas_texture);
+        if (atlas_texture)
+            s->atlas_texture = NGLI_RC_REF(atlas_texture);
+    }
+    text->atlas_texture = s->atlas_texture;
 
-    ret = register_chars(text, str, chars_dst, &runs_array, glyph_index);
+    ret = register_chars(text, str, chars_dst, &runs_array);
     if (ret < 0)
         goto end;
 
 end:
     reset_runs(&runs_array);
-    ngli_hmap_freep(&glyph_index);
     return ret;
 }
 
+static int text_external_atlas_outdated(const struct text *text)
+{
+    const struct text_external *s = text->priv_data;
+    if (!s->cache->distmap)
+        return 1;
+    return s->atlas_texture != ngli_distmap_get_texture(s->cache->distmap);
+}
+
 static void text_external_reset(struct text *text)
 {
     struct text_external *s = text->priv_data;
 
+    ngli_darray_reset(&s->face_ids);
     ngli_darray_reset(&s->hb_fonts);
     ngli_darray_reset(&s->ft_faces);
 
-    FT_Done_FreeType(s->ft_library);
-
-    ngli_distmap_freep(&s->distmap);
+    NGLI_RC_UNREFP(&s->atlas_texture);
 }
 
 const struct text_cls ngli_text_external = {
@@ -836,6 +1145,7 @@ const struct text_cls ngli_text_external = {
     .init            = text_external_init,
     .set_string      = text_external_set_string,
     .reset           = text_external_reset,
+    .atlas_outdated  = text_external_atlas_outdated,
     .flags           = NGLI_TEXT_FLAG_MUTABLE_ATLAS,
 };
 
@@ -857,4 +1167,8 @@ const struct text_cls ngli_text_external = {
     .set_string = text_external_dummy_set_string,
 };
 
+void ngli_text_external_cache_freep(struct text_external_cache **sp)
+{
+}
+
 #endif
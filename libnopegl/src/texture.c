@@ -37,18 +37,25 @@ struct texture *ngli_texture_create(struct gpu_ctx *gpu_ctx)
     return s;
 }
 
+/*
+ * Creating, uploading and generating the mipmaps of a texture may rebind
+ * texture units behind the bound bindgroup (OpenGL)
+ */
 int ngli_texture_init(struct texture *s, const struct texture_params *params)
 {
+    ngli_gpu_ctx_invalidate_state(s->gpu_ctx, NGLI_GPU_STATE_BINDGROUP);
     return s->gpu_ctx->cls->texture_init(s, params);
 }
 
 int ngli_texture_upload(struct texture *s, const uint8_t *data, int linesize)
 {
+    ngli_gpu_ctx_invalidate_state(s->gpu_ctx, NGLI_GPU_STATE_BINDGROUP);
     return s->gpu_ctx->cls->texture_upload(s, data, linesize);
 }
 
 int ngli_texture_generate_mipmap(struct texture *s)
 {
+    ngli_gpu_ctx_invalidate_state(s->gpu_ctx, NGLI_GPU_STATE_BINDGROUP);
     return s->gpu_ctx->cls->texture_generate_mipmap(s);
 }
 
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "darray.h"
+#include "log.h"
+#include "memory.h"
+#include "nopegl.h"
+#include "pthread_compat.h"
+#include "threadpool.h"
+#include "utils.h"
+
+struct job {
+    int (*func)(void *arg);
+    void *arg;
+};
+
+struct threadpool {
+    pthread_t *threads;
+    size_t nb_threads;
+    pthread_mutex_t lock;
+    pthread_cond_t job_cond;
+    pthread_cond_t done_cond;
+    int sync_initialized;
+    struct darray jobs;
+    size_t next_job;
+    size_t nb_pending; // queued and running jobs
+    int ret;
+    int stop;
+};
+
+static size_t get_nb_cpus(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+#else
+    const long nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return nb_cpus > 0 ? (size_t)nb_cpus : 1;
+#endif
+}
+
+static void *worker_thread(void *arg)
+{
+    struct threadpool *s = arg;
+
+    ngli_thread_set_name("ngl-worker");
+
+    pthread_mutex_lock(&s->lock);
+    for (;;) {
+        while (!s->stop && s->next_job == ngli_darray_count(&s->jobs))
+            pthread_cond_wait(&s->job_cond, &s->lock);
+        if (s->next_job == ngli_darray_count(&s->jobs))
+            break;
+
+        const struct job job = *(struct job *)ngli_darray_get(&s->jobs, s->next_job++);
+        if (s->next_job == ngli_darray_count(&s->jobs)) {
+            ngli_darray_clear(&s->jobs);
+            s->next_job = 0;
+        }
+
+        pthread_mutex_unlock(&s->lock);
+        const int ret = job.func(job.arg);
+        pthread_mutex_lock(&s->lock);
+
+        if (ret < 0 && s->ret >= 0)
+            s->ret = ret;
+        if (--s->nb_pending == 0)
+            pthread_cond_broadcast(&s->done_cond);
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    return NULL;
+}
+
+struct threadpool *ngli_threadpool_create(void)
+{
+    struct threadpool *s = ngli_calloc(1, sizeof(*s));
+    return s;
+}
+
+int ngli_threadpool_init(struct threadpool *s, size_t nb_threads)
+{
+    if (!nb_threads)
+        nb_threads = get_nb_cpus();
+
+    ngli_darray_init(&s->jobs, sizeof(struct job), 0);
+
+    if (pthread_mutex_init(&s->lock, NULL))
+        return NGL_ERROR_EXTERNAL;
+    if (pthread_cond_init(&s->job_cond, NULL)) {
+        pthread_mutex_destroy(&s->lock);
+        return NGL_ERROR_EXTERNAL;
+    }
+    if (pthread_cond_init(&s->done_cond, NULL)) {
+        pthread_cond_destroy(&s->job_cond);
+        pthread_mutex_destroy(&s->lock);
+        return NGL_ERROR_EXTERNAL;
+    }
+    s->sync_initialized = 1;
+
+    s->threads = ngli_calloc(nb_threads, sizeof(*s->threads));
+    if (!s->threads)
+        return NGL_ERROR_MEMORY;
+
+    for (size_t i = 0; i < nb_threads; i++) {
+        if (pthread_create(&s->threads[i], NULL, worker_thread, s)) {
+            LOG(ERROR, "could not create worker thread %zu/%zu", i + 1, nb_threads);
+            return NGL_ERROR_EXTERNAL;
+        }
+        s->nb_threads++;
+    }
+
+    return 0;
+}
+
+int ngli_threadpool_submit(struct threadpool *s, int (*func)(void *arg), void *arg)
+{
+    const struct job job = {.func = func, .arg = arg};
+
+    pthread_mutex_lock(&s->lock);
+    if (!ngli_darray_push(&s->jobs, &job)) {
+        pthread_mutex_unlock(&s->lock);
+        return NGL_ERROR_MEMORY;
+    }
+    s->nb_pending++;
+    pthread_cond_signal(&s->job_cond);
+    pthread_mutex_unlock(&s->lock);
+
+    return 0;
+}
+
+int ngli_threadpool_wait(struct threadpool *s)
+{
+    pthread_mutex_lock(&s->lock);
+    while (s->nb_pending)
+        pthread_cond_wait(&s->done_cond, &s->lock);
+    const int ret = s->ret;
+    s->ret = 0;
+    pthread_mutex_unlock(&s->lock);
+    return ret;
+}
+
+size_t ngli_threadpool_get_nb_threads(const struct threadpool *s)
+{
+    return s->nb_threads;
+}
+
+void ngli_threadpool_freep(struct threadpool **sp)
+{
+    struct threadpool *s = *sp;
+    if (!s)
+        return;
+
+    if (s->sync_initialized) {
+        /* Remaining jobs are executed before the workers exit */
+        pthread_mutex_lock(&s->lock);
+        s->stop = 1;
+        pthread_cond_broadcast(&s->job_cond);
+        pthread_mutex_unlock(&s->lock);
+
+        for (size_t i = 0; i < s->nb_threads; i++)
+            pthread_join(s->threads[i], NULL);
+
+        pthread_cond_destroy(&s->done_cond);
+        pthread_cond_destroy(&s->job_cond);
+        pthread_mutex_destroy(&s->lock);
+    }
+
+    ngli_freep(&s->threads);
+    ngli_darray_reset(&s->jobs);
+    ngli_freep(sp);
+}
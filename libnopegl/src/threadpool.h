@@ -0,0 +1,42 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stddef.h>
+
+/*
+ * Fixed-size pool of worker threads executing the submitted jobs in order of
+ * submission. Jobs return a status code: ngli_threadpool_wait() blocks until
+ * all the jobs submitted so far are done and returns the first error
+ * encountered (if any) since the previous wait.
+ */
+struct threadpool;
+
+struct threadpool *ngli_threadpool_create(void);
+int ngli_threadpool_init(struct threadpool *s, size_t nb_threads);
+int ngli_threadpool_submit(struct threadpool *s, int (*func)(void *arg), void *arg);
+int ngli_threadpool_wait(struct threadpool *s);
+size_t ngli_threadpool_get_nb_threads(const struct threadpool *s);
+void ngli_threadpool_freep(struct threadpool **sp);
+
+#endif
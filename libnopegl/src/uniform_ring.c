@@ -0,0 +1,199 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "darray.h"
+#include "gpu_ctx.h"
+#include "log.h"
+#include "memory.h"
+#include "nopegl.h"
+#include "uniform_ring.h"
+#include "utils.h"
+
+#define NB_REGIONS NGL_MAX_FRAMES_IN_FLIGHT
+#define INITIAL_REGION_SIZE (64 * 1024)
+
+struct retired_buffer {
+    struct buffer *buffer;
+    uint64_t frame_id;
+};
+
+struct uniform_ring {
+    struct gpu_ctx *gpu_ctx;
+    struct buffer *buffer;
+    uint8_t *mapped_data;
+    size_t region_size;
+    size_t region_index;
+    size_t offset;
+    uint64_t frame_id;
+    struct darray retired_buffers;
+};
+
+static void free_buffer(struct uniform_ring *s, struct buffer **bufferp)
+{
+    if (!*bufferp)
+        return;
+    if (s->gpu_ctx->features & NGLI_FEATURE_BUFFER_MAP_PERSISTENT)
+        ngli_buffer_unmap(*bufferp);
+    ngli_buffer_freep(bufferp);
+}
+
+static void free_retired_buffer(void *user_arg, void *data)
+{
+    struct uniform_ring *s = user_arg;
+    struct retired_buffer *retired = data;
+    free_buffer(s, &retired->buffer);
+}
+
+static int create_buffer(struct uniform_ring *s, size_t region_size)
+{
+    struct gpu_ctx *gpu_ctx = s->gpu_ctx;
+
+    struct buffer *buffer = ngli_buffer_create(gpu_ctx);
+    if (!buffer)
+        return NGL_ERROR_MEMORY;
+
+    int usage = NGLI_BUFFER_USAGE_DYNAMIC_BIT |
+                NGLI_BUFFER_USAGE_TRANSFER_DST_BIT |
+                NGLI_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                NGLI_BUFFER_USAGE_MAP_WRITE;
+    if (gpu_ctx->features & NGLI_FEATURE_BUFFER_MAP_PERSISTENT)
+        usage |= NGLI_BUFFER_USAGE_MAP_PERSISTENT;
+
+    int ret = ngli_buffer_init(buffer, NB_REGIONS * region_size, usage);
+    if (ret < 0) {
+        ngli_buffer_freep(&buffer);
+        return ret;
+    }
+
+    uint8_t *mapped_data = NULL;
+    if (gpu_ctx->features & NGLI_FEATURE_BUFFER_MAP_PERSISTENT) {
+        ret = ngli_buffer_map(buffer, 0, buffer->size, (void **)&mapped_data);
+        if (ret < 0) {
+            ngli_buffer_freep(&buffer);
+            return ret;
+        }
+    }
+
+    /*
+     * The previous buffer may still be referenced by the frames in flight
+     * (including the current one), so its destruction is deferred until they
+     * are all completed
+     */
+    if (s->buffer) {
+        const struct retired_buffer retired = {.buffer = s->buffer, .frame_id = s->frame_id};
+        if (!ngli_darray_push(&s->retired_buffers, &retired)) {
+            free_buffer(s, &buffer);
+            return NGL_ERROR_MEMORY;
+        }
+    }
+
+    s->buffer = buffer;
+    s->mapped_data = mapped_data;
+    s->region_size = region_size;
+    s->offset = 0;
+
+    return 0;
+}
+
+struct uniform_ring *ngli_uniform_ring_create(struct gpu_ctx *gpu_ctx)
+{
+    struct uniform_ring *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->gpu_ctx = gpu_ctx;
+    return s;
+}
+
+int ngli_uniform_ring_init(struct uniform_ring *s)
+{
+    ngli_darray_init(&s->retired_buffers, sizeof(struct retired_buffer), 0);
+    ngli_darray_set_free_func(&s->retired_buffers, free_retired_buffer, s);
+
+    const size_t alignment = s->gpu_ctx->limits.min_uniform_block_offset_alignment;
+    return create_buffer(s, NGLI_ALIGN(INITIAL_REGION_SIZE, alignment));
+}
+
+void ngli_uniform_ring_begin_frame(struct uniform_ring *s)
+{
+    s->frame_id++;
+    s->region_index = (s->region_index + 1) % NB_REGIONS;
+    s->offset = 0;
+
+    size_t nb_expired = 0;
+    const struct retired_buffer *retired_buffers = ngli_darray_data(&s->retired_buffers);
+    while (nb_expired < ngli_darray_count(&s->retired_buffers) &&
+           s->frame_id - retired_buffers[nb_expired].frame_id >= NB_REGIONS)
+        nb_expired++;
+    ngli_darray_remove_range(&s->retired_buffers, 0, nb_expired);
+}
+
+uint64_t ngli_uniform_ring_get_frame_id(const struct uniform_ring *s)
+{
+    return s->frame_id;
+}
+
+int ngli_uniform_ring_push(struct uniform_ring *s, const void *data, size_t size, size_t aligned_size,
+                           struct buffer **bufferp, size_t *offsetp)
+{
+    ngli_assert(size <= aligned_size);
+
+    if (s->offset + aligned_size > s->region_size) {
+        size_t region_size = s->region_size * 2;
+        while (region_size < aligned_size)
+            region_size *= 2;
+        LOG(DEBUG, "grow uniform ring regions from %zu to %zu bytes", s->region_size, region_size);
+        int ret = create_buffer(s, region_size);
+        if (ret < 0)
+            return ret;
+    }
+
+    const size_t offset = s->region_index * s->region_size + s->offset;
+    if (s->mapped_data) {
+        memcpy(s->mapped_data + offset, data, size);
+    } else {
+        /*
+         * Without persistent mapping (OpenGL contexts lacking buffer
+         * storage), the buffer cannot stay mapped while the draws reading
+         * the previous slices of the region are submitted, so every slice
+         * is uploaded on its own
+         */
+        int ret = ngli_buffer_upload(s->buffer, data, offset, size);
+        if (ret < 0)
+            return ret;
+    }
+    s->offset += aligned_size;
+
+    *bufferp = s->buffer;
+    *offsetp = offset;
+    return 0;
+}
+
+void ngli_uniform_ring_freep(struct uniform_ring **sp)
+{
+    struct uniform_ring *s = *sp;
+    if (!s)
+        return;
+    ngli_darray_reset(&s->retired_buffers);
+    free_buffer(s, &s->buffer);
+    ngli_freep(sp);
+}
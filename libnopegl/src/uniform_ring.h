@@ -0,0 +1,48 @@
+/*
+ * Copyright 2023 Nope Forge
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef UNIFORM_RING_H
+#define UNIFORM_RING_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "buffer.h"
+
+struct gpu_ctx;
+
+/*
+ * Context-wide ring allocator for the uniform blocks of the pipelines. Every
+ * frame sub-allocates its uniform slices from its own region of a single
+ * buffer, so that the data of the frames still in flight is never
+ * overwritten. The slices are meant to be bound as dynamic uniform buffers.
+ */
+struct uniform_ring;
+
+struct uniform_ring *ngli_uniform_ring_create(struct gpu_ctx *gpu_ctx);
+int ngli_uniform_ring_init(struct uniform_ring *s);
+void ngli_uniform_ring_begin_frame(struct uniform_ring *s);
+uint64_t ngli_uniform_ring_get_frame_id(const struct uniform_ring *s);
+int ngli_uniform_ring_push(struct uniform_ring *s, const void *data, size_t size, size_t aligned_size,
+                           struct buffer **bufferp, size_t *offsetp);
+void ngli_uniform_ring_freep(struct uniform_ring **sp);
+
+#endif
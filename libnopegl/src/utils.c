@@ -25,13 +25,16 @@
 #define POW10_9 1000000000
 #include <Windows.h>
 #else
+#include <sys/mman.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/stat.h>
-#include <unistd.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
+#include <inttypes.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -242,6 +245,143 @@ static int count_digits(int x)
     return n;
 }
 
+int ngli_file_map(const char *filename, struct file_map *map)
+{
+    memset(map, 0, sizeof(*map));
+
+#ifdef _WIN32
+    HANDLE file_handle = CreateFile(TEXT(filename), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        LOG(ERROR, "could not open '%s'", filename);
+        return NGL_ERROR_IO;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle, &file_size)) {
+        CloseHandle(file_handle);
+        return NGL_ERROR_IO;
+    }
+    if ((uint64_t)file_size.QuadPart > SIZE_MAX) {
+        LOG(ERROR, "'%s' size (%" PRId64 ") exceeds supported limit (%zu)", filename, file_size.QuadPart, SIZE_MAX);
+        CloseHandle(file_handle);
+        return NGL_ERROR_UNSUPPORTED;
+    }
+    map->size = (size_t)file_size.QuadPart;
+    if (!map->size) {
+        CloseHandle(file_handle);
+        return 0;
+    }
+
+    HANDLE map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file_handle);
+    if (!map_handle) {
+        LOG(ERROR, "could not map '%s'", filename);
+        return NGL_ERROR_IO;
+    }
+
+    /* The view keeps a reference on the mapping object */
+    map->data = MapViewOfFile(map_handle, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(map_handle);
+    if (!map->data) {
+        LOG(ERROR, "could not map '%s'", filename);
+        return NGL_ERROR_IO;
+    }
+#else
+    const int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        LOG(ERROR, "could not open '%s': %s", filename, strerror(errno));
+        return NGL_ERROR_IO;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        LOG(ERROR, "could not stat '%s': %s", filename, strerror(errno));
+        close(fd);
+        return NGL_ERROR_IO;
+    }
+    if ((uint64_t)st.st_size > SIZE_MAX) {
+        LOG(ERROR, "'%s' size (%" PRId64 ") exceeds supported limit (%zu)", filename, (int64_t)st.st_size, SIZE_MAX);
+        close(fd);
+        return NGL_ERROR_UNSUPPORTED;
+    }
+    map->size = (size_t)st.st_size;
+    if (!map->size) {
+        close(fd);
+        return 0;
+    }
+
+    /* The mapping stays valid after the file descriptor is closed */
+    void *data = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        LOG(ERROR, "could not map '%s': %s", filename, strerror(errno));
+        return NGL_ERROR_IO;
+    }
+    map->data = data;
+
+    /* Pages are faulted in on access, in a mostly forward order */
+    madvise(data, map->size, MADV_SEQUENTIAL);
+#endif
+
+    return 0;
+}
+
+void ngli_file_map_prefetch(const struct file_map *map)
+{
+    if (!map->data)
+        return;
+#ifndef _WIN32
+    madvise(map->data, map->size, MADV_WILLNEED);
+#endif
+}
+
+size_t ngli_file_map_get_resident_size(const struct file_map *map)
+{
+    if (!map->data)
+        return 0;
+
+#ifdef _WIN32
+    /* No cheap residency query: report the mapped size as an upper bound */
+    return map->size;
+#else
+    const long page_size = sysconf(_SC_PAGESIZE);
+    if (page_size <= 0)
+        return map->size;
+
+#if defined(__APPLE__)
+    char vec[1024];
+#else
+    unsigned char vec[1024];
+#endif
+    const size_t chunk_size = sizeof(vec) * (size_t)page_size;
+    size_t resident_size = 0;
+    for (size_t offset = 0; offset < map->size; offset += chunk_size) {
+        const size_t size = NGLI_MIN(map->size - offset, chunk_size);
+        if (mincore(map->data + offset, size, vec) == -1)
+            return map->size;
+        const size_t nb_pages = (size + (size_t)page_size - 1) / (size_t)page_size;
+        for (size_t i = 0; i < nb_pages; i++) {
+            if (vec[i] & 1)
+                resident_size += NGLI_MIN((size_t)page_size, size - i * (size_t)page_size);
+        }
+    }
+    return resident_size;
+#endif
+}
+
+void ngli_file_unmap(struct file_map *map)
+{
+    if (map->data) {
+#ifdef _WIN32
+        UnmapViewOfFile(map->data);
+#else
+        munmap(map->data, map->size);
+#endif
+    }
+    memset(map, 0, sizeof(*map));
+}
+
 char *ngli_numbered_lines(const char *s)
 {
     struct bstr *b = ngli_bstr_create();
@@ -281,6 +421,14 @@ int ngli_config_copy(struct ngl_config *dst, const struct ngl_config *src)
             return NGL_ERROR_MEMORY;
     }
 
+    if (src->cache_dir) {
+        tmp.cache_dir = ngli_strdup(src->cache_dir);
+        if (!tmp.cache_dir) {
+            ngli_freep(&tmp.hud_export_filename);
+            return NGL_ERROR_MEMORY;
+        }
+    }
+
     if (src->backend_config) {
         if (src->backend == NGL_BACKEND_OPENGL ||
             src->backend == NGL_BACKEND_OPENGLES) {
@@ -288,10 +436,12 @@ int ngli_config_copy(struct ngl_config *dst, const struct ngl_config *src)
             tmp.backend_config = ngli_memdup(src->backend_config, size);
             if (!tmp.backend_config) {
                 ngli_freep(&tmp.hud_export_filename);
+                ngli_freep(&tmp.cache_dir);
                 return NGL_ERROR_MEMORY;
             }
         } else {
             ngli_freep(&tmp.hud_export_filename);
+            ngli_freep(&tmp.cache_dir);
             LOG(ERROR, "backend_config %p is not supported by backend %d",
                 src->backend_config, src->backend);
             return NGL_ERROR_UNSUPPORTED;
@@ -307,5 +457,6 @@ void ngli_config_reset(struct ngl_config *config)
 {
     ngli_freep(&config->backend_config);
     ngli_freep(&config->hud_export_filename);
+    ngli_freep(&config->cache_dir);
     memset(config, 0, sizeof(*config));
 }
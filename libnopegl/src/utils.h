@@ -154,6 +154,17 @@ uint32_t ngli_crc32(const char *s);
 uint32_t ngli_crc32_mem(const uint8_t *s, size_t size);
 void ngli_thread_set_name(const char *name);
 int ngli_get_filesize(const char *name, int64_t *size);
+
+/* Read-only memory mapping of a whole file; data is NULL for empty files */
+struct file_map {
+    uint8_t *data;
+    size_t size;
+};
+
+int ngli_file_map(const char *filename, struct file_map *map);
+void ngli_file_map_prefetch(const struct file_map *map);
+size_t ngli_file_map_get_resident_size(const struct file_map *map);
+void ngli_file_unmap(struct file_map *map);
 char *ngli_numbered_lines(const char *s);
 int ngli_config_copy(struct ngl_config *dst, const struct ngl_config *src);
 void ngli_config_reset(struct ngl_config *config);
@@ -36,24 +36,24 @@
 
 #include "common.h"
 #include "opts.h"
+#include "pthread_compat.h"
 #include "wsi.h"
 
 #ifndef O_BINARY
 #define O_BINARY 0
 #endif
 
-static struct ngl_scene *get_scene(const char *filename)
+/*
+ * Scenes read from a file (text or binary) are loaded directly by the library
+ * from a memory mapping, only the standard input goes through a string.
+ */
+static struct ngl_scene *get_scene(const char *filename, const char *str)
 {
-    char *buf = get_text_file_content(filename);
-    if (!buf)
-        return NULL;
     struct ngl_scene *scene = ngl_scene_create();
-    if (!scene) {
-        free(buf);
+    if (!scene)
         return NULL;
-    }
-    int ret = ngl_scene_init_from_str(scene, buf);
-    free(buf);
+    int ret = filename ? ngl_scene_init_from_file(scene, filename)
+                       : ngl_scene_init_from_str(scene, str);
     if (ret < 0)
         ngl_scene_freep(&scene);
     return scene;
@@ -74,6 +74,7 @@ struct ctx {
     const char *output;
     struct range *ranges;
     size_t nb_ranges;
+    int nb_jobs;
 };
 
 static int opt_timerange(const char *arg, void *dst)
@@ -99,6 +100,328 @@ static int opt_timerange(const char *arg, void *dst)
     return 0;
 }
 
+struct frame_sink {
+    int fd;
+    int height;
+    int ret;
+};
+
+static void on_frame(void *opaque, const uint8_t *data, int linesize, double t)
+{
+    struct frame_sink *sink = opaque;
+    if (sink->ret < 0)
+        return;
+    const size_t size = (size_t)linesize * sink->height;
+    const size_t n = write(sink->fd, data, size);
+    if (n != size) {
+        fprintf(stderr, "unable to write capture buffer to output\n");
+        sink->ret = -1;
+    }
+}
+
+static int wait_frame(struct ngl_ctx *ctx, const struct frame_sink *sink)
+{
+    int ret = ngl_wait_frame(ctx, NULL);
+    if (ret < 0) {
+        fprintf(stderr, "Unable to draw frame\n");
+        return ret;
+    }
+    if (sink->ret < 0)
+        return EXIT_FAILURE;
+    return 0;
+}
+
+static float *get_frame_times(const struct ctx *s, size_t *nb_framesp)
+{
+    float *times = NULL;
+    size_t nb_frames = 0;
+
+    /* The first pass counts the frames, the second one fills their times */
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass) {
+            times = malloc((nb_frames ? nb_frames : 1) * sizeof(*times));
+            if (!times)
+                return NULL;
+            nb_frames = 0;
+        }
+        for (size_t i = 0; i < s->nb_ranges; i++) {
+            const struct range *r = &s->ranges[i];
+            const float t0 = r->start;
+            const float t1 = r->start + r->duration;
+            for (size_t k = 0;; k++) {
+                const float t = t0 + (float)k / (float)r->freq;
+                if (t >= t1)
+                    break;
+                if (times)
+                    times[nb_frames] = t;
+                nb_frames++;
+            }
+        }
+    }
+
+    *nb_framesp = nb_frames;
+    return times;
+}
+
+/*
+ * In parallel mode, the frames are split into segments of SEGMENT_SIZE
+ * consecutive frames which are distributed round-robin across the jobs. Every
+ * job renders its segments on its own offscreen context and queues the
+ * captured frames into a ring of SEGMENT_SIZE slots, which is consumed in
+ * presentation order by the main thread.
+ */
+#define SEGMENT_SIZE 8
+
+struct job {
+    const struct ctx *s;
+    const char *scene_str;
+    const float *times;
+    size_t nb_frames;
+    int id;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint8_t *frames;
+    size_t frame_size;
+    size_t read_pos;
+    size_t nb_queued;
+    int stop;
+    int done;
+    int ret;
+};
+
+static int job_should_stop(struct job *job)
+{
+    pthread_mutex_lock(&job->lock);
+    const int stop = job->stop;
+    pthread_mutex_unlock(&job->lock);
+    return stop;
+}
+
+static void job_on_frame(void *opaque, const uint8_t *data, int linesize, double t)
+{
+    struct job *job = opaque;
+
+    pthread_mutex_lock(&job->lock);
+    while (job->nb_queued == SEGMENT_SIZE && !job->stop)
+        pthread_cond_wait(&job->cond, &job->lock);
+    const int stop = job->stop;
+    const size_t pos = (job->read_pos + job->nb_queued) % SEGMENT_SIZE;
+    pthread_mutex_unlock(&job->lock);
+
+    if (stop)
+        return;
+
+    /* The slot is not visible to the main thread until it is queued */
+    memcpy(job->frames + pos * job->frame_size, data, job->frame_size);
+
+    pthread_mutex_lock(&job->lock);
+    job->nb_queued++;
+    pthread_cond_broadcast(&job->cond);
+    pthread_mutex_unlock(&job->lock);
+}
+
+static int job_render(struct job *job)
+{
+    const struct ctx *s = job->s;
+
+    struct ngl_ctx *ctx = NULL;
+    struct ngl_scene *scene = get_scene(s->input, job->scene_str);
+    if (!scene)
+        return EXIT_FAILURE;
+
+    ctx = ngl_create();
+    if (!ctx) {
+        ngl_scene_freep(&scene);
+        return EXIT_FAILURE;
+    }
+
+    struct ngl_config cfg = s->cfg;
+    if (job->frames) {
+        cfg.on_frame = job_on_frame;
+        cfg.on_frame_opaque = job;
+        cfg.capture_async = 1;
+    }
+
+    int ret = ngl_configure(ctx, &cfg);
+    if (ret < 0) {
+        ngl_scene_freep(&scene);
+        goto end;
+    }
+
+    ret = ngl_set_scene(ctx, scene);
+    ngl_scene_freep(&scene);
+    if (ret < 0)
+        goto end;
+
+    size_t nb_frames_in_flight = 0;
+    const size_t segment_stride = (size_t)SEGMENT_SIZE * s->nb_jobs;
+    for (size_t seg = (size_t)job->id * SEGMENT_SIZE; seg < job->nb_frames; seg += segment_stride) {
+        const size_t seg_end = seg + SEGMENT_SIZE < job->nb_frames ? seg + SEGMENT_SIZE : job->nb_frames;
+        for (size_t i = seg; i < seg_end; i++) {
+            if (job_should_stop(job))
+                goto end;
+            const float t = job->times[i];
+            if (s->debug)
+                printf("draw @ t=%f [job %d/%d, frame %zu/%zu]\n",
+                       t, job->id + 1, s->nb_jobs, i + 1, job->nb_frames);
+            if (nb_frames_in_flight == NGL_MAX_FRAMES_IN_FLIGHT) {
+                ret = ngl_wait_frame(ctx, NULL);
+                if (ret < 0) {
+                    fprintf(stderr, "Unable to draw frame\n");
+                    goto end;
+                }
+                nb_frames_in_flight--;
+            }
+            ret = ngl_draw_async(ctx, t, NULL);
+            if (ret < 0) {
+                fprintf(stderr, "Unable to draw @ t=%g\n", t);
+                goto end;
+            }
+            nb_frames_in_flight++;
+        }
+    }
+
+    for (; nb_frames_in_flight > 0; nb_frames_in_flight--) {
+        ret = ngl_wait_frame(ctx, NULL);
+        if (ret < 0) {
+            fprintf(stderr, "Unable to draw frame\n");
+            goto end;
+        }
+    }
+
+end:
+    ngl_freep(&ctx);
+    return ret;
+}
+
+static void *job_thread(void *arg)
+{
+    struct job *job = arg;
+    const int ret = job_render(job);
+    pthread_mutex_lock(&job->lock);
+    job->ret = ret;
+    job->done = 1;
+    pthread_cond_broadcast(&job->cond);
+    pthread_mutex_unlock(&job->lock);
+    return NULL;
+}
+
+static int write_frames(struct job *jobs, int nb_jobs, size_t nb_frames, int fd)
+{
+    for (size_t i = 0; i < nb_frames; i++) {
+        struct job *job = &jobs[(i / SEGMENT_SIZE) % nb_jobs];
+
+        pthread_mutex_lock(&job->lock);
+        while (!job->nb_queued && !job->done)
+            pthread_cond_wait(&job->cond, &job->lock);
+        const int available = job->nb_queued > 0;
+        const int job_ret = job->ret;
+        pthread_mutex_unlock(&job->lock);
+
+        if (!available)
+            return job_ret < 0 ? job_ret : EXIT_FAILURE;
+
+        const uint8_t *frame = job->frames + job->read_pos * job->frame_size;
+        const size_t n = write(fd, frame, job->frame_size);
+        if (n != job->frame_size) {
+            fprintf(stderr, "unable to write capture buffer to output\n");
+            return EXIT_FAILURE;
+        }
+
+        pthread_mutex_lock(&job->lock);
+        job->read_pos = (job->read_pos + 1) % SEGMENT_SIZE;
+        job->nb_queued--;
+        pthread_cond_broadcast(&job->cond);
+        pthread_mutex_unlock(&job->lock);
+    }
+    return 0;
+}
+
+static int render_parallel(const struct ctx *s, const char *scene_str, int fd)
+{
+    size_t nb_frames = 0;
+    float *times = get_frame_times(s, &nb_frames);
+    if (!times)
+        return EXIT_FAILURE;
+
+    struct job *jobs = calloc(s->nb_jobs, sizeof(*jobs));
+    if (!jobs) {
+        free(times);
+        return EXIT_FAILURE;
+    }
+
+    const size_t frame_size = (size_t)s->cfg.width * s->cfg.height * 4;
+    for (int i = 0; i < s->nb_jobs; i++) {
+        struct job *job = &jobs[i];
+        job->s          = s;
+        job->scene_str  = scene_str;
+        job->times      = times;
+        job->nb_frames  = nb_frames;
+        job->id         = i;
+        job->frame_size = frame_size;
+        pthread_mutex_init(&job->lock, NULL);
+        pthread_cond_init(&job->cond, NULL);
+    }
+
+    int ret = 0;
+    int nb_started = 0;
+    if (fd != -1) {
+        for (int i = 0; i < s->nb_jobs; i++) {
+            jobs[i].frames = malloc(SEGMENT_SIZE * frame_size);
+            if (!jobs[i].frames) {
+                ret = EXIT_FAILURE;
+                goto end;
+            }
+        }
+    }
+
+    const int64_t start = gettime_relative();
+
+    for (; nb_started < s->nb_jobs; nb_started++) {
+        if (pthread_create(&jobs[nb_started].thread, NULL, job_thread, &jobs[nb_started])) {
+            fprintf(stderr, "Unable to create rendering job\n");
+            ret = EXIT_FAILURE;
+            goto end;
+        }
+    }
+
+    if (fd != -1)
+        ret = write_frames(jobs, s->nb_jobs, nb_frames, fd);
+
+end:
+    if (ret) {
+        for (int i = 0; i < nb_started; i++) {
+            struct job *job = &jobs[i];
+            pthread_mutex_lock(&job->lock);
+            job->stop = 1;
+            pthread_cond_broadcast(&job->cond);
+            pthread_mutex_unlock(&job->lock);
+        }
+    }
+
+    for (int i = 0; i < nb_started; i++) {
+        pthread_join(jobs[i].thread, NULL);
+        if (!ret && jobs[i].ret != 0)
+            ret = jobs[i].ret;
+    }
+
+    if (!ret) {
+        const double tdiff = (double)(gettime_relative() - start) / 1000000.;
+        printf("Rendered %zu frames in %g (FPS=%g) using %d jobs\n",
+               nb_frames, tdiff, (double)nb_frames / tdiff, s->nb_jobs);
+    }
+
+    for (int i = 0; i < s->nb_jobs; i++) {
+        pthread_mutex_destroy(&jobs[i].lock);
+        pthread_cond_destroy(&jobs[i].cond);
+        free(jobs[i].frames);
+    }
+    free(jobs);
+    free(times);
+    return ret;
+}
+
 #define OFFSET(x) offsetof(struct ctx, x)
 static const struct opt options[] = {
     {"-d", "--debug",         OPT_TYPE_TOGGLE,   .offset=OFFSET(debug)},
@@ -112,6 +435,7 @@ static const struct opt options[] = {
     {"-z", "--swap_interval", OPT_TYPE_INT,      .offset=OFFSET(cfg.swap_interval)},
     {"-c", "--clear_color",   OPT_TYPE_COLOR,    .offset=OFFSET(cfg.clear_color)},
     {"-m", "--samples",       OPT_TYPE_INT,      .offset=OFFSET(cfg.samples)},
+    {"-j", "--jobs",          OPT_TYPE_INT,      .offset=OFFSET(nb_jobs)},
 };
 
 int main(int argc, char *argv[])
@@ -125,6 +449,7 @@ int main(int argc, char *argv[])
         .cfg.offscreen      = 1,
         .cfg.swap_interval  = -1,
         .cfg.clear_color[3] = 1.f,
+        .nb_jobs            = 1,
     };
 
     SDL_Window *window = NULL;
@@ -142,6 +467,16 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+    if (s.nb_jobs < 1) {
+        fprintf(stderr, "The number of jobs must be at least 1\n");
+        return EXIT_FAILURE;
+    }
+
+    if (s.nb_jobs > 1 && !s.cfg.offscreen) {
+        fprintf(stderr, "Parallel rendering is only supported offscreen\n");
+        return EXIT_FAILURE;
+    }
+
     printf("%s -> %s %dx%d\n", s.input ? s.input : "<stdin>", s.output ? s.output : "-", s.cfg.width, s.cfg.height);
 
     if (!s.cfg.offscreen) {
@@ -157,10 +492,18 @@ int main(int argc, char *argv[])
 
     int fd = -1;
     struct ngl_ctx *ctx = NULL;
-    uint8_t *capture_buffer = NULL;
-    const size_t capture_buffer_size = 4 * s.cfg.width * s.cfg.height;
+    struct frame_sink sink = {.fd = -1, .height = s.cfg.height};
+
+    char *scene_str = NULL;
+    if (!s.input) {
+        scene_str = get_text_file_content(NULL);
+        if (!scene_str) {
+            ret = EXIT_FAILURE;
+            goto end;
+        }
+    }
 
-    struct ngl_scene *scene = get_scene(s.input);
+    struct ngl_scene *scene = get_scene(s.input, scene_str);
     if (!scene) {
         ret = EXIT_FAILURE;
         goto end;
@@ -182,9 +525,17 @@ int main(int argc, char *argv[])
                 goto end;
             }
         }
-        capture_buffer = calloc(1, capture_buffer_size);
-        if (!capture_buffer)
-            goto end;
+        sink.fd = fd;
+    }
+
+    const struct ngl_scene_params *params = ngl_scene_get_params(scene);
+    get_viewport(s.cfg.width, s.cfg.height, params->aspect_ratio, s.cfg.viewport);
+
+    if (s.nb_jobs > 1) {
+        /* Every job deserializes its own scene from the same input */
+        ngl_scene_freep(&scene);
+        ret = render_parallel(&s, scene_str, fd);
+        goto end;
     }
 
     ctx = ngl_create();
@@ -193,9 +544,12 @@ int main(int argc, char *argv[])
         goto end;
     }
 
-    const struct ngl_scene_params *params = ngl_scene_get_params(scene);
-    get_viewport(s.cfg.width, s.cfg.height, params->aspect_ratio, s.cfg.viewport);
-    s.cfg.capture_buffer = capture_buffer;
+    if (fd != -1) {
+        /* Frames are written directly from the mapped staging memory */
+        s.cfg.on_frame = on_frame;
+        s.cfg.on_frame_opaque = &sink;
+        s.cfg.capture_async = 1;
+    }
 
     if (!s.cfg.offscreen) {
         ret = wsi_set_ngl_config(&s.cfg, window);
@@ -218,6 +572,7 @@ int main(int argc, char *argv[])
 
     for (size_t i = 0; i < s.nb_ranges; i++) {
         size_t k = 0;
+        size_t nb_frames_in_flight = 0;
         const struct range *r = &s.ranges[i];
         const float t0 = r->start;
         const float t1 = r->start + r->duration;
@@ -231,18 +586,22 @@ int main(int argc, char *argv[])
             if (s.debug)
                 printf("draw @ t=%f [range %zu/%zu: %g-%g @ %dHz]\n",
                        t, i + 1, s.nb_ranges, t0, t1, r->freq);
-            ret = ngl_draw(ctx, t);
+            /*
+             * Keep up to NGL_MAX_FRAMES_IN_FLIGHT frames queued so that the
+             * output of a frame is written while the next ones are rendered
+             */
+            if (nb_frames_in_flight == NGL_MAX_FRAMES_IN_FLIGHT) {
+                ret = wait_frame(ctx, &sink);
+                if (ret)
+                    goto end;
+                nb_frames_in_flight--;
+            }
+            ret = ngl_draw_async(ctx, t, NULL);
             if (ret < 0) {
                 fprintf(stderr, "Unable to draw @ t=%g\n", t);
                 goto end;
             }
-            if (capture_buffer) {
-                const size_t n = write(fd, capture_buffer, capture_buffer_size);
-                if (n != capture_buffer_size) {
-                    fprintf(stderr, "unable to write capture buffer to output\n");
-                    goto end;
-                }
-            }
+            nb_frames_in_flight++;
             if (!s.cfg.offscreen) {
                 SDL_Event event;
                 while (SDL_PollEvent(&event)) {
@@ -252,17 +611,23 @@ int main(int argc, char *argv[])
             k++;
         }
 
+        for (; nb_frames_in_flight > 0; nb_frames_in_flight--) {
+            ret = wait_frame(ctx, &sink);
+            if (ret)
+                goto end;
+        }
+
         const double tdiff = (double)(gettime_relative() - start) / 1000000.;
         printf("Rendered %zu frames in %g (FPS=%g)\n", k, tdiff, (double)k / tdiff);
     }
 
 end:
     ngl_freep(&ctx);
+    free(scene_str);
 
     if (fd != -1)
         close(fd);
 
-    free(capture_buffer);
     free(s.ranges);
 
     if (!s.cfg.offscreen) {
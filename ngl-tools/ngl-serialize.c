@@ -55,7 +55,7 @@ int main(int argc, char *argv[])
     int ret = 0;
 
     if (argc != 4) {
-        fprintf(stderr, "Usage: %s <module> <scene_func> <output.ngl>\n", argv[0]);
+        fprintf(stderr, "Usage: %s <module> <scene_func> <output.ngl|output.nglb>\n", argv[0]);
         return 0;
     }
 
@@ -69,15 +69,28 @@ int main(int argc, char *argv[])
         goto end;
     }
 
-    char *serialized_scene = ngl_scene_serialize(scene);
+    /* The output format is selected from the extension of the output file */
+    const size_t olen = strlen(argv[3]);
+    const int binary = olen > 5 && !strcmp(argv[3] + olen - 5, ".nglb");
+
+    void *serialized_scene = NULL;
+    size_t slen = 0;
+    if (binary) {
+        if (ngl_scene_serialize_binary(scene, &serialized_scene, &slen) < 0)
+            serialized_scene = NULL;
+    } else {
+        serialized_scene = ngl_scene_serialize(scene);
+        if (serialized_scene)
+            slen = strlen(serialized_scene);
+    }
     ngl_scene_freep(&scene);
     if (!serialized_scene) {
         ret = EXIT_FAILURE;
         goto end;
     }
 
-    const size_t slen = strlen(serialized_scene);
     const size_t n = fwrite(serialized_scene, 1, slen, of);
+    free(serialized_scene);
     if (n != slen) {
         ret = EXIT_FAILURE;
         goto end;
@@ -168,7 +168,7 @@ def _export_worker(
         reader = subprocess.Popen(cmd, pass_fds=(fd_r,))
     os.close(fd_r)
 
-    capture_buffer = bytearray(width * height * 4)
+    capture_buffers = [bytearray(width * height * 4) for _ in range(ngl.MAX_FRAMES_IN_FLIGHT)]
 
     ctx = ngl.Context()
     ctx.configure(
@@ -181,18 +181,22 @@ def _export_worker(
             viewport=get_viewport(width, height, scene.aspect_ratio),
             samples=samples,
             clear_color=scene_info.clear_color,
-            capture_buffer=capture_buffer,
+            capture_async=True,
         )
     )
     ctx.set_scene(scene)
 
-    # Draw every frame
+    # Draw every frame, keeping several of them in flight so that the readback
+    # and the write of a frame overlap with the rendering of the next ones
     nb_frame = int(duration * fps[0] / fps[1])
-    for i in range(nb_frame):
-        time = i * fps[1] / float(fps[0])
-        ctx.draw(time)
-        os.write(fd_w, capture_buffer)
-        yield i * 100 / nb_frame
+    for i in range(nb_frame + ngl.MAX_FRAMES_IN_FLIGHT):
+        if i >= ngl.MAX_FRAMES_IN_FLIGHT:
+            ctx.wait_frame()
+            os.write(fd_w, capture_buffers[i % ngl.MAX_FRAMES_IN_FLIGHT])
+        if i < nb_frame:
+            time = i * fps[1] / float(fps[0])
+            ctx.draw_async(time, capture_buffers[i % ngl.MAX_FRAMES_IN_FLIGHT])
+            yield i * 100 / nb_frame
     yield 100
 
     os.close(fd_w)
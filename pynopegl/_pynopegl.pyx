@@ -21,6 +21,7 @@
 #
 
 from cpython cimport array
+from cpython.bytes cimport PyBytes_FromStringAndSize
 from libc.stdint cimport int32_t, uint8_t, uint32_t, uintptr_t
 from libc.stdlib cimport calloc, free
 from libc.string cimport memset
@@ -66,6 +67,7 @@ cdef extern from "nopegl.h":
     int ngl_node_param_set_vec3(ngl_node *node, const char *key, const float *value)
     int ngl_node_param_set_vec4(ngl_node *node, const char *key, const float *value)
     int ngl_anim_evaluate(ngl_node *anim, void *dst, double t)
+    int ngl_anim_evaluate_batch(ngl_node *anim, const double *ts, size_t nb_ts, void *dst)
 
     cdef int NGL_PLATFORM_AUTO
     cdef int NGL_PLATFORM_XLIB
@@ -99,6 +101,17 @@ cdef extern from "nopegl.h":
     cdef int NGL_CAP_MAX_TEXTURE_DIMENSION_CUBE
     cdef int NGL_CAP_TEXT_LIBRARIES
 
+    cdef int NGL_CAPTURE_FORMAT_RGBA
+    cdef int NGL_CAPTURE_FORMAT_NV12
+    cdef int NGL_CAPTURE_FORMAT_I420
+    cdef int NGL_CAPTURE_FORMAT_P010
+
+    cdef int NGL_CAPTURE_COLORSPACE_BT709
+    cdef int NGL_CAPTURE_COLORSPACE_BT601
+    cdef int NGL_CAPTURE_COLORSPACE_BT2020
+
+    cdef int NGL_MAX_FRAMES_IN_FLIGHT
+
     cdef struct ngl_cap:
         unsigned id
         const char *string_id
@@ -125,7 +138,9 @@ cdef extern from "nopegl.h":
     int ngl_scene_init(ngl_scene *s, const ngl_scene_params *params)
     const ngl_scene_params *ngl_scene_get_params(const ngl_scene *s)
     int ngl_scene_init_from_str(ngl_scene *s, const char *str)
+    int ngl_scene_init_from_file(ngl_scene *s, const char *filename)
     char *ngl_scene_serialize(const ngl_scene *scene)
+    int ngl_scene_serialize_binary(const ngl_scene *scene, void **datap, size_t *sizep)
     char *ngl_scene_dot(const ngl_scene *scene)
     void ngl_scene_freep(ngl_scene **sp)
 
@@ -151,11 +166,19 @@ cdef extern from "nopegl.h":
         float clear_color[4]
         void *capture_buffer
         int capture_buffer_type
+        int capture_format
+        int capture_colorspace
+        int capture_async
         int hud
         int hud_measure_window
         int hud_refresh_rate[2]
         const char *hud_export_filename
         int hud_scale
+        const char *cache_dir
+        int update_threads
+        int bake_animations
+        int dedup_nodes
+        int disable_batching
 
     cdef union ngl_livectl_data:
         float f[4]
@@ -183,6 +206,8 @@ cdef extern from "nopegl.h":
     int ngl_set_capture_buffer(ngl_ctx *s, void *capture_buffer)
     int ngl_set_scene(ngl_ctx *s, ngl_scene *scene)
     int ngl_draw(ngl_ctx *s, double t) nogil
+    int ngl_draw_async(ngl_ctx *s, double t, void *capture_buffer)
+    int ngl_wait_frame(ngl_ctx *s, void **capture_bufferp) nogil
     char *ngl_dot(ngl_ctx *s, double t) nogil
     int ngl_livectls_get(ngl_scene *scene, size_t *nb_livectlsp, ngl_livectl **livectlsp)
     void ngl_livectls_freep(ngl_livectl **livectlsp)
@@ -229,6 +254,15 @@ CAP_MAX_TEXTURE_DIMENSION_3D       = NGL_CAP_MAX_TEXTURE_DIMENSION_3D
 CAP_MAX_TEXTURE_DIMENSION_CUBE     = NGL_CAP_MAX_TEXTURE_DIMENSION_CUBE
 CAP_TEXT_LIBRARIES                 = NGL_CAP_TEXT_LIBRARIES
 
+CAPTURE_FORMAT_RGBA = NGL_CAPTURE_FORMAT_RGBA
+CAPTURE_FORMAT_NV12 = NGL_CAPTURE_FORMAT_NV12
+CAPTURE_FORMAT_I420 = NGL_CAPTURE_FORMAT_I420
+CAPTURE_FORMAT_P010 = NGL_CAPTURE_FORMAT_P010
+
+CAPTURE_COLORSPACE_BT709  = NGL_CAPTURE_COLORSPACE_BT709
+CAPTURE_COLORSPACE_BT601  = NGL_CAPTURE_COLORSPACE_BT601
+CAPTURE_COLORSPACE_BT2020 = NGL_CAPTURE_COLORSPACE_BT2020
+
 LOG_VERBOSE = NGL_LOG_VERBOSE
 LOG_DEBUG   = NGL_LOG_DEBUG
 LOG_INFO    = NGL_LOG_INFO
@@ -236,6 +270,8 @@ LOG_WARNING = NGL_LOG_WARNING
 LOG_ERROR   = NGL_LOG_ERROR
 LOG_QUIET   = NGL_LOG_QUIET
 
+MAX_FRAMES_IN_FLIGHT = NGL_MAX_FRAMES_IN_FLIGHT
+
 cdef _ret_pystr(char *s):
     try:
         pystr = <bytes>s
@@ -377,6 +413,32 @@ cdef class _Node:
         ngl_anim_evaluate(self.ctx, vec, t)
         return (vec[0], vec[1], vec[2], vec[3])
 
+    def _eval_batch(self, times, size_t nb_comps):
+        cdef size_t nb_times = len(times)
+        if nb_times == 0:
+            return []
+        times_c = <double *>calloc(nb_times, sizeof(double))
+        if times_c is NULL:
+            raise MemoryError()
+        values_c = <float *>calloc(nb_times * nb_comps, sizeof(float))
+        if values_c is NULL:
+            free(times_c)
+            raise MemoryError()
+        cdef size_t i
+        for i, t in enumerate(times):
+            times_c[i] = t
+        ret = ngl_anim_evaluate_batch(self.ctx, times_c, nb_times, values_c)
+        free(times_c)
+        if ret < 0:
+            free(values_c)
+            raise Exception("Error evaluating the animation")
+        if nb_comps == 1:
+            values = [values_c[i] for i in range(nb_times)]
+        else:
+            values = [tuple([values_c[i * nb_comps + j] for j in range(nb_comps)]) for i in range(nb_times)]
+        free(values_c)
+        return values
+
     def _param_add_f64s(self, const char *key, size_t nb_f64s, f64s):
         f64s_c = <double *>calloc(nb_f64s, sizeof(double))
         if f64s_c is NULL:
@@ -562,9 +624,34 @@ cdef class Scene:
         scene.root = _Node(ctx=<uintptr_t>params.root)
         return scene
 
+    @classmethod
+    def from_file(cls, const char *filename):
+        scene = cls()
+        cdef uintptr_t sptr = scene.cptr
+        cdef ngl_scene *scenep = <ngl_scene *>sptr
+        cdef int ret = ngl_scene_init_from_file(scenep, filename)
+        if ret < 0:
+            raise Exception(f"unable to load scene from {filename}")
+        cdef const ngl_scene_params *params = ngl_scene_get_params(scenep);
+        # FIXME: this is limited because the node won't even have set_label()
+        scene.root = _Node(ctx=<uintptr_t>params.root)
+        return scene
+
     def serialize(self):
         return _ret_pystr(ngl_scene_serialize(self.ctx))
 
+    def serialize_binary(self):
+        cdef void *data = NULL
+        cdef size_t size = 0
+        cdef int ret = ngl_scene_serialize_binary(self.ctx, &data, &size)
+        if ret < 0:
+            raise MemoryError()
+        try:
+            pybytes = PyBytes_FromStringAndSize(<char *>data, size)
+        finally:
+            free(data)
+        return pybytes
+
     def dot(self):
         return _ret_pystr(ngl_scene_dot(self.ctx))
 
@@ -632,11 +719,19 @@ cdef class Config:
         clear_color,
         capture_buffer,
         capture_buffer_type,
+        capture_format,
+        capture_colorspace,
+        capture_async,
         hud,
         hud_measure_window,
         hud_refresh_rate,
         hud_export_filename,
         hud_scale,
+        cache_dir,
+        update_threads,
+        bake_animations,
+        dedup_nodes,
+        disable_batching,
     ):
         self.config.platform = platform.value
         self.config.backend = backend.value
@@ -659,6 +754,9 @@ cdef class Config:
         if capture_buffer is not None:
             self.config.capture_buffer = <uint8_t *>capture_buffer
         self.config.capture_buffer_type = capture_buffer_type
+        self.config.capture_format = capture_format.value
+        self.config.capture_colorspace = capture_colorspace.value
+        self.config.capture_async = capture_async
         self.config.hud = hud
         self.config.hud_measure_window = hud_measure_window
         self.config.hud_refresh_rate[0] = hud_refresh_rate[0]
@@ -666,6 +764,12 @@ cdef class Config:
         if hud_export_filename is not None:
             self.config.hud_export_filename = hud_export_filename
         self.config.hud_scale = hud_scale
+        if cache_dir is not None:
+            self.config.cache_dir = cache_dir
+        self.config.update_threads = update_threads
+        self.config.bake_animations = bake_animations
+        self.config.dedup_nodes = dedup_nodes
+        self.config.disable_batching = disable_batching
 
     @property
     def cptr(self):
@@ -675,14 +779,17 @@ cdef class Config:
 cdef class Context:
     cdef ngl_ctx *ctx
     cdef object capture_buffer
+    cdef list async_capture_buffers
 
     def __cinit__(self):
         self.ctx = ngl_create()
         if self.ctx is NULL:
             raise MemoryError()
+        self.async_capture_buffers = []
 
     def configure(self, py_config):
         self.capture_buffer = py_config.capture_buffer
+        self.async_capture_buffers = []
         cdef uintptr_t ptr = py_config.cptr
         cdef ngl_config *configp = <ngl_config *>ptr
         return ngl_configure(self.ctx, configp)
@@ -734,6 +841,25 @@ cdef class Context:
             ret = ngl_draw(self.ctx, t)
         return ret
 
+    def draw_async(self, double t, capture_buffer=None):
+        cdef uint8_t *ptr = NULL
+        if capture_buffer is not None:
+            ptr = <uint8_t *>capture_buffer
+        ret = ngl_draw_async(self.ctx, t, ptr)
+        if ret == 0:
+            # Keep the buffers alive until their frame is retrieved and while
+            # they remain the current context capture buffer
+            self.async_capture_buffers.append(capture_buffer)
+            self.capture_buffer = capture_buffer
+        return ret
+
+    def wait_frame(self):
+        with nogil:
+            ret = ngl_wait_frame(self.ctx, NULL)
+        if self.async_capture_buffers:
+            self.async_capture_buffers.pop(0)
+        return ret
+
     def dot(self, double t):
         cdef char *s
         with nogil:
@@ -86,6 +86,19 @@ class Cap(IntEnum):
     TEXT_LIBRARIES                 = _ngl.CAP_TEXT_LIBRARIES
 
 
+class CaptureFormat(IntEnum):
+    RGBA = _ngl.CAPTURE_FORMAT_RGBA
+    NV12 = _ngl.CAPTURE_FORMAT_NV12
+    I420 = _ngl.CAPTURE_FORMAT_I420
+    P010 = _ngl.CAPTURE_FORMAT_P010
+
+
+class CaptureColorspace(IntEnum):
+    BT709  = _ngl.CAPTURE_COLORSPACE_BT709
+    BT601  = _ngl.CAPTURE_COLORSPACE_BT601
+    BT2020 = _ngl.CAPTURE_COLORSPACE_BT2020
+
+
 class Log(IntEnum):
     VERBOSE = _ngl.LOG_VERBOSE
     DEBUG   = _ngl.LOG_DEBUG
@@ -95,6 +108,8 @@ class Log(IntEnum):
     QUIET   = _ngl.LOG_QUIET
 # fmt: on
 
+MAX_FRAMES_IN_FLIGHT = _ngl.MAX_FRAMES_IN_FLIGHT
+
 
 def log_set_min_level(level: Log):
     return _ngl.log_set_min_level(level.value)
@@ -123,11 +138,19 @@ class Config(_ngl.Config):
         clear_color: Tuple[float, float, float, float] = (0.0, 0.0, 0.0, 1.0),
         capture_buffer: Optional[bytearray] = None,
         # capture_buffer_type: int = 0,
+        capture_format: CaptureFormat = CaptureFormat.RGBA,
+        capture_colorspace: CaptureColorspace = CaptureColorspace.BT709,
+        capture_async: bool = False,
         hud: bool = False,
         hud_measure_window: int = 0,
         hud_refresh_rate: Tuple[int, int] = (0, 0),
         hud_export_filename: Optional[str] = None,
         hud_scale: int = 0,
+        cache_dir: Optional[str] = None,
+        update_threads: int = 0,
+        bake_animations: bool = False,
+        dedup_nodes: bool = False,
+        disable_batching: bool = False,
     ):
         self.capture_buffer = capture_buffer
         super().__init__(
@@ -146,11 +169,19 @@ class Config(_ngl.Config):
             clear_color,
             capture_buffer,
             0,
+            capture_format,
+            capture_colorspace,
+            capture_async,
             hud,
             hud_measure_window,
             hud_refresh_rate,
             hud_export_filename,
             hud_scale,
+            cache_dir,
+            update_threads,
+            bake_animations,
+            dedup_nodes,
+            disable_batching,
         )
 
 
@@ -238,9 +269,16 @@ class Scene(_ngl.Scene):
     def from_string(cls, s: Union[str, bytes]):
         return super().from_string(s)
 
+    @classmethod
+    def from_file(cls, filename: str):
+        return super().from_file(filename)
+
     def serialize(self) -> bytes:
         return super().serialize()
 
+    def serialize_binary(self) -> bytes:
+        return super().serialize_binary()
+
     def dot(self) -> bytes:
         return super().dot()
 
@@ -270,6 +308,12 @@ class Context(_ngl.Context):
     def draw(self, t: float) -> int:
         return super().draw(t)
 
+    def draw_async(self, t: float, capture_buffer: Optional[bytearray] = None) -> int:
+        return super().draw_async(t, capture_buffer)
+
+    def wait_frame(self) -> int:
+        return super().wait_frame()
+
     def dot(self, t: float) -> Optional[str]:
         return super().dot(t)
 
@@ -217,6 +217,7 @@ class _WrapperGenerator:
             AnimatedVec3="vec3",
             AnimatedVec4="vec4",
             AnimatedQuat="vec4",
+            AnimatedColor="vec3",
             VelocityFloat="f32",
             VelocityVec2="vec2",
             VelocityVec3="vec3",
@@ -227,10 +228,14 @@ class _WrapperGenerator:
         if not eval_type:
             return ""
         ret_type = cls._TYPING_MAP[eval_type]
+        nb_comps = dict(f32=1, vec2=2, vec3=3, vec4=4)[eval_type]
         return textwrap.dedent(
             f"""
             def evaluate(self, t: float) -> {ret_type}:
                 return self._eval_{eval_type}(t)
+
+            def evaluate_batch(self, times: Sequence[float]) -> List[{ret_type}]:
+                return self._eval_batch(times, {nb_comps})
             """
         )
 
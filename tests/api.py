@@ -43,6 +43,32 @@ def _get_scene(geometry=None):
     return ngl.Scene.from_params(ngl.RenderColor(geometry=ngl.Quad() if geometry is None else geometry))
 
 
+def _get_frame_crcs(scene, times, width, height, **config_params):
+    """Render the scene offscreen at the specified times and return the CRC of each captured frame"""
+    import zlib
+
+    capture_buffer = bytearray(width * height * 4)
+    ctx = ngl.Context()
+    ret = ctx.configure(
+        ngl.Config(
+            offscreen=True,
+            width=width,
+            height=height,
+            backend=_backend,
+            capture_buffer=capture_buffer,
+            **config_params,
+        )
+    )
+    assert ret == 0
+    assert ctx.set_scene(scene) == 0
+    crcs = []
+    for t in times:
+        assert ctx.draw(t) == 0
+        crcs.append(zlib.crc32(capture_buffer))
+    del ctx
+    return crcs
+
+
 def api_backend():
     ctx = ngl.Context()
     fake_backend_cls = namedtuple("FakeBackend", "value")
@@ -188,6 +214,354 @@ def api_capture_buffer_lifetime(width=1024, height=1024):
     del ctx
 
 
+def api_draw_async(width=16, height=16, capture_async=False):
+    import zlib
+
+    ctx = ngl.Context()
+    ret = ctx.configure(
+        ngl.Config(offscreen=True, width=width, height=height, backend=_backend, capture_async=capture_async)
+    )
+    assert ret == 0
+    scene = _get_scene()
+    assert ctx.set_scene(scene) == 0
+    assert ctx.wait_frame() != 0
+    capture_buffers = [bytearray(width * height * 4) for _ in range(3)]
+    for capture_buffer in capture_buffers:
+        assert ctx.draw_async(0, capture_buffer) == 0
+    assert ctx.draw_async(0, None) != 0
+    for capture_buffer in capture_buffers:
+        assert ctx.wait_frame() == 0
+        assert zlib.crc32(capture_buffer) == 0xB4BD32FA
+    assert ctx.wait_frame() != 0
+    del ctx
+
+
+def api_draw_async_capture_async():
+    api_draw_async(capture_async=True)
+
+
+def api_draw_async_order(width=16, height=16):
+    import zlib
+
+    colors = [(1, 0, 0), (0, 1, 0), (0, 0, 1), (1, 1, 0), (0, 1, 1), (1, 0, 1), (1, 1, 1), (0, 0, 0)]
+    animkf = [ngl.AnimKeyFrameColor(i, color) for i, color in enumerate(colors)]
+    scene = ngl.Scene.from_params(ngl.RenderColor(color=ngl.AnimatedColor(animkf)), duration=len(colors))
+
+    # Reference captures, drawn synchronously
+    crcs = _get_frame_crcs(scene, range(len(colors)), width, height)
+    assert len(set(crcs)) == len(crcs)
+
+    # Keep the maximum number of frames in flight so the staging buffers of
+    # the asynchronous captures are reused several times
+    ctx = ngl.Context()
+    ret = ctx.configure(ngl.Config(offscreen=True, width=width, height=height, backend=_backend, capture_async=True))
+    assert ret == 0
+    assert ctx.set_scene(scene) == 0
+    capture_buffers = [bytearray(width * height * 4) for _ in colors]
+    nb_in_flight = 3
+    for i in range(nb_in_flight):
+        assert ctx.draw_async(i, capture_buffers[i]) == 0
+    for i in range(len(colors)):
+        assert ctx.wait_frame() == 0
+        assert zlib.crc32(capture_buffers[i]) == crcs[i]
+        if i + nb_in_flight < len(colors):
+            assert ctx.draw_async(i + nb_in_flight, capture_buffers[i + nb_in_flight]) == 0
+    assert ctx.wait_frame() != 0
+    del ctx
+
+
+def _create_egl_context(es):
+    import ctypes
+
+    EGL_NONE = 0x3038
+    EGL_SURFACE_TYPE = 0x3033
+    EGL_PBUFFER_BIT = 0x0001
+    EGL_RENDERABLE_TYPE = 0x3040
+    EGL_OPENGL_BIT = 0x0008
+    EGL_OPENGL_ES3_BIT = 0x0040
+    EGL_OPENGL_API = 0x30A2
+    EGL_OPENGL_ES_API = 0x30A0
+    EGL_CONTEXT_MAJOR_VERSION = 0x3098
+    EGL_CONTEXT_MINOR_VERSION = 0x30FB
+    EGL_CONTEXT_OPENGL_PROFILE_MASK = 0x30FD
+    EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT = 0x0001
+    EGL_PLATFORM_SURFACELESS_MESA = 0x31DD
+
+    egl = ctypes.CDLL("libEGL.so.1")
+    egl.eglGetProcAddress.restype = ctypes.c_void_p
+    egl.eglGetProcAddress.argtypes = [ctypes.c_char_p]
+    egl.eglGetDisplay.restype = ctypes.c_void_p
+    egl.eglGetDisplay.argtypes = [ctypes.c_void_p]
+    egl.eglInitialize.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p]
+    egl.eglChooseConfig.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int, ctypes.c_void_p]
+    egl.eglCreateContext.restype = ctypes.c_void_p
+    egl.eglCreateContext.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p]
+    egl.eglMakeCurrent.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p]
+    egl.eglDestroyContext.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+    egl.eglTerminate.argtypes = [ctypes.c_void_p]
+
+    get_platform_display_addr = egl.eglGetProcAddress(b"eglGetPlatformDisplayEXT")
+    if get_platform_display_addr:
+        get_platform_display = ctypes.CFUNCTYPE(ctypes.c_void_p, ctypes.c_uint, ctypes.c_void_p, ctypes.c_void_p)(
+            get_platform_display_addr
+        )
+        display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, None, None)
+    else:
+        display = egl.eglGetDisplay(None)
+    assert display
+    assert egl.eglInitialize(display, None, None)
+
+    config_attribs = (ctypes.c_int * 5)(
+        EGL_SURFACE_TYPE,
+        EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE,
+        EGL_OPENGL_ES3_BIT if es else EGL_OPENGL_BIT,
+        EGL_NONE,
+    )
+    config = ctypes.c_void_p()
+    nb_configs = ctypes.c_int()
+    assert egl.eglChooseConfig(display, config_attribs, ctypes.byref(config), 1, ctypes.byref(nb_configs))
+    assert nb_configs.value == 1
+
+    assert egl.eglBindAPI(EGL_OPENGL_ES_API if es else EGL_OPENGL_API)
+    if es:
+        ctx_attribs = (ctypes.c_int * 3)(EGL_CONTEXT_MAJOR_VERSION, 3, EGL_NONE)
+    else:
+        ctx_attribs = (ctypes.c_int * 7)(
+            EGL_CONTEXT_MAJOR_VERSION,
+            3,
+            EGL_CONTEXT_MINOR_VERSION,
+            3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK,
+            EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE,
+        )
+    context = egl.eglCreateContext(display, config, None, ctx_attribs)
+    assert context
+    assert egl.eglMakeCurrent(display, None, None, context)
+
+    def release():
+        egl.eglMakeCurrent(display, None, None, None)
+        egl.eglDestroyContext(display, context)
+        egl.eglTerminate(display)
+
+    def get_proc(name, restype, *argtypes):
+        addr = egl.eglGetProcAddress(name.encode())
+        assert addr
+        return ctypes.CFUNCTYPE(restype, *argtypes)(addr)
+
+    return get_proc, release
+
+
+def api_gl_external_context(width=16, height=16):
+    import ctypes
+
+    GL_TEXTURE_2D = 0x0DE1
+    GL_RGBA = 0x1908
+    GL_RGBA8 = 0x8058
+    GL_UNSIGNED_BYTE = 0x1401
+    GL_RENDERBUFFER = 0x8D41
+    GL_DEPTH24_STENCIL8 = 0x88F0
+    GL_FRAMEBUFFER = 0x8D40
+    GL_COLOR_ATTACHMENT0 = 0x8CE0
+    GL_DEPTH_STENCIL_ATTACHMENT = 0x821A
+
+    get_proc, release = _create_egl_context(es=_backend == ngl.Backend.OPENGLES)
+
+    uint_p = ctypes.POINTER(ctypes.c_uint)
+    c_uint, c_int = ctypes.c_uint, ctypes.c_int
+    glGenTextures = get_proc("glGenTextures", None, c_int, uint_p)
+    glBindTexture = get_proc("glBindTexture", None, c_uint, c_uint)
+    glTexImage2D = get_proc(
+        "glTexImage2D", None, c_uint, c_int, c_int, c_int, c_int, c_int, c_uint, c_uint, ctypes.c_void_p
+    )
+    glGenRenderbuffers = get_proc("glGenRenderbuffers", None, c_int, uint_p)
+    glBindRenderbuffer = get_proc("glBindRenderbuffer", None, c_uint, c_uint)
+    glRenderbufferStorage = get_proc("glRenderbufferStorage", None, c_uint, c_uint, c_int, c_int)
+    glGenFramebuffers = get_proc("glGenFramebuffers", None, c_int, uint_p)
+    glBindFramebuffer = get_proc("glBindFramebuffer", None, c_uint, c_uint)
+    glFramebufferTexture2D = get_proc("glFramebufferTexture2D", None, c_uint, c_uint, c_uint, c_uint, c_int)
+    glFramebufferRenderbuffer = get_proc("glFramebufferRenderbuffer", None, c_uint, c_uint, c_uint, c_uint)
+    glReadPixels = get_proc("glReadPixels", None, c_int, c_int, c_int, c_int, c_uint, c_uint, ctypes.c_void_p)
+
+    texture, renderbuffer, framebuffer = c_uint(), c_uint(), c_uint()
+    glGenTextures(1, ctypes.byref(texture))
+    glBindTexture(GL_TEXTURE_2D, texture)
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, None)
+    glGenRenderbuffers(1, ctypes.byref(renderbuffer))
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer)
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height)
+    glGenFramebuffers(1, ctypes.byref(framebuffer))
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer)
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0)
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffer)
+
+    # The external context has no capture render target: drawing must not
+    # touch the capture machinery
+    ctx = ngl.Context()
+    config_gl = ngl.ConfigGL(external=True, external_framebuffer=framebuffer.value)
+    ret = ctx.configure(ngl.Config(width=width, height=height, backend=_backend, backend_config=config_gl))
+    assert ret == 0
+    assert ctx.set_scene(ngl.Scene.from_params(ngl.RenderColor(color=(1.0, 0.0, 0.0)))) == 0
+    for i in range(3):
+        assert ctx.draw(i) == 0
+    del ctx
+
+    pixels = bytearray(width * height * 4)
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer)
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (ctypes.c_char * len(pixels)).from_buffer(pixels))
+    assert pixels == bytes((0xFF, 0x00, 0x00, 0xFF)) * (width * height)
+
+    release()
+
+
+def api_capture_format(width=16, height=16):
+    # Pure red in BT.709 limited range: Y=63, Cb=102, Cr=240
+    expected_y, expected_u, expected_v = 63, 102, 240
+    luma_size = width * height
+    chroma_size = luma_size // 4
+
+    for capture_format in (ngl.CaptureFormat.NV12, ngl.CaptureFormat.I420, ngl.CaptureFormat.P010):
+        sample_size = 2 if capture_format == ngl.CaptureFormat.P010 else 1
+        capture_buffer = bytearray(luma_size * 3 // 2 * sample_size)
+        ctx = ngl.Context()
+        ret = ctx.configure(
+            ngl.Config(
+                offscreen=True,
+                width=width,
+                height=height,
+                backend=_backend,
+                capture_buffer=capture_buffer,
+                capture_format=capture_format,
+                capture_colorspace=ngl.CaptureColorspace.BT709,
+            )
+        )
+        assert ret == 0
+        scene = ngl.Scene.from_params(ngl.RenderColor(color=(1.0, 0.0, 0.0)))
+        assert ctx.set_scene(scene) == 0
+        assert ctx.draw(0) == 0
+        del ctx
+
+        if capture_format == ngl.CaptureFormat.P010:
+            samples = [int.from_bytes(capture_buffer[i : i + 2], "little") for i in range(0, len(capture_buffer), 2)]
+            assert all(v & 0x3F == 0 for v in samples)
+            samples = [(v >> 6) >> 2 for v in samples]
+        else:
+            samples = list(capture_buffer)
+
+        luma = samples[:luma_size]
+        chroma = samples[luma_size:]
+        if capture_format == ngl.CaptureFormat.I420:
+            u, v = chroma[:chroma_size], chroma[chroma_size:]
+        else:
+            u, v = chroma[0::2], chroma[1::2]
+        assert all(abs(y - expected_y) <= 1 for y in luma)
+        assert all(abs(c - expected_u) <= 1 for c in u)
+        assert all(abs(c - expected_v) <= 1 for c in v)
+
+    # Unaligned dimensions are rejected
+    ctx = ngl.Context()
+    ret = ctx.configure(
+        ngl.Config(
+            offscreen=True,
+            width=15,
+            height=16,
+            backend=_backend,
+            capture_format=ngl.CaptureFormat.NV12,
+        )
+    )
+    assert ret != 0
+    del ctx
+
+
+def api_update_threads(width=32, height=32):
+    def get_scene():
+        renders = []
+        for i in range(16):
+            animkf = [
+                ngl.AnimKeyFrameColor(0, (1.0, 0.0, 0.0)),
+                ngl.AnimKeyFrameColor(1 + i / 16, (0.0, 1.0, i / 16)),
+            ]
+            opacity = ngl.NoiseFloat(octaves=3, seed=i)
+            geometry = ngl.Quad((-1 + i / 8, -1, 0), (1 / 8, 0, 0), (0, 2, 0))
+            renders.append(
+                ngl.RenderColor(
+                    color=ngl.AnimatedColor(animkf), opacity=opacity, geometry=geometry, blending="src_over"
+                )
+            )
+        return ngl.Scene.from_params(ngl.Group(children=renders), duration=2)
+
+    times = (0.0, 0.5, 1.5, 0.25, 2.0)
+    crcs = [_get_frame_crcs(get_scene(), times, width, height, update_threads=n) for n in (0, 4)]
+    assert crcs[0] == crcs[1]
+
+    ctx = ngl.Context()
+    assert ctx.configure(ngl.Config(offscreen=True, width=16, height=16, backend=_backend, update_threads=-1)) != 0
+    del ctx
+
+
+def api_update_threads_text(width=64, height=64):
+    def get_effect(i):
+        opacity_kf = [ngl.AnimKeyFrameFloat(0, 0.2), ngl.AnimKeyFrameFloat(1, 1)]
+        if i % 2:
+            bounce_kf = [ngl.AnimKeyFrameVec3(0, (0, 0.5, 0)), ngl.AnimKeyFrameVec3(1, (0, 0, 0), "bounce_out")]
+            return ngl.TextEffect(
+                start=0,
+                end=2,
+                target="char",
+                overlap=0.5,
+                opacity=ngl.AnimatedFloat(opacity_kf),
+                transform=ngl.Translate(ngl.Identity(), vector=ngl.AnimatedVec3(bounce_kf)),
+            )
+        color_kf = [ngl.AnimKeyFrameColor(0, (1.0, 0.0, 0.0)), ngl.AnimKeyFrameColor(1, (0.0, 0.0, 1.0))]
+        return ngl.TextEffect(
+            start=0,
+            end=2,
+            target="char",
+            overlap=0.5,
+            opacity=ngl.AnimatedFloat(opacity_kf),
+            color=ngl.AnimatedColor(color_kf),
+        )
+
+    def get_scene():
+        # The path is shared by all the animated paths, each evaluating it
+        # with its own lookup hint
+        path = ngl.Path((ngl.PathKeyMove(to=(-0.5, -0.5, 0)), ngl.PathKeyLine(to=(0.5, 0.5, 0))))
+        shared_effect = get_effect(0)
+        children = []
+        for i in range(8):
+            anim_kf = [ngl.AnimKeyFrameFloat(0, 0), ngl.AnimKeyFrameFloat(1 + i / 8, 1)]
+            # The effect shared by the last texts keeps them on the regular update
+            effects = [shared_effect] if i >= 6 else [get_effect(i)]
+            text = ngl.Text(f"t{i}", box_corner=(-1 + i / 4, -1, 0), box_width=(1 / 4, 0, 0), effects=effects)
+            children.append(ngl.Translate(text, vector=ngl.AnimatedPath(anim_kf, path)))
+        return ngl.Scene.from_params(ngl.Group(children=children), duration=2)
+
+    fd, csvpath = tempfile.mkstemp(suffix=".csv", prefix="ngl-test-hud-")
+    os.close(fd)
+    atexit.register(lambda: os.remove(csvpath))
+
+    # The texts and animated paths are updated on the worker threads and must
+    # render the same as on the rendering thread
+    times = (0.0, 0.5, 1.5, 0.25, 2.0)
+    crcs = []
+    nb_parallel_updates = []
+    for update_threads in (0, 4):
+        crcs.append(
+            _get_frame_crcs(
+                get_scene(), times, width, height, update_threads=update_threads, hud=True, hud_export_filename=csvpath
+            )
+        )
+        with open(csvpath) as csvfile:
+            rows = list(csv.DictReader(csvfile))
+        nb_parallel_updates.append([int(row["Par. updates"]) for row in rows])
+    assert crcs[0] == crcs[1]
+
+    # The 8 animated paths and the 6 texts owning their effects, whose
+    # animations are only evaluated at the effect times by the texts
+    assert nb_parallel_updates == [[0] * len(times), [8 + 6] * len(times)], nb_parallel_updates
+
+
 # Exercise the HUD rasterization. We can't really check the output, so this is
 # just for blind coverage and similar code instrumentalization.
 def api_hud(width=234, height=123):
@@ -233,6 +607,185 @@ def api_hud_csv(width=16, height=16):
     assert time_column == ["0.000000", "0.150000", "0.300000", "0.450000", "1.000000"], time_column
 
 
+def api_buffer_filename(width=16, height=16):
+    import array
+
+    rng = random.Random(0)
+    timestamps = array.array("q", [0, 500000, 1000000, 1500000])
+    colors = array.array("f", [rng.random() for _ in range(len(timestamps) * 2 * 4)])
+
+    fd, datapath = tempfile.mkstemp(suffix=".bin", prefix="ngl-test-buffer-")
+    os.close(fd)
+    atexit.register(lambda: os.remove(datapath))
+    with open(datapath, "wb") as f:
+        colors.tofile(f)
+
+    fd, csvpath = tempfile.mkstemp(suffix=".csv", prefix="ngl-test-hud-")
+    os.close(fd)
+    atexit.register(lambda: os.remove(csvpath))
+
+    vert = """
+void main()
+{
+    ngl_out_pos = ngl_projection_matrix * ngl_modelview_matrix * vec4(ngl_position, 1.0);
+}
+"""
+    frag = """
+void main()
+{
+    ngl_out_color = mix(data.colors[0], data.colors[1], 0.5);
+}
+"""
+
+    def get_scene(buffer):
+        streamed = ngl.StreamedBufferVec4(2, ngl.BufferInt64(data=timestamps), buffer, label="colors")
+        render = ngl.Render(
+            ngl.Quad(),
+            ngl.Program(vertex=vert, fragment=frag),
+            frag_resources=dict(data=ngl.Block(fields=[streamed])),
+        )
+        return ngl.Scene.from_params(render, duration=2)
+
+    times = [0.0, 0.7, 0.2, 1.9, 1.0]
+    crcs = [
+        _get_frame_crcs(get_scene(buffer), times, width, height, hud=True, hud_export_filename=csvpath)
+        for buffer in (ngl.BufferVec4(data=colors), ngl.BufferVec4(filename=datapath))
+    ]
+    assert crcs[0] == crcs[1]
+
+    # The file backed buffer is mapped, not allocated
+    with open(csvpath) as csvfile:
+        rows = list(csv.DictReader(csvfile))
+    mapped_size = str(len(colors) * colors.itemsize)
+    assert all(row["Buf. mapped memory"] == mapped_size for row in rows), rows
+    assert all(int(row["Buf. resident memory"]) <= int(mapped_size) for row in rows), rows
+
+
+def api_dedup_nodes(width=16, height=16):
+    import array
+
+    vert = """
+void main()
+{
+    ngl_out_pos = ngl_projection_matrix * ngl_modelview_matrix * vec4(ngl_position, 1.0);
+    uv = ngl_uvcoord;
+}
+"""
+    frag = """
+void main()
+{
+    ngl_out_color = ngl_texvideo(tex, uv);
+}
+"""
+    pixels = array.array("B", [0xFF, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF] * 2)
+
+    def get_scene():
+        # Every branch is built from distinct but identical nodes
+        renders = []
+        for i in range(4):
+            texture = ngl.Texture2D(width=2, height=2, data_src=ngl.BufferUBVec4(data=pixels))
+            render = ngl.Render(
+                ngl.Quad((-1, -1, 0), (1, 0, 0), (0, 1, 0)),
+                ngl.Program(vertex=vert, fragment=frag, vert_out_vars=dict(uv=ngl.IOVec2())),
+                frag_resources=dict(tex=texture),
+            )
+            renders.append(ngl.Translate(render, vector=(i % 2, i // 2, 0)))
+        return ngl.Scene.from_params(ngl.Group(children=renders))
+
+    fd, csvpath = tempfile.mkstemp(suffix=".csv", prefix="ngl-test-hud-")
+    os.close(fd)
+    atexit.register(lambda: os.remove(csvpath))
+
+    crcs = []
+    tex_memory = []
+    for dedup_nodes in (False, True):
+        scene = get_scene()
+        serialized_scene = scene.serialize()
+        crcs.append(
+            _get_frame_crcs(scene, [0], width, height, dedup_nodes=dedup_nodes, hud=True, hud_export_filename=csvpath)
+        )
+
+        # The nodes are only merged within the context, the graph of the user is left untouched
+        assert scene.serialize() == serialized_scene
+
+        with open(csvpath) as csvfile:
+            rows = list(csv.DictReader(csvfile))
+        tex_memory.append(int(rows[-1]["Textures memory"]))
+    assert crcs[0] == crcs[1]
+
+    # Only one of the 4 identical textures is allocated
+    assert tex_memory == [4 * len(pixels), len(pixels)], tex_memory
+
+
+def api_disable_batching(width=32, height=32):
+    def get_scene():
+        geometry = ngl.Quad((-1, -1, 0), (0.5, 0, 0), (0, 0.5, 0))
+        renders = []
+        for i in range(16):
+            animkf = [
+                ngl.AnimKeyFrameColor(0, (1.0, i / 16, 0.0)),
+                ngl.AnimKeyFrameColor(1, (0.0, 1.0 - i / 16, 1.0)),
+            ]
+            render = ngl.RenderColor(
+                color=ngl.AnimatedColor(animkf), opacity=0.75, geometry=geometry, blending="src_over"
+            )
+            renders.append(ngl.Translate(render, vector=(i % 4 * 0.5, i // 4 * 0.5, 0)))
+        return ngl.Scene.from_params(ngl.Group(children=renders), duration=1)
+
+    # The batched and individual draws must render the same frames
+    times = (0.0, 0.25, 1.0)
+    crcs = [_get_frame_crcs(get_scene(), times, width, height, disable_batching=d) for d in (False, True)]
+    assert crcs[0] == crcs[1]
+
+
+def api_uniform_ring_growth(width=32, height=32):
+    """
+    Draw one cell per pixel, each with its own animated color, so that the
+    uniform blocks of a frame overflow the uniform ring once the time range
+    enabling most of the cells is entered. The ring grows in the middle of the
+    timeline and its previous buffers are retired while the next frames keep
+    reading their own slices.
+    """
+    palette = ((1, 0, 0), (0, 1, 0), (0, 0, 1), (1, 1, 0), (1, 0, 1), (0, 1, 1), (1, 1, 1))
+    nb_frames = 8
+    nb_static = 64
+    start = 2
+
+    renders = []
+    for i in range(width * height):
+        x, y = i % width, i // width
+        geometry = ngl.Quad((-1 + 2 * x / width, -1 + 2 * y / height, 0), (2 / width, 0, 0), (0, 2 / height, 0))
+        animkf = [ngl.AnimKeyFrameColor(t, palette[(i + t) % len(palette)]) for t in range(nb_frames)]
+        renders.append(ngl.RenderColor(color=ngl.AnimatedColor(animkf), geometry=geometry))
+    static = ngl.Group(children=renders[:nb_static])
+    trf = ngl.TimeRangeFilter(ngl.Group(children=renders[nb_static:]), start=start)
+    scene = ngl.Scene.from_params(ngl.Group(children=(static, trf)), duration=nb_frames)
+
+    ctx = ngl.Context()
+    capture_buffer = bytearray(width * height * 4)
+    ret = ctx.configure(
+        ngl.Config(
+            offscreen=True,
+            width=width,
+            height=height,
+            backend=_backend,
+            capture_buffer=capture_buffer,
+            disable_batching=True,
+        )
+    )
+    assert ret == 0
+    assert ctx.set_scene(scene) == 0
+    for t in range(nb_frames):
+        assert ctx.draw(t) == 0
+        for i in range(width * height):
+            x, y = i % width, i // width
+            visible = i < nb_static or t >= start
+            expected = palette[(i + t) % len(palette)] if visible else (0, 0, 0)
+            pos = ((height - 1 - y) * width + x) * 4
+            pixel = capture_buffer[pos : pos + 3]
+            assert tuple(int(c > 127) for c in pixel) == expected, f"cell {i} at t={t}: {pixel.hex()}"
+
+
 def _api_text_live_change(width=320, height=240, font_files=None):
     import zlib
 
@@ -273,6 +826,107 @@ def api_text_live_change_with_font():
     return _api_text_live_change(font_files=font_files.as_posix())
 
 
+def api_text_shared_atlas(width=320, height=160):
+    font_files = Path(__file__).resolve().parent / "assets" / "fonts" / "Quicksand-Medium.ttf"
+    ctx = ngl.Context()
+    capture_buffer = bytearray(width * height * 4)
+    ret = ctx.configure(
+        ngl.Config(offscreen=True, width=width, height=height, backend=_backend, capture_buffer=capture_buffer)
+    )
+    assert ret == 0
+
+    def get_text(text, x):
+        return ngl.Text(text, font_files=font_files.as_posix(), box_corner=(x, -1, 0), box_width=(1, 0, 0))
+
+    def get_left_half():
+        row_size = width * 4
+        return [capture_buffer[y * row_size : y * row_size + row_size // 2] for y in range(height)]
+
+    # The right text grows the atlas shared with the left one, which must be
+    # laid out again against the new atlas. The glyphs are sampled at another
+    # location of a texture with different dimensions so a slight difference
+    # is tolerated.
+    left = get_text("hello", -1)
+    right = get_text("world", 0)
+    assert ctx.set_scene(ngl.Scene.from_params(ngl.Group(children=(left, right)))) == 0
+    assert ctx.draw(0) == 0
+    ref_rows = get_left_half()
+    right.set_text("The quick brown fox JUMPS over 1234567890")
+    assert ctx.draw(1) == 0
+    for ref_row, row in zip(ref_rows, get_left_half()):
+        assert max(abs(a - b) for a, b in zip(ref_row, row)) <= 32
+
+
+def api_text_scene_change(width=320, height=160):
+    import zlib
+
+    font_files = Path(__file__).resolve().parent / "assets" / "fonts" / "Quicksand-Medium.ttf"
+    ctx = ngl.Context()
+    capture_buffer = bytearray(width * height * 4)
+    ret = ctx.configure(
+        ngl.Config(offscreen=True, width=width, height=height, backend=_backend, capture_buffer=capture_buffer)
+    )
+    assert ret == 0
+
+    # The glyphs of a previous scene must not remain in the atlas: the same
+    # scene must render identically whatever was set before it
+    crcs = []
+    for text in ("hello", "ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz", "hello"):
+        assert ctx.set_scene(ngl.Scene.from_params(ngl.Text(text, font_files=font_files.as_posix()))) == 0
+        assert ctx.draw(0) == 0
+        crcs.append(zlib.crc32(capture_buffer))
+    assert crcs[0] == crcs[2]
+
+
+def api_text_shaping_cache(width=320, height=160):
+    font_files = Path(__file__).resolve().parent / "assets" / "fonts" / "Quicksand-Medium.ttf"
+    ctx = ngl.Context()
+    capture_buffer = bytearray(width * height * 4)
+    ret = ctx.configure(
+        ngl.Config(offscreen=True, width=width, height=height, backend=_backend, capture_buffer=capture_buffer)
+    )
+    assert ret == 0
+
+    def get_text(text):
+        return ngl.Text(text, font_files=font_files.as_posix())
+
+    def get_fresh_frame(text):
+        fresh_buffer = bytearray(width * height * 4)
+        fresh_ctx = ngl.Context()
+        ret = fresh_ctx.configure(
+            ngl.Config(offscreen=True, width=width, height=height, backend=_backend, capture_buffer=fresh_buffer)
+        )
+        assert ret == 0
+        assert fresh_ctx.set_scene(ngl.Scene.from_params(get_text(text))) == 0
+        assert fresh_ctx.draw(0) == 0
+        del fresh_ctx
+        return fresh_buffer
+
+    # The glyphs are not laid out at the same location of the atlas as in a
+    # fresh render, so a slight difference is tolerated
+    def check_frame(text, ref_frames):
+        if text not in ref_frames:
+            ref_frames[text] = get_fresh_frame(text)
+        ref_frame = ref_frames[text]
+        assert max(abs(a - b) for a, b in zip(ref_frame, capture_buffer)) <= 32, f"text {text!r} differs"
+
+    # Alternating between a few values hits the shaping cache from the second
+    # round; the distinct strings pushed in between exceed the cache size
+    # (64 entries) so the next rounds have to shape the values again
+    values = ["hello", "world", "12:34"]
+    distinct = [f"frame {i}" for i in range(80)]
+    ref_frames = {}
+    text_node = get_text(values[0])
+    assert ctx.set_scene(ngl.Scene.from_params(text_node)) == 0
+    t = 0
+    for strings in (values * 2, distinct, values * 2):
+        for text in strings:
+            text_node.set_text(text)
+            assert ctx.draw(t) == 0
+            check_frame(text, ref_frames)
+            t += 1
+
+
 def _ret_to_fourcc(ret):
     if ret >= 0:
         return None
@@ -490,6 +1144,24 @@ def api_trf_seek_keep_alive(width=320, height=240):
     assert ctx.draw(end) == 0
 
 
+def api_static_subtree_prefetch(width=32, height=32):
+    """
+    Render a static subtree shared by two time ranges: it is skipped once
+    updated, released in between the two ranges, and must be updated again
+    once prefetched.
+    """
+    texture = ngl.Texture2D(width=16, height=16)
+    rtt = ngl.RenderToTexture(ngl.RenderColor((1.0, 0.5, 0.0)), color_textures=(texture,))
+    static = ngl.Group(children=(rtt, ngl.RenderTexture(texture)))
+    trf0 = ngl.TimeRangeFilter(static, start=0, end=1)
+    trf1 = ngl.TimeRangeFilter(static, start=5, end=6)
+    scene = ngl.Scene.from_params(ngl.Group(children=(trf0, trf1)), duration=10)
+
+    crcs = _get_frame_crcs(scene, (0.5, 0.75, 3.0, 5.5, 5.75), width, height)
+    assert crcs[0] == crcs[1] == crcs[3] == crcs[4]
+    assert crcs[2] != crcs[0]
+
+
 def api_dot(width=320, height=240):
     """
     Exercise the ngl.dot() API.
@@ -502,6 +1174,71 @@ def api_dot(width=320, height=240):
     assert ctx.dot(1.0) is not None
 
 
+def api_serialize_binary(width=16, height=16):
+    """
+    Exercise the binary serialization: a scene loaded back from its binary
+    form must serialize and render exactly like the original
+    """
+    import array
+
+    rng = random.Random(0)
+    colors = array.array("f", [rng.random() for _ in range(4 * 4)])
+    animkf = [
+        ngl.AnimKeyFrameVec4(0, (1.0, 0.0, 0.0, 1.0)),
+        ngl.AnimKeyFrameVec4(1, (0.0, 1.0, 0.0, 1.0), "exp_in"),
+    ]
+    vert = """
+void main()
+{
+    ngl_out_pos = ngl_projection_matrix * ngl_modelview_matrix * vec4(ngl_position, 1.0);
+}
+"""
+    frag = """
+void main()
+{
+    ngl_out_color = mix(data.colors[1], color, 0.5);
+}
+"""
+    render = ngl.Render(
+        ngl.Quad(),
+        ngl.Program(vertex=vert, fragment=frag, label="prog"),
+        frag_resources=dict(
+            data=ngl.Block(fields=[ngl.BufferVec4(data=colors, label="colors")]),
+            color=ngl.AnimatedVec4(animkf),
+        ),
+        blending="src_over",
+    )
+    scene = ngl.Scene.from_params(render, duration=1, framerate=(30, 1), aspect_ratio=(4, 3))
+
+    fd, binpath = tempfile.mkstemp(suffix=".nglb", prefix="ngl-test-scene-")
+    os.close(fd)
+    atexit.register(lambda: os.remove(binpath))
+
+    # A scene without any node (node count of the header zeroed) is rejected
+    data = bytearray(scene.serialize_binary())
+    data[12:16] = bytes(4)
+    with open(binpath, "wb") as f:
+        f.write(data)
+    try:
+        ngl.Scene.from_file(binpath)
+    except Exception:
+        pass
+    else:
+        assert False
+
+    with open(binpath, "wb") as f:
+        f.write(scene.serialize_binary())
+
+    loaded_scene = ngl.Scene.from_file(binpath)
+    assert loaded_scene.serialize() == scene.serialize()
+    assert loaded_scene.duration == 1
+    assert loaded_scene.framerate == (30, 1)
+    assert loaded_scene.aspect_ratio == (4, 3)
+
+    crcs = [_get_frame_crcs(s, [0.5], width, height) for s in (scene, loaded_scene)]
+    assert crcs[0] == crcs[1]
+
+
 def api_probing():
     """
     Exercise the probing APIs; the result is platform/hardware specific so
@@ -513,6 +1250,108 @@ def api_probing():
     pprint.pprint(probe)
 
 
+def api_bake_animations(width=32, height=32):
+    # The baked resources are referenced through struct members, swizzles and
+    # function parameters sharing their names
+    vert = """
+struct shift {
+    vec2 offset;
+};
+
+void main()
+{
+    shift s;
+    s.offset = offset + vec2(0.0, tint.g * 0.1);
+    ngl_out_pos = ngl_projection_matrix * ngl_modelview_matrix * vec4(ngl_position + vec3(s.offset, 0.0), 1.0);
+}
+"""
+    frag = """
+float half_of(float intensity)
+{
+    return intensity * 0.5;
+}
+
+void main()
+{
+    ngl_out_color = vec4(mix(color.bgr.bgr, vec3(half_of(intensity)), 0.5), 1.0);
+}
+"""
+
+    def get_scene():
+        offset = ngl.AnimatedVec2(
+            [
+                ngl.AnimKeyFrameVec2(0, (-0.5, 0.0)),
+                ngl.AnimKeyFrameVec2(1, (0.5, 0.25), "exp_in_out"),
+                ngl.AnimKeyFrameVec2(2, (0.0, -0.25), "bounce_out"),
+            ]
+        )
+        color = ngl.AnimatedColor(
+            [
+                ngl.AnimKeyFrameColor(0, (1.0, 0.0, 0.0)),
+                ngl.AnimKeyFrameColor(2, (0.0, 1.0, 0.5), "sinus_in"),
+            ],
+            space="hsl",
+        )
+        intensity = ngl.AnimatedFloat([ngl.AnimKeyFrameFloat(0, 0.0), ngl.AnimKeyFrameFloat(2, 1.0, "quadratic_in")])
+        render = ngl.Render(
+            ngl.Quad((-0.5, -0.5, 0), (1, 0, 0), (0, 1, 0)),
+            ngl.Program(vertex=vert, fragment=frag),
+            vert_resources=dict(offset=offset, tint=color),
+            frag_resources=dict(color=color, intensity=intensity),
+        )
+        # The color is also used by a node not reading the baked values, so it
+        # must keep being evaluated at every frame
+        render_color = ngl.RenderColor(color=color, geometry=ngl.Quad((-1, -1, 0), (0.5, 0, 0), (0, 0.5, 0)))
+        return ngl.Scene.from_params(ngl.Group(children=[render, render_color]), duration=2, framerate=(30, 1))
+
+    # Frame times, then times not matching any frame or out of the scene
+    times = [i / 30 for i in range(0, 61, 7)] + [0.123, 3 / 30, 0.123, -1.0, 3.0, 2.0]
+
+    crcs = [_get_frame_crcs(get_scene(), times, width, height, bake_animations=bake) for bake in (False, True)]
+    assert crcs[0] == crcs[1]
+
+
+def api_anim_evaluate_batch():
+    times = [-0.5, 0.0, 0.1, 0.2, 0.75, 0.3, 1.0, 1.5, 2.5, 3.0, 2.9, 1.2, 5.0]
+
+    anims = [
+        ngl.AnimatedFloat(
+            [
+                ngl.AnimKeyFrameFloat(0, 1.0),
+                ngl.AnimKeyFrameFloat(1, -2.0, "exp_in"),
+                ngl.AnimKeyFrameFloat(1, 3.0),
+                ngl.AnimKeyFrameFloat(3, 4.0, "bounce_out"),
+            ]
+        ),
+        ngl.AnimatedVec3(
+            [
+                ngl.AnimKeyFrameVec3(0, (0.0, 1.0, 2.0)),
+                ngl.AnimKeyFrameVec3(2, (1.0, -1.0, 0.5), "quadratic_in_out"),
+                ngl.AnimKeyFrameVec3(3, (0.5, 0.5, 0.5), "circular_in"),
+            ]
+        ),
+        ngl.AnimatedColor(
+            [
+                ngl.AnimKeyFrameColor(0, (1.0, 0.0, 0.0)),
+                ngl.AnimKeyFrameColor(1.5, (0.0, 1.0, 0.5), "sinus_in"),
+                ngl.AnimKeyFrameColor(3, (0.2, 0.3, 1.0)),
+            ],
+            space="hsl",
+        ),
+        ngl.AnimatedQuat(
+            [
+                ngl.AnimKeyFrameQuat(0, (0.0, 0.0, 0.0, 1.0)),
+                ngl.AnimKeyFrameQuat(3, (0.0, 0.7071068, 0.0, 0.7071068), "cubic_out"),
+            ]
+        ),
+    ]
+    anims.append(ngl.VelocityFloat(anims[0]))
+
+    for anim in anims:
+        assert anim.evaluate_batch(times) == [anim.evaluate(t) for t in times]
+        assert anim.evaluate_batch([]) == []
+
+
 def api_caps():
     # Manually build a scene config with the default backend and explicit capabilities
     scene_cfg = ngl.SceneCfg(backend=next(k for k, v in ngl.get_backends().items() if v["is_default"]))
@@ -0,0 +1,148 @@
+#
+# Copyright 2023 Nope Forge
+#
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+#
+
+import array
+
+from pynopegl_utils.tests.cmp_cuepoints import test_cuepoints
+from pynopegl_utils.toolbox.colors import COLORS
+
+import pynopegl as ngl
+
+# The children of a Group ending with compatible render nodes (same node type,
+# program, geometry and graphics state) are drawn with a single instanced
+# draw. The scenes are made of 4x4 cells sharing the same geometry and
+# positioned by their transforms.
+
+_COLORS = (
+    COLORS.red,
+    COLORS.orange,
+    COLORS.yellow,
+    COLORS.green,
+    COLORS.cyan,
+    COLORS.azure,
+    COLORS.blue,
+    COLORS.violet,
+)
+
+
+def _get_cell_geometry():
+    return ngl.Quad((-1, -1, 0), (0.5, 0, 0), (0, 0.5, 0))
+
+
+def _get_cell_pos(col, row, offset=(0.0, 0.0)):
+    return (-0.75 + col * 0.5 + offset[0], -0.75 + row * 0.5 + offset[1])
+
+
+def _place(child, col, row, offset=(0.0, 0.0)):
+    return ngl.Translate(child, vector=(col * 0.5 + offset[0], row * 0.5 + offset[1], 0))
+
+
+_GRID_POINTS = {f"C{i}": _get_cell_pos(i % 4, i // 4) for i in range(8)}
+_GRID_POINTS.update({f"T{i}": _get_cell_pos(i % 4, 2 + i // 4, (0.125, 0.125)) for i in range(8)})
+
+
+@test_cuepoints(width=64, height=64, points=_GRID_POINTS, tolerance=1)
+@ngl.scene()
+def batching_grid(cfg: ngl.SceneCfg):
+    cfg.aspect_ratio = (1, 1)
+
+    geometry = _get_cell_geometry()
+
+    # Two lower rows: a run of RenderColor with distinct colors
+    colors = [_place(ngl.RenderColor(color, geometry=geometry), i % 4, i // 4) for i, color in enumerate(_COLORS)]
+
+    # Two upper rows: a run of RenderTexture sharing a 2x2 texture, each cell
+    # rotated differently around its center
+    data = array.array("B")
+    for color in (COLORS.red, COLORS.green, COLORS.blue, COLORS.white):
+        data.extend([int(c * 255) for c in color] + [255])
+    texture = ngl.Texture2D(
+        width=2, height=2, data_src=ngl.BufferUBVec4(data=data), min_filter="nearest", mag_filter="nearest"
+    )
+    textures = []
+    for i in range(8):
+        col, row = i % 4, 2 + i // 4
+        center = _get_cell_pos(col, row)
+        render = _place(ngl.RenderTexture(texture, geometry=geometry), col, row)
+        textures.append(ngl.Rotate(render, angle=90 * i, anchor=(center[0], center[1], 0)))
+
+    return ngl.Group(children=colors + textures)
+
+
+_MIXED_POINTS = {f"A{i}": _get_cell_pos(i, 1) for i in range(4)}
+_MIXED_POINTS.update({f"B{i}": _get_cell_pos(i, 2) for i in range(4)})
+
+
+@test_cuepoints(width=64, height=64, points=_MIXED_POINTS, tolerance=1)
+@ngl.scene()
+def batching_mixed(cfg: ngl.SceneCfg):
+    cfg.aspect_ratio = (1, 1)
+
+    geometry = _get_cell_geometry()
+
+    # A node which can not be batched, drawn between two runs and overlapping
+    # both of them: the draw order of the siblings must be preserved
+    vert = """
+void main()
+{
+    ngl_out_pos = ngl_projection_matrix * ngl_modelview_matrix * vec4(ngl_position, 1.0);
+}
+"""
+    frag = """
+void main()
+{
+    ngl_out_color = vec4(1.0);
+}
+"""
+    sibling = ngl.Render(ngl.Quad((0, -0.5, 0), (1, 0, 0), (0, 1, 0)), ngl.Program(vertex=vert, fragment=frag))
+
+    run0 = [_place(ngl.RenderColor(color, geometry=geometry), i, 1) for i, color in enumerate(_COLORS[:4])]
+    run1 = [_place(ngl.RenderColor(color, geometry=geometry), i, 2) for i, color in enumerate(_COLORS[4:])]
+
+    return ngl.Group(children=run0 + [sibling] + run1)
+
+
+_BLENDING_POINTS = {f"A{i}": _get_cell_pos(i, 1) for i in range(4)}
+_BLENDING_POINTS.update({f"B{i}": _get_cell_pos(i, 2, (0, -0.125)) for i in range(4)})
+_BLENDING_POINTS.update({f"C{i}": _get_cell_pos(i, 2, (0, 0.125)) for i in range(4)})
+
+
+@test_cuepoints(width=64, height=64, points=_BLENDING_POINTS, tolerance=1)
+@ngl.scene()
+def batching_blending(cfg: ngl.SceneCfg):
+    cfg.aspect_ratio = (1, 1)
+
+    geometry = _get_cell_geometry()
+    background = ngl.RenderColor(COLORS.white)
+
+    # Consecutive runs of identical nodes only differing by their blending, the
+    # last one covering the upper half of the cells of the previous one
+    run0 = [
+        _place(ngl.RenderColor(color, opacity=0.5, blending="src_over", geometry=geometry), i, 1)
+        for i, color in enumerate(_COLORS[:4])
+    ]
+    run1 = [_place(ngl.RenderColor(color, geometry=geometry), i, 2) for i, color in enumerate(_COLORS[4:])]
+    run2 = [
+        _place(ngl.RenderColor(COLORS.black, opacity=0.5, blending="src_over", geometry=geometry), i, 2, (0, 0.25))
+        for i in range(4)
+    ]
+
+    return ngl.Group(children=[background] + run0 + run1 + run2)
@@ -180,7 +180,7 @@ def _get_data_streamed_buffer_cuepoints(size):
     return {f"{x}{y}": (c(x), c(y)) for y in range(size) for x in range(size)}
 
 
-def _get_data_streamed_buffer_vec4_scene(cfg: ngl.SceneCfg, size, keyframes, scale, single, show_dbg_points):
+def _get_data_streamed_buffer_vec4_scene(cfg: ngl.SceneCfg, size, keyframes, scale, single, show_dbg_points, resident):
     cfg.duration = keyframes * scale
     cfg.aspect_ratio = (1, 1)
     data_size = size * size
@@ -216,7 +216,9 @@ def _get_data_streamed_buffer_vec4_scene(cfg: ngl.SceneCfg, size, keyframes, sca
     if single:
         streamed_buffer = ngl.StreamedVec4(pts_buffer, vec4_buffer, time_anim=time_anim, label="data")
     else:
-        streamed_buffer = ngl.StreamedBufferVec4(data_size, pts_buffer, vec4_buffer, time_anim=time_anim, label="data")
+        streamed_buffer = ngl.StreamedBufferVec4(
+            data_size, pts_buffer, vec4_buffer, time_anim=time_anim, resident=resident, label="data"
+        )
     streamed_block = ngl.Block(layout="std140", label="streamed_block", fields=(streamed_buffer,))
 
     shader_params = dict(data_size=data_size, size=size)
@@ -237,14 +239,14 @@ def _get_data_streamed_buffer_vec4_scene(cfg: ngl.SceneCfg, size, keyframes, sca
     return group
 
 
-def _get_data_streamed_buffer_function(scale, single):
+def _get_data_streamed_buffer_function(scale, single, resident=False):
     size = 2 if single else 4
     keyframes = 4
 
     @test_cuepoints(points=_get_data_streamed_buffer_cuepoints(size), keyframes=keyframes, tolerance=1)
     @ngl.scene(controls=dict(show_dbg_points=ngl.scene.Bool()))
     def scene_func(cfg: ngl.SceneCfg, show_dbg_points=False):
-        return _get_data_streamed_buffer_vec4_scene(cfg, size, keyframes, scale, single, show_dbg_points)
+        return _get_data_streamed_buffer_vec4_scene(cfg, size, keyframes, scale, single, show_dbg_points, resident)
 
     return scene_func
 
@@ -253,6 +255,48 @@ data_streamed_vec4 = _get_data_streamed_buffer_function(1, True)
 data_streamed_vec4_time_anim = _get_data_streamed_buffer_function(2, True)
 data_streamed_buffer_vec4 = _get_data_streamed_buffer_function(1, False)
 data_streamed_buffer_vec4_time_anim = _get_data_streamed_buffer_function(2, False)
+data_streamed_buffer_vec4_resident = _get_data_streamed_buffer_function(1, False, resident=True)
+data_streamed_buffer_vec4_time_anim_resident = _get_data_streamed_buffer_function(2, False, resident=True)
+
+
+@test_cuepoints(points={"c": (0, 0)}, keyframes=4, tolerance=1)
+@ngl.scene()
+def data_streamed_buffer_vec4_attribute(cfg: ngl.SceneCfg):
+    cfg.duration = 2
+    cfg.aspect_ratio = (1, 1)
+
+    # 2 chunks of 4 vertex colors: every chunk upload must cover the 4 vertices
+    # (and not only as many vertices as there are chunks) for the center of the
+    # quad to switch entirely from red to blue
+    pts_data = array.array("q", [0, 1000000])
+    vec4_data = array.array("f")
+    for color in (COLORS.red, COLORS.blue):
+        vec4_data.extend([*color, 1.0] * 4)
+
+    streamed_buffer = ngl.StreamedBufferVec4(4, ngl.BufferInt64(data=pts_data), ngl.BufferVec4(data=vec4_data))
+
+    vert = textwrap.dedent(
+        """\
+        void main()
+        {
+            ngl_out_pos = ngl_projection_matrix * ngl_modelview_matrix * vec4(ngl_position, 1.0);
+            var_color = vertex_color;
+        }
+        """
+    )
+    frag = textwrap.dedent(
+        """\
+        void main()
+        {
+            ngl_out_color = var_color;
+        }
+        """
+    )
+    program = ngl.Program(vertex=vert, fragment=frag)
+    program.update_vert_out_vars(var_color=ngl.IOVec4())
+    render = ngl.Render(ngl.Quad((-1, -1, 0), (2, 0, 0), (0, 2, 0)), program)
+    render.update_attributes(vertex_color=streamed_buffer)
+    return render
 
 
 @test_cuepoints(points={"c": (0, 0)}, tolerance=1)
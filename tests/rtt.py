@@ -282,6 +282,88 @@ def rtt_load_attachment_nested_msaa(_):
     return _rtt_load_attachment_nested(4)
 
 
+def _get_rtt_shared_depth_function(samples=0):
+    @test_cuepoints(
+        width=32,
+        height=32,
+        points={"a-front": (-0.5, -0.5), "a-back": (0.5, -0.5), "b-back": (-0.5, 0.5), "b-front": (0.5, 0.5)},
+        tolerance=1,
+    )
+    @ngl.scene()
+    def rtt_shared_depth_function(cfg: ngl.SceneCfg):
+        cfg.aspect_ratio = (1, 1)
+
+        def get_depth_render(color, corner, width):
+            quad = ngl.Quad(corner, (width, 0, 0), (0, 2, 0))
+            return ngl.GraphicConfig(ngl.RenderColor(color, geometry=quad), depth_test=True)
+
+        # Sibling RTTs of the same dimensions, format and samples share their
+        # transient depth attachment: each of them must still be depth tested
+        # against its own content only
+        rtts = []
+        renders = []
+        for i, (front, back) in enumerate(((COLORS.orange, COLORS.white), (COLORS.azure, COLORS.rose))):
+            # The background drawn after the front half is hidden by it
+            front_render = get_depth_render(front, (-1 + i, -1, 0), 1)
+            back_render = get_depth_render(back, (-1, -1, 0.5), 2)
+            texture = ngl.Texture2D(width=16, height=16, min_filter="nearest", mag_filter="nearest")
+            group = ngl.Group(children=(front_render, back_render))
+            rtts.append(ngl.RenderToTexture(group, [texture], samples=samples))
+            quad = ngl.Quad((-1, -1 + i, 0), (2, 0, 0), (0, 1, 0))
+            renders.append(ngl.RenderTexture(texture, geometry=quad))
+
+        return ngl.Group(children=rtts + renders)
+
+    return rtt_shared_depth_function
+
+
+rtt_shared_depth = _get_rtt_shared_depth_function()
+rtt_shared_depth_msaa = _get_rtt_shared_depth_function(samples=4)
+
+
+_RENDER_MRT_VERT = """
+void main()
+{
+    ngl_out_pos = ngl_projection_matrix * ngl_modelview_matrix * vec4(ngl_position, 1.0);
+}
+"""
+
+
+_RENDER_MRT_FRAG = """
+void main()
+{
+    ngl_out_color[0] = vec4(color0, 1.0);
+    ngl_out_color[1] = vec4(color1, 1.0);
+}
+"""
+
+
+def _get_rtt_mrt_function(samples=0):
+    @test_cuepoints(width=32, height=32, points={"left": (-0.5, 0), "right": (0.5, 0)}, tolerance=1)
+    @ngl.scene()
+    def rtt_mrt_function(_):
+        # The color targets share the same format and dimensions: each of them
+        # must still get its own transient multisampled attachment
+        program = ngl.Program(vertex=_RENDER_MRT_VERT, fragment=_RENDER_MRT_FRAG, nb_frag_output=2)
+        render = ngl.Render(ngl.Quad(), program)
+        render.update_frag_resources(color0=ngl.UniformVec3(COLORS.orange), color1=ngl.UniformVec3(COLORS.azure))
+        textures = [ngl.Texture2D(width=16, height=16, min_filter="nearest", mag_filter="nearest") for _ in range(2)]
+        rtt = ngl.RenderToTexture(render, textures, samples=samples)
+
+        renders = []
+        for i, texture in enumerate(textures):
+            quad = ngl.Quad((-1 + i, -1, 0), (1, 0, 0), (0, 2, 0))
+            renders.append(ngl.RenderTexture(texture, geometry=quad))
+
+        return ngl.Group(children=[rtt] + renders)
+
+    return rtt_mrt_function
+
+
+rtt_mrt = _get_rtt_mrt_function()
+rtt_mrt_msaa = _get_rtt_mrt_function(samples=4)
+
+
 @test_fingerprint(width=512, height=512, keyframes=10, tolerance=3)
 @ngl.scene()
 def rtt_clear_attachment_with_timeranges(cfg: ngl.SceneCfg):
@@ -313,3 +395,84 @@ def rtt_clear_attachment_with_timeranges(cfg: ngl.SceneCfg):
     render = ngl.RenderTexture(texture)
 
     return ngl.Group(children=(rtt, render))
+
+
+def _get_rtt_cache_function(cache):
+    @test_cuepoints(width=32, height=32, points={"c": (0, 0)}, keyframes=2, tolerance=1)
+    @ngl.scene()
+    def rtt_cache_function(cfg: ngl.SceneCfg):
+        cfg.duration = 2
+        cfg.aspect_ratio = (1, 1)
+
+        # Animated from white at the first keyframe to orange at the second one
+        animkf = [ngl.AnimKeyFrameColor(0, COLORS.white), ngl.AnimKeyFrameColor(1, COLORS.orange)]
+        render = ngl.RenderColor(ngl.AnimatedColor(animkf))
+
+        texture = ngl.Texture2D(width=16, height=16, min_filter="nearest", mag_filter="nearest")
+        rtt = ngl.RenderToTexture(render, [texture], cache=cache)
+
+        return ngl.Group(children=(rtt, ngl.RenderTexture(texture)))
+
+    return rtt_cache_function
+
+
+rtt_cache_auto = _get_rtt_cache_function("auto")
+rtt_cache_always = _get_rtt_cache_function("always")
+rtt_cache_never = _get_rtt_cache_function("never")
+
+
+def _get_rtt_cache_live_function():
+    data = [COLORS.red, COLORS.orange]
+    color = ngl.UniformColor(value=COLORS.white)
+
+    def keyframes_callback(t_id):
+        color.set_value(*data[t_id])
+
+    @test_cuepoints(
+        width=32,
+        height=32,
+        points={"c": (0, 0)},
+        keyframes=len(data),
+        keyframes_callback=keyframes_callback,
+        tolerance=1,
+        exercise_serialization=False,
+    )
+    @ngl.scene()
+    def rtt_cache_live(cfg: ngl.SceneCfg):
+        cfg.duration = 0
+        cfg.aspect_ratio = (1, 1)
+
+        # The time invariant child is cached but the live change must refresh it
+        texture = ngl.Texture2D(width=16, height=16, min_filter="nearest", mag_filter="nearest")
+        rtt = ngl.RenderToTexture(ngl.RenderColor(color), [texture], cache="auto")
+
+        return ngl.Group(children=(rtt, ngl.RenderTexture(texture)))
+
+    return rtt_cache_live
+
+
+rtt_cache_live = _get_rtt_cache_live_function()
+
+
+@test_cuepoints(
+    width=32,
+    height=32,
+    points={"bl": (-0.5, -0.5), "tr": (0.5, 0.5)},
+    keyframes=2,
+    tolerance=1,
+)
+@ngl.scene()
+def rtt_cache_auto_transform(cfg: ngl.SceneCfg):
+    cfg.duration = 2
+    cfg.aspect_ratio = (1, 1)
+
+    # The child is time invariant but the animated transform above the RTT moves it
+    quad = ngl.Quad((-1, -1, 0), (1, 0, 0), (0, 1, 0))
+    render = ngl.RenderColor(COLORS.red, geometry=quad)
+    texture = ngl.Texture2D(width=16, height=16, min_filter="nearest", mag_filter="nearest")
+    rtt = ngl.RenderToTexture(render, [texture], cache="auto")
+
+    animkf = [ngl.AnimKeyFrameVec3(0, (0, 0, 0)), ngl.AnimKeyFrameVec3(1, (1, 1, 0))]
+    translate = ngl.Translate(rtt, vector=ngl.AnimatedVec3(animkf))
+
+    return ngl.Group(children=(translate, ngl.RenderTexture(texture)))